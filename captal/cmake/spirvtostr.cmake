@@ -0,0 +1,19 @@
+#Writes a SPIR-V binary as the comma separated words included by engine.cpp
+#Usage: cmake -DINPUT=shader.spv -DOUTPUT=shader.spv.str -P spirvtostr.cmake
+
+file(READ ${INPUT} CONTENT HEX)
+string(LENGTH "${CONTENT}" LENGTH)
+
+set(WORDS "")
+math(EXPR LAST "${LENGTH} - 8")
+
+foreach(BEGIN RANGE 0 ${LAST} 8)
+    string(SUBSTRING "${CONTENT}" ${BEGIN} 8 BYTES)
+    string(SUBSTRING "${BYTES}" 0 2 BYTE0)
+    string(SUBSTRING "${BYTES}" 2 2 BYTE1)
+    string(SUBSTRING "${BYTES}" 4 2 BYTE2)
+    string(SUBSTRING "${BYTES}" 6 2 BYTE3)
+    string(APPEND WORDS "0x${BYTE3}${BYTE2}${BYTE1}${BYTE0},")
+endforeach()
+
+file(WRITE ${OUTPUT} "${WORDS}")
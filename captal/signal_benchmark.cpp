@@ -0,0 +1,110 @@
+#include <captal/signal.hpp>
+
+#include <sigslot/signal.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <cstdint>
+
+//Compares cpt::signal against sigslot on the engine's usage patterns.
+//Usage: captal_signal_benchmark [iterations]
+
+template<typename Function>
+static void measure(std::string_view name, std::uint64_t operations, Function&& function)
+{
+    const auto begin{std::chrono::steady_clock::now()};
+    const auto result{function()};
+    const auto end{std::chrono::steady_clock::now()};
+
+    const auto nanoseconds{std::chrono::duration<double, std::nano>{end - begin}.count()};
+
+    std::cout << name << ": " << nanoseconds / static_cast<double>(operations) << " ns/op (" << result << ")\n";
+}
+
+//Connect a few callbacks, emit once and disconnect everything: what a transfer buffer or a frame does
+template<typename Signal>
+static std::uint64_t transfer_pattern(std::uint64_t iterations)
+{
+    Signal signal{};
+    std::uint64_t counter{};
+
+    for(std::uint64_t i{}; i < iterations; ++i)
+    {
+        for(std::uint64_t j{}; j < 4; ++j)
+        {
+            signal.connect([&counter, j]()
+            {
+                counter += j;
+            });
+        }
+
+        signal();
+        signal.disconnect_all();
+    }
+
+    return counter;
+}
+
+//Emission only, with long lived callbacks: what the window and the engine update signals do
+template<typename Signal>
+static std::uint64_t emission_pattern(std::uint64_t iterations)
+{
+    Signal signal{};
+    std::uint64_t counter{};
+
+    for(std::uint64_t j{}; j < 8; ++j)
+    {
+        signal.connect([&counter, j](float time)
+        {
+            counter += j + static_cast<std::uint64_t>(time);
+        });
+    }
+
+    for(std::uint64_t i{}; i < iterations; ++i)
+    {
+        signal(1.0f);
+    }
+
+    return counter;
+}
+
+//Connect and disconnect through a scoped connection: what cpt::text does on its atlas
+template<typename Signal, typename Connection>
+static std::uint64_t scoped_pattern(std::uint64_t iterations)
+{
+    Signal signal{};
+    std::uint64_t counter{};
+
+    for(std::uint64_t i{}; i < iterations; ++i)
+    {
+        Connection connection{signal.connect([&counter]()
+        {
+            ++counter;
+        })};
+
+        signal();
+    }
+
+    return counter;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::uint64_t iterations{argc > 1 ? std::stoull(argv[1]) : 1000000};
+
+    measure("transfer pattern, sigslot::signal     ", iterations, [iterations]{return transfer_pattern<sigslot::signal<>>(iterations);});
+    measure("transfer pattern, sigslot::signal_st  ", iterations, [iterations]{return transfer_pattern<sigslot::signal_st<>>(iterations);});
+    measure("transfer pattern, cpt::signal         ", iterations, [iterations]{return transfer_pattern<cpt::signal<>>(iterations);});
+    measure("transfer pattern, cpt::signal_st      ", iterations, [iterations]{return transfer_pattern<cpt::signal_st<>>(iterations);});
+
+    measure("emission pattern, sigslot::signal     ", iterations, [iterations]{return emission_pattern<sigslot::signal<float>>(iterations);});
+    measure("emission pattern, sigslot::signal_st  ", iterations, [iterations]{return emission_pattern<sigslot::signal_st<float>>(iterations);});
+    measure("emission pattern, cpt::signal         ", iterations, [iterations]{return emission_pattern<cpt::signal<float>>(iterations);});
+    measure("emission pattern, cpt::signal_st      ", iterations, [iterations]{return emission_pattern<cpt::signal_st<float>>(iterations);});
+
+    measure("scoped pattern, sigslot::signal       ", iterations, [iterations]{return scoped_pattern<sigslot::signal<>, sigslot::scoped_connection>(iterations);});
+    measure("scoped pattern, sigslot::signal_st    ", iterations, [iterations]{return scoped_pattern<sigslot::signal_st<>, sigslot::scoped_connection>(iterations);});
+    measure("scoped pattern, cpt::signal           ", iterations, [iterations]{return scoped_pattern<cpt::signal<>, cpt::scoped_connection>(iterations);});
+    measure("scoped pattern, cpt::signal_st        ", iterations, [iterations]{return scoped_pattern<cpt::signal_st<>, cpt::scoped_connection>(iterations);});
+}
@@ -93,6 +93,41 @@ constexpr bool bounding_box_query(const vec2<T>& point, const vec2<T>& box_posit
         && point.y() <  box_position.y() + box_size.y();
 }
 
+struct bounding_box
+{
+    vec2f top_left{};
+    vec2f bottom_right{};
+};
+
+constexpr bool intersects(const bounding_box& left, const bounding_box& right) noexcept
+{
+    return left.top_left.x() <= right.bottom_right.x()
+        && left.bottom_right.x() >= right.top_left.x()
+        && left.top_left.y() <= right.bottom_right.y()
+        && left.bottom_right.y() >= right.top_left.y();
+}
+
+template<std::input_iterator InputIt>
+constexpr bounding_box make_bounding_box(InputIt first, InputIt last) noexcept
+{
+    if(first == last)
+    {
+        return bounding_box{};
+    }
+
+    bounding_box output{vec2f{*first}, vec2f{*first}};
+
+    while(++first != last)
+    {
+        const vec2f point{*first};
+
+        output.top_left     = vec2f{std::min(output.top_left.x(), point.x()),     std::min(output.top_left.y(), point.y())};
+        output.bottom_right = vec2f{std::max(output.bottom_right.x(), point.x()), std::max(output.bottom_right.y(), point.y())};
+    }
+
+    return output;
+}
+
 template<typename CharT, typename Traits>
 std::vector<std::basic_string_view<CharT, Traits>> split_once(std::basic_string_view<CharT, Traits> string, CharT delimiter)
 {
@@ -0,0 +1,238 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+#include "asynchronous_resource.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+resource_retirement::~resource_retirement()
+{
+    flush();
+}
+
+epoch_t resource_retirement::begin_epoch()
+{
+    std::lock_guard lock{m_mutex};
+
+    const epoch_t epoch{m_next++};
+    m_in_flight.emplace_back(in_flight_epoch{epoch});
+
+    return epoch;
+}
+
+template<typename T>
+static auto find_epoch(std::vector<T>& in_flight, epoch_t epoch)
+{
+    return std::lower_bound(std::begin(in_flight), std::end(in_flight), epoch, [](const auto& data, epoch_t value)
+    {
+        return data.epoch < value;
+    });
+}
+
+void resource_retirement::submit_epoch(epoch_t epoch, std::function<bool()> completed)
+{
+    std::lock_guard lock{m_mutex};
+
+    const auto it{find_epoch(m_in_flight, epoch)};
+    assert(it != std::end(m_in_flight) && it->epoch == epoch && "cpt::resource_retirement::submit_epoch called with an epoch that is not in flight.");
+
+    it->completed = std::move(completed);
+}
+
+void resource_retirement::end_epoch(epoch_t epoch)
+{
+    std::unique_lock lock{m_mutex};
+
+    const auto it{find_epoch(m_in_flight, epoch)};
+    assert(it != std::end(m_in_flight) && it->epoch == epoch && "cpt::resource_retirement::end_epoch called with an epoch that is not in flight.");
+
+    //Epochs before this one may be done without having been ended yet
+    const bool oldest{std::all_of(std::begin(m_in_flight), it, [](const in_flight_epoch& data){ return data.done; })};
+    m_in_flight.erase(it);
+
+    lock.unlock();
+
+    //Only the completion of the oldest running epoch can make retired resources destroyable
+    if(oldest)
+    {
+        collect();
+    }
+}
+
+void resource_retirement::retire(const asynchronous_resource& resource, std::function<void()> destroy)
+{
+    std::unique_lock lock{m_mutex};
+
+    if(resource.last_use() <= completed_epoch_unlocked())
+    {
+        lock.unlock();
+        destroy();
+    }
+    else
+    {
+        m_retired.emplace_back(retired_resource{&resource, std::move(destroy)});
+    }
+}
+
+void resource_retirement::collect()
+{
+    std::unique_lock lock{m_mutex};
+
+    poll_unlocked();
+
+    const epoch_t completed{completed_epoch_unlocked()};
+    const auto it{std::partition(std::begin(m_retired), std::end(m_retired), [completed](const retired_resource& resource)
+    {
+        return resource.resource->last_use() > completed;
+    })};
+
+    if(it == std::end(m_retired))
+    {
+        return;
+    }
+
+    std::vector<retired_resource> ready{std::make_move_iterator(it), std::make_move_iterator(std::end(m_retired))};
+    m_retired.erase(it, std::end(m_retired));
+
+    //Destruction may release other resources, that will be retired in turn
+    lock.unlock();
+
+    for(auto& resource : ready)
+    {
+        resource.destroy();
+    }
+}
+
+void resource_retirement::flush()
+{
+    std::unique_lock lock{m_mutex};
+
+    while(!std::empty(m_retired))
+    {
+        auto retired{std::move(m_retired)};
+        m_retired.clear();
+
+        lock.unlock();
+
+        for(auto& resource : retired)
+        {
+            resource.destroy();
+        }
+
+        lock.lock();
+    }
+}
+
+epoch_t resource_retirement::completed_epoch()
+{
+    std::lock_guard lock{m_mutex};
+
+    poll_unlocked();
+
+    return completed_epoch_unlocked();
+}
+
+std::size_t resource_retirement::pending_count() const noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    return std::size(m_retired);
+}
+
+void resource_retirement::poll_unlocked()
+{
+    //Only the oldest epochs matter, the others are polled once they are at the front
+    for(auto& data : m_in_flight)
+    {
+        if(!data.done && !(data.completed && data.completed()))
+        {
+            return;
+        }
+
+        data.done = true;
+    }
+}
+
+epoch_t resource_retirement::completed_epoch_unlocked() const noexcept
+{
+    const auto it{std::find_if(std::begin(m_in_flight), std::end(m_in_flight), [](const in_flight_epoch& data)
+    {
+        return !data.done;
+    })};
+
+    if(it == std::end(m_in_flight))
+    {
+        return m_next - 1;
+    }
+
+    return it->epoch - 1;
+}
+
+namespace impl
+{
+
+epoch_t begin_epoch()
+{
+    if(!engine::has_instance())
+    {
+        return 0;
+    }
+
+    return engine::instance().retirement().begin_epoch();
+}
+
+void submit_epoch(epoch_t epoch, std::function<bool()> completed)
+{
+    if(engine::has_instance())
+    {
+        engine::instance().retirement().submit_epoch(epoch, std::move(completed));
+    }
+}
+
+void end_epoch(epoch_t epoch)
+{
+    if(engine::has_instance())
+    {
+        engine::instance().retirement().end_epoch(epoch);
+    }
+}
+
+void retire_resource(const asynchronous_resource& resource, std::function<void()> destroy)
+{
+    if(engine::has_instance())
+    {
+        engine::instance().retirement().retire(resource, std::move(destroy));
+    }
+    else
+    {
+        destroy();
+    }
+}
+
+}
+
+}
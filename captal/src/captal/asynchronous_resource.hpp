@@ -27,63 +27,302 @@
 
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+#include <iterator>
+#include <utility>
 
 namespace cpt
 {
 
+//Epochs are numbered from 1, 0 means "never used by the GPU"
+using epoch_t = std::uint64_t;
+
+class asynchronous_resource;
+
+template<typename T, typename... Args>
+std::shared_ptr<T> make_asynchronous_resource(Args&&... args);
+
+namespace impl
+{
+
+CAPTAL_API epoch_t begin_epoch();
+CAPTAL_API void submit_epoch(epoch_t epoch, std::function<bool()> completed);
+CAPTAL_API void end_epoch(epoch_t epoch);
+CAPTAL_API void retire_resource(const asynchronous_resource& resource, std::function<void()> destroy);
+
+}
+
 class CAPTAL_API asynchronous_resource
 {
+    template<typename T, typename... Args>
+    friend std::shared_ptr<T> make_asynchronous_resource(Args&&... args);
+    friend class asynchronous_resource_keeper;
+    friend class descriptor_pool;
+
 public:
     asynchronous_resource() noexcept = default;
     virtual ~asynchronous_resource() = default;
 
+    epoch_t last_use() const noexcept
+    {
+        return m_last_use.load(std::memory_order_acquire);
+    }
+
+    bool deferred_destruction() const noexcept
+    {
+        return m_deferred;
+    }
+
 protected:
-    asynchronous_resource(const asynchronous_resource&) = default;
-    asynchronous_resource& operator=(const asynchronous_resource&) = default;
-    asynchronous_resource(asynchronous_resource&& other) noexcept = default;
-    asynchronous_resource& operator=(asynchronous_resource&& other) noexcept = default;
+    //The lifetime tracking belongs to the object, it is never copied nor moved
+    asynchronous_resource(const asynchronous_resource&) noexcept
+    {
+
+    }
+
+    asynchronous_resource& operator=(const asynchronous_resource&) noexcept
+    {
+        return *this;
+    }
+
+    asynchronous_resource(asynchronous_resource&&) noexcept
+    {
+
+    }
+
+    asynchronous_resource& operator=(asynchronous_resource&&) noexcept
+    {
+        return *this;
+    }
+
+private:
+    void mark_used(epoch_t epoch) noexcept
+    {
+        epoch_t current{m_last_use.load(std::memory_order_relaxed)};
+
+        while(current < epoch && !m_last_use.compare_exchange_weak(current, epoch, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+private:
+    std::atomic<epoch_t> m_last_use{};
+    bool m_deferred{};
 };
 
 using asynchronous_resource_ptr = std::shared_ptr<asynchronous_resource>;
 using asynchronous_resource_weak_ptr = std::weak_ptr<asynchronous_resource>;
 
+namespace impl
+{
+
+struct retiring_deleter
+{
+    template<typename T>
+    void operator()(T* resource) const noexcept
+    {
+        retire_resource(*resource, [resource]()
+        {
+            delete resource;
+        });
+    }
+};
+
+}
+
+//Resources created by this function are not destroyed when their last reference is released,
+//they go to the engine's retirement queue until every epoch that may have used them is completed.
+template<typename T, typename... Args>
+std::shared_ptr<T> make_asynchronous_resource(Args&&... args)
+{
+    static_assert(std::is_base_of_v<asynchronous_resource, T>, "cpt::make_asynchronous_resource called with a type that does not inherit from cpt::asynchronous_resource.");
+
+    std::shared_ptr<T> output{new T(std::forward<Args>(args)...), impl::retiring_deleter{}};
+    static_cast<asynchronous_resource&>(*output).m_deferred = true;
+
+    return output;
+}
+
+//An epoch is opened by a keeper for a submission. It is completed once the keeper is cleared,
+//or as soon as the completion function given on submission returns true, so keepers that are never cleared do not pin it.
+//Retired resources are destroyed when every epoch up to their last use is completed.
+class CAPTAL_API resource_retirement
+{
+public:
+    resource_retirement() = default;
+    ~resource_retirement();
+    resource_retirement(const resource_retirement&) = delete;
+    resource_retirement& operator=(const resource_retirement&) = delete;
+    resource_retirement(resource_retirement&&) noexcept = delete;
+    resource_retirement& operator=(resource_retirement&&) noexcept = delete;
+
+    epoch_t begin_epoch();
+    //completed is polled with the retirement's lock held, it must stay callable until the epoch ends
+    void submit_epoch(epoch_t epoch, std::function<bool()> completed);
+    void end_epoch(epoch_t epoch);
+    void retire(const asynchronous_resource& resource, std::function<void()> destroy);
+
+    //Destroys the resources that are no longer in use
+    void collect();
+    //Destroys all retired resources, the GPU must be idle
+    void flush();
+
+    //Polls the submitted epochs
+    epoch_t completed_epoch();
+    std::size_t pending_count() const noexcept;
+
+private:
+    //The last use is read on each collection, a resource may still be marked by a keeper renewing its epoch
+    struct retired_resource
+    {
+        const asynchronous_resource* resource{};
+        std::function<void()> destroy{};
+    };
+
+    struct in_flight_epoch
+    {
+        epoch_t epoch{};
+        std::function<bool()> completed{}; //Empty until the epoch is submitted
+        bool done{};
+    };
+
+private:
+    void poll_unlocked();
+    epoch_t completed_epoch_unlocked() const noexcept;
+
+private:
+    mutable std::mutex m_mutex{};
+    epoch_t m_next{1};
+    std::vector<in_flight_epoch> m_in_flight{}; //Sorted, epochs are opened in increasing order
+    std::vector<retired_resource> m_retired{};
+};
+
+//Resources kept for an epoch are marked with it instead of being referenced.
+//Resources that were not created with make_asynchronous_resource are still referenced until the keeper is cleared.
 class CAPTAL_API asynchronous_resource_keeper
 {
 public:
     asynchronous_resource_keeper() = default;
-    ~asynchronous_resource_keeper() = default;
+
+    ~asynchronous_resource_keeper()
+    {
+        clear();
+    }
+
     asynchronous_resource_keeper(const asynchronous_resource_keeper&) = delete;
     asynchronous_resource_keeper& operator=(const asynchronous_resource_keeper&) = delete;
-    asynchronous_resource_keeper(asynchronous_resource_keeper&&) noexcept = default;
-    asynchronous_resource_keeper& operator=(asynchronous_resource_keeper&&) noexcept = default;
+
+    asynchronous_resource_keeper(asynchronous_resource_keeper&& other) noexcept
+    :m_epoch{std::exchange(other.m_epoch, 0)}
+    ,m_marked{std::move(other.m_marked)}
+    ,m_resources{std::move(other.m_resources)}
+    {
+
+    }
+
+    asynchronous_resource_keeper& operator=(asynchronous_resource_keeper&& other) noexcept
+    {
+        clear();
+
+        m_epoch = std::exchange(other.m_epoch, 0);
+        m_marked = std::move(other.m_marked);
+        m_resources = std::move(other.m_resources);
+
+        return *this;
+    }
 
     template<typename T>
-    void keep(T&& resource)
+    void keep(const std::shared_ptr<T>& resource)
     {
-        static_assert(!std::is_pointer_v<T>, "cpt::asynchronous_resource_keeper::keep called with raw pointer.");
+        static_assert(std::is_base_of_v<asynchronous_resource, T>, "cpt::asynchronous_resource_keeper::keep called with a type that does not inherit from cpt::asynchronous_resource.");
+
+        if(!resource)
+        {
+            return;
+        }
+
+        asynchronous_resource& base{*resource};
 
-        m_resources.emplace_back(std::forward<T>(resource));
+        if(base.m_deferred)
+        {
+            if(m_epoch == 0)
+            {
+                m_epoch = impl::begin_epoch();
+            }
+
+            //Same epoch means that this keeper already has it
+            if(base.m_last_use.load(std::memory_order_relaxed) != m_epoch)
+            {
+                base.mark_used(m_epoch);
+                m_marked.emplace_back(&base);
+            }
+        }
+        else
+        {
+            m_resources.emplace_back(resource);
+        }
     }
 
     template<std::input_iterator InputIt>
     void keep(InputIt begin, InputIt end)
     {
-        static_assert(!std::is_pointer_v<typename std::iterator_traits<InputIt>::value_type>, "cpt::asynchronous_resource_keeper::keep called with raw pointer.");
-
-        m_resources.insert(std::end(m_resources), begin, end);
+        for(; begin != end; ++begin)
+        {
+            keep(*begin);
+        }
     }
 
     void reserve(std::size_t size)
     {
-        m_resources.reserve(std::size(m_resources) + size);
+        m_marked.reserve(std::size(m_marked) + size);
+    }
+
+    //Call it once the work using the kept resources is submitted, completed must return true once the GPU is done with it.
+    //The epoch can then complete before the keeper is cleared. completed must stay callable until the keeper is cleared or renewed.
+    void submitted(std::function<bool()> completed)
+    {
+        if(m_epoch != 0)
+        {
+            impl::submit_epoch(m_epoch, std::move(completed));
+        }
+    }
+
+    //Moves the kept resources to a new epoch, for work that is submitted again as is.
+    void renew()
+    {
+        if(m_epoch != 0)
+        {
+            const epoch_t old{std::exchange(m_epoch, impl::begin_epoch())};
+
+            for(asynchronous_resource* resource : m_marked)
+            {
+                resource->mark_used(m_epoch);
+            }
+
+            impl::end_epoch(old);
+        }
     }
 
     void clear() noexcept
     {
+        if(m_epoch != 0)
+        {
+            impl::end_epoch(std::exchange(m_epoch, 0));
+        }
+
+        m_marked.clear();
         m_resources.clear();
     }
 
+    epoch_t epoch() const noexcept
+    {
+        return m_epoch;
+    }
+
 private:
+    epoch_t m_epoch{};
+    std::vector<asynchronous_resource*> m_marked{};
     std::vector<asynchronous_resource_ptr> m_resources{};
 };
 
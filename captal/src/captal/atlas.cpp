@@ -0,0 +1,439 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "atlas.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <chrono>
+#include <cstring>
+#include <cassert>
+
+#include <tephra/commands.hpp>
+
+#include <captal_foundation/frame_arena.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static constexpr auto atlas_usage{tph::texture_usage::sampled | tph::texture_usage::transfer_destination};
+
+static tph::texture_format atlas_format(color_space space) noexcept
+{
+    switch(space)
+    {
+        case color_space::srgb:   return tph::texture_format::r8g8b8a8_srgb;
+        case color_space::linear: return tph::texture_format::r8g8b8a8_unorm;
+        default: std::terminate();
+    }
+}
+
+//New pages are cleared so the padding between images stays transparent
+static void begin_page_upload(tph::command_buffer& buffer, const texture_ptr& texture, tph::texture_layout old_layout)
+{
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.source_access      = tph::resource_access::none;
+    barrier.destination_access = tph::resource_access::transfer_write;
+    barrier.old_layout         = old_layout;
+    barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+}
+
+static void begin_page_upload(tph::command_buffer& buffer, const texture_ptr& texture, bool first_upload)
+{
+    begin_page_upload(buffer, texture, first_upload ? tph::texture_layout::undefined : tph::texture_layout::shader_read_only_optimal);
+
+    if(first_upload)
+    {
+        const tph::texture_subresource_range range{};
+        tph::cmd::clear_color_image(buffer, texture->get_texture(), tph::texture_layout::transfer_destination_optimal, tph::clear_color_float_value{}, std::span{&range, 1});
+
+        //The copies write over the cleared texels
+        tph::texture_memory_barrier clear_barrier{texture->get_texture()};
+        clear_barrier.source_access      = tph::resource_access::transfer_write;
+        clear_barrier.destination_access = tph::resource_access::transfer_write;
+        clear_barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+        clear_barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
+
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&clear_barrier, 1});
+    }
+}
+
+static void end_page_upload(tph::command_buffer& buffer, const texture_ptr& texture)
+{
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.source_access      = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+    barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+    barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+    tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+}
+
+atlas_builder::atlas_builder(std::uint32_t page_size, const tph::sampler_info& sampling, color_space space, std::uint32_t padding)
+:m_page_size{page_size}
+,m_padding{padding}
+,m_sampling{sampling}
+,m_space{space}
+{
+
+}
+
+texture_region_ptr atlas_builder::add(const std::filesystem::path& path)
+{
+    if(const auto it{m_paths.find(path)}; it != std::end(m_paths))
+    {
+        return m_images[it->second].region;
+    }
+
+    const tph::image image{engine::instance().renderer(), path, tph::image_usage::transfer_source | tph::image_usage::persistant_mapping};
+    const auto data{reinterpret_cast<const std::uint8_t*>(image.data())};
+
+    auto output{insert(static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), std::vector<std::uint8_t>{data, data + image.byte_size()})};
+    m_paths.emplace(path, std::size(m_images) - 1);
+
+    return output;
+}
+
+texture_region_ptr atlas_builder::add(std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba)
+{
+    assert(std::size(rgba) == static_cast<std::size_t>(width) * height * 4 && "cpt::atlas_builder::add called with wrong pixel count.");
+
+    return insert(width, height, std::vector<std::uint8_t>{std::begin(rgba), std::end(rgba)});
+}
+
+texture_region_ptr atlas_builder::find(const std::filesystem::path& path) const
+{
+    if(const auto it{m_paths.find(path)}; it != std::end(m_paths))
+    {
+        return m_images[it->second].region;
+    }
+
+    return nullptr;
+}
+
+void atlas_builder::upload()
+{
+    if(std::empty(m_pending))
+    {
+        return;
+    }
+
+    //Copies are recorded page by page
+    std::sort(std::begin(m_pending), std::end(m_pending), [this](std::size_t left, std::size_t right)
+    {
+        return m_images[left].page < m_images[right].page;
+    });
+
+    const auto accumulator = [this](std::uint64_t total, std::size_t index)
+    {
+        return total + std::size(m_images[index].pixels);
+    };
+
+    auto&& [buffer, signal, keeper] = engine::instance().begin_transfer();
+
+    const std::uint64_t total_size{std::accumulate(std::begin(m_pending), std::end(m_pending), std::uint64_t{}, accumulator)};
+    const auto staging{engine::instance().transfer_scheduler().stage(total_size)};
+
+    auto copies{make_frame_vector<tph::buffer_texture_copy>()};
+    copies.reserve(std::size(m_pending));
+
+    std::uint64_t offset{};
+    auto it{std::begin(m_pending)};
+    while(it != std::end(m_pending))
+    {
+        const std::size_t current{m_images[*it].page};
+        auto& page{m_pages[current]};
+
+        copies.clear();
+        for(; it != std::end(m_pending) && m_images[*it].page == current; ++it)
+        {
+            const auto& image{m_images[*it]};
+
+            std::memcpy(reinterpret_cast<std::uint8_t*>(staging.data) + offset, std::data(image.pixels), std::size(image.pixels));
+
+            tph::buffer_texture_copy copy{};
+            copy.buffer_offset = staging.offset + offset;
+            copy.buffer_image_width = image.width;
+            copy.buffer_image_height = image.height;
+            copy.texture_offset.x = static_cast<std::int32_t>(image.region->x);
+            copy.texture_offset.y = static_cast<std::int32_t>(image.region->y);
+            copy.texture_size.width = image.width;
+            copy.texture_size.height = image.height;
+            copy.texture_size.depth = 1;
+
+            copies.emplace_back(copy);
+            offset += std::size(image.pixels);
+        }
+
+        begin_page_upload(buffer, page.texture, std::exchange(page.first_upload, false));
+        tph::cmd::copy(buffer, staging.buffer, page.texture->get_texture(), copies);
+        end_page_upload(buffer, page.texture);
+
+        keeper.keep(page.texture);
+    }
+
+    m_pending.clear();
+}
+
+void atlas_builder::rebuild()
+{
+    if(rebuilding())
+    {
+        return;
+    }
+
+    //Pixels of added images are never modified nor freed, the worker can read them without copy
+    std::vector<image_view> images{};
+    images.reserve(std::size(m_images));
+
+    for(auto&& image : m_images)
+    {
+        images.emplace_back(image_view{image.width, image.height, std::data(image.pixels)});
+    }
+
+    m_rebuild_count = std::size(m_images);
+    m_rebuild = std::async(std::launch::async, &atlas_builder::compute_layout, std::move(images), m_page_size, m_padding);
+}
+
+bool atlas_builder::poll()
+{
+    if(!m_rebuild.valid() || m_rebuild.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+    {
+        return false;
+    }
+
+    auto layout{m_rebuild.get()};
+
+    auto&& [buffer, signal, keeper] = engine::instance().begin_transfer();
+
+    //Old pages stay alive as long as renderables are bound to them
+    std::vector<page_data> pages{};
+    pages.reserve(std::size(layout.pages));
+
+    for(std::size_t i{}; i < std::size(layout.pages); ++i)
+    {
+        auto& page{pages.emplace_back(page_data{make_texture(m_sampling, m_page_size, m_page_size, tph::texture_info{atlas_format(m_space), atlas_usage}), std::move(layout.packers[i]), false})};
+
+        const auto& pixels{layout.pages[i]};
+        const auto staging{engine::instance().transfer_scheduler().stage(std::size(pixels))};
+        std::memcpy(staging.data, std::data(pixels), std::size(pixels));
+
+        tph::buffer_texture_copy copy{};
+        copy.buffer_offset = staging.offset;
+        copy.texture_size.width = m_page_size;
+        copy.texture_size.height = m_page_size;
+        copy.texture_size.depth = 1;
+
+        //New texture, the copy writes the whole page so it does not need the clear of a first upload
+        begin_page_upload(buffer, page.texture, tph::texture_layout::undefined);
+        tph::cmd::copy(buffer, staging.buffer, page.texture->get_texture(), copy);
+        end_page_upload(buffer, page.texture);
+
+        keeper.keep(page.texture);
+    }
+
+    m_pages = std::move(pages);
+
+#ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        for(std::size_t i{}; i < std::size(m_pages); ++i)
+        {
+            m_pages[i].texture->set_name(m_name + " page " + std::to_string(i));
+        }
+    }
+#endif
+
+    for(std::size_t i{}; i < m_rebuild_count; ++i)
+    {
+        const auto& placement{layout.placements[i]};
+        auto& image{m_images[i]};
+
+        image.page = placement.page;
+        *image.region = texture_region{m_pages[placement.page].texture, placement.rect.x + m_padding, placement.rect.y + m_padding, image.width, image.height};
+    }
+
+    //Images added during the rebuild go in the new pages
+    m_pending.clear();
+    for(std::size_t i{m_rebuild_count}; i < std::size(m_images); ++i)
+    {
+        pack(i);
+    }
+
+    m_signal();
+
+    return true;
+}
+
+#ifdef CAPTAL_DEBUG
+void atlas_builder::set_name(std::string_view name)
+{
+    m_name = name;
+
+    for(std::size_t i{}; i < std::size(m_pages); ++i)
+    {
+        m_pages[i].texture->set_name(m_name + " page " + std::to_string(i));
+    }
+}
+#endif
+
+texture_region_ptr atlas_builder::insert(std::uint32_t width, std::uint32_t height, std::vector<std::uint8_t> pixels)
+{
+    assert(width > 0 && height > 0 && "cpt::atlas_builder::add called with null size.");
+
+    if(width + m_padding * 2 > m_page_size || height + m_padding * 2 > m_page_size)
+    {
+        throw std::runtime_error{"cpt::atlas_builder image of size " + std::to_string(width) + "x" + std::to_string(height) + " does not fit in a page."};
+    }
+
+    auto& image{m_images.emplace_back(image_data{width, height, std::move(pixels), std::make_shared<texture_region>()})};
+    auto output{image.region};
+
+    pack(std::size(m_images) - 1);
+
+    return output;
+}
+
+void atlas_builder::pack(std::size_t index)
+{
+    const auto& image{m_images[index]};
+
+    const std::uint32_t width {image.width  + m_padding * 2};
+    const std::uint32_t height{image.height + m_padding * 2};
+
+    for(std::size_t i{}; i < std::size(m_pages); ++i)
+    {
+        if(const auto rect{m_pages[i].packer.append(width, height)}; rect)
+        {
+            place(index, i, *rect);
+
+            return;
+        }
+    }
+
+    const auto rect{add_page().packer.append(width, height)};
+    assert(rect && "cpt::atlas_builder::pack failed on an empty page.");
+
+    place(index, std::size(m_pages) - 1, *rect);
+}
+
+void atlas_builder::place(std::size_t index, std::size_t page, const bin_packer::rect& rect)
+{
+    auto& image{m_images[index]};
+
+    image.page = page;
+    *image.region = texture_region{m_pages[page].texture, rect.x + m_padding, rect.y + m_padding, image.width, image.height};
+
+    m_pending.emplace_back(index);
+}
+
+atlas_builder::page_data& atlas_builder::add_page()
+{
+    auto& page{m_pages.emplace_back(page_data{make_texture(m_sampling, m_page_size, m_page_size, tph::texture_info{atlas_format(m_space), atlas_usage}), bin_packer{m_page_size, m_page_size}})};
+
+#ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        page.texture->set_name(m_name + " page " + std::to_string(std::size(m_pages) - 1));
+    }
+#endif
+
+    return page;
+}
+
+atlas_builder::layout atlas_builder::compute_layout(std::vector<image_view> images, std::uint32_t page_size, std::uint32_t padding)
+{
+    layout output{};
+    output.placements.resize(std::size(images));
+
+    //Tallest first, the bin packer fills rows of free space better that way
+    std::vector<std::size_t> order(std::size(images));
+    std::iota(std::begin(order), std::end(order), std::size_t{});
+
+    std::sort(std::begin(order), std::end(order), [&images](std::size_t left, std::size_t right)
+    {
+        if(images[left].height != images[right].height)
+        {
+            return images[left].height > images[right].height;
+        }
+
+        return images[left].width > images[right].width;
+    });
+
+    for(const auto index : order)
+    {
+        const std::uint32_t width {images[index].width  + padding * 2};
+        const std::uint32_t height{images[index].height + padding * 2};
+
+        auto& placement{output.placements[index]};
+
+        const auto fits = [&]()
+        {
+            for(std::size_t i{}; i < std::size(output.packers); ++i)
+            {
+                if(const auto rect{output.packers[i].append(width, height)}; rect)
+                {
+                    placement = layout::placement{i, *rect};
+
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        if(!fits())
+        {
+            output.packers.emplace_back(page_size, page_size);
+            output.pages.emplace_back(static_cast<std::size_t>(page_size) * page_size * 4);
+
+            placement = layout::placement{std::size(output.packers) - 1, output.packers.back().append(width, height).value()};
+        }
+    }
+
+    //Padding stays transparent
+    for(std::size_t i{}; i < std::size(images); ++i)
+    {
+        const auto& image{images[i]};
+        const auto& placement{output.placements[i]};
+
+        auto* const page{std::data(output.pages[placement.page])};
+        const std::size_t row_size{static_cast<std::size_t>(image.width) * 4};
+
+        for(std::uint32_t y{}; y < image.height; ++y)
+        {
+            const std::size_t x_offset{placement.rect.x + padding};
+            const std::size_t y_offset{placement.rect.y + padding + y};
+
+            std::memcpy(page + (y_offset * page_size + x_offset) * 4, image.pixels + y * row_size, row_size);
+        }
+    }
+
+    return output;
+}
+
+}
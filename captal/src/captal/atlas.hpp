@@ -0,0 +1,187 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_ATLAS_HPP_INCLUDED
+#define CAPTAL_ATLAS_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <span>
+
+#include "texture.hpp"
+#include "bin_packing.hpp"
+#include "signal.hpp"
+
+namespace cpt
+{
+
+using texture_region_ptr = std::shared_ptr<const texture_region>;
+using atlas_rebuild_signal = cpt::signal<>;
+
+//Packs many images in a few large textures (pages), so renderables using them can share textures and descriptor sets.
+//Regions are updated in place when the atlas is rebuilt; atlas_builder::signal() is then emitted, and users must re-apply them.
+class CAPTAL_API atlas_builder
+{
+    struct path_hash
+    {
+        std::size_t operator()(const std::filesystem::path& path) const noexcept
+        {
+            return std::filesystem::hash_value(path);
+        }
+    };
+
+public:
+    static constexpr std::uint32_t default_page_size{2048};
+
+public:
+    atlas_builder() = default;
+    explicit atlas_builder(std::uint32_t page_size, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, std::uint32_t padding = 1);
+
+    ~atlas_builder() = default;
+    atlas_builder(const atlas_builder&) = delete;
+    atlas_builder& operator=(const atlas_builder&) = delete;
+    atlas_builder(atlas_builder&&) noexcept = default;
+    atlas_builder& operator=(atlas_builder&&) noexcept = default;
+
+    //Images are packed immediately and copied on the next upload, the same path always returns the same region.
+    //The pixels are kept on the CPU for rebuilds.
+    texture_region_ptr add(const std::filesystem::path& path);
+    texture_region_ptr add(std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba);
+    texture_region_ptr find(const std::filesystem::path& path) const;
+
+    void upload();
+
+    //Repacks every image from scratch on a worker thread, largest first, which usually takes fewer pages than incremental additions.
+    //Images added meanwhile are packed in the new pages once the rebuild is applied.
+    void rebuild();
+    //Applies the rebuild if the worker is done, returns true if it has been applied
+    bool poll();
+
+    bool need_upload() const noexcept
+    {
+        return !std::empty(m_pending);
+    }
+
+    bool rebuilding() const noexcept
+    {
+        return m_rebuild.valid();
+    }
+
+    std::size_t page_count() const noexcept
+    {
+        return std::size(m_pages);
+    }
+
+    const texture_ptr& page(std::size_t index) const noexcept
+    {
+        return m_pages[index].texture;
+    }
+
+    std::size_t image_count() const noexcept
+    {
+        return std::size(m_images);
+    }
+
+    atlas_rebuild_signal& signal() noexcept
+    {
+        return m_signal;
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct image_data
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        std::vector<std::uint8_t> pixels{};
+        std::shared_ptr<texture_region> region{};
+        std::size_t page{};
+    };
+
+    struct page_data
+    {
+        texture_ptr texture{};
+        bin_packer packer{};
+        bool first_upload{true};
+    };
+
+    //Result of a rebuild, computed by the worker
+    struct layout
+    {
+        struct placement
+        {
+            std::size_t page{};
+            bin_packer::rect rect{};
+        };
+
+        std::vector<placement> placements{};
+        std::vector<bin_packer> packers{};
+        std::vector<std::vector<std::uint8_t>> pages{};
+    };
+
+    struct image_view
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        const std::uint8_t* pixels{};
+    };
+
+private:
+    texture_region_ptr insert(std::uint32_t width, std::uint32_t height, std::vector<std::uint8_t> pixels);
+    void pack(std::size_t index);
+    void place(std::size_t index, std::size_t page, const bin_packer::rect& rect);
+    page_data& add_page();
+    static layout compute_layout(std::vector<image_view> images, std::uint32_t page_size, std::uint32_t padding);
+
+private:
+    std::uint32_t m_page_size{};
+    std::uint32_t m_padding{};
+    tph::sampler_info m_sampling{};
+    color_space m_space{};
+    std::vector<image_data> m_images{};
+    std::unordered_map<std::filesystem::path, std::size_t, path_hash> m_paths{};
+    std::vector<page_data> m_pages{};
+    std::vector<std::size_t> m_pending{};
+    std::future<layout> m_rebuild{};
+    std::size_t m_rebuild_count{};
+    atlas_rebuild_signal m_signal{};
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+}
+
+#endif
@@ -112,6 +112,43 @@ inline tph::descriptor_write make_descriptor_write(tph::descriptor_set& set, std
     }
 }
 
+//Dynamic uniform buffers are written with the whole buffer heap, so every buffer of the same heap can share the descriptor.
+//The offset of the data in the heap is given when the set is bound.
+struct dynamic_buffer_info
+{
+    std::reference_wrapper<tph::buffer> buffer;
+    std::uint64_t offset{};
+    std::uint64_t size{};
+};
+
+inline dynamic_buffer_info get_dynamic_buffer(const cpt::binding& data) noexcept
+{
+    assert((get_binding_type(data) == binding_type::uniform_buffer || get_binding_type(data) == binding_type::uniform_buffer_part) && "cpt::get_dynamic_buffer called with a binding that is not a uniform buffer.");
+
+    if(get_binding_type(data) == binding_type::uniform_buffer)
+    {
+        auto& buffer{*std::get<uniform_buffer_ptr>(data)};
+        const auto info{buffer.get_buffer()};
+
+        return dynamic_buffer_info{info.buffer, info.offset, buffer.size()};
+    }
+    else
+    {
+        const auto& part{std::get<uniform_buffer_part>(data)};
+        const auto info{part.buffer->get_buffer()};
+
+        return dynamic_buffer_info{info.buffer, info.offset + part.buffer->part_offset(part.part), part.buffer->part_size(part.part)};
+    }
+}
+
+inline tph::descriptor_write make_dynamic_descriptor_write(tph::descriptor_set& set, std::uint32_t binding, const cpt::binding& data) noexcept
+{
+    const auto buffer{get_dynamic_buffer(data)};
+    const tph::descriptor_buffer_info info{buffer.buffer, 0, buffer.size};
+
+    return tph::descriptor_write{set, binding, 0, tph::descriptor_type::uniform_buffer_dynamic, info};
+}
+
 class CAPTAL_API binding_buffer
 {
 public:
@@ -0,0 +1,150 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "bindless.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static std::uint32_t clamp_capacity(std::uint32_t capacity) noexcept
+{
+    const auto& limits{engine::instance().graphics_device().limits()};
+
+    return std::min({capacity, limits.max_per_stage_descriptor_sampled_images, limits.max_per_stage_descriptor_samplers});
+}
+
+bindless_texture_table::bindless_texture_table(std::uint32_t capacity)
+{
+    constexpr auto flags{tph::descriptor_binding_flags::partially_bound | tph::descriptor_binding_flags::update_after_bind | tph::descriptor_binding_flags::update_unused_while_pending};
+
+    m_binding = tph::descriptor_set_layout_binding{tph::shader_stage::fragment, textures_binding, tph::descriptor_type::image_sampler, clamp_capacity(capacity), flags};
+    m_layout = tph::descriptor_set_layout{engine::instance().renderer(), bindings()};
+
+    const tph::descriptor_pool_size size{tph::descriptor_type::image_sampler, m_binding.count};
+    m_pool = tph::descriptor_pool{engine::instance().renderer(), std::span{&size, 1}, 1, tph::descriptor_pool_options::update_after_bind};
+    m_set = tph::descriptor_set{engine::instance().renderer(), m_pool, m_layout};
+}
+
+std::uint32_t bindless_texture_table::add(texture_ptr texture)
+{
+    assert(texture && "cpt::bindless_texture_table::add called with null texture.");
+
+    std::lock_guard lock{m_mutex};
+
+    if(const auto it{m_indices.find(texture.get())}; it != std::end(m_indices))
+    {
+        return it->second;
+    }
+
+    collect();
+
+    std::uint32_t index{};
+
+    if(!std::empty(m_free))
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else if(std::size(m_textures) < m_binding.count)
+    {
+        index = static_cast<std::uint32_t>(std::size(m_textures));
+        m_textures.emplace_back();
+    }
+    else
+    {
+        throw std::runtime_error{"cpt::bindless_texture_table is full."};
+    }
+
+    //Update after bind: the set may be bound by pending frames, as long as they do not use this index
+    const tph::descriptor_texture_info info{&texture->get_sampler(), &texture->get_texture_view(), tph::texture_layout::shader_read_only_optimal};
+    const tph::descriptor_write write{m_set, textures_binding, index, tph::descriptor_type::image_sampler, info};
+    tph::write_descriptors(engine::instance().renderer(), std::span{&write, 1});
+
+    m_indices.emplace(texture.get(), index);
+    m_textures[index] = std::move(texture);
+
+    return index;
+}
+
+void bindless_texture_table::remove(const texture_ptr& texture)
+{
+    std::lock_guard lock{m_mutex};
+
+    const auto it{m_indices.find(texture.get())};
+    if(it == std::end(m_indices))
+    {
+        return;
+    }
+
+    //Frames submitted up to now may still sample the texture, it is kept until they are completed
+    m_retired.emplace_back(retired_index{it->second, last_use()});
+    m_indices.erase(it);
+}
+
+std::optional<std::uint32_t> bindless_texture_table::find(const texture_ptr& texture) const
+{
+    std::lock_guard lock{m_mutex};
+
+    if(const auto it{m_indices.find(texture.get())}; it != std::end(m_indices))
+    {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+#ifdef CAPTAL_DEBUG
+void bindless_texture_table::set_name(std::string_view name)
+{
+    const std::string string_name{name};
+
+    tph::set_object_name(engine::instance().renderer(), m_layout, string_name + " descriptor set layout");
+    tph::set_object_name(engine::instance().renderer(), m_pool, string_name + " descriptor pool");
+    tph::set_object_name(engine::instance().renderer(), m_set, string_name + " descriptor set");
+}
+#endif
+
+void bindless_texture_table::collect()
+{
+    const epoch_t completed{engine::instance().retirement().completed_epoch()};
+
+    const auto it{std::partition(std::begin(m_retired), std::end(m_retired), [completed](const retired_index& retired)
+    {
+        return retired.last_use > completed;
+    })};
+
+    for(auto current{it}; current != std::end(m_retired); ++current)
+    {
+        m_textures[current->index].reset();
+        m_free.emplace_back(current->index);
+    }
+
+    m_retired.erase(it, std::end(m_retired));
+}
+
+}
@@ -0,0 +1,134 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_BINDLESS_HPP_INCLUDED
+#define CAPTAL_BINDLESS_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <mutex>
+#include <span>
+
+#include <tephra/descriptor.hpp>
+
+#include "asynchronous_resource.hpp"
+#include "texture.hpp"
+
+namespace cpt
+{
+
+//One large array of textures shared by every draw, written once per texture.
+//Draws select their texture with an index, given by a push constant in the engine's bindless render layout,
+//so switching textures does not need any new descriptor set.
+class CAPTAL_API bindless_texture_table : public asynchronous_resource
+{
+public:
+    static constexpr std::uint32_t textures_binding{0};
+    static constexpr std::uint32_t default_capacity{4096};
+
+public:
+    explicit bindless_texture_table(std::uint32_t capacity);
+    ~bindless_texture_table() = default;
+    bindless_texture_table(const bindless_texture_table&) = delete;
+    bindless_texture_table& operator=(const bindless_texture_table&) = delete;
+    bindless_texture_table(bindless_texture_table&&) noexcept = delete;
+    bindless_texture_table& operator=(bindless_texture_table&&) noexcept = delete;
+
+    //Returns the index of the texture, the same texture always has the same index until it is removed
+    std::uint32_t add(texture_ptr texture);
+    //The index is reused only once the GPU is done with every frame that may have sampled it
+    void remove(const texture_ptr& texture);
+    std::optional<std::uint32_t> find(const texture_ptr& texture) const;
+
+    std::span<const tph::descriptor_set_layout_binding> bindings() const noexcept
+    {
+        return std::span{&m_binding, 1};
+    }
+
+    tph::descriptor_set& set() noexcept
+    {
+        return m_set;
+    }
+
+    const tph::descriptor_set& set() const noexcept
+    {
+        return m_set;
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return m_binding.count;
+    }
+
+    std::size_t size() const noexcept
+    {
+        std::lock_guard lock{m_mutex};
+
+        return std::size(m_indices);
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct retired_index
+    {
+        std::uint32_t index{};
+        epoch_t last_use{};
+    };
+
+private:
+    void collect();
+
+private:
+    tph::descriptor_set_layout_binding m_binding{};
+    tph::descriptor_set_layout m_layout{};
+    tph::descriptor_pool m_pool{};
+    tph::descriptor_set m_set{};
+    std::vector<texture_ptr> m_textures{};
+    std::unordered_map<const texture*, std::uint32_t> m_indices{};
+    std::vector<std::uint32_t> m_free{};
+    std::vector<retired_index> m_retired{};
+    mutable std::mutex m_mutex{};
+};
+
+using bindless_texture_table_ptr = std::shared_ptr<bindless_texture_table>;
+using bindless_texture_table_weak_ptr = std::weak_ptr<bindless_texture_table>;
+
+template<typename... Args>
+bindless_texture_table_ptr make_bindless_texture_table(Args&&... args)
+{
+    return make_asynchronous_resource<bindless_texture_table>(std::forward<Args>(args)...);
+}
+
+}
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "buffer_pool.hpp"
 
+#include <cstring>
+
 #include <captal_foundation/stack_allocator.hpp>
 
 #include "engine.hpp"
@@ -78,10 +80,10 @@ const void* buffer_heap_chunk::map(std::uint64_t offset) const noexcept
 }
 
 buffer_heap::buffer_heap(std::uint64_t size, tph::buffer_usage usage)
-:m_local_data{engine::instance().renderer(), size, usage | tph::buffer_usage::transfer_source}
+:m_local_data{std::make_unique<std::uint8_t[]>(size)}
 ,m_device_data{engine::instance().renderer(), size, usage | tph::buffer_usage::transfer_destination | tph::buffer_usage::device_only}
 ,m_size{size}
-,m_local_map{m_local_data.map()}
+,m_local_map{m_local_data.get()}
 {
     m_ranges.reserve(64);
     m_upload_ranges.reserve(64);
@@ -178,13 +180,7 @@ void buffer_heap::set_name(std::string_view name)
 
     m_name = name;
 
-    tph::set_object_name(engine::instance().renderer(), m_local_data, m_name + " host buffer");
     tph::set_object_name(engine::instance().renderer(), m_device_data, m_name + " device buffer");
-
-    for(std::size_t i{}; i < std::size(m_stagings); ++i)
-    {
-        tph::set_object_name(engine::instance().renderer(), m_stagings[i].buffer, m_name + " staging buffer #" + std::to_string(i));
-    }
 }
 #endif
 
@@ -196,9 +192,9 @@ static ForwardIt coalesce(ForwardIt begin, ForwardIt end)
 
     while(++begin != end)
     {
-        if(last->source_offset + last->size >= begin->source_offset) //Overlaping or contiguous
+        if(last->destination_offset + last->size >= begin->destination_offset) //Overlaping or contiguous
         {
-            last->size = std::max(begin->source_offset + begin->size - last->source_offset, last->size);
+            last->size = std::max(begin->destination_offset + begin->size - last->destination_offset, last->size);
         }
         else
         {
@@ -212,118 +208,42 @@ static ForwardIt coalesce(ForwardIt begin, ForwardIt end)
     return result;
 }
 
-bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
+void buffer_heap::upload(tph::command_buffer& command_buffer)
 {
-    std::unique_lock lock{m_upload_mutex};
+    std::lock_guard lock{m_upload_mutex};
 
     if(std::empty(m_upload_ranges))
     {
-        return false;
+        return;
     }
 
     const auto sort_predicate = [](const tph::buffer_copy& left, const tph::buffer_copy& right)
     {
-        return left.source_offset < right.source_offset;
+        return left.destination_offset < right.destination_offset;
     };
 
     std::sort(std::begin(m_upload_ranges), std::end(m_upload_ranges), sort_predicate);
     m_upload_ranges.erase(coalesce(std::begin(m_upload_ranges), std::end(m_upload_ranges)), std::end(m_upload_ranges));
 
-    const auto accumulator = [](std::uint64_t left, tph::buffer_copy& right)
+    const auto accumulator = [](std::uint64_t left, const tph::buffer_copy& right)
     {
         return left + right.size;
     };
 
-    const std::uint64_t total_size {std::accumulate(std::begin(m_upload_ranges), std::end(m_upload_ranges), 0ull, accumulator)};
-    const std::uint64_t chunk_size {m_size / 4};
-    const std::uint64_t chunk_count{(total_size + chunk_size) / chunk_size};
-    const std::uint64_t chunk_mask {(1u << chunk_count) - 1u};
-
-    const auto find_staging = [this, chunk_mask]
-    {
-        for(std::size_t i{}; i < std::size(m_stagings); ++i)
-        {
-            for(std::uint64_t mask{chunk_mask}; mask < 0x10; mask <<= 1)
-            {
-                if((m_stagings[i].used & mask) == 0)
-                {
-                    return std::make_pair(i, mask);
-                }
-            }
-        }
-
-        return std::make_pair(std::numeric_limits<std::size_t>::max(), std::uint64_t{});
-    };
-
-    const auto [staging_index, mask] = find_staging();
-
-    if(staging_index != std::numeric_limits<std::size_t>::max())
-    {
-        m_current_staging = staging_index;
-        m_current_mask = mask;
-
-        for(std::size_t i{}; i < 4; ++i) //find base index of the staging
-        {
-            if(((m_current_mask >> i) & 0x01) != 0)
-            {
-                m_current_mask_index = i;
-                break;
-            }
-        }
-    }
-    else
-    {
-        constexpr auto usage{tph::buffer_usage::transfer_source | tph::buffer_usage::transfer_destination};
-
-        m_stagings.emplace_back(staging_buffer{tph::buffer{engine::instance().renderer(), m_size, usage}});
-
-        #ifdef CAPTAL_DEBUG
-        if(!std::empty(m_name))
-        {
-            tph::set_object_name(engine::instance().renderer(), m_stagings.back().buffer, m_name + " staging buffer #" + std::to_string(std::size(m_stagings) - 1));
-        }
-        #endif
-
-        m_current_staging = std::size(m_stagings) - 1;
-        m_current_mask = chunk_mask;
-        m_current_mask_index = 0;
-    }
+    const std::uint64_t total_size{std::accumulate(std::begin(m_upload_ranges), std::end(m_upload_ranges), 0ull, accumulator)};
+    const auto staging{engine::instance().transfer_scheduler().stage(total_size)};
 
-    std::uint64_t current_offset{chunk_size * m_current_mask_index};
+    std::uint64_t current_offset{};
     for(auto& range : m_upload_ranges)
     {
-        range.destination_offset = current_offset;
-        current_offset += range.size;
-    }
-
-    staging_buffer& staging{m_stagings[m_current_staging]};
-    staging.used |= m_current_mask;
-
-    tph::cmd::copy(command_buffer, m_local_data, staging.buffer, m_upload_ranges);
-
-    lock.release();
-
-    return true;
-}
-
-void buffer_heap::end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal)
-{
-    std::unique_lock lock{m_upload_mutex, std::adopt_lock};
+        std::memcpy(reinterpret_cast<std::uint8_t*>(staging.data) + current_offset, m_local_data.get() + range.destination_offset, range.size);
 
-    staging_buffer& staging{m_stagings[m_current_staging]};
-
-    for(auto& range : m_upload_ranges)
-    {
-        std::swap(range.source_offset, range.destination_offset);
+        range.source_offset = staging.offset + current_offset;
+        current_offset += range.size;
     }
 
     tph::cmd::copy(command_buffer, staging.buffer, m_device_data, m_upload_ranges);
     m_upload_ranges.clear();
-
-    staging.connection[m_current_mask_index] = signal.connect([this, index = m_current_staging, mask = m_current_mask]()
-    {
-        m_stagings[index].used &= ~mask;
-    });
 }
 
 void buffer_heap::register_upload(std::uint64_t offset, std::uint64_t size) noexcept
@@ -332,7 +252,7 @@ void buffer_heap::register_upload(std::uint64_t offset, std::uint64_t size) noex
 
     assert(size != 0 && "cpt::buffer_heap::register_upload called with null size.");
 
-    m_upload_ranges.emplace_back(offset, 0, size);
+    m_upload_ranges.emplace_back(0, offset, size);
 }
 
 void buffer_heap::unregister_chunk(const buffer_heap_chunk& chunk) noexcept
@@ -375,7 +295,6 @@ buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignm
         #endif
 
         std::lock_guard lock{m_mutex};
-        m_to_end.emplace_back();
         m_heaps.emplace_back(std::move(heap));
 
         return chunk;
@@ -428,7 +347,6 @@ buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignm
     }
     #endif
 
-    m_to_end.emplace_back();
     m_heaps.emplace_back(std::move(heap));
 
     return chunk;
@@ -442,20 +360,9 @@ void buffer_pool::upload(memory_transfer_info info)
     tph::cmd::begin_label(info.buffer, m_name + " transfer", 0.961f, 0.961f, 0.863f, 1.0f);
     #endif
 
-    for(std::size_t i{}; i < std::size(m_heaps); ++i)
-    {
-        m_to_end[i] = m_heaps[i]->begin_upload(info.buffer);
-    }
-
-    tph::cmd::pipeline_barrier(info.buffer, tph::resource_access::transfer_write, tph::resource_access::transfer_read, tph::dependency_flags::none,
-                                            tph::pipeline_stage::transfer, tph::pipeline_stage::transfer);
-
-    for(std::size_t i{}; i < std::size(m_heaps); ++i)
+    for(auto& heap : m_heaps)
     {
-        if(m_to_end[i])
-        {
-            m_heaps[i]->end_upload(info.buffer, info.signal);
-        }
+        heap->upload(info.buffer);
     }
 
     #ifdef CAPTAL_DEBUG
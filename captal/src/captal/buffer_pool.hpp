@@ -149,24 +149,14 @@ public:
 #endif
 
 private:
-    bool begin_upload(tph::command_buffer& command_buffer);
-    void end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal);
+    void upload(tph::command_buffer& command_buffer);
 
     void register_upload(std::uint64_t offset, std::uint64_t size) noexcept;
     void unregister_chunk(const buffer_heap_chunk& chunk) noexcept;
 
 private:
-    struct staging_buffer
-    {
-        tph::buffer buffer{};
-        std::uint64_t used{}; //only 4 bits are used
-        std::array<cpt::scoped_connection, 4> connection{};
-    };
-
-private:
-    tph::buffer m_local_data{};
+    std::unique_ptr<std::uint8_t[]> m_local_data{};
     tph::buffer m_device_data{};
-    std::vector<staging_buffer> m_stagings{};
     std::uint64_t m_size{};
     void* m_local_map{};
     std::atomic<std::uint64_t> m_free_space{};
@@ -175,9 +165,6 @@ private:
     std::mutex m_mutex{};
 
     std::vector<tph::buffer_copy> m_upload_ranges{};
-    std::size_t m_current_staging{};
-    std::uint64_t m_current_mask{};
-    std::uint64_t m_current_mask_index{};
     std::mutex m_upload_mutex{};
 
 #ifdef CAPTAL_DEBUG
@@ -213,7 +200,6 @@ private:
     tph::buffer_usage m_pool_usage{};
     std::uint64_t m_pool_size{};
 
-    std::vector<bool> m_to_end{};
     std::vector<std::unique_ptr<buffer_heap>> m_heaps{};
     mutable std::mutex m_mutex{};
 
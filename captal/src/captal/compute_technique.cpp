@@ -0,0 +1,138 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "compute_technique.hpp"
+
+#include <cassert>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static tph::compute_pipeline_info make_info(const compute_technique_info& info)
+{
+    assert(info.stage.shader.get().stage() == tph::shader_stage::compute && "cpt::compute_technique created with a shader that is not a compute shader.");
+
+    return tph::compute_pipeline_info{tph::pipeline_options{}, info.stage};
+}
+
+compute_technique::compute_technique(const compute_technique_info& info, render_layout_ptr layout)
+:m_layout{std::move(layout)}
+,m_pipeline{engine::instance().renderer(), make_info(info), m_layout->pipeline_layout(), engine::instance().pipeline_cache()}
+{
+    m_sets.resize(m_layout->user_layout_count() + 2);
+}
+
+void compute_technique::dispatch(frame_render_info info, std::uint32_t group_count_x, std::uint32_t group_count_y, std::uint32_t group_count_z)
+{
+    tph::cmd::bind_pipeline(info.buffer, m_pipeline);
+
+    const auto bindless_index{m_layout->bindless_textures_index()};
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(m_sets)); ++i)
+    {
+        m_push_constants.push(info.buffer, m_layout, i);
+
+        if(bindless_index == i)
+        {
+            const auto& table{engine::instance().bindless_textures()};
+
+            tph::cmd::bind_descriptor_set(info.buffer, i, table->set(), m_layout->pipeline_layout(), tph::pipeline_type::compute);
+            info.keeper.keep(table);
+
+            continue;
+        }
+
+        if(std::empty(m_layout->bindings(i)))
+        {
+            continue;
+        }
+
+        auto& data{m_sets[i]};
+
+        if(std::exchange(data.need_update, false))
+        {
+            data.set.reset();
+            data.set = m_layout->make_set(i, data.bindings);
+
+            #ifdef CAPTAL_DEBUG
+            if(!std::empty(m_name))
+            {
+                tph::set_object_name(engine::instance().renderer(), data.set->set(), m_name + " descriptor set #" + std::to_string(i));
+            }
+            #endif
+        }
+
+        if(m_layout->has_dynamic_offsets(i))
+        {
+            const auto offsets{m_layout->dynamic_offsets(i, data.bindings)};
+
+            tph::cmd::bind_descriptor_set(info.buffer, i, data.set->set(), m_layout->pipeline_layout(), offsets, tph::pipeline_type::compute);
+        }
+        else
+        {
+            tph::cmd::bind_descriptor_set(info.buffer, i, data.set->set(), m_layout->pipeline_layout(), tph::pipeline_type::compute);
+        }
+
+        info.keeper.keep(data.set);
+    }
+
+    tph::cmd::dispatch(info.buffer, group_count_x, group_count_y, group_count_z);
+
+    constexpr auto destination_stages{tph::pipeline_stage::compute_shader | tph::pipeline_stage::draw_indirect | tph::pipeline_stage::vertex_input | tph::pipeline_stage::vertex_shader | tph::pipeline_stage::fragment_shader};
+    constexpr auto destination_access{tph::resource_access::shader_read | tph::resource_access::shader_write | tph::resource_access::indirect_command_read | tph::resource_access::index_read | tph::resource_access::vertex_attribute};
+
+    const tph::memory_barrier barrier{tph::resource_access::shader_write, destination_access};
+    tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::compute_shader, destination_stages, tph::dependency_flags::none, std::span{&barrier, 1}, {}, {});
+
+    info.keeper.keep(shared_from_this());
+}
+
+void compute_technique::set_binding(std::uint32_t set, std::uint32_t index, cpt::binding binding)
+{
+    assert(set < std::size(m_sets) && "cpt::compute_technique::set_binding called with a set index out of the layout.");
+
+    m_sets[set].bindings.set(index, std::move(binding));
+    m_sets[set].need_update = true;
+}
+
+#ifdef CAPTAL_DEBUG
+void compute_technique::set_name(std::string_view name)
+{
+    m_name = name;
+
+    tph::set_object_name(engine::instance().renderer(), m_pipeline, m_name + " pipeline");
+
+    for(std::size_t i{}; i < std::size(m_sets); ++i)
+    {
+        if(m_sets[i].set)
+        {
+            tph::set_object_name(engine::instance().renderer(), m_sets[i].set->set(), m_name + " descriptor set #" + std::to_string(i));
+        }
+    }
+}
+#endif
+
+}
@@ -0,0 +1,189 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_COMPUTE_TECHNIQUE_HPP_INCLUDED
+#define CAPTAL_COMPUTE_TECHNIQUE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <array>
+#include <memory>
+
+#include <tephra/shader.hpp>
+#include <tephra/pipeline.hpp>
+
+#include <captal_foundation/math.hpp>
+
+#include "asynchronous_resource.hpp"
+#include "render_target.hpp"
+#include "render_technique.hpp"
+#include "push_constant_buffer.hpp"
+#include "binding.hpp"
+
+namespace cpt
+{
+
+struct compute_technique_info
+{
+    tph::pipeline_shader_stage stage;
+};
+
+//A compute pipeline with its own bindings and push constants.
+//The layout is a regular render_layout, every set of it is owned by the technique, sets without bindings are not bound.
+//Dispatch from render_target::on_compute, so the dispatches are recorded outside of the render pass.
+class CAPTAL_API compute_technique : public asynchronous_resource, public std::enable_shared_from_this<compute_technique>
+{
+public:
+    explicit compute_technique(const compute_technique_info& info, render_layout_ptr layout);
+    ~compute_technique() = default;
+    compute_technique(const compute_technique&) = delete;
+    compute_technique& operator=(const compute_technique&) = delete;
+    compute_technique(compute_technique&&) noexcept = delete;
+    compute_technique& operator=(compute_technique&&) noexcept = delete;
+
+    //Binds the sets, pushes the constants and dispatches the given number of work groups.
+    //A barrier then makes the writes of the shader visible to the next dispatches and to the draws of the frame.
+    void dispatch(frame_render_info info, std::uint32_t group_count_x, std::uint32_t group_count_y = 1, std::uint32_t group_count_z = 1);
+
+    void set_binding(std::uint32_t set, std::uint32_t index, cpt::binding binding);
+
+    template<typename T>
+    void set_push_constant(std::uint32_t offset, T&& value)
+    {
+        m_push_constants.set(tph::shader_stage::compute, offset, std::forward<T>(value));
+    }
+
+    const cpt::binding& get_binding(std::uint32_t set, std::uint32_t index) const
+    {
+        return m_sets[set].bindings.get(index);
+    }
+
+    optional_ref<const cpt::binding> try_get_binding(std::uint32_t set, std::uint32_t index) const
+    {
+        return m_sets[set].bindings.try_get(index);
+    }
+
+    bool has_binding(std::uint32_t set, std::uint32_t index) const
+    {
+        return m_sets[set].bindings.has(index);
+    }
+
+    template<typename T>
+    const T& get_push_constant(std::uint32_t offset) const
+    {
+        return m_push_constants.get<T>(tph::shader_stage::compute, offset);
+    }
+
+    template<typename T>
+    optional_ref<const T> try_get_push_constant(std::uint32_t offset) const
+    {
+        return m_push_constants.try_get<T>(tph::shader_stage::compute, offset);
+    }
+
+    bool has_push_constant(std::uint32_t offset) const
+    {
+        return m_push_constants.has(tph::shader_stage::compute, offset);
+    }
+
+    const render_layout_ptr& layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    tph::pipeline& pipeline() noexcept
+    {
+        return m_pipeline;
+    }
+
+    const tph::pipeline& pipeline() const noexcept
+    {
+        return m_pipeline;
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct set_data
+    {
+        binding_buffer bindings{};
+        descriptor_set_ptr set{};
+        bool need_update{true};
+    };
+
+private:
+    render_layout_ptr m_layout{};
+    tph::pipeline m_pipeline{};
+    std::vector<set_data> m_sets{};
+    push_constants_buffer m_push_constants{};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+//Work group size of the engine's reference kernels, dispatch (count + reference_group_size - 1) / reference_group_size groups
+inline constexpr std::uint32_t reference_group_size{64};
+
+//Push constants of engine::sprite_cull_compute_shader().
+//Binding 0 holds the boxes (min x, min y, max x, max y), binding 1 a counter followed by the indices of the visible boxes.
+//The counter must be reset to 0 before the dispatch, the order of the indices is unspecified.
+struct sprite_cull_parameters
+{
+    std::array<float, 4> area{}; //min x, min y, max x, max y
+    std::uint32_t count{};
+};
+
+static_assert(sizeof(sprite_cull_parameters) == 20, "cpt::sprite_cull_parameters must match the push constants of data/sprite_cull.comp");
+
+//Push constants of engine::particle_compute_shader().
+//Binding 0 holds the particles as written by cpt::particle_system::copy_attributes, binding 1 receives the cpt::particle_instance of each particle.
+struct particle_simulation_parameters
+{
+    float time{};
+    std::uint32_t count{};
+    std::uint32_t capacity{};
+    float drag{};
+    vec2f gravity{};
+};
+
+static_assert(sizeof(particle_simulation_parameters) == 24, "cpt::particle_simulation_parameters must match the push constants of data/particle.comp");
+
+using compute_technique_ptr = std::shared_ptr<compute_technique>;
+using compute_technique_weak_ptr = std::weak_ptr<compute_technique>;
+
+template<typename... Args>
+compute_technique_ptr make_compute_technique(Args&&... args)
+{
+    return make_asynchronous_resource<compute_technique>(std::forward<Args>(args)...);
+}
+
+}
+
+#endif
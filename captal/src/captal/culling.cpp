@@ -0,0 +1,251 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "culling.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace cpt
+{
+
+static std::uint64_t cell_key(std::int32_t x, std::int32_t y) noexcept
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(y));
+}
+
+static std::int64_t cell_count(std::int32_t x1, std::int32_t y1, std::int32_t x2, std::int32_t y2) noexcept
+{
+    return (static_cast<std::int64_t>(x2) - x1 + 1) * (static_cast<std::int64_t>(y2) - y1 + 1);
+}
+
+culling_grid::culling_grid(float cell_size)
+:m_cell_size{cell_size}
+{
+    assert(cell_size > 0.0f && "cpt::culling_grid cell size must be greater than 0.");
+}
+
+void culling_grid::update(entt::entity entity, const bounding_box& bounds)
+{
+    const auto range{compute_range(bounds)};
+    const bool large{cell_count(range.x1, range.y1, range.x2, range.y2) > max_item_cells};
+
+    auto it{m_items.find(entity)};
+
+    if(it == std::end(m_items))
+    {
+        m_items.emplace(entity, item{bounds, range, large});
+
+        if(large)
+        {
+            m_large_items.emplace_back(entity);
+        }
+        else
+        {
+            insert_cells(entity, range);
+        }
+
+        return;
+    }
+
+    auto& current{it->second};
+    current.bounds = bounds;
+
+    const bool same_range{current.range.x1 == range.x1 && current.range.y1 == range.y1 && current.range.x2 == range.x2 && current.range.y2 == range.y2};
+
+    if(same_range && current.large == large)
+    {
+        return;
+    }
+
+    if(current.large)
+    {
+        remove_large(entity);
+    }
+    else
+    {
+        remove_cells(entity, current.range);
+    }
+
+    if(large)
+    {
+        m_large_items.emplace_back(entity);
+    }
+    else
+    {
+        insert_cells(entity, range);
+    }
+
+    current.range = range;
+    current.large = large;
+}
+
+void culling_grid::remove(entt::entity entity)
+{
+    const auto it{m_items.find(entity)};
+
+    if(it != std::end(m_items))
+    {
+        if(it->second.large)
+        {
+            remove_large(entity);
+        }
+        else
+        {
+            remove_cells(entity, it->second.range);
+        }
+
+        m_items.erase(it);
+    }
+}
+
+void culling_grid::clear() noexcept
+{
+    m_items.clear();
+    m_cells.clear();
+    m_large_items.clear();
+    m_query_result.clear();
+}
+
+std::span<entt::entity> culling_grid::query(const bounding_box& area)
+{
+    m_query_result.clear();
+
+    const auto range{compute_range(area)};
+
+    //If the area covers more cells than there are populated cells, it is cheaper to iterate the populated ones
+    if(cell_count(range.x1, range.y1, range.x2, range.y2) > static_cast<std::int64_t>(std::size(m_cells)))
+    {
+        for(auto&& [key, cell] : m_cells)
+        {
+            const auto x{static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32))};
+            const auto y{static_cast<std::int32_t>(static_cast<std::uint32_t>(key & 0xFFFFFFFF))};
+
+            if(x >= range.x1 && x <= range.x2 && y >= range.y1 && y <= range.y2)
+            {
+                query_cell(x, y, cell, range, area);
+            }
+        }
+    }
+    else
+    {
+        for(std::int32_t y{range.y1}; y <= range.y2; ++y)
+        {
+            for(std::int32_t x{range.x1}; x <= range.x2; ++x)
+            {
+                if(const auto it{m_cells.find(cell_key(x, y))}; it != std::end(m_cells))
+                {
+                    query_cell(x, y, it->second, range, area);
+                }
+            }
+        }
+    }
+
+    for(const auto entity : m_large_items)
+    {
+        if(intersects(m_items.at(entity).bounds, area))
+        {
+            m_query_result.emplace_back(entity);
+        }
+    }
+
+    return m_query_result;
+}
+
+culling_grid::cell_range culling_grid::compute_range(const bounding_box& bounds) const noexcept
+{
+    constexpr auto min{static_cast<float>(std::numeric_limits<std::int32_t>::min() / 2)};
+    constexpr auto max{static_cast<float>(std::numeric_limits<std::int32_t>::max() / 2)};
+
+    const auto to_cell = [this, min, max](float value)
+    {
+        return static_cast<std::int32_t>(std::clamp(std::floor(value / m_cell_size), min, max));
+    };
+
+    return cell_range
+    {
+        to_cell(bounds.top_left.x()),
+        to_cell(bounds.top_left.y()),
+        to_cell(bounds.bottom_right.x()),
+        to_cell(bounds.bottom_right.y())
+    };
+}
+
+void culling_grid::insert_cells(entt::entity entity, const cell_range& range)
+{
+    for(std::int32_t y{range.y1}; y <= range.y2; ++y)
+    {
+        for(std::int32_t x{range.x1}; x <= range.x2; ++x)
+        {
+            m_cells[cell_key(x, y)].emplace_back(entity);
+        }
+    }
+}
+
+void culling_grid::remove_cells(entt::entity entity, const cell_range& range)
+{
+    for(std::int32_t y{range.y1}; y <= range.y2; ++y)
+    {
+        for(std::int32_t x{range.x1}; x <= range.x2; ++x)
+        {
+            const auto it{m_cells.find(cell_key(x, y))};
+            assert(it != std::end(m_cells) && "cpt::culling_grid is corrupted.");
+
+            auto& cell{it->second};
+
+            //Order of entities within a cell does not matter
+            const auto position{std::find(std::begin(cell), std::end(cell), entity)};
+            *position = cell.back();
+            cell.pop_back();
+
+            if(std::empty(cell))
+            {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+
+void culling_grid::remove_large(entt::entity entity)
+{
+    const auto position{std::find(std::begin(m_large_items), std::end(m_large_items), entity)};
+    *position = m_large_items.back();
+    m_large_items.pop_back();
+}
+
+void culling_grid::query_cell(std::int32_t x, std::int32_t y, const std::vector<entt::entity>& cell, const cell_range& range, const bounding_box& area)
+{
+    for(const auto entity : cell)
+    {
+        const auto& current{m_items.at(entity)};
+
+        //An item that spans multiple cells is only reported by the first cell shared with the queried area
+        if(x == std::max(current.range.x1, range.x1) && y == std::max(current.range.y1, range.y1) && intersects(current.bounds, area))
+        {
+            m_query_result.emplace_back(entity);
+        }
+    }
+}
+
+}
@@ -0,0 +1,112 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_CULLING_HPP_INCLUDED
+#define CAPTAL_CULLING_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <span>
+
+#include <entt/entity/entity.hpp>
+
+#include "algorithm.hpp"
+
+namespace cpt
+{
+
+//Uniform grid broadphase used to find which entities intersect a view.
+//Items that cover more than max_item_cells cells are kept in a separate list and tested individually.
+class CAPTAL_API culling_grid
+{
+public:
+    static constexpr float default_cell_size{256.0f};
+    static constexpr std::int64_t max_item_cells{64};
+
+public:
+    culling_grid() = default;
+    explicit culling_grid(float cell_size);
+
+    ~culling_grid() = default;
+    culling_grid(const culling_grid&) = delete;
+    culling_grid& operator=(const culling_grid&) = delete;
+    culling_grid(culling_grid&&) noexcept = default;
+    culling_grid& operator=(culling_grid&&) noexcept = default;
+
+    void update(entt::entity entity, const bounding_box& bounds);
+    void remove(entt::entity entity);
+    void clear() noexcept;
+
+    //The returned span is valid until the next call to query, update, remove or clear
+    std::span<entt::entity> query(const bounding_box& area);
+
+    bool contains(entt::entity entity) const noexcept
+    {
+        return m_items.find(entity) != std::end(m_items);
+    }
+
+    float cell_size() const noexcept
+    {
+        return m_cell_size;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return std::size(m_items);
+    }
+
+private:
+    struct cell_range
+    {
+        std::int32_t x1{};
+        std::int32_t y1{};
+        std::int32_t x2{};
+        std::int32_t y2{};
+    };
+
+    struct item
+    {
+        bounding_box bounds{};
+        cell_range range{};
+        bool large{};
+    };
+
+private:
+    cell_range compute_range(const bounding_box& bounds) const noexcept;
+    void insert_cells(entt::entity entity, const cell_range& range);
+    void remove_cells(entt::entity entity, const cell_range& range);
+    void remove_large(entt::entity entity);
+    void query_cell(std::int32_t x, std::int32_t y, const std::vector<entt::entity>& cell, const cell_range& range, const bounding_box& area);
+
+private:
+    float m_cell_size{default_cell_size};
+    std::unordered_map<entt::entity, item> m_items{};
+    std::unordered_map<std::uint64_t, std::vector<entt::entity>> m_cells{};
+    std::vector<entt::entity> m_large_items{};
+    std::vector<entt::entity> m_query_result{};
+};
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 2, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform texture_index_constant
+{
+	uint index;
+} texture_index;
+
+layout(location = 0) in vec4 frag_color;
+layout(location = 1) in vec2 frag_texture_coord;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+	const vec4 texture_color = texture(textures[texture_index.index], frag_texture_coord);
+
+	out_color = frag_color * texture_color;
+}
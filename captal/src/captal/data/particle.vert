@@ -0,0 +1,34 @@
+#version 450
+
+layout(row_major, set = 0, binding = 0) uniform view_uniform
+{
+    mat4 view;
+    mat4 proj;
+} view;
+
+layout(row_major, set = 1, binding = 0) uniform model_uniform
+{
+    mat4 model;
+} model;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec2 texture_coord;
+layout(location = 3) in vec4 particle; //xy: position, z: size, w: rotation
+layout(location = 4) in vec4 particle_color;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) out vec2 frag_texture_coord;
+
+void main()
+{
+    const float c = cos(particle.w);
+    const float s = sin(particle.w);
+    const vec2 local = position.xy * particle.z;
+    const vec2 world = vec2(c * local.x - s * local.y, s * local.x + c * local.y) + particle.xy;
+
+    gl_Position = view.proj * view.view * model.model * vec4(world, position.z, 1.0);
+
+    frag_color = color * particle_color;
+    frag_texture_coord = texture_coord;
+}
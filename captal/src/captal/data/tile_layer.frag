@@ -0,0 +1,34 @@
+#version 450
+
+layout(set = 1, binding = 1) uniform sampler2D tileset;
+
+layout(std430, set = 1, binding = 2) readonly buffer tile_layer
+{
+	uint width;
+	uint height;
+	vec2 tile_size;
+	uint columns;
+	uint tiles[]; //Two 16-bit tile indices per element
+} layer;
+
+layout(location = 0) in vec4 frag_color;
+layout(location = 1) in vec2 frag_texture_coord;
+
+layout(location = 0) out vec4 out_color;
+
+void main()
+{
+	const uvec2 cell = min(uvec2(frag_texture_coord), uvec2(layer.width - 1, layer.height - 1));
+	const uint cell_index = cell.y * layer.width + cell.x;
+	const uint tile = (layer.tiles[cell_index >> 1] >> ((cell_index & 1) << 4)) & 0xFFFF;
+
+	if(tile == 0xFFFF)
+	{
+		discard;
+	}
+
+	const vec2 origin = vec2(tile % layer.columns, tile / layer.columns) * layer.tile_size;
+	const vec2 texture_coord = origin + fract(frag_texture_coord) * layer.tile_size;
+
+	out_color = frag_color * textureLod(tileset, texture_coord, 0.0);
+}
@@ -0,0 +1,135 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "draw_list.hpp"
+
+#include <array>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace cpt
+{
+
+void draw_list::sort()
+{
+    static constexpr std::size_t digit_bits{8};
+    static constexpr std::size_t digit_count{64 / digit_bits};
+    static constexpr std::size_t bucket_count{1 << digit_bits};
+    static constexpr std::uint64_t digit_mask{bucket_count - 1};
+
+    if(std::size(m_items) < 2)
+    {
+        return;
+    }
+
+    //All histograms are computed in a single pass over the keys
+    std::array<std::array<std::size_t, bucket_count>, digit_count> histograms{};
+
+    for(auto&& item : m_items)
+    {
+        for(std::size_t digit{}; digit < digit_count; ++digit)
+        {
+            ++histograms[digit][(item.key >> (digit * digit_bits)) & digit_mask];
+        }
+    }
+
+    m_buffer.resize(std::size(m_items));
+
+    for(std::size_t digit{}; digit < digit_count; ++digit)
+    {
+        auto& histogram{histograms[digit]};
+
+        //Skip the pass if all keys have the same digit (e.g. unused draw index, same texture)
+        const auto bucket{(m_items.front().key >> (digit * digit_bits)) & digit_mask};
+        if(histogram[bucket] == std::size(m_items))
+        {
+            continue;
+        }
+
+        std::size_t offset{};
+        for(auto& count : histogram)
+        {
+            offset += std::exchange(count, offset);
+        }
+
+        for(auto&& item : m_items)
+        {
+            m_buffer[histogram[(item.key >> (digit * digit_bits)) & digit_mask]++] = item;
+        }
+
+        m_items.swap(m_buffer);
+    }
+
+    sort_collisions();
+}
+
+//Items whose draw index and truncated values are equal are sorted again on their exact key.
+//Such runs are short unless many items share a z that is not exactly the same, e.g. with all sprites on z = 0 only y collisions are sorted.
+void draw_list::sort_collisions()
+{
+    const auto exact_order = [](const item& left, const item& right)
+    {
+        return std::tie(left.exact, left.key) < std::tie(right.exact, right.key);
+    };
+
+    //Calls function(begin, end, exact) for each run of items with the same key bits above shift, exact tells if their exact keys differ
+    const auto for_each_run = [](auto first, auto last, std::uint32_t shift, std::uint64_t exact_mask, auto&& function)
+    {
+        while(first != last)
+        {
+            auto end{std::next(first)};
+            bool exact{};
+
+            for(; end != last && (end->key >> shift) == (first->key >> shift); ++end)
+            {
+                exact = exact || (end->exact & exact_mask) != (first->exact & exact_mask);
+            }
+
+            function(first, end, exact);
+            first = end;
+        }
+    };
+
+    constexpr std::uint64_t z_mask{0xFFFFFFFF00000000ull};
+
+    for_each_run(std::begin(m_items), std::end(m_items), draw_key_layout::z_shift, z_mask, [&](auto begin, auto end, bool z_collision)
+    {
+        //The truncated y decided the order of items with different z
+        if(z_collision)
+        {
+            std::stable_sort(begin, end, exact_order);
+
+            return;
+        }
+
+        for_each_run(begin, end, draw_key_layout::y_shift, ~z_mask, [&](auto y_begin, auto y_end, bool y_collision)
+        {
+            if(y_collision)
+            {
+                std::stable_sort(y_begin, y_end, exact_order);
+            }
+        });
+    });
+}
+
+}
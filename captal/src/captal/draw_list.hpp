@@ -0,0 +1,173 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_DRAW_LIST_HPP_INCLUDED
+#define CAPTAL_DRAW_LIST_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <span>
+#include <bit>
+#include <cassert>
+
+#include <entt/entity/entity.hpp>
+
+namespace cpt
+{
+
+//Layout of a draw key, from most significant to least significant bits:
+//[draw index: 12 bits][z: 20 bits][y: 20 bits][texture: 12 bits]
+//Keys are ordered by draw index, then z, then y. z and y only keep their 20 most significant bits (sign, exponent
+//and 11 bits of mantissa), so close values compare equal. Items pushed with an exact key (see make_exact_draw_key) are then
+//ordered by their exact z and y. The texture only orders keys whose draw index, z and y are equal, to batch draws
+//that share a texture, and the draw list keeps the insertion order of equal keys.
+struct draw_key_layout
+{
+    static constexpr std::uint32_t index_bits{12};
+    static constexpr std::uint32_t z_bits{20};
+    static constexpr std::uint32_t y_bits{20};
+    static constexpr std::uint32_t texture_bits{12};
+
+    static constexpr std::uint32_t texture_shift{0};
+    static constexpr std::uint32_t y_shift{texture_shift + texture_bits};
+    static constexpr std::uint32_t z_shift{y_shift + y_bits};
+    static constexpr std::uint32_t index_shift{z_shift + z_bits};
+
+    static constexpr std::uint32_t max_index{(1u << index_bits) - 1};
+};
+
+static_assert(draw_key_layout::index_shift + draw_key_layout::index_bits == 64);
+
+//Maps a float to an unsigned integer with the same ordering, and keeps the most significant bits
+template<std::uint32_t Bits>
+constexpr std::uint64_t sortable_float(float value) noexcept
+{
+    const auto bits{std::bit_cast<std::uint32_t>(value)};
+    const auto ordered{(bits & 0x80000000u) != 0 ? ~bits : (bits | 0x80000000u)};
+
+    return static_cast<std::uint64_t>(ordered >> (32 - Bits));
+}
+
+//draw_index must not be greater than draw_key_layout::max_index, use make_index_draw_key to sort on the draw index only
+constexpr std::uint64_t make_draw_key(std::uint32_t draw_index, float z, float y, std::uint32_t texture_id) noexcept
+{
+    using layout = draw_key_layout;
+
+    assert(draw_index <= layout::max_index && "cpt::make_draw_key draw index is too big, it must not be greater than cpt::draw_key_layout::max_index.");
+
+    constexpr std::uint64_t texture_mask{(1ull << layout::texture_bits) - 1};
+
+    return (static_cast<std::uint64_t>(draw_index) << layout::index_shift)
+         | (sortable_float<layout::z_bits>(z) << layout::z_shift)
+         | (sortable_float<layout::y_bits>(y) << layout::y_shift)
+         | ((static_cast<std::uint64_t>(texture_id) & texture_mask) << layout::texture_shift);
+}
+
+//Exact z and y of a draw key, sorts the items whose truncated z and y are equal
+constexpr std::uint64_t make_exact_draw_key(float z, float y) noexcept
+{
+    return (sortable_float<32>(z) << 32) | sortable_float<32>(y);
+}
+
+//Keys ordered by the whole draw index, then by texture
+constexpr std::uint64_t make_index_draw_key(std::uint32_t draw_index, std::uint32_t texture_id) noexcept
+{
+    return (static_cast<std::uint64_t>(draw_index) << 32) | static_cast<std::uint64_t>(texture_id);
+}
+
+//Flat array of (key, entity) pairs, sorted with a LSD radix sort.
+//Memory is kept between frames, so a steady state frame does not allocate.
+class CAPTAL_API draw_list
+{
+public:
+    struct item
+    {
+        std::uint64_t key{};
+        entt::entity entity{};
+        std::uint64_t exact{};
+    };
+
+public:
+    draw_list() = default;
+    ~draw_list() = default;
+    draw_list(const draw_list&) = delete;
+    draw_list& operator=(const draw_list&) = delete;
+    draw_list(draw_list&&) noexcept = default;
+    draw_list& operator=(draw_list&&) noexcept = default;
+
+    void clear() noexcept
+    {
+        m_items.clear();
+    }
+
+    void reserve(std::size_t size)
+    {
+        m_items.reserve(size);
+        m_buffer.reserve(size);
+    }
+
+    void push(std::uint64_t key, entt::entity entity, std::uint64_t exact = 0)
+    {
+        m_items.emplace_back(key, entity, exact);
+    }
+
+    //Stable sort, items with the same key and exact key keep their insertion order
+    void sort();
+
+    std::span<const item> items() const noexcept
+    {
+        return m_items;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return std::size(m_items);
+    }
+
+    bool empty() const noexcept
+    {
+        return std::empty(m_items);
+    }
+
+    auto begin() const noexcept
+    {
+        return std::cbegin(m_items);
+    }
+
+    auto end() const noexcept
+    {
+        return std::cend(m_items);
+    }
+
+private:
+    void sort_collisions();
+
+private:
+    std::vector<item> m_items{};
+    std::vector<item> m_buffer{};
+};
+
+}
+
+#endif
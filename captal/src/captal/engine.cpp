@@ -23,6 +23,7 @@
 #include "engine.hpp"
 
 #include <iostream>
+#include <fstream>
 
 #include <apyre/power.hpp>
 
@@ -47,6 +48,36 @@ static constexpr auto default_fragment_shader_spv = std::to_array<std::uint32_t>
     #include "data/default.frag.spv.str"
 });
 
+static constexpr auto tile_layer_fragment_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/tile_layer.frag.spv.str"
+});
+
+static constexpr auto compact_vertex_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/compact.vert.spv.str"
+});
+
+static constexpr auto particle_vertex_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/particle.vert.spv.str"
+});
+
+static constexpr auto sprite_cull_compute_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/sprite_cull.comp.spv.str"
+});
+
+static constexpr auto particle_compute_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/particle.comp.spv.str"
+});
+
+static constexpr auto bindless_fragment_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include "data/bindless.frag.spv.str"
+});
+
 static constexpr std::array<std::uint8_t, 4> default_texture_data{255, 255, 255, 255};
 
 using clock = std::chrono::steady_clock;
@@ -58,6 +89,104 @@ static swl::stream_info make_stream_info(const swl::listener& listener, const sw
     return swl::stream_info{swl::sample_format::float32, listener.channel_count(), audio_world.sample_rate(), audio_device.default_low_output_latency()};
 }
 
+//Pipeline cache files start with this header, the driver's data follows.
+//Vulkan implementations already check their own header, but some of them misbehave on unexpected data.
+//We also reject caches made by another driver version, since they would be useless anyway.
+struct pipeline_cache_header
+{
+    std::array<char, 8> magic{'C', 'P', 'T', 'P', 'C', 'A', 'C', 'H'};
+    std::uint32_t version{1};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
+    std::array<std::uint8_t, 16> uuid{};
+    std::uint64_t size{};
+};
+
+static pipeline_cache_header make_pipeline_cache_header(const tph::physical_device& device, std::uint64_t size) noexcept
+{
+    pipeline_cache_header output{};
+    output.vendor_id = device.properties().vendor_id;
+    output.device_id = device.properties().device_id;
+    output.driver_version = device.properties().driver_version;
+    output.uuid = device.properties().uuid;
+    output.size = size;
+
+    return output;
+}
+
+static bool is_compatible(const pipeline_cache_header& header, const pipeline_cache_header& reference) noexcept
+{
+    return header.magic == reference.magic
+        && header.version == reference.version
+        && header.vendor_id == reference.vendor_id
+        && header.device_id == reference.device_id
+        && header.driver_version == reference.driver_version
+        && header.uuid == reference.uuid;
+}
+
+static tph::pipeline_cache load_pipeline_cache(tph::renderer& renderer, const tph::physical_device& device, const std::filesystem::path& path)
+{
+    if(std::empty(path))
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    std::error_code error{};
+    const auto file_size{std::filesystem::file_size(path, error)};
+    if(error || file_size < sizeof(pipeline_cache_header))
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    std::ifstream ifs{path, std::ios_base::binary};
+    if(!ifs)
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    pipeline_cache_header header{};
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(pipeline_cache_header)) || !is_compatible(header, make_pipeline_cache_header(device, 0)))
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    //A truncated or corrupted file must not make us allocate what the header claims
+    if(header.size > file_size - sizeof(pipeline_cache_header))
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    std::vector<std::uint8_t> data{};
+    data.resize(static_cast<std::size_t>(header.size));
+
+    if(!ifs.read(reinterpret_cast<char*>(std::data(data)), static_cast<std::streamsize>(std::size(data))))
+    {
+        return tph::pipeline_cache{renderer};
+    }
+
+    return tph::pipeline_cache{renderer, data};
+}
+
+static tph::physical_device_features make_renderer_features(const tph::physical_device& device, const graphics_parameters& parameters) noexcept
+{
+    tph::physical_device_features output{parameters.features};
+    output.timeline_semaphore = output.timeline_semaphore || device.features().timeline_semaphore; //Used by the transfer scheduler when available
+
+    if(parameters.bindless_texture_capacity > 0)
+    {
+        output.descriptor_indexing = true;
+        output.shader_sampled_image_array_dynamic_indexing = true;
+    }
+
+    return output;
+}
+
+static tph::renderer_options make_renderer_options(const graphics_parameters& parameters) noexcept
+{
+    return parameters.options | tph::renderer_options::standalone_transfer_queue; //The transfer family is the graphics one if the device has no dedicated family
+}
+
 engine::engine(const std::string& application_name, cpt::version version)
 :m_application{application_name, version}
 ,m_audio_device{m_application.audio_application().default_output_device()}
@@ -67,10 +196,11 @@ engine::engine(const std::string& application_name, cpt::version version)
 ,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
 ,m_graphics_device{m_application.graphics_application().default_physical_device()}
 ,m_renderer{m_graphics_device, graphics_layers, graphics_extensions}
+,m_pipeline_cache{m_renderer}
 ,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
 ,m_transfer_scheduler{m_renderer}
 {
-    init();
+    init(graphics_parameters{});
 }
 
 static const swl::physical_device& default_audio_device(const swl::application& application, const audio_parameters& parameters)
@@ -130,6 +260,11 @@ static const tph::physical_device& default_graphics_device(const tph::applicatio
             return false;
         }
 
+        if(parameters.bindless_texture_capacity > 0 && !(device.features().descriptor_indexing && device.features().shader_sampled_image_array_dynamic_indexing))
+        {
+            return false;
+        }
+
         return true;
     };
 
@@ -150,16 +285,31 @@ engine::engine(cpt::application application, const system_parameters& system [[m
 ,m_listener{m_audio_pulser.bind(swl::listener{audio.channel_count})}
 ,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
 ,m_graphics_device{default_graphics_device(m_application.graphics_application(), graphics)}
-,m_renderer{m_graphics_device, graphics_layers | graphics.layers, graphics_extensions | graphics.extensions, graphics.features, graphics.options}
+,m_renderer{m_graphics_device, graphics_layers | graphics.layers, graphics_extensions | graphics.extensions, make_renderer_features(m_graphics_device, graphics), make_renderer_options(graphics)}
+,m_pipeline_cache_path{graphics.pipeline_cache_path}
+,m_pipeline_cache{load_pipeline_cache(m_renderer, m_graphics_device, m_pipeline_cache_path)}
 ,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
-,m_transfer_scheduler{m_renderer}
+,m_transfer_scheduler{m_renderer, graphics.staging_size}
 {
-    init();
+    init(graphics);
 }
 
 engine::~engine()
 {
     m_renderer.wait();
+    m_retirement.flush();
+
+    try
+    {
+        save_pipeline_cache();
+    }
+    catch(const std::exception& e)
+    {
+        if constexpr(debug_enabled)
+        {
+            std::cerr << "Can not save pipeline cache: " << e.what() << std::endl;
+        }
+    }
 
     m_update_signal.disconnect_all();
     m_frame_per_second_signal.disconnect_all();
@@ -212,9 +362,48 @@ memory_transfer_info engine::begin_transfer()
 void engine::submit_transfers()
 {
     m_uniform_pool.upload();
+    m_transfer_scheduler.submit_streaming_transfers(); //Their acquires are recorded by submit_transfers once the transfer queue executed them
     m_transfer_scheduler.submit_transfers();
 }
 
+void engine::save_pipeline_cache()
+{
+    if(std::empty(m_pipeline_cache_path))
+    {
+        return;
+    }
+
+    const auto data{m_pipeline_cache.data()};
+    const auto header{make_pipeline_cache_header(m_graphics_device, std::size(data))};
+
+    //Write to a temporary file first, so a crash never leaves a truncated cache behind
+    auto temporary_path{m_pipeline_cache_path};
+    temporary_path += ".tmp";
+
+    if(m_pipeline_cache_path.has_parent_path())
+    {
+        std::filesystem::create_directories(m_pipeline_cache_path.parent_path());
+    }
+
+    {
+        std::ofstream ofs{temporary_path, std::ios_base::binary | std::ios_base::trunc};
+        if(!ofs)
+        {
+            throw std::runtime_error{"Can not open file \"" + temporary_path.string() + "\"."};
+        }
+
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(pipeline_cache_header));
+        ofs.write(std::data(data), static_cast<std::streamsize>(std::size(data)));
+
+        if(!ofs)
+        {
+            throw std::runtime_error{"Can not write pipeline cache to \"" + temporary_path.string() + "\"."};
+        }
+    }
+
+    std::filesystem::rename(temporary_path, m_pipeline_cache_path);
+}
+
 bool engine::run()
 {
     update_frame();
@@ -245,7 +434,7 @@ const engine& engine::cinstance() noexcept
     return *m_instance;
 }
 
-void engine::init()
+void engine::init(const graphics_parameters& graphics)
 {
     assert(!m_instance && "Can not create a new engine if one already exists.");
 
@@ -266,15 +455,76 @@ void engine::init()
 
     render_layout_info renderable_info{};
     renderable_info.bindings.reserve(2);
-    renderable_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer);
+    renderable_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer_dynamic);
     renderable_info.bindings.emplace_back(tph::shader_stage::fragment, 1, tph::descriptor_type::image_sampler);
     renderable_info.default_bindings.emplace(1, make_texture(1, 1, std::data(default_texture_data), default_sampling));
 
     set_default_render_layout(make_render_layout(view_info, renderable_info));
 
+    m_tile_layer_fragment_shader = tph::shader{m_renderer, tph::shader_stage::fragment, tile_layer_fragment_shader_spv};
+
+    render_layout_info tile_layer_info{};
+    tile_layer_info.bindings.reserve(3);
+    tile_layer_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer_dynamic);
+    tile_layer_info.bindings.emplace_back(tph::shader_stage::fragment, 1, tph::descriptor_type::image_sampler);
+    tile_layer_info.bindings.emplace_back(tph::shader_stage::fragment, 2, tph::descriptor_type::storage_buffer);
+
+    m_tile_layer_layout = make_render_layout(view_info, tile_layer_info);
+
+    m_compact_vertex_shader = tph::shader{m_renderer, tph::shader_stage::vertex, compact_vertex_shader_spv};
+    m_particle_vertex_shader = tph::shader{m_renderer, tph::shader_stage::vertex, particle_vertex_shader_spv};
+
+    render_layout_info sprite_cull_info{};
+    sprite_cull_info.bindings.reserve(2);
+    sprite_cull_info.bindings.emplace_back(tph::shader_stage::compute, 0, tph::descriptor_type::storage_buffer);
+    sprite_cull_info.bindings.emplace_back(tph::shader_stage::compute, 1, tph::descriptor_type::storage_buffer);
+    sprite_cull_info.push_constants.emplace_back(tph::shader_stage::compute, 0, static_cast<std::uint32_t>(sizeof(sprite_cull_parameters)));
+
+    m_sprite_cull_compute_shader = tph::shader{m_renderer, tph::shader_stage::compute, sprite_cull_compute_shader_spv};
+    m_sprite_cull_compute_layout = make_render_layout(sprite_cull_info, render_layout_info{});
+
+    render_layout_info particle_compute_info{};
+    particle_compute_info.bindings.reserve(2);
+    particle_compute_info.bindings.emplace_back(tph::shader_stage::compute, 0, tph::descriptor_type::storage_buffer);
+    particle_compute_info.bindings.emplace_back(tph::shader_stage::compute, 1, tph::descriptor_type::storage_buffer);
+    particle_compute_info.push_constants.emplace_back(tph::shader_stage::compute, 0, static_cast<std::uint32_t>(sizeof(particle_simulation_parameters)));
+
+    m_particle_compute_shader = tph::shader{m_renderer, tph::shader_stage::compute, particle_compute_shader_spv};
+    m_particle_compute_layout = make_render_layout(particle_compute_info, render_layout_info{});
+
+    if(graphics.bindless_texture_capacity > 0)
+    {
+        m_bindless_textures = make_bindless_texture_table(graphics.bindless_texture_capacity);
+        m_bindless_fragment_shader = tph::shader{m_renderer, tph::shader_stage::fragment, bindless_fragment_shader_spv};
+
+        render_layout_info bindless_renderable_info{};
+        bindless_renderable_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::uniform_buffer_dynamic);
+        bindless_renderable_info.push_constants.emplace_back(tph::shader_stage::fragment, 0, static_cast<std::uint32_t>(sizeof(std::uint32_t)));
+
+        render_layout_info bindless_textures_info{};
+        bindless_textures_info.bindless_textures = true;
+
+        m_bindless_layout = make_render_layout(view_info, bindless_renderable_info, std::span{&bindless_textures_info, 1});
+    }
+
     if constexpr(debug_enabled)
     {
         m_uniform_pool.set_name("cpt::engine's uniform pool");
+        m_tile_layer_layout->set_name("cpt::engine's tile layer render layout");
+        tph::set_object_name(m_renderer, m_tile_layer_fragment_shader, "cpt::engine's tile layer fragment shader");
+        tph::set_object_name(m_renderer, m_compact_vertex_shader, "cpt::engine's compact vertex shader");
+        tph::set_object_name(m_renderer, m_particle_vertex_shader, "cpt::engine's particle vertex shader");
+        tph::set_object_name(m_renderer, m_sprite_cull_compute_shader, "cpt::engine's sprite cull compute shader");
+        tph::set_object_name(m_renderer, m_particle_compute_shader, "cpt::engine's particle compute shader");
+        m_sprite_cull_compute_layout->set_name("cpt::engine's sprite cull compute layout");
+        m_particle_compute_layout->set_name("cpt::engine's particle compute layout");
+
+        if(m_bindless_textures)
+        {
+            m_bindless_textures->set_name("cpt::engine's bindless texture table");
+            m_bindless_layout->set_name("cpt::engine's bindless render layout");
+            tph::set_object_name(m_renderer, m_bindless_fragment_shader, "cpt::engine's bindless fragment shader");
+        }
 
         //Display initialization info
         const auto format_power_state = [](apr::power_state state) -> std::string_view
@@ -392,6 +642,9 @@ void engine::init()
 
 void engine::update_frame()
 {
+    //Submitted epochs complete without any keeper being cleared, check them at least once per frame
+    m_retirement.collect();
+
     ++m_frame_id;
     ++m_frame_per_second_counter;
 
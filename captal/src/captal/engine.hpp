@@ -27,6 +27,7 @@
 
 #include <optional>
 #include <memory>
+#include <filesystem>
 
 #include <swell/stream.hpp>
 #include <swell/audio_pulser.hpp>
@@ -34,6 +35,7 @@
 #include <tephra/renderer.hpp>
 #include <tephra/commands.hpp>
 #include <tephra/shader.hpp>
+#include <tephra/pipeline.hpp>
 
 #include "signal.hpp"
 #include "application.hpp"
@@ -41,6 +43,8 @@
 #include "memory_transfer.hpp"
 #include "buffer_pool.hpp"
 #include "render_technique.hpp"
+#include "bindless.hpp"
+#include "compute_technique.hpp"
 #include "translation.hpp"
 #include "font.hpp"
 
@@ -68,6 +72,9 @@ struct graphics_parameters
     tph::renderer_extension extensions{};
     tph::physical_device_features features{};
     optional_ref<const tph::physical_device> physical_device{};
+    std::filesystem::path pipeline_cache_path{}; //If empty, the pipeline cache is not persistent
+    std::uint64_t staging_size{memory_transfer_scheduler::default_staging_size}; //Size of the staging ring used by uploads
+    std::uint32_t bindless_texture_capacity{}; //If not 0, enables the bindless mode with a texture table of this size, the device must support descriptor indexing
 };
 
 using update_signal = cpt::signal<float>;
@@ -100,11 +107,18 @@ public:
     memory_transfer_info begin_transfer();
     void submit_transfers();
 
+    void save_pipeline_cache();
+
     bool run();
 
     static engine& instance() noexcept;
     static const engine& cinstance() noexcept;
 
+    static bool has_instance() noexcept
+    {
+        return m_instance != nullptr;
+    }
+
     cpt::application& application() noexcept
     {
         return m_application;
@@ -175,6 +189,31 @@ public:
         return m_renderer;
     }
 
+    tph::pipeline_cache& pipeline_cache() noexcept
+    {
+        return m_pipeline_cache;
+    }
+
+    const tph::pipeline_cache& pipeline_cache() const noexcept
+    {
+        return m_pipeline_cache;
+    }
+
+    cpt::resource_retirement& retirement() noexcept
+    {
+        return m_retirement;
+    }
+
+    const cpt::resource_retirement& retirement() const noexcept
+    {
+        return m_retirement;
+    }
+
+    const std::filesystem::path& pipeline_cache_path() const noexcept
+    {
+        return m_pipeline_cache_path;
+    }
+
     memory_transfer_scheduler& transfer_scheduler() noexcept
     {
         return m_transfer_scheduler;
@@ -220,6 +259,67 @@ public:
         return m_default_layout;
     }
 
+    tph::shader& tile_layer_fragment_shader() noexcept
+    {
+        return m_tile_layer_fragment_shader;
+    }
+
+    const render_layout_ptr& tile_layer_render_layout() noexcept
+    {
+        return m_tile_layer_layout;
+    }
+
+    //Used instead of the default vertex shader by render techniques with vertex_layout::compact
+    tph::shader& compact_vertex_shader() noexcept
+    {
+        return m_compact_vertex_shader;
+    }
+
+    //Used instead of the default vertex shader by render techniques with vertex_layout::particle
+    tph::shader& particle_vertex_shader() noexcept
+    {
+        return m_particle_vertex_shader;
+    }
+
+    //Reference kernel culling boxes against an area, see sprite_cull_parameters
+    tph::shader& sprite_cull_compute_shader() noexcept
+    {
+        return m_sprite_cull_compute_shader;
+    }
+
+    const render_layout_ptr& sprite_cull_compute_layout() noexcept
+    {
+        return m_sprite_cull_compute_layout;
+    }
+
+    //Reference kernel integrating particles stored like cpt::particle_system, see particle_simulation_parameters
+    tph::shader& particle_compute_shader() noexcept
+    {
+        return m_particle_compute_shader;
+    }
+
+    const render_layout_ptr& particle_compute_layout() noexcept
+    {
+        return m_particle_compute_layout;
+    }
+
+    //Null if the bindless mode is disabled
+    const bindless_texture_table_ptr& bindless_textures() noexcept
+    {
+        return m_bindless_textures;
+    }
+
+    tph::shader& bindless_fragment_shader() noexcept
+    {
+        return m_bindless_fragment_shader;
+    }
+
+    //Renderables drawn with this layout select their texture with set_push_constant(tph::shader_stage::fragment, 0, index)
+    const render_layout_ptr& bindless_render_layout() noexcept
+    {
+        return m_bindless_layout;
+    }
+
     const cpt::translator& translator() const noexcept
     {
         return m_translator;
@@ -256,7 +356,7 @@ public:
     }
 
 private:
-    void init();
+    void init(const graphics_parameters& graphics);
     void update_frame();
 
 private:
@@ -270,6 +370,9 @@ private:
 
     const tph::physical_device& m_graphics_device;
     tph::renderer m_renderer;
+    std::filesystem::path m_pipeline_cache_path;
+    tph::pipeline_cache m_pipeline_cache;
+    cpt::resource_retirement m_retirement{};
 
     buffer_pool m_uniform_pool;
     memory_transfer_scheduler m_transfer_scheduler;
@@ -278,6 +381,17 @@ private:
     tph::shader m_default_vertex_shader{};
     tph::shader m_default_fragment_shader{};
     render_layout_ptr m_default_layout{};
+    tph::shader m_tile_layer_fragment_shader{};
+    render_layout_ptr m_tile_layer_layout{};
+    tph::shader m_compact_vertex_shader{};
+    tph::shader m_particle_vertex_shader{};
+    tph::shader m_sprite_cull_compute_shader{};
+    render_layout_ptr m_sprite_cull_compute_layout{};
+    tph::shader m_particle_compute_shader{};
+    render_layout_ptr m_particle_compute_layout{};
+    bindless_texture_table_ptr m_bindless_textures{};
+    tph::shader m_bindless_fragment_shader{};
+    render_layout_ptr m_bindless_layout{};
 
     cpt::translator m_translator{};
     cpt::font_engine m_font_engine{};
@@ -34,6 +34,7 @@
 #include FT_STROKER_H
 
 #include <captal_foundation/utility.hpp>
+#include <captal_foundation/frame_arena.hpp>
 
 #include "engine.hpp"
 
@@ -220,13 +221,16 @@ void font_atlas::upload()
         }
     }
 
-    std::vector<tph::buffer_texture_copy> copies{};
+    const auto staging{engine::instance().transfer_scheduler().stage(std::size(m_buffer_data))};
+    std::memcpy(staging.data, std::data(m_buffer_data), std::size(m_buffer_data));
+
+    auto copies{make_frame_vector<tph::buffer_texture_copy>()};
     copies.reserve(std::size(m_buffers));
 
     for(auto&& buffer : m_buffers)
     {
         tph::buffer_texture_copy copy{};
-        copy.buffer_offset = buffer.begin;
+        copy.buffer_offset = staging.offset + buffer.begin;
         copy.buffer_image_width = buffer.rect.width;
         copy.buffer_image_height = buffer.rect.height;
         copy.texture_offset.x = buffer.rect.x;
@@ -238,18 +242,7 @@ void font_atlas::upload()
         copies.emplace_back(copy);
     }
 
-    tph::buffer staging_buffer{engine::instance().renderer(), std::size(m_buffer_data), tph::buffer_usage::staging | tph::buffer_usage::transfer_source};
-    std::memcpy(staging_buffer.map(), std::data(m_buffer_data), std::size(m_buffer_data));
-    staging_buffer.unmap();
-
-#ifdef CAPTAL_DEBUG
-    if(!std::empty(m_name))
-    {
-        tph::set_object_name(engine::instance().renderer(), staging_buffer, m_name + " staging buffer (frame: " + std::to_string(engine::instance().frame()) + ")");
-    }
-#endif
-
-    tph::cmd::copy(buffer, staging_buffer, m_texture->get_texture(), copies);
+    tph::cmd::copy(buffer, staging.buffer, m_texture->get_texture(), copies);
 
     tph::texture_memory_barrier barrier{m_texture->get_texture()};
     barrier.source_access      = tph::resource_access::transfer_write;
@@ -260,7 +253,6 @@ void font_atlas::upload()
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
 
     keeper.keep(m_texture);
-    signal.connect([buffer = std::move(staging_buffer)](){});
 
     m_buffers.clear();
     m_buffer_data.clear();
@@ -25,6 +25,7 @@
 #include "engine.hpp"
 
 #include <sstream>
+#include <algorithm>
 
 namespace cpt
 {
@@ -37,17 +38,50 @@ static std::string thread_name(std::thread::id thread)
     return ss.str();
 }
 
-memory_transfer_scheduler::memory_transfer_scheduler(tph::renderer& renderer) noexcept
+memory_transfer_scheduler::memory_transfer_scheduler(tph::renderer& renderer, std::uint64_t staging_size)
 :m_renderer{&renderer}
 ,m_pool{renderer, tph::command_pool_options::reset | tph::command_pool_options::transient}
+,m_timeline{renderer.enabled_features().timeline_semaphore}
+,m_streaming{m_timeline && !renderer.is_same_queue(tph::queue::transfer, tph::queue::graphics)}
 {
     if(debug_enabled)
     {
         tph::set_object_name(*m_renderer, m_pool, "cpt::engine's primary transfer command pool");
     }
 
+    if(m_timeline)
+    {
+        m_graphics_timeline = tph::semaphore{*m_renderer, 0};
+
+        if constexpr(debug_enabled)
+        {
+            tph::set_object_name(*m_renderer, m_graphics_timeline, "cpt::engine's transfer timeline");
+        }
+    }
+
+    if(m_streaming)
+    {
+        m_streaming_pool = tph::command_pool{*m_renderer, tph::queue::transfer, tph::command_pool_options::reset | tph::command_pool_options::transient};
+        m_streaming_timeline = tph::semaphore{*m_renderer, 0};
+        m_streaming_buffers.reserve(4);
+
+        if constexpr(debug_enabled)
+        {
+            tph::set_object_name(*m_renderer, m_streaming_pool, "cpt::engine's streaming transfer command pool");
+            tph::set_object_name(*m_renderer, m_streaming_timeline, "cpt::engine's streaming transfer timeline");
+        }
+    }
+
+    m_staging = tph::buffer{*m_renderer, staging_size, tph::buffer_usage::staging | tph::buffer_usage::transfer_source};
+    m_staging_map = m_staging.map(); //Persistent mapping, staging memory is host coherent
+    m_staging_statistics.capacity = staging_size;
+
+    if constexpr(debug_enabled)
+    {
+        tph::set_object_name(*m_renderer, m_staging, "cpt::engine's staging ring");
+    }
+
     m_thread_pools.reserve(4);
-    m_buffers.reserve(4);
 
     //Main thread pool
     const auto thread{std::this_thread::get_id()};
@@ -92,7 +126,20 @@ void memory_transfer_scheduler::submit_transfers()
 {
     std::unique_lock lock{m_mutex};
 
-    if(!m_begin)
+    reclaim_staging(); //Must be done before next_buffer, it may reuse the buffer of a pending batch
+    release_completed(); //Completes the keepers' epochs even if nothing is submitted for a while
+
+    const std::uint64_t completed{m_streaming ? m_streaming_timeline.value() : 0};
+
+    //Executed streaming transfers are handed to the next graphics submission, which acquires their resources and keeps them alive
+    const auto is_executed = [completed](const streaming_buffer& buffer)
+    {
+        return buffer.submitted && buffer.parent == no_parent && buffer.value <= completed;
+    };
+
+    const bool acquire{std::any_of(std::begin(m_streaming_buffers), std::end(m_streaming_buffers), is_executed)};
+
+    if(!m_begin && !acquire)
     {
         return;
     }
@@ -103,25 +150,289 @@ void memory_transfer_scheduler::submit_transfers()
     const auto index{buffer_index(buffer)};
     const auto to_execute{secondary_buffers(index)};
 
+    //Uniform heaps are rewritten while previous frames may still read them, so graphics work still has to finish before the copies.
     tph::cmd::pipeline_barrier(buffer.buffer, tph::pipeline_stage::bottom_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none);
-    tph::cmd::execute(buffer.buffer, to_execute);
+    const auto wait_value{record_acquires(buffer.buffer, completed)};
+
+    for(auto& streaming : m_streaming_buffers)
+    {
+        if(is_executed(streaming))
+        {
+            streaming.parent = index;
+            streaming.signal();
+            streaming.signal.disconnect_all();
+        }
+    }
+
+    if(!std::empty(to_execute))
+    {
+        tph::cmd::execute(buffer.buffer, to_execute);
+    }
+
     tph::cmd::end(buffer.buffer);
 
-    buffer.fence.reset();
+    m_staging_batches.emplace_back(staging_batch{index, m_staging_head, m_batch_id++});
 
     tph::submit_info info{};
     info.command_buffers.emplace_back(buffer.buffer);
 
+    //The streaming timeline is already past this value, the wait only orders the releases before the acquires
+    if(wait_value != 0)
+    {
+        info.wait_semaphores.emplace_back(m_streaming_timeline);
+        info.wait_stages.emplace_back(tph::pipeline_stage::all_commands);
+        info.wait_values.emplace_back(wait_value);
+    }
+
+    if(m_timeline)
+    {
+        buffer.value = ++m_graphics_value;
+
+        info.signal_semaphores.emplace_back(m_graphics_timeline);
+        info.signal_values.emplace_back(buffer.value);
+
+        std::unique_lock queue_lock{engine::instance().submit_mutex()};
+        tph::submit(*m_renderer, info, tph::nullref);
+    }
+    else
+    {
+        buffer.fence.reset();
+
+        std::unique_lock queue_lock{engine::instance().submit_mutex()};
+        tph::submit(*m_renderer, info, buffer.fence);
+    }
+}
+
+staging_allocation memory_transfer_scheduler::stage(std::uint64_t size, std::uint64_t alignment)
+{
+    std::unique_lock lock{m_mutex};
+
+    m_staging_statistics.bytes_staged += size;
+
+    reclaim_staging();
+    auto offset{allocate_staging(size, alignment)};
+
+    if(!offset && !std::empty(m_staging_batches))
+    {
+        m_staging_statistics.stalls += 1;
+
+        while(!offset && !std::empty(m_staging_batches))
+        {
+            //The lock is released during the wait so other threads can still stage and submit,
+            //the buffer is pinned so its fence is not reset by a submission in the meantime
+            auto& oldest{m_buffers[m_staging_batches.front().buffer]};
+            const auto value{oldest.value};
+
+            oldest.waiters += 1;
+
+            lock.unlock();
+            wait(oldest, value);
+            lock.lock();
+
+            oldest.waiters -= 1;
+
+            reclaim_staging();
+            offset = allocate_staging(size, alignment);
+        }
+    }
+
+    if(offset)
+    {
+        return staging_allocation{m_staging, *offset, size, m_staging_map + *offset};
+    }
+
+    //The current batch alone does not fit in the ring
+    m_staging_statistics.overflows += 1;
+
+    auto& overflow{m_staging_overflows.emplace_back(staging_overflow{m_batch_id, tph::buffer{*m_renderer, size, tph::buffer_usage::staging | tph::buffer_usage::transfer_source}})};
+
+    if constexpr(debug_enabled)
+    {
+        tph::set_object_name(*m_renderer, overflow.buffer, "cpt::engine's staging overflow buffer (batch: " + std::to_string(m_batch_id) + ")");
+    }
+
+    return staging_allocation{overflow.buffer, 0, size, overflow.buffer.map()};
+}
+
+staging_ring_statistics memory_transfer_scheduler::staging_statistics() const
+{
+    std::unique_lock lock{m_mutex};
+
+    staging_ring_statistics output{m_staging_statistics};
+
+    if(m_staging_head >= m_staging_tail)
+    {
+        output.in_use = m_staging_head - m_staging_tail;
+    }
+    else
+    {
+        output.in_use = (m_staging.size() - m_staging_tail) + m_staging_head;
+    }
+
+    return output;
+}
+
+memory_transfer_info memory_transfer_scheduler::begin_streaming_transfer()
+{
+    if(!m_streaming)
+    {
+        return begin_transfer();
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    auto& buffer{next_streaming_buffer()};
+
+    return memory_transfer_info{buffer.buffer, buffer.signal, buffer.keeper};
+}
+
+staging_allocation memory_transfer_scheduler::stage_streaming(std::uint64_t size)
+{
+    if(!m_streaming)
+    {
+        return stage(size);
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    auto& buffer{next_streaming_buffer()};
+    auto& staging{buffer.staging.emplace_back(*m_renderer, size, tph::buffer_usage::staging | tph::buffer_usage::transfer_source)};
+
+    if constexpr(debug_enabled)
+    {
+        tph::set_object_name(*m_renderer, staging, "cpt::engine's streaming staging buffer (value: " + std::to_string(m_streaming_value + 1) + ")");
+    }
+
+    return staging_allocation{staging, 0, size, staging.map()};
+}
+
+void memory_transfer_scheduler::transfer_ownership(const tph::buffer_memory_barrier& barrier)
+{
+    if(!m_streaming)
+    {
+        tph::buffer_memory_barrier local_barrier{barrier};
+        local_barrier.source_queue_family = VK_QUEUE_FAMILY_IGNORED;
+        local_barrier.destination_queue_family = VK_QUEUE_FAMILY_IGNORED;
+
+        auto info{begin_transfer()};
+        tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::all_commands, tph::dependency_flags::none, {}, std::span{&local_barrier, 1}, {});
+
+        return;
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    auto& buffer{next_streaming_buffer()};
+
+    tph::buffer_memory_barrier release{barrier};
+    release.destination_access = tph::resource_access::none;
+    release.source_queue_family = m_renderer->queue_family(tph::queue::transfer);
+    release.destination_queue_family = m_renderer->queue_family(tph::queue::graphics);
+
+    tph::cmd::pipeline_barrier(buffer.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::bottom_of_pipe, tph::dependency_flags::none, {}, std::span{&release, 1}, {});
+
+    tph::buffer_memory_barrier acquire{release};
+    acquire.source_access = tph::resource_access::none;
+    acquire.destination_access = barrier.destination_access;
+
+    m_buffer_acquires.emplace_back(buffer_acquire{acquire});
+}
+
+void memory_transfer_scheduler::transfer_ownership(const tph::texture_memory_barrier& barrier)
+{
+    if(!m_streaming)
+    {
+        tph::texture_memory_barrier local_barrier{barrier};
+        local_barrier.source_queue_family = VK_QUEUE_FAMILY_IGNORED;
+        local_barrier.destination_queue_family = VK_QUEUE_FAMILY_IGNORED;
+
+        auto info{begin_transfer()};
+        tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::all_commands, tph::dependency_flags::none, {}, {}, std::span{&local_barrier, 1});
+
+        return;
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    auto& buffer{next_streaming_buffer()};
+
+    //Both halves of the ownership transfer must describe the same layout transition
+    tph::texture_memory_barrier release{barrier};
+    release.destination_access = tph::resource_access::none;
+    release.source_queue_family = m_renderer->queue_family(tph::queue::transfer);
+    release.destination_queue_family = m_renderer->queue_family(tph::queue::graphics);
+
+    tph::cmd::pipeline_barrier(buffer.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::bottom_of_pipe, tph::dependency_flags::none, {}, {}, std::span{&release, 1});
+
+    tph::texture_memory_barrier acquire{release};
+    acquire.source_access = tph::resource_access::none;
+    acquire.destination_access = barrier.destination_access;
+
+    m_texture_acquires.emplace_back(texture_acquire{acquire});
+}
+
+void memory_transfer_scheduler::submit_streaming_transfers()
+{
+    if(!m_streaming) //Regular transfers are submitted by submit_transfers
+    {
+        return;
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    const auto it{std::find_if(std::begin(m_streaming_buffers), std::end(m_streaming_buffers), [](const streaming_buffer& buffer)
+    {
+        return buffer.begin;
+    })};
+
+    if(it == std::end(m_streaming_buffers))
+    {
+        return;
+    }
+
+    auto& buffer{*it};
+
+    if constexpr(debug_enabled)
+    {
+        tph::cmd::end_label(buffer.buffer);
+    }
+
+    tph::cmd::end(buffer.buffer);
+
+    buffer.begin = false;
+    buffer.submitted = true;
+    buffer.value = ++m_streaming_value;
+
+    for(auto& acquire : m_buffer_acquires)
+    {
+        if(acquire.value == 0)
+        {
+            acquire.value = buffer.value;
+        }
+    }
+
+    for(auto& acquire : m_texture_acquires)
+    {
+        if(acquire.value == 0)
+        {
+            acquire.value = buffer.value;
+        }
+    }
+
+    tph::submit_info info{};
+    info.command_buffers.emplace_back(buffer.buffer);
+    info.signal_semaphores.emplace_back(m_streaming_timeline);
+    info.signal_values.emplace_back(buffer.value);
+
     std::unique_lock queue_lock{engine::instance().submit_mutex()};
-    tph::submit(*m_renderer, info, buffer.fence);
-    queue_lock.unlock();
+    tph::submit(*m_renderer, tph::queue::transfer, info, tph::nullref);
 }
 
 memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::next_buffer()
 {
     for(auto& buffer : m_buffers)
     {
-        if(buffer.fence.try_wait())
+        if(buffer.waiters == 0 && is_complete(buffer))
         {
             reset_buffer(buffer);
 
@@ -136,12 +447,20 @@ memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::add_buffe
 {
     transfer_buffer data{};
     data.buffer = tph::cmd::begin(m_pool, tph::command_buffer_level::primary, tph::command_buffer_options::one_time_submit);
-    data.fence  = tph::fence{*m_renderer, true};
+
+    if(!m_timeline)
+    {
+        data.fence = tph::fence{*m_renderer, true};
+    }
 
     if constexpr(debug_enabled)
     {
         tph::set_object_name(*m_renderer, data.buffer, "cpt::engine's primary transfer buffer #" + std::to_string(std::size(m_buffers)));
-        tph::set_object_name(*m_renderer, data.fence, "cpt::engine's transfer fence #" + std::to_string(std::size(m_buffers)));
+
+        if(!m_timeline)
+        {
+            tph::set_object_name(*m_renderer, data.fence, "cpt::engine's transfer fence #" + std::to_string(std::size(m_buffers)));
+        }
     }
 
     return m_buffers.emplace_back(std::move(data));
@@ -149,25 +468,215 @@ memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::add_buffe
 
 std::size_t memory_transfer_scheduler::buffer_index(const transfer_buffer& buffer) const noexcept
 {
-    return static_cast<std::size_t>(std::distance(std::data(m_buffers), &buffer));
+    const auto it{std::find_if(std::begin(m_buffers), std::end(m_buffers), [&buffer](const transfer_buffer& other)
+    {
+        return &other == &buffer;
+    })};
+
+    return static_cast<std::size_t>(std::distance(std::begin(m_buffers), it));
+}
+
+bool memory_transfer_scheduler::is_complete(const transfer_buffer& buffer) const
+{
+    if(m_timeline)
+    {
+        return m_graphics_timeline.try_wait(buffer.value);
+    }
+
+    return buffer.fence.try_wait();
+}
+
+void memory_transfer_scheduler::wait(const transfer_buffer& buffer, std::uint64_t value) const
+{
+    if(m_timeline)
+    {
+        m_graphics_timeline.wait(value);
+    }
+    else
+    {
+        buffer.fence.wait();
+    }
+}
+
+std::optional<std::uint64_t> memory_transfer_scheduler::allocate_staging(std::uint64_t size, std::uint64_t alignment) noexcept
+{
+    //Classic ring: head == tail means empty, so the head never catches up the tail from behind
+    const std::uint64_t capacity{m_staging.size()};
+    const std::uint64_t offset{align_up(m_staging_head, alignment)};
+
+    if(m_staging_head >= m_staging_tail) //free space is [head; capacity[ and [0; tail[
+    {
+        if(offset <= capacity && capacity - offset >= size)
+        {
+            m_staging_head = offset + size;
+
+            return std::make_optional(offset);
+        }
+
+        if(size < m_staging_tail)
+        {
+            m_staging_head = size;
+
+            return std::make_optional(std::uint64_t{0});
+        }
+    }
+    else if(offset < m_staging_tail && m_staging_tail - offset > size) //free space is [head; tail[
+    {
+        m_staging_head = offset + size;
+
+        return std::make_optional(offset);
+    }
+
+    return std::nullopt;
+}
+
+void memory_transfer_scheduler::reclaim_staging()
+{
+    while(!std::empty(m_staging_batches) && is_complete(m_buffers[m_staging_batches.front().buffer]))
+    {
+        const auto& batch{m_staging_batches.front()};
+
+        m_staging_tail = batch.head;
+
+        while(!std::empty(m_staging_overflows) && m_staging_overflows.front().batch <= batch.id)
+        {
+            m_staging_overflows.pop_front();
+        }
+
+        m_staging_batches.pop_front();
+    }
+
+    //Nothing in flight: restart from the beginning to maximise contiguous space
+    if(std::empty(m_staging_batches) && m_staging_head == m_staging_tail)
+    {
+        m_staging_head = 0;
+        m_staging_tail = 0;
+    }
 }
 
 void memory_transfer_scheduler::reset_buffer(transfer_buffer& buffer)
 {
-    const std::size_t index{buffer_index(buffer)};
+    release_thread_buffers(buffer_index(buffer));
+
+    tph::cmd::begin(buffer.buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
+}
+
+void memory_transfer_scheduler::release_completed()
+{
+    for(auto& buffer : m_buffers)
+    {
+        if(is_complete(buffer))
+        {
+            release_thread_buffers(buffer_index(buffer));
+        }
+    }
+}
 
+void memory_transfer_scheduler::release_thread_buffers(std::size_t parent)
+{
     for(auto&& [thread, pool] : m_thread_pools)
     {
         for(auto&& buffer : pool.buffers)
         {
-            if(buffer.parent == index)
+            if(buffer.parent == parent)
             {
                 reset_thread_buffer(buffer);
             }
         }
     }
 
-    tph::cmd::begin(buffer.buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
+    for(auto& buffer : m_streaming_buffers)
+    {
+        if(buffer.parent == parent)
+        {
+            buffer.keeper.clear();
+            buffer.staging.clear();
+            buffer.parent = no_parent;
+            buffer.submitted = false;
+        }
+    }
+}
+
+std::uint64_t memory_transfer_scheduler::record_acquires(tph::command_buffer& buffer, std::uint64_t completed)
+{
+    const auto is_ready = [completed](const auto& acquire)
+    {
+        return acquire.value != 0 && acquire.value <= completed;
+    };
+
+    std::uint64_t wait_value{};
+
+    auto buffer_barriers{make_frame_vector<tph::buffer_memory_barrier>()};
+    for(auto&& acquire : m_buffer_acquires)
+    {
+        if(is_ready(acquire))
+        {
+            buffer_barriers.emplace_back(acquire.barrier);
+            wait_value = std::max(wait_value, acquire.value);
+        }
+    }
+
+    auto texture_barriers{make_frame_vector<tph::texture_memory_barrier>()};
+    for(auto&& acquire : m_texture_acquires)
+    {
+        if(is_ready(acquire))
+        {
+            texture_barriers.emplace_back(acquire.barrier);
+            wait_value = std::max(wait_value, acquire.value);
+        }
+    }
+
+    if(wait_value != 0)
+    {
+        tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::all_commands, tph::pipeline_stage::all_commands, tph::dependency_flags::none, {}, buffer_barriers, texture_barriers);
+
+        std::erase_if(m_buffer_acquires, is_ready);
+        std::erase_if(m_texture_acquires, is_ready);
+    }
+
+    return wait_value;
+}
+
+memory_transfer_scheduler::streaming_buffer& memory_transfer_scheduler::next_streaming_buffer()
+{
+    for(auto& buffer : m_streaming_buffers)
+    {
+        if(buffer.begin)
+        {
+            return buffer;
+        }
+    }
+
+    for(auto& buffer : m_streaming_buffers)
+    {
+        if(!buffer.submitted)
+        {
+            tph::cmd::begin(buffer.buffer, tph::command_buffer_reset_options::none, tph::command_buffer_options::one_time_submit);
+
+            if constexpr(debug_enabled)
+            {
+                tph::cmd::begin_label(buffer.buffer, "cpt::engine's streaming transfer", 1.0f, 0.843f, 0.0f, 1.0f);
+            }
+
+            buffer.begin = true;
+
+            return buffer;
+        }
+    }
+
+    streaming_buffer data{};
+    data.buffer = tph::cmd::begin(m_streaming_pool, tph::command_buffer_level::primary, tph::command_buffer_options::one_time_submit);
+    data.keeper.reserve(512);
+
+    if constexpr(debug_enabled)
+    {
+        tph::set_object_name(*m_renderer, data.buffer, "cpt::engine's streaming transfer buffer #" + std::to_string(std::size(m_streaming_buffers)));
+        tph::cmd::begin_label(data.buffer, "cpt::engine's streaming transfer", 1.0f, 0.843f, 0.0f, 1.0f);
+    }
+
+    data.begin = true;
+
+    return m_streaming_buffers.emplace_back(std::move(data));
 }
 
 void memory_transfer_scheduler::reset_thread_buffer(thread_transfer_buffer& data)
@@ -178,9 +687,9 @@ void memory_transfer_scheduler::reset_thread_buffer(thread_transfer_buffer& data
     data.parent = no_parent;
 }
 
-std::vector<std::reference_wrapper<tph::command_buffer>> memory_transfer_scheduler::secondary_buffers(std::size_t parent)
+frame_vector<std::reference_wrapper<tph::command_buffer>> memory_transfer_scheduler::secondary_buffers(std::size_t parent)
 {
-    std::vector<std::reference_wrapper<tph::command_buffer>> output{};
+    auto output{make_frame_vector<std::reference_wrapper<tph::command_buffer>>()};
     output.reserve(std::size(m_thread_pools));
 
     for(auto&& pool : m_thread_pools)
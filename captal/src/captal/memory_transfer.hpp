@@ -26,9 +26,14 @@
 #include "config.hpp"
 
 #include <unordered_map>
+#include <deque>
+#include <optional>
 #include <future>
 
+#include <captal_foundation/frame_arena.hpp>
+
 #include <tephra/renderer.hpp>
+#include <tephra/buffer.hpp>
 #include <tephra/commands.hpp>
 #include <tephra/synchronization.hpp>
 
@@ -38,7 +43,7 @@
 namespace cpt
 {
 
-using transfer_ended_signal = cpt::signal<>;
+using transfer_ended_signal = cpt::signal_st<>;
 
 struct memory_transfer_info
 {
@@ -47,12 +52,32 @@ struct memory_transfer_info
     asynchronous_resource_keeper& keeper;
 };
 
+struct staging_allocation
+{
+    tph::buffer& buffer;
+    std::uint64_t offset{};
+    std::uint64_t size{};
+    void* data{};
+};
+
+struct staging_ring_statistics
+{
+    std::uint64_t capacity{}; //Size of the staging ring
+    std::uint64_t in_use{}; //Bytes of the ring still owned by in-flight transfers
+    std::uint64_t bytes_staged{}; //Total bytes requested since the scheduler creation
+    std::uint64_t stalls{}; //Number of allocations that had to wait for the GPU
+    std::uint64_t overflows{}; //Number of allocations that did not fit in the ring and got their own buffer
+};
+
 class CAPTAL_API memory_transfer_scheduler
 {
     static constexpr std::size_t no_parent{std::numeric_limits<std::size_t>::max()};
 
 public:
-    explicit memory_transfer_scheduler(tph::renderer& renderer) noexcept;
+    static constexpr std::uint64_t default_staging_size{16 * 1024 * 1024};
+
+public:
+    explicit memory_transfer_scheduler(tph::renderer& renderer, std::uint64_t staging_size = default_staging_size);
     ~memory_transfer_scheduler();
     memory_transfer_scheduler(const memory_transfer_scheduler&) = delete;
     memory_transfer_scheduler& operator=(const memory_transfer_scheduler&) = delete;
@@ -64,6 +89,28 @@ public:
     void submit_transfers();
     std::size_t clean_threads();
 
+    //Sub-allocates host-visible memory from the staging ring, the memory is owned by the next submitted transfer batch.
+    //Must be called between begin_transfer and submit_transfers, the allocation can not be used by streaming transfers.
+    staging_allocation stage(std::uint64_t size, std::uint64_t alignment = 16);
+    staging_ring_statistics staging_statistics() const;
+
+    //Streaming transfers are recorded on the dedicated transfer queue, if any, and run concurrently with rendering.
+    //Resources written by a streaming transfer must be handed to the graphics queue with transfer_ownership before the submission,
+    //the barrier's source values describe the transfer side, its destination values describe the graphics side.
+    //The signal of a streaming transfer is called once the acquires have been recorded, the resources can then be used by the graphics queue.
+    //Without a dedicated transfer queue or timeline semaphores, streaming transfers are regular transfers.
+    memory_transfer_info begin_streaming_transfer();
+    //Host-visible memory owned by the current streaming transfer, it is released once the transfer has been executed.
+    staging_allocation stage_streaming(std::uint64_t size);
+    void transfer_ownership(const tph::buffer_memory_barrier& barrier);
+    void transfer_ownership(const tph::texture_memory_barrier& barrier);
+    void submit_streaming_transfers();
+
+    bool has_streaming_queue() const noexcept
+    {
+        return m_streaming;
+    }
+
 private:
     struct thread_transfer_buffer
     {
@@ -85,16 +132,63 @@ private:
     struct transfer_buffer
     {
         tph::command_buffer buffer{};
-        tph::fence fence{};
+        tph::fence fence{}; //Only used without timeline semaphores
+        std::uint64_t value{}; //Timeline value signaled once the buffer has been executed
+        std::uint32_t waiters{}; //Threads waiting on the fence outside of the lock, the buffer can not be reused until they are done
+    };
+
+    struct streaming_buffer
+    {
+        tph::command_buffer buffer{};
+        transfer_ended_signal signal{};
+        asynchronous_resource_keeper keeper{};
+        std::deque<tph::buffer> staging{}; //deque: allocations keep references to the buffers
+        std::uint64_t value{};
+        std::size_t parent{no_parent}; //Transfer buffer acquiring the resources, they are kept until it has been executed
+        bool begin{};
+        bool submitted{};
+    };
+
+    struct staging_batch
+    {
+        std::size_t buffer{};
+        std::uint64_t head{};
+        std::uint64_t id{};
+    };
+
+    struct staging_overflow
+    {
+        std::uint64_t batch{};
+        tph::buffer buffer{};
+    };
+
+    struct buffer_acquire
+    {
+        tph::buffer_memory_barrier barrier;
+        std::uint64_t value{};
+    };
+
+    struct texture_acquire
+    {
+        tph::texture_memory_barrier barrier;
+        std::uint64_t value{};
     };
 
 private:
     transfer_buffer& next_buffer();
     transfer_buffer& add_buffer();
     std::size_t buffer_index(const transfer_buffer& buffer) const noexcept;
+    bool is_complete(const transfer_buffer& buffer) const;
+    void wait(const transfer_buffer& buffer, std::uint64_t value) const;
+    std::optional<std::uint64_t> allocate_staging(std::uint64_t size, std::uint64_t alignment) noexcept;
+    void reclaim_staging();
     void reset_buffer(transfer_buffer& buffer);
+    void release_completed();
+    void release_thread_buffers(std::size_t parent);
+    std::uint64_t record_acquires(tph::command_buffer& buffer, std::uint64_t completed);
+    streaming_buffer& next_streaming_buffer();
     void reset_thread_buffer(thread_transfer_buffer& data);
-    std::vector<std::reference_wrapper<tph::command_buffer>> secondary_buffers(std::size_t parent);
+    frame_vector<std::reference_wrapper<tph::command_buffer>> secondary_buffers(std::size_t parent);
 
     thread_transfer_pool& get_transfer_pool(std::thread::id thread);
     thread_transfer_buffer& next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread);
@@ -104,9 +198,28 @@ private:
     tph::renderer* m_renderer{};
     std::unordered_map<std::thread::id, thread_transfer_pool> m_thread_pools{};
     tph::command_pool m_pool{};
-    std::vector<transfer_buffer> m_buffers{};
-    std::mutex m_mutex{};
+    std::deque<transfer_buffer> m_buffers{}; //References stay valid while another thread adds buffers, see stage
+    mutable std::mutex m_mutex{};
     bool m_begin{};
+    bool m_timeline{};
+    tph::semaphore m_graphics_timeline{};
+    std::uint64_t m_graphics_value{};
+    bool m_streaming{};
+    tph::command_pool m_streaming_pool{};
+    std::vector<streaming_buffer> m_streaming_buffers{};
+    tph::semaphore m_streaming_timeline{};
+    std::uint64_t m_streaming_value{};
+    std::vector<buffer_acquire> m_buffer_acquires{};
+    std::vector<texture_acquire> m_texture_acquires{};
+
+    tph::buffer m_staging{};
+    std::uint8_t* m_staging_map{};
+    std::uint64_t m_staging_head{};
+    std::uint64_t m_staging_tail{};
+    std::uint64_t m_batch_id{};
+    std::deque<staging_batch> m_staging_batches{};
+    std::deque<staging_overflow> m_staging_overflows{}; //deque: allocations keep references to the buffers
+    staging_ring_statistics m_staging_statistics{};
 };
 
 }
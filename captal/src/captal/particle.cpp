@@ -0,0 +1,711 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "particle.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stop_token>
+#include <exception>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CAPTAL_PARTICLE_SSE2
+    #include <emmintrin.h>
+#endif
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+//A rotated quad of size s fits in a square of half extent s * sqrt(2) / 2
+static constexpr float bounds_factor{0.70710678f};
+
+static constexpr bounding_box empty_bounds
+{
+    vec2f{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+    vec2f{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()}
+};
+
+namespace impl
+{
+
+//Persistent threads used by particle_system::parallel_for, so updates and uploads don't spawn threads every frame
+class particle_workers
+{
+public:
+    using job_type = void(*)(const void* data, std::uint32_t index);
+
+public:
+    explicit particle_workers(std::uint32_t count)
+    {
+        m_threads.reserve(count);
+
+        for(std::uint32_t i{}; i < count; ++i)
+        {
+            m_threads.emplace_back([this, i](std::stop_token token)
+            {
+                work(token, i + 1);
+            });
+        }
+    }
+
+    //Threads are stopped and joined by their destructor
+    ~particle_workers() = default;
+    particle_workers(const particle_workers&) = delete;
+    particle_workers& operator=(const particle_workers&) = delete;
+    particle_workers(particle_workers&&) noexcept = delete;
+    particle_workers& operator=(particle_workers&&) noexcept = delete;
+
+    //Calls job(data, index) for each index in [0, count), index 0 on the calling thread, and waits for all of them.
+    //job must not throw.
+    void run(std::uint32_t count, job_type job, const void* data)
+    {
+        assert(count <= size() + 1 && "cpt::impl::particle_workers::run called with too many jobs.");
+
+        {
+            std::lock_guard lock{m_mutex};
+
+            m_job = job;
+            m_data = data;
+            m_count = count;
+            m_pending = count - 1;
+            ++m_generation;
+        }
+
+        m_condition.notify_all();
+
+        job(data, 0);
+
+        std::unique_lock lock{m_mutex};
+        m_done.wait(lock, [this]()
+        {
+            return m_pending == 0;
+        });
+    }
+
+    std::uint32_t size() const noexcept
+    {
+        return static_cast<std::uint32_t>(std::size(m_threads));
+    }
+
+private:
+    void work(std::stop_token token, std::uint32_t index)
+    {
+        std::uint64_t generation{};
+
+        std::unique_lock lock{m_mutex};
+
+        while(m_condition.wait(lock, token, [this, &generation]() { return m_generation != generation; }))
+        {
+            generation = m_generation;
+
+            //Workers that are not needed by this run just skip it
+            if(index >= m_count)
+            {
+                continue;
+            }
+
+            const auto job {m_job};
+            const auto data{m_data};
+
+            lock.unlock();
+            job(data, index);
+            lock.lock();
+
+            if(--m_pending == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+
+private:
+    std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    std::condition_variable m_done{};
+    job_type m_job{};
+    const void* m_data{};
+    std::uint32_t m_count{};
+    std::uint32_t m_pending{};
+    std::uint64_t m_generation{};
+    std::vector<std::jthread> m_threads{}; //Last, so the threads are joined before the rest is destroyed
+};
+
+}
+
+particle_system::particle_system(std::uint32_t capacity, std::uint32_t thread_count)
+:basic_renderable{4, 6, 0, vertex_layout::particle}
+,m_capacity{capacity}
+,m_instances{make_storage_buffer(capacity * sizeof(particle_instance), tph::buffer_usage::vertex | tph::buffer_usage::transfer_destination)}
+{
+    assert(capacity > 0 && "cpt::particle_system created with a capacity of 0.");
+
+    for(auto&& values : m_attributes)
+    {
+        values.resize(capacity);
+    }
+
+    set_thread_count(thread_count);
+
+    //Unit quad centered on the particle, scaled by its size in the vertex shader
+    set_vertices(std::array<vertex, 4>
+    {
+        vertex{vec3f{-0.5f, -0.5f, 0.0f}, vec4f{1.0f}, vec2f{0.0f, 0.0f}},
+        vertex{vec3f{ 0.5f, -0.5f, 0.0f}, vec4f{1.0f}, vec2f{1.0f, 0.0f}},
+        vertex{vec3f{ 0.5f,  0.5f, 0.0f}, vec4f{1.0f}, vec2f{1.0f, 1.0f}},
+        vertex{vec3f{-0.5f,  0.5f, 0.0f}, vec4f{1.0f}, vec2f{0.0f, 1.0f}},
+    });
+
+    set_indices(std::array<std::uint32_t, 6>{0, 1, 2, 2, 3, 0});
+}
+
+particle_system::particle_system(std::uint32_t capacity, texture_ptr texture, std::uint32_t thread_count)
+:particle_system{capacity, thread_count}
+{
+    set_texture(std::move(texture));
+}
+
+particle_system::~particle_system() = default;
+particle_system::particle_system(particle_system&&) noexcept = default;
+particle_system& particle_system::operator=(particle_system&&) noexcept = default;
+
+void particle_system::update(float time)
+{
+    for(auto&& data : m_emitters)
+    {
+        if(data.emitter.rate > 0.0f)
+        {
+            data.accumulator += data.emitter.rate * time;
+
+            const auto count{static_cast<std::uint32_t>(data.accumulator)};
+            data.accumulator -= static_cast<float>(count);
+
+            spawn(data.emitter, count);
+        }
+    }
+
+    std::vector<bounding_box> bounds{};
+    bounds.resize(m_thread_count, empty_bounds);
+
+    parallel_for(m_count, [this, time, &bounds](std::uint32_t begin, std::uint32_t end, std::uint32_t thread_index)
+    {
+        integrate(begin, end, time, bounds[thread_index]);
+
+        for(auto&& affector : m_affectors)
+        {
+            affector(range(begin, end), time);
+        }
+    });
+
+    remove_dead();
+
+    m_bounds = empty_bounds;
+
+    for(auto&& range_bounds : bounds)
+    {
+        m_bounds.top_left     = vec2f{std::min(m_bounds.top_left.x(), range_bounds.top_left.x()), std::min(m_bounds.top_left.y(), range_bounds.top_left.y())};
+        m_bounds.bottom_right = vec2f{std::max(m_bounds.bottom_right.x(), range_bounds.bottom_right.x()), std::max(m_bounds.bottom_right.y(), range_bounds.bottom_right.y())};
+    }
+
+    if(m_count == 0)
+    {
+        m_bounds = bounding_box{};
+    }
+
+    m_uploaded = false;
+}
+
+void particle_system::bind(frame_render_info info, cpt::view& view)
+{
+    basic_renderable::bind(info, view);
+
+    tph::cmd::bind_vertex_buffer(info.buffer, 1, m_instances->get_buffer(), 0);
+
+    info.keeper.keep(m_instances);
+}
+
+void particle_system::draw(frame_render_info info)
+{
+    if(m_instance_count > 0)
+    {
+        tph::cmd::draw_indexed(info.buffer, 6, m_instance_count, 0, 0, 0);
+    }
+}
+
+void particle_system::draw(frame_render_info info, cpt::view& view)
+{
+    bind(info, view);
+    draw(info);
+}
+
+void particle_system::upload(memory_transfer_info info)
+{
+    basic_renderable::upload(info);
+
+    if(std::exchange(m_uploaded, true))
+    {
+        return;
+    }
+
+    m_instance_count = m_count;
+
+    if(m_instance_count == 0)
+    {
+        return;
+    }
+
+    //Particles are packed straight into the staging memory
+    const std::uint64_t size{m_instance_count * sizeof(particle_instance)};
+    const auto staging{engine::instance().transfer_scheduler().stage(size)};
+
+    pack(std::span{reinterpret_cast<particle_instance*>(staging.data), m_instance_count});
+
+    tph::cmd::copy(info.buffer, staging.buffer, m_instances->get_buffer(), tph::buffer_copy{staging.offset, 0, size});
+
+    tph::buffer_memory_barrier barrier{m_instances->get_buffer()};
+    barrier.size = size;
+    barrier.source_access = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::vertex_attribute;
+
+    tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::vertex_input, tph::dependency_flags::none, {}, std::span{&barrier, 1}, {});
+
+    info.keeper.keep(m_instances);
+}
+
+std::size_t particle_system::add_emitter(const particle_emitter& emitter)
+{
+    m_emitters.emplace_back(emitter_data{emitter});
+
+    return std::size(m_emitters) - 1;
+}
+
+void particle_system::clear_emitters() noexcept
+{
+    m_emitters.clear();
+}
+
+void particle_system::emit(const particle_emitter& emitter, std::uint32_t count)
+{
+    spawn(emitter, count);
+}
+
+void particle_system::add_affector(particle_affector affector)
+{
+    m_affectors.emplace_back(std::move(affector));
+}
+
+void particle_system::clear_affectors() noexcept
+{
+    m_affectors.clear();
+}
+
+void particle_system::clear() noexcept
+{
+    m_count = 0;
+    m_bounds = bounding_box{};
+    m_uploaded = false;
+}
+
+void particle_system::set_thread_count(std::uint32_t thread_count) noexcept
+{
+    m_thread_count = thread_count == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : thread_count;
+
+    if(m_workers && m_workers->size() != m_thread_count - 1)
+    {
+        m_workers.reset();
+    }
+}
+
+void particle_system::set_texture(texture_ptr texture)
+{
+    set_binding(1, std::move(texture));
+}
+
+void particle_system::set_texture(const texture_region& region)
+{
+    const auto width {static_cast<float>(region.texture->width())};
+    const auto height{static_cast<float>(region.texture->height())};
+
+    set_relative_texture_coords(region.x / width, region.y / height, (region.x + region.width) / width, (region.y + region.height) / height);
+    set_texture(region.texture);
+}
+
+void particle_system::set_relative_texture_coords(float x1, float y1, float x2, float y2) noexcept
+{
+    const auto quad{vertices()};
+
+    quad[0].texture_coord = vec2f{x1, y1};
+    quad[1].texture_coord = vec2f{x2, y1};
+    quad[2].texture_coord = vec2f{x2, y2};
+    quad[3].texture_coord = vec2f{x1, y2};
+}
+
+void particle_system::pack(std::span<particle_instance> output) const
+{
+    assert(std::size(output) >= m_count && "cpt::particle_system::pack called with a too small output.");
+
+    parallel_for(m_count, [this, output](std::uint32_t begin, std::uint32_t end, std::uint32_t)
+    {
+        pack_range(begin, end, std::data(output));
+    });
+}
+
+void particle_system::copy_attributes(std::span<float> output) const
+{
+    assert(std::size(output) >= attribute_count * m_capacity && "cpt::particle_system::copy_attributes called with a too small output.");
+
+    for(std::size_t i{}; i < attribute_count; ++i)
+    {
+        std::copy_n(std::data(m_attributes[i]), m_count, std::data(output) + i * m_capacity);
+    }
+}
+
+bounding_box particle_system::global_bounds() const noexcept
+{
+    const auto model{cpt::model(position(), rotation(), vec3f{0.0f, 0.0f, 1.0f}, scale(), origin())};
+
+    const std::array corners
+    {
+        model * vec4f{m_bounds.top_left.x(),     m_bounds.top_left.y(),     0.0f, 1.0f},
+        model * vec4f{m_bounds.bottom_right.x(), m_bounds.top_left.y(),     0.0f, 1.0f},
+        model * vec4f{m_bounds.bottom_right.x(), m_bounds.bottom_right.y(), 0.0f, 1.0f},
+        model * vec4f{m_bounds.top_left.x(),     m_bounds.bottom_right.y(), 0.0f, 1.0f},
+    };
+
+    return make_bounding_box(std::begin(corners), std::end(corners));
+}
+
+template<typename Function>
+void particle_system::parallel_for(std::uint32_t count, Function&& function) const
+{
+    const std::uint32_t thread_count{std::clamp(count / min_range_size, 1u, m_thread_count)};
+
+    if(thread_count == 1)
+    {
+        function(0, count, 0);
+
+        return;
+    }
+
+    //Keep ranges a multiple of 4 particles so only the last one has a scalar tail
+    const std::uint32_t range_size{(((count + thread_count - 1) / thread_count) + 3) & ~3u};
+
+    std::vector<std::exception_ptr> errors{};
+    errors.resize(thread_count);
+
+    const auto worker = [&](std::uint32_t thread_index)
+    {
+        try
+        {
+            const std::uint32_t begin{std::min(thread_index * range_size, count)};
+            const std::uint32_t end  {std::min(begin + range_size, count)};
+
+            function(begin, end, thread_index);
+        }
+        catch(...)
+        {
+            errors[thread_index] = std::current_exception();
+        }
+    };
+
+    if(!m_workers)
+    {
+        m_workers = std::make_unique<impl::particle_workers>(m_thread_count - 1);
+    }
+
+    m_workers->run(thread_count, [](const void* data, std::uint32_t index)
+    {
+        (*static_cast<const decltype(worker)*>(data))(index);
+    }, &worker);
+
+    for(auto&& error : errors)
+    {
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+particle_range particle_system::range(std::uint32_t begin, std::uint32_t end) noexcept
+{
+    return particle_range
+    {
+        static_cast<std::size_t>(end - begin),
+        data(attribute::x) + begin,
+        data(attribute::y) + begin,
+        data(attribute::velocity_x) + begin,
+        data(attribute::velocity_y) + begin,
+        data(attribute::rotation) + begin,
+        data(attribute::spin) + begin,
+        data(attribute::size) + begin,
+        data(attribute::red) + begin,
+        data(attribute::green) + begin,
+        data(attribute::blue) + begin,
+        data(attribute::alpha) + begin,
+        data(attribute::life) + begin,
+    };
+}
+
+void particle_system::spawn(const particle_emitter& emitter, std::uint32_t count)
+{
+    count = std::min(count, m_capacity - m_count);
+
+    std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+
+    const auto random = [this, &distribution](float min, float max)
+    {
+        return std::lerp(min, max, distribution(m_random));
+    };
+
+    const auto start_color{static_cast<vec4f>(emitter.start_color)};
+    const auto end_color  {static_cast<vec4f>(emitter.end_color)};
+
+    for(std::uint32_t i{m_count}; i < m_count + count; ++i)
+    {
+        const float angle   {random(emitter.min_angle, emitter.max_angle)};
+        const float speed   {random(emitter.min_speed, emitter.max_speed)};
+        const float lifetime{std::max(random(emitter.min_lifetime, emitter.max_lifetime), std::numeric_limits<float>::epsilon())};
+
+        data(attribute::x)[i] = emitter.position.x() + random(-emitter.extent.x(), emitter.extent.x());
+        data(attribute::y)[i] = emitter.position.y() + random(-emitter.extent.y(), emitter.extent.y());
+        data(attribute::velocity_x)[i] = std::cos(angle) * speed;
+        data(attribute::velocity_y)[i] = std::sin(angle) * speed;
+        data(attribute::rotation)[i] = random(emitter.min_rotation, emitter.max_rotation);
+        data(attribute::spin)[i] = random(emitter.min_spin, emitter.max_spin);
+        data(attribute::size)[i] = emitter.start_size;
+        data(attribute::size_delta)[i] = (emitter.end_size - emitter.start_size) / lifetime;
+        data(attribute::red)[i] = start_color.x();
+        data(attribute::green)[i] = start_color.y();
+        data(attribute::blue)[i] = start_color.z();
+        data(attribute::alpha)[i] = start_color.w();
+        data(attribute::red_delta)[i] = (end_color.x() - start_color.x()) / lifetime;
+        data(attribute::green_delta)[i] = (end_color.y() - start_color.y()) / lifetime;
+        data(attribute::blue_delta)[i] = (end_color.z() - start_color.z()) / lifetime;
+        data(attribute::alpha_delta)[i] = (end_color.w() - start_color.w()) / lifetime;
+        data(attribute::life)[i] = lifetime;
+    }
+
+    m_count += count;
+}
+
+void particle_system::integrate(std::uint32_t begin, std::uint32_t end, float time, bounding_box& bounds) noexcept
+{
+    float* const x          {data(attribute::x)};
+    float* const y          {data(attribute::y)};
+    float* const velocity_x {data(attribute::velocity_x)};
+    float* const velocity_y {data(attribute::velocity_y)};
+    float* const rotation   {data(attribute::rotation)};
+    float* const spin       {data(attribute::spin)};
+    float* const size       {data(attribute::size)};
+    float* const size_delta {data(attribute::size_delta)};
+    float* const life       {data(attribute::life)};
+
+    //Colors and their rates of change are adjacent attributes
+    std::array<float*, 4> colors{data(attribute::red), data(attribute::green), data(attribute::blue), data(attribute::alpha)};
+    std::array<float*, 4> color_deltas{data(attribute::red_delta), data(attribute::green_delta), data(attribute::blue_delta), data(attribute::alpha_delta)};
+
+    const float damping  {std::max(1.0f - m_drag * time, 0.0f)};
+    const float gravity_x{m_gravity.x() * time};
+    const float gravity_y{m_gravity.y() * time};
+
+    float min_x{bounds.top_left.x()};
+    float min_y{bounds.top_left.y()};
+    float max_x{bounds.bottom_right.x()};
+    float max_y{bounds.bottom_right.y()};
+
+    std::uint32_t i{begin};
+
+#if defined(CAPTAL_PARTICLE_SSE2)
+    const __m128 time4     {_mm_set1_ps(time)};
+    const __m128 damping4  {_mm_set1_ps(damping)};
+    const __m128 gravity_x4{_mm_set1_ps(gravity_x)};
+    const __m128 gravity_y4{_mm_set1_ps(gravity_y)};
+    const __m128 factor4   {_mm_set1_ps(bounds_factor)};
+
+    __m128 min_x4{_mm_set1_ps(min_x)};
+    __m128 min_y4{_mm_set1_ps(min_y)};
+    __m128 max_x4{_mm_set1_ps(max_x)};
+    __m128 max_y4{_mm_set1_ps(max_y)};
+
+    for(; i + 4 <= end; i += 4)
+    {
+        const __m128 new_velocity_x{_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocity_x + i), gravity_x4), damping4)};
+        const __m128 new_velocity_y{_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocity_y + i), gravity_y4), damping4)};
+        const __m128 new_x{_mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(new_velocity_x, time4))};
+        const __m128 new_y{_mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(new_velocity_y, time4))};
+        const __m128 new_size{_mm_add_ps(_mm_loadu_ps(size + i), _mm_mul_ps(_mm_loadu_ps(size_delta + i), time4))};
+
+        _mm_storeu_ps(velocity_x + i, new_velocity_x);
+        _mm_storeu_ps(velocity_y + i, new_velocity_y);
+        _mm_storeu_ps(x + i, new_x);
+        _mm_storeu_ps(y + i, new_y);
+        _mm_storeu_ps(size + i, new_size);
+        _mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(spin + i), time4)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), time4));
+
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            _mm_storeu_ps(colors[j] + i, _mm_add_ps(_mm_loadu_ps(colors[j] + i), _mm_mul_ps(_mm_loadu_ps(color_deltas[j] + i), time4)));
+        }
+
+        const __m128 extent{_mm_mul_ps(new_size, factor4)};
+
+        min_x4 = _mm_min_ps(min_x4, _mm_sub_ps(new_x, extent));
+        min_y4 = _mm_min_ps(min_y4, _mm_sub_ps(new_y, extent));
+        max_x4 = _mm_max_ps(max_x4, _mm_add_ps(new_x, extent));
+        max_y4 = _mm_max_ps(max_y4, _mm_add_ps(new_y, extent));
+    }
+
+    alignas(16) std::array<float, 4> lanes{};
+
+    const auto reduce = [&lanes](__m128 value, const auto& operation)
+    {
+        _mm_store_ps(std::data(lanes), value);
+
+        return operation(operation(lanes[0], lanes[1]), operation(lanes[2], lanes[3]));
+    };
+
+    const auto min = [](float left, float right){ return std::min(left, right); };
+    const auto max = [](float left, float right){ return std::max(left, right); };
+
+    min_x = reduce(min_x4, min);
+    min_y = reduce(min_y4, min);
+    max_x = reduce(max_x4, max);
+    max_y = reduce(max_y4, max);
+#endif
+
+    for(; i < end; ++i)
+    {
+        velocity_x[i] = (velocity_x[i] + gravity_x) * damping;
+        velocity_y[i] = (velocity_y[i] + gravity_y) * damping;
+        x[i] += velocity_x[i] * time;
+        y[i] += velocity_y[i] * time;
+        size[i] += size_delta[i] * time;
+        rotation[i] += spin[i] * time;
+        life[i] -= time;
+
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            colors[j][i] += color_deltas[j][i] * time;
+        }
+
+        const float extent{size[i] * bounds_factor};
+
+        min_x = std::min(min_x, x[i] - extent);
+        min_y = std::min(min_y, y[i] - extent);
+        max_x = std::max(max_x, x[i] + extent);
+        max_y = std::max(max_y, y[i] + extent);
+    }
+
+    bounds = bounding_box{vec2f{min_x, min_y}, vec2f{max_x, max_y}};
+}
+
+void particle_system::pack_range(std::uint32_t begin, std::uint32_t end, particle_instance* output) const noexcept
+{
+    const float* const x       {data(attribute::x)};
+    const float* const y       {data(attribute::y)};
+    const float* const rotation{data(attribute::rotation)};
+    const float* const size    {data(attribute::size)};
+    const float* const red     {data(attribute::red)};
+    const float* const green   {data(attribute::green)};
+    const float* const blue    {data(attribute::blue)};
+    const float* const alpha   {data(attribute::alpha)};
+
+    std::uint32_t i{begin};
+
+#if defined(CAPTAL_PARTICLE_SSE2)
+    //Colors are converted four particles at a time, each lane ends up as one RGBA8 value
+    const __m128 zero {_mm_setzero_ps()};
+    const __m128 one  {_mm_set1_ps(1.0f)};
+    const __m128 scale{_mm_set1_ps(255.0f)};
+
+    const auto convert = [&](const float* values)
+    {
+        return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(values), zero), one), scale));
+    };
+
+    alignas(16) std::array<std::uint32_t, 4> packed{};
+
+    for(; i + 4 <= end; i += 4)
+    {
+        const __m128i rg{_mm_or_si128(convert(red + i), _mm_slli_epi32(convert(green + i), 8))};
+        const __m128i ba{_mm_or_si128(_mm_slli_epi32(convert(blue + i), 16), _mm_slli_epi32(convert(alpha + i), 24))};
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(std::data(packed)), _mm_or_si128(rg, ba));
+
+        for(std::uint32_t j{}; j < 4; ++j)
+        {
+            auto& instance{output[i + j]};
+
+            instance.position = vec2f{x[i + j], y[i + j]};
+            instance.size = size[i + j];
+            instance.rotation = rotation[i + j];
+            std::memcpy(std::data(instance.color), &packed[j], sizeof(std::uint32_t));
+        }
+    }
+#endif
+
+    for(; i < end; ++i)
+    {
+        auto& instance{output[i]};
+
+        instance.position = vec2f{x[i], y[i]};
+        instance.size = size[i];
+        instance.rotation = rotation[i];
+        instance.color = std::array<std::uint8_t, 4>{pack_unorm8(red[i]), pack_unorm8(green[i]), pack_unorm8(blue[i]), pack_unorm8(alpha[i])};
+    }
+}
+
+void particle_system::remove_dead() noexcept
+{
+    const float* const life{data(attribute::life)};
+
+    //Dead particles are replaced by the last ones, order does not matter
+    std::uint32_t i{};
+    while(i < m_count)
+    {
+        if(life[i] <= 0.0f)
+        {
+            --m_count;
+
+            for(auto&& values : m_attributes)
+            {
+                values[i] = values[m_count];
+            }
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+}
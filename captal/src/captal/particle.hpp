@@ -0,0 +1,284 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_PARTICLE_HPP_INCLUDED
+#define CAPTAL_PARTICLE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <array>
+#include <span>
+#include <memory>
+#include <functional>
+#include <random>
+#include <numbers>
+
+#include "renderable.hpp"
+#include "storage_buffer.hpp"
+
+namespace cpt
+{
+
+//Initial state of the particles spawned by an emitter, each [min, max] range is sampled uniformly
+struct particle_emitter
+{
+    vec2f position{}; //Center of the spawn area, in the local space of the particle system
+    vec2f extent{}; //Half size of the spawn area
+    float rate{}; //Particles per second, 0 for emitters only used with particle_system::emit
+    float min_angle{}; //Direction of the initial velocity, in radians
+    float max_angle{std::numbers::pi_v<float> * 2.0f};
+    float min_speed{};
+    float max_speed{};
+    float min_lifetime{1.0f};
+    float max_lifetime{1.0f};
+    float min_rotation{};
+    float max_rotation{};
+    float min_spin{}; //Angular velocity, in radians per second
+    float max_spin{};
+    float start_size{1.0f}; //Size is interpolated from start_size to end_size over the lifetime of the particle
+    float end_size{1.0f};
+    color start_color{colors::white}; //Same for color
+    color end_color{colors::white};
+};
+
+//Structure-of-arrays view on a contiguous range of particles, given to affectors
+struct particle_range
+{
+    std::size_t count{};
+    float* x{};
+    float* y{};
+    float* velocity_x{};
+    float* velocity_y{};
+    float* rotation{};
+    float* spin{};
+    float* size{};
+    float* red{};
+    float* green{};
+    float* blue{};
+    float* alpha{};
+    float* life{}; //Remaining lifetime in seconds, particles are removed once it reaches 0
+};
+
+//Called once per range after the built-in integration, with the elapsed time. May run on several threads at once.
+using particle_affector = std::function<void(const particle_range& particles, float time)>;
+
+namespace impl
+{
+
+class particle_workers;
+
+}
+
+//Draws all of its particles with a single instanced draw of a textured quad.
+//Views drawing it must use a render technique with vertex_layout::particle,
+//which uses engine::particle_vertex_shader() when no vertex shader is specified.
+class CAPTAL_API particle_system final : public basic_renderable
+{
+public:
+    particle_system() = default;
+    explicit particle_system(std::uint32_t capacity, std::uint32_t thread_count = 1);
+    explicit particle_system(std::uint32_t capacity, texture_ptr texture, std::uint32_t thread_count = 1);
+
+    ~particle_system();
+    particle_system(const particle_system&) = delete;
+    particle_system& operator=(const particle_system&) = delete;
+    particle_system(particle_system&&) noexcept;
+    particle_system& operator=(particle_system&&) noexcept;
+
+    //Spawns the particles of the emitters, integrates, applies the affectors and removes dead particles
+    void update(float time);
+
+    void bind(frame_render_info info, cpt::view& view);
+    void draw(frame_render_info info);
+    void draw(frame_render_info info, cpt::view& view);
+    void upload(memory_transfer_info info);
+
+    //Writes the particles as they are uploaded to the instance buffer, output must hold size() instances
+    void pack(std::span<particle_instance> output) const;
+    //Writes the particles in the layout read by engine::particle_compute_shader(), attribute i of particle j is at i * capacity() + j.
+    //output must hold attribute_count * capacity() values
+    void copy_attributes(std::span<float> output) const;
+
+    std::size_t add_emitter(const particle_emitter& emitter);
+    void clear_emitters() noexcept;
+    //Spawns count particles at once, particles above capacity are dropped
+    void emit(const particle_emitter& emitter, std::uint32_t count);
+
+    void add_affector(particle_affector affector);
+    void clear_affectors() noexcept;
+    void clear() noexcept;
+
+    //Constant acceleration applied to every particle
+    void set_gravity(const vec2f& gravity) noexcept
+    {
+        m_gravity = gravity;
+    }
+
+    //Fraction of the velocity lost per second
+    void set_drag(float drag) noexcept
+    {
+        m_drag = drag;
+    }
+
+    //0 uses all hardware threads, ranges smaller than min_range_size are never split
+    void set_thread_count(std::uint32_t thread_count) noexcept;
+
+    void set_texture(texture_ptr texture);
+    void set_texture(const texture_region& region);
+    void set_relative_texture_coords(float x1, float y1, float x2, float y2) noexcept;
+
+    //Bounds of the particles after the last update
+    bounding_box local_bounds() const noexcept
+    {
+        return m_bounds;
+    }
+
+    bounding_box global_bounds() const noexcept;
+
+    particle_emitter& emitter(std::size_t index) noexcept
+    {
+        assert(index < std::size(m_emitters) && "cpt::particle_system::emitter called with out of bounds index.");
+
+        return m_emitters[index].emitter;
+    }
+
+    const particle_emitter& emitter(std::size_t index) const noexcept
+    {
+        assert(index < std::size(m_emitters) && "cpt::particle_system::emitter called with out of bounds index.");
+
+        return m_emitters[index].emitter;
+    }
+
+    std::size_t emitter_count() const noexcept
+    {
+        return std::size(m_emitters);
+    }
+
+    const vec2f& gravity() const noexcept
+    {
+        return m_gravity;
+    }
+
+    float drag() const noexcept
+    {
+        return m_drag;
+    }
+
+    std::uint32_t thread_count() const noexcept
+    {
+        return m_thread_count;
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::uint32_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    texture_ptr texture() const
+    {
+        return std::get<texture_ptr>(get_binding(1));
+    }
+
+    const storage_buffer_ptr& instance_buffer() const noexcept
+    {
+        return m_instances;
+    }
+
+public:
+    static constexpr std::uint32_t min_range_size{16384};
+    static constexpr std::size_t attribute_count{17};
+
+private:
+    enum class attribute : std::size_t
+    {
+        x,
+        y,
+        velocity_x,
+        velocity_y,
+        rotation,
+        spin,
+        size,
+        size_delta,
+        red,
+        green,
+        blue,
+        alpha,
+        red_delta,
+        green_delta,
+        blue_delta,
+        alpha_delta,
+        life,
+    };
+
+    struct emitter_data
+    {
+        particle_emitter emitter{};
+        float accumulator{}; //Fractional particles carried to the next update
+    };
+
+    //Runs function(begin, end, thread_index) on ranges of [0, count) split among the worker threads
+    template<typename Function>
+    void parallel_for(std::uint32_t count, Function&& function) const;
+
+    float* data(attribute value) noexcept
+    {
+        return std::data(m_attributes[static_cast<std::size_t>(value)]);
+    }
+
+    const float* data(attribute value) const noexcept
+    {
+        return std::data(m_attributes[static_cast<std::size_t>(value)]);
+    }
+
+    particle_range range(std::uint32_t begin, std::uint32_t end) noexcept;
+    void spawn(const particle_emitter& emitter, std::uint32_t count);
+    void integrate(std::uint32_t begin, std::uint32_t end, float time, bounding_box& bounds) noexcept;
+    //Writes the particles [begin, end) to output[begin, end)
+    void pack_range(std::uint32_t begin, std::uint32_t end, particle_instance* output) const noexcept;
+    void remove_dead() noexcept;
+
+private:
+    std::uint32_t m_capacity{};
+    std::uint32_t m_count{};
+    std::uint32_t m_instance_count{}; //Particles in the instance buffer, drawn until the next upload
+    std::uint32_t m_thread_count{1};
+    std::array<std::vector<float>, attribute_count> m_attributes{};
+    std::vector<emitter_data> m_emitters{};
+    std::vector<particle_affector> m_affectors{};
+    vec2f m_gravity{};
+    float m_drag{};
+    std::minstd_rand m_random{std::random_device{}()};
+    bounding_box m_bounds{};
+    storage_buffer_ptr m_instances{};
+    bool m_uploaded{true}; //Whether the instance buffer holds the particles of the last update
+    mutable std::unique_ptr<impl::particle_workers> m_workers{}; //Created on the first update that needs them, then kept alive
+};
+
+}
+
+#endif
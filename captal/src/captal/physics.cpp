@@ -254,6 +254,42 @@ std::vector<physical_world::ray_hit> physical_world::ray_query(vec2f from, vec2f
     return output;
 }
 
+std::pmr::vector<physical_world::point_hit> physical_world::point_query(vec2f point, float max_distance, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource)
+{
+    std::pmr::vector<point_hit> output{resource};
+
+    point_query(point, max_distance, group, id, mask, [&output](point_hit hit)
+    {
+        output.emplace_back(hit);
+    });
+
+    return output;
+}
+
+std::pmr::vector<physical_world::region_hit> physical_world::region_query(float x, float y, float width, float height, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource)
+{
+    std::pmr::vector<region_hit> output{resource};
+
+    region_query(x, y, width, height, group, id, mask, [&output](region_hit hit)
+    {
+        output.emplace_back(hit);
+    });
+
+    return output;
+}
+
+std::pmr::vector<physical_world::ray_hit> physical_world::ray_query(vec2f from, vec2f to, float thickness, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource)
+{
+    std::pmr::vector<ray_hit> output{resource};
+
+    ray_query(from, to, thickness, group, id, mask, [&output](ray_hit hit)
+    {
+        output.emplace_back(hit);
+    });
+
+    return output;
+}
+
 std::optional<physical_world::point_hit> physical_world::point_query_nearest(vec2f point, float max_distance, group_t group, collision_id_t id, collision_id_t mask)
 {
     const cpShapeFilter filter{cpShapeFilterNew(group, id, mask)};
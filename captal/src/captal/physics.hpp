@@ -31,9 +31,12 @@
 #include <variant>
 #include <span>
 #include <optional>
+#include <memory_resource>
 
 #include <captal_foundation/math.hpp>
 
+#include "algorithm.hpp"
+
 struct cpSpace;
 struct cpBody;
 struct cpShape;
@@ -165,6 +168,11 @@ public:
     std::vector<region_hit> region_query(float x, float y, float width, float height, group_t group, collision_id_t id, collision_id_t mask);
     std::vector<ray_hit> ray_query(vec2f from, vec2f to, float thickness, group_t group, collision_id_t id, collision_id_t mask);
 
+    //Results are allocated within resource, pass cpt::thread_frame_arena() for per-frame queries
+    std::pmr::vector<point_hit> point_query(vec2f point, float max_distance, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource);
+    std::pmr::vector<region_hit> region_query(float x, float y, float width, float height, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource);
+    std::pmr::vector<ray_hit> ray_query(vec2f from, vec2f to, float thickness, group_t group, collision_id_t id, collision_id_t mask, std::pmr::memory_resource* resource);
+
     std::optional<point_hit> point_query_nearest(vec2f point, float max_distance, group_t group, collision_id_t id, collision_id_t mask);
     std::optional<ray_hit> ray_query_first(vec2f from, vec2f to, float thickness, group_t group, collision_id_t id, collision_id_t mask);
 
@@ -228,12 +236,6 @@ private:
     float m_time{};
 };
 
-struct bounding_box
-{
-    vec2f top_left{};
-    vec2f bottom_right{};
-};
-
 class CAPTAL_API physical_shape
 {
 public:
@@ -0,0 +1,918 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <iterator>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+enum class graph_access_type : std::uint32_t
+{
+    color = 0,
+    depth = 1,
+    input = 2,
+    sampled = 3
+};
+
+struct graph_access
+{
+    render_graph_texture texture{};
+    graph_access_type type{};
+    bool cleared{};
+};
+
+struct graph_use
+{
+    std::uint32_t render_pass{};
+    std::uint32_t subpass{};
+    graph_access access{};
+};
+
+struct graph_sync_scope
+{
+    tph::pipeline_stage stage{};
+    tph::resource_access access{};
+};
+
+static std::vector<graph_access> pass_accesses(const render_graph_pass_info& info)
+{
+    std::vector<graph_access> output{};
+    output.reserve(std::size(info.color_attachments) + std::size(info.input_attachments) + std::size(info.sampled_textures) + 1);
+
+    for(auto&& attachment : info.color_attachments)
+    {
+        output.emplace_back(graph_access{attachment.texture, graph_access_type::color, attachment.clear.has_value()});
+    }
+
+    if(info.depth_attachment)
+    {
+        output.emplace_back(graph_access{info.depth_attachment->texture, graph_access_type::depth, info.depth_attachment->clear.has_value()});
+    }
+
+    for(auto texture : info.input_attachments)
+    {
+        output.emplace_back(graph_access{texture, graph_access_type::input});
+    }
+
+    for(auto texture : info.sampled_textures)
+    {
+        output.emplace_back(graph_access{texture, graph_access_type::sampled});
+    }
+
+    return output;
+}
+
+static bool is_write(graph_access_type type) noexcept
+{
+    return type == graph_access_type::color || type == graph_access_type::depth;
+}
+
+//Attachments that are not cleared keep the previous content, so they read it
+static bool is_read(const graph_access& access) noexcept
+{
+    return !is_write(access.type) || !access.cleared;
+}
+
+static bool is_depth_format(tph::texture_format format) noexcept
+{
+    return static_cast<bool>(tph::aspect_from_format(format) & (tph::texture_aspect::depth | tph::texture_aspect::stencil));
+}
+
+static bool has_stencil(tph::texture_format format) noexcept
+{
+    return static_cast<bool>(tph::aspect_from_format(format) & tph::texture_aspect::stencil);
+}
+
+static tph::texture_layout access_layout(graph_access_type type, bool depth) noexcept
+{
+    switch(type)
+    {
+        case graph_access_type::color: return tph::texture_layout::color_attachment_optimal;
+        case graph_access_type::depth: return tph::texture_layout::depth_stencil_attachment_optimal;
+        default: return depth ? tph::texture_layout::depth_stencil_read_only_optimal : tph::texture_layout::shader_read_only_optimal;
+    }
+}
+
+static tph::texture_usage access_usage(graph_access_type type) noexcept
+{
+    switch(type)
+    {
+        case graph_access_type::color: return tph::texture_usage::color_attachment;
+        case graph_access_type::depth: return tph::texture_usage::depth_stencil_attachment;
+        case graph_access_type::input: return tph::texture_usage::input_attachment;
+        default: return tph::texture_usage::sampled;
+    }
+}
+
+//What the next access must wait for
+static graph_sync_scope source_scope(graph_access_type type) noexcept
+{
+    switch(type)
+    {
+        case graph_access_type::color: return graph_sync_scope{tph::pipeline_stage::color_attachment_output, tph::resource_access::color_attachment_write};
+        case graph_access_type::depth: return graph_sync_scope{tph::pipeline_stage::early_fragment_tests | tph::pipeline_stage::late_fragment_tests, tph::resource_access::depth_stencil_attachment_write};
+        default: return graph_sync_scope{tph::pipeline_stage::fragment_shader, tph::resource_access::none}; //Write after read only needs an execution dependency
+    }
+}
+
+static graph_sync_scope destination_scope(graph_access_type type) noexcept
+{
+    switch(type)
+    {
+        case graph_access_type::color: return graph_sync_scope{tph::pipeline_stage::color_attachment_output, tph::resource_access::color_attachment_read | tph::resource_access::color_attachment_write};
+        case graph_access_type::depth: return graph_sync_scope{tph::pipeline_stage::early_fragment_tests | tph::pipeline_stage::late_fragment_tests, tph::resource_access::depth_stencil_attachment_read | tph::resource_access::depth_stencil_attachment_write};
+        case graph_access_type::input: return graph_sync_scope{tph::pipeline_stage::fragment_shader, tph::resource_access::input_attachment};
+        default: return graph_sync_scope{tph::pipeline_stage::vertex_shader | tph::pipeline_stage::fragment_shader, tph::resource_access::shader_read};
+    }
+}
+
+//Imported textures are used by the rest of the frame in their final layout
+static graph_sync_scope final_scope(tph::texture_layout layout) noexcept
+{
+    switch(layout)
+    {
+        case tph::texture_layout::shader_read_only_optimal: [[fallthrough]];
+        case tph::texture_layout::depth_stencil_read_only_optimal:
+            return graph_sync_scope{tph::pipeline_stage::vertex_shader | tph::pipeline_stage::fragment_shader | tph::pipeline_stage::compute_shader, tph::resource_access::shader_read};
+        case tph::texture_layout::transfer_source_optimal:
+            return graph_sync_scope{tph::pipeline_stage::transfer, tph::resource_access::transfer_read};
+        default:
+            return graph_sync_scope{tph::pipeline_stage::all_commands, tph::resource_access::memory_read | tph::resource_access::memory_write};
+    }
+}
+
+//First use of a texture in the frame, its memory may have been used by another transient texture or by the previous frame
+static constexpr graph_sync_scope unknown_scope
+{
+    tph::pipeline_stage::fragment_shader | tph::pipeline_stage::early_fragment_tests | tph::pipeline_stage::late_fragment_tests | tph::pipeline_stage::color_attachment_output,
+    tph::resource_access::color_attachment_write | tph::resource_access::depth_stencil_attachment_write
+};
+
+//Dependencies between the same subpasses are merged together
+static void add_dependency(std::vector<tph::subpass_dependency>& dependencies, std::uint32_t source, std::uint32_t destination, const graph_sync_scope& source_scope, const graph_sync_scope& destination_scope)
+{
+    const auto it{std::find_if(std::begin(dependencies), std::end(dependencies), [source, destination](const tph::subpass_dependency& dependency)
+    {
+        return dependency.source_subpass == source && dependency.destination_subpass == destination;
+    })};
+
+    if(it != std::end(dependencies))
+    {
+        it->source_stage |= source_scope.stage;
+        it->destination_stage |= destination_scope.stage;
+        it->source_access |= source_scope.access;
+        it->destination_access |= destination_scope.access;
+    }
+    else
+    {
+        const bool framebuffer_local{source != tph::external_subpass && destination != tph::external_subpass};
+        const auto flags{framebuffer_local ? tph::dependency_flags::by_region : tph::dependency_flags::none};
+
+        dependencies.emplace_back(tph::subpass_dependency{source, destination, source_scope.stage, destination_scope.stage, source_scope.access, destination_scope.access, flags});
+    }
+}
+
+render_graph_texture render_graph::add_texture(const render_graph_texture_info& info)
+{
+    m_textures.emplace_back(texture_data{info});
+
+    return static_cast<render_graph_texture>(std::size(m_textures) - 1);
+}
+
+render_graph_texture render_graph::import_texture(texture_ptr texture, tph::texture_layout final_layout, tph::texture_layout current_layout)
+{
+    render_graph_texture_info info{};
+    info.width = texture->width();
+    info.height = texture->height();
+    info.format = texture->format();
+    info.sample_count = texture->get_texture().sample_count();
+
+    std::optional<tph::texture_layout> pending_layout{};
+    if(current_layout != final_layout)
+    {
+        pending_layout = current_layout;
+    }
+
+    m_textures.emplace_back(texture_data{info, std::move(texture), final_layout, true, pending_layout});
+
+    return static_cast<render_graph_texture>(std::size(m_textures) - 1);
+}
+
+std::uint32_t render_graph::add_pass(render_graph_pass_info info)
+{
+    assert((!std::empty(info.color_attachments) || info.depth_attachment) && "cpt::render_graph::add_pass called with a pass that has no attachment.");
+
+    m_passes.emplace_back(pass_data{std::move(info)});
+
+    return static_cast<std::uint32_t>(std::size(m_passes) - 1);
+}
+
+void render_graph::compile()
+{
+    //A pass depends on the last pass that wrote what it reads (a producer),
+    //and must also run after the passes that used what it overwrites
+    std::vector<std::vector<std::uint32_t>> producers(std::size(m_passes));
+    std::vector<std::vector<std::uint32_t>> predecessors(std::size(m_passes));
+    std::vector<std::optional<std::uint32_t>> last_writers(std::size(m_textures));
+    std::vector<std::vector<std::uint32_t>> readers(std::size(m_textures));
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(m_passes)); ++i)
+    {
+        for(auto&& access : pass_accesses(m_passes[i].info))
+        {
+            auto& last_writer{last_writers[access.texture]};
+
+            if(last_writer && *last_writer != i)
+            {
+                predecessors[i].emplace_back(*last_writer);
+
+                if(is_read(access))
+                {
+                    producers[i].emplace_back(*last_writer);
+                }
+            }
+
+            if(is_write(access.type))
+            {
+                std::copy_if(std::begin(readers[access.texture]), std::end(readers[access.texture]), std::back_inserter(predecessors[i]), [i](std::uint32_t reader)
+                {
+                    return reader != i;
+                });
+
+                readers[access.texture].clear();
+                last_writer = i;
+            }
+            else
+            {
+                readers[access.texture].emplace_back(i);
+            }
+        }
+    }
+
+    m_compiled = make_asynchronous_resource<compiled_data>();
+
+    cull_passes(producers, last_writers);
+    schedule_passes(predecessors);
+    make_transient_textures();
+    make_render_passes();
+
+#ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        set_name(std::string{m_name});
+    }
+#endif
+}
+
+void render_graph::record(frame_render_info info)
+{
+    assert(m_compiled && "cpt::render_graph::record called before cpt::render_graph::compile.");
+
+    //The render passes expect imported textures in their final layout, as left by the previous frame
+    for(auto& texture : m_textures)
+    {
+        if(texture.pending_layout)
+        {
+            tph::texture_memory_barrier barrier{texture.texture->get_texture()};
+            barrier.subresource.mip_level_count = texture.texture->mip_levels();
+            barrier.source_access      = tph::resource_access::memory_write;
+            barrier.destination_access = tph::resource_access::memory_read | tph::resource_access::memory_write;
+            barrier.old_layout         = *texture.pending_layout;
+            barrier.new_layout         = texture.final_layout;
+
+            tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::all_commands, tph::pipeline_stage::all_commands, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+            texture.pending_layout.reset();
+        }
+    }
+
+    for(auto& render_pass : m_compiled->render_passes)
+    {
+        tph::cmd::begin_render_pass(info.buffer, render_pass.render_pass, render_pass.framebuffer);
+
+        for(std::size_t i{}; i < std::size(render_pass.passes); ++i)
+        {
+            if(i > 0)
+            {
+                tph::cmd::next_subpass(info.buffer);
+            }
+
+            auto& callback{m_passes[render_pass.passes[i]].info.callback};
+
+            if(callback)
+            {
+                callback(info);
+            }
+        }
+
+        tph::cmd::end_render_pass(info.buffer);
+    }
+
+    for(auto&& texture : m_textures)
+    {
+        if(texture.texture)
+        {
+            info.keeper.keep(texture.texture);
+        }
+    }
+
+    info.keeper.keep(m_compiled);
+}
+
+std::uint64_t render_graph::transient_memory_size() const noexcept
+{
+    if(!m_compiled)
+    {
+        return 0;
+    }
+
+    return std::accumulate(std::begin(m_compiled->memory), std::end(m_compiled->memory), std::uint64_t{}, [](std::uint64_t total, const tph::vulkan::memory_heap_chunk& chunk)
+    {
+        return total + chunk.size();
+    });
+}
+
+#ifdef CAPTAL_DEBUG
+void render_graph::set_name(std::string_view name)
+{
+    m_name = name;
+
+    if(!m_compiled)
+    {
+        return;
+    }
+
+    for(std::size_t i{}; i < std::size(m_compiled->render_passes); ++i)
+    {
+        tph::set_object_name(engine::instance().renderer(), m_compiled->render_passes[i].render_pass, m_name + " render pass #" + std::to_string(i));
+        tph::set_object_name(engine::instance().renderer(), m_compiled->render_passes[i].framebuffer, m_name + " framebuffer #" + std::to_string(i));
+    }
+
+    for(std::size_t i{}; i < std::size(m_textures); ++i)
+    {
+        if(m_textures[i].texture && !m_textures[i].imported)
+        {
+            m_textures[i].texture->set_name(m_name + " transient texture #" + std::to_string(i));
+        }
+    }
+}
+#endif
+
+void render_graph::cull_passes(const std::vector<std::vector<std::uint32_t>>& producers, const std::vector<std::optional<std::uint32_t>>& last_writers)
+{
+    //Only the passes that contribute to the final content of an imported texture are kept
+    std::vector<std::uint32_t> stack{};
+
+    for(std::size_t i{}; i < std::size(m_textures); ++i)
+    {
+        if(m_textures[i].imported && last_writers[i])
+        {
+            stack.emplace_back(*last_writers[i]);
+        }
+    }
+
+    for(auto& pass : m_passes)
+    {
+        pass.culled = true;
+    }
+
+    while(!std::empty(stack))
+    {
+        const auto index{stack.back()};
+        stack.pop_back();
+
+        if(std::exchange(m_passes[index].culled, false))
+        {
+            stack.insert(std::end(stack), std::begin(producers[index]), std::end(producers[index]));
+        }
+    }
+}
+
+void render_graph::schedule_passes(const std::vector<std::vector<std::uint32_t>>& predecessors)
+{
+    //Topological sort that prefers, among the passes that are ready, one that fits in the current render pass
+    std::vector<std::uint32_t> remaining(std::size(m_passes));
+    std::vector<std::vector<std::uint32_t>> successors(std::size(m_passes));
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(m_passes)); ++i)
+    {
+        if(m_passes[i].culled)
+        {
+            continue;
+        }
+
+        auto unique{predecessors[i]};
+        std::sort(std::begin(unique), std::end(unique));
+        unique.erase(std::unique(std::begin(unique), std::end(unique)), std::end(unique));
+
+        for(auto predecessor : unique)
+        {
+            if(!m_passes[predecessor].culled)
+            {
+                successors[predecessor].emplace_back(i);
+                ++remaining[i];
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> ready{};
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(m_passes)); ++i)
+    {
+        if(!m_passes[i].culled && remaining[i] == 0)
+        {
+            ready.emplace_back(i);
+        }
+    }
+
+    auto& render_passes{m_compiled->render_passes};
+
+    while(!std::empty(ready))
+    {
+        std::sort(std::begin(ready), std::end(ready));
+
+        auto it{std::begin(ready)};
+
+        if(!std::empty(render_passes))
+        {
+            const auto mergeable{std::find_if(std::begin(ready), std::end(ready), [this, &render_passes](std::uint32_t index)
+            {
+                return can_merge(render_passes.back(), m_passes[index]);
+            })};
+
+            if(mergeable != std::end(ready))
+            {
+                it = mergeable;
+            }
+        }
+
+        const auto index{*it};
+        ready.erase(it);
+
+        auto& pass{m_passes[index]};
+        const auto accesses{pass_accesses(pass.info)};
+
+        if(std::empty(render_passes) || !can_merge(render_passes.back(), pass))
+        {
+            const auto& info{m_textures[accesses.front().texture].info};
+
+            auto& render_pass{render_passes.emplace_back()};
+            render_pass.width = info.width;
+            render_pass.height = info.height;
+        }
+
+        auto& render_pass{render_passes.back()};
+
+        pass.render_pass = static_cast<std::uint32_t>(std::size(render_passes) - 1);
+        pass.subpass = static_cast<std::uint32_t>(std::size(render_pass.passes));
+        render_pass.passes.emplace_back(index);
+
+        for(auto&& access : accesses)
+        {
+            if(access.type != graph_access_type::sampled && std::find(std::begin(render_pass.attachments), std::end(render_pass.attachments), access.texture) == std::end(render_pass.attachments))
+            {
+                render_pass.attachments.emplace_back(access.texture);
+            }
+        }
+
+        for(auto successor : successors[index])
+        {
+            if(--remaining[successor] == 0)
+            {
+                ready.emplace_back(successor);
+            }
+        }
+    }
+}
+
+bool render_graph::can_merge(const render_pass_data& render_pass, const pass_data& pass) const
+{
+    const auto accesses{pass_accesses(pass.info)};
+    const auto& info{m_textures[accesses.front().texture].info};
+
+    if(info.width != render_pass.width || info.height != render_pass.height)
+    {
+        return false;
+    }
+
+    const auto is_attached{[&render_pass](render_graph_texture texture)
+    {
+        return std::find(std::begin(render_pass.attachments), std::end(render_pass.attachments), texture) != std::end(render_pass.attachments);
+    }};
+
+    const auto is_sampled{[this, &render_pass](render_graph_texture texture)
+    {
+        return std::any_of(std::begin(render_pass.passes), std::end(render_pass.passes), [this, texture](std::uint32_t index)
+        {
+            const auto& sampled{m_passes[index].info.sampled_textures};
+
+            return std::find(std::begin(sampled), std::end(sampled), texture) != std::end(sampled);
+        });
+    }};
+
+    for(auto&& access : accesses)
+    {
+        //Sampling may read other fragments, that are only available once the render pass ends
+        if(access.type == graph_access_type::sampled)
+        {
+            if(is_attached(access.texture))
+            {
+                return false;
+            }
+        }
+        else if(is_sampled(access.texture))
+        {
+            return false;
+        }
+
+        //Attachments can only be cleared at the beginning of the render pass
+        if(is_write(access.type) && access.cleared && is_attached(access.texture))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void render_graph::make_transient_textures()
+{
+    const auto& render_passes{m_compiled->render_passes};
+
+    constexpr auto unused{std::numeric_limits<std::uint32_t>::max()};
+
+    std::vector<std::uint32_t> first_uses(std::size(m_textures), unused);
+    std::vector<std::uint32_t> last_uses(std::size(m_textures));
+    std::vector<tph::texture_usage> usages(std::size(m_textures));
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(render_passes)); ++i)
+    {
+        for(auto index : render_passes[i].passes)
+        {
+            for(auto&& access : pass_accesses(m_passes[index].info))
+            {
+                first_uses[access.texture] = std::min(first_uses[access.texture], i);
+                last_uses[access.texture] = std::max(last_uses[access.texture], i);
+                usages[access.texture] |= access_usage(access.type);
+            }
+        }
+    }
+
+    //Textures that never leave a render pass may stay in tile memory
+    for(std::size_t i{}; i < std::size(m_textures); ++i)
+    {
+        if(first_uses[i] == last_uses[i] && !static_cast<bool>(usages[i] & tph::texture_usage::sampled))
+        {
+            usages[i] |= tph::texture_usage::transient_attachment;
+        }
+    }
+
+    //Textures whose lifetimes do not overlap share the same memory, depth and color textures are kept apart
+    //since their memory requirements rarely match
+    struct memory_slot
+    {
+        std::uint32_t last_use{};
+        bool depth{};
+        std::vector<render_graph_texture> textures{};
+    };
+
+    std::vector<render_graph_texture> candidates{};
+
+    for(render_graph_texture i{}; i < static_cast<render_graph_texture>(std::size(m_textures)); ++i)
+    {
+        if(!m_textures[i].imported)
+        {
+            m_textures[i].texture.reset();
+
+            if(first_uses[i] != unused)
+            {
+                candidates.emplace_back(i);
+            }
+        }
+    }
+
+    std::stable_sort(std::begin(candidates), std::end(candidates), [&first_uses](render_graph_texture left, render_graph_texture right)
+    {
+        return first_uses[left] < first_uses[right];
+    });
+
+    std::vector<memory_slot> slots{};
+
+    for(auto texture : candidates)
+    {
+        const bool depth{is_depth_format(m_textures[texture].info.format)};
+
+        auto it{std::find_if(std::begin(slots), std::end(slots), [&first_uses, texture, depth](const memory_slot& slot)
+        {
+            return slot.depth == depth && slot.last_use < first_uses[texture];
+        })};
+
+        if(it == std::end(slots))
+        {
+            it = slots.insert(std::end(slots), memory_slot{0, depth});
+        }
+
+        it->last_use = last_uses[texture];
+        it->textures.emplace_back(texture);
+    }
+
+    auto& renderer{engine::instance().renderer()};
+
+    for(auto&& slot : slots)
+    {
+        std::vector<tph::texture> textures{};
+        textures.reserve(std::size(slot.textures));
+
+        for(auto texture : slot.textures)
+        {
+            const auto& info{m_textures[texture].info};
+
+            textures.emplace_back(renderer, tph::aliased_memory, info.width, info.height, tph::texture_info{.format = info.format, .usage = usages[texture], .sample_count = info.sample_count});
+        }
+
+        const std::vector<std::reference_wrapper<tph::texture>> references{std::begin(textures), std::end(textures)};
+        m_compiled->memory.emplace_back(tph::alias_memory(renderer, references));
+
+        for(std::size_t i{}; i < std::size(textures); ++i)
+        {
+            const auto& info{m_textures[slot.textures[i]].info};
+
+            tph::texture_view view{renderer, textures[i]};
+            tph::sampler sampler{renderer, info.sampling};
+
+            m_textures[slot.textures[i]].texture = make_texture(std::move(textures[i]), std::move(view), std::move(sampler));
+        }
+    }
+}
+
+void render_graph::make_render_passes()
+{
+    auto& render_passes{m_compiled->render_passes};
+
+    //Every use of each texture, in execution order
+    std::vector<std::vector<graph_use>> uses(std::size(m_textures));
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(render_passes)); ++i)
+    {
+        for(std::uint32_t j{}; j < static_cast<std::uint32_t>(std::size(render_passes[i].passes)); ++j)
+        {
+            for(auto&& access : pass_accesses(m_passes[render_passes[i].passes[j]].info))
+            {
+                uses[access.texture].emplace_back(graph_use{i, j, access});
+            }
+        }
+    }
+
+    //Layout of each texture between render passes
+    std::vector<tph::texture_layout> layouts{};
+    layouts.reserve(std::size(m_textures));
+
+    for(auto&& texture : m_textures)
+    {
+        layouts.emplace_back(texture.imported ? texture.final_layout : tph::texture_layout::undefined);
+    }
+
+    auto& renderer{engine::instance().renderer()};
+
+    for(std::uint32_t i{}; i < static_cast<std::uint32_t>(std::size(render_passes)); ++i)
+    {
+        auto& data{render_passes[i]};
+
+        const auto find_use{[&uses, i](render_graph_texture texture, std::uint32_t subpass)
+        {
+            return std::find_if(std::begin(uses[texture]), std::end(uses[texture]), [i, subpass](const graph_use& use)
+            {
+                return use.render_pass == i && use.subpass == subpass;
+            });
+        }};
+
+        const auto attachment_index{[&data](render_graph_texture texture)
+        {
+            return static_cast<std::uint32_t>(std::find(std::begin(data.attachments), std::end(data.attachments), texture) - std::begin(data.attachments));
+        }};
+
+        tph::render_pass_info info{};
+
+        for(auto texture : data.attachments)
+        {
+            const auto& texture_data{m_textures[texture]};
+            const auto& texture_uses{uses[texture]};
+            const bool depth{is_depth_format(texture_data.info.format)};
+
+            const auto first{std::find_if(std::begin(texture_uses), std::end(texture_uses), [i](const graph_use& use){ return use.render_pass == i; })};
+            const auto last{std::find_if(std::rbegin(texture_uses), std::rend(texture_uses), [i](const graph_use& use){ return use.render_pass == i; }).base() - 1};
+            const auto next{std::next(last)};
+
+            const bool has_previous{first != std::begin(texture_uses)};
+            const bool has_next{next != std::end(texture_uses)};
+
+            auto& attachment{info.attachments.emplace_back()};
+            attachment.format = texture_data.info.format;
+            attachment.sample_count = texture_data.info.sample_count;
+
+            if(is_write(first->access.type) && first->access.cleared)
+            {
+                attachment.load_op = tph::attachment_load_op::clear;
+            }
+            else if(has_previous || texture_data.imported)
+            {
+                attachment.load_op = tph::attachment_load_op::load;
+            }
+            else
+            {
+                attachment.load_op = tph::attachment_load_op::dont_care;
+            }
+
+            if(has_next ? is_read(next->access) : texture_data.imported)
+            {
+                attachment.store_op = tph::attachment_store_op::store;
+            }
+            else
+            {
+                attachment.store_op = tph::attachment_store_op::dont_care;
+            }
+
+            if(has_stencil(attachment.format))
+            {
+                attachment.stencil_load_op = attachment.load_op;
+                attachment.stencil_store_op = attachment.store_op;
+            }
+            else
+            {
+                attachment.stencil_load_op = tph::attachment_load_op::dont_care;
+                attachment.stencil_store_op = tph::attachment_store_op::dont_care;
+            }
+
+            if(attachment.load_op == tph::attachment_load_op::load)
+            {
+                attachment.initial_layout = layouts[texture];
+            }
+            else
+            {
+                attachment.initial_layout = tph::texture_layout::undefined;
+            }
+
+            //The next render pass finds the texture in the layout it needs, without any extra barrier
+            if(has_next && next->access.type == graph_access_type::sampled)
+            {
+                attachment.final_layout = access_layout(graph_access_type::sampled, depth);
+            }
+            else if(!has_next && texture_data.imported)
+            {
+                attachment.final_layout = texture_data.final_layout;
+            }
+            else
+            {
+                attachment.final_layout = access_layout(last->access.type, depth);
+            }
+
+            layouts[texture] = attachment.final_layout;
+
+            //Each use is synchronized with the next one by the render pass that does it,
+            //only the first use of the frame has to wait for something unknown.
+            //A layout transition at the beginning of the render pass is only ordered by the dependency from external,
+            //the one of the previous render pass does not cover it.
+            if(!has_previous)
+            {
+                add_dependency(info.dependencies, tph::external_subpass, first->subpass, unknown_scope, destination_scope(first->access.type));
+            }
+            else if(attachment.initial_layout != access_layout(first->access.type, depth))
+            {
+                add_dependency(info.dependencies, tph::external_subpass, first->subpass, source_scope(std::prev(first)->access.type), destination_scope(first->access.type));
+            }
+
+            if(has_next)
+            {
+                add_dependency(info.dependencies, last->subpass, tph::external_subpass, source_scope(last->access.type), destination_scope(next->access.type));
+            }
+            else if(texture_data.imported)
+            {
+                add_dependency(info.dependencies, last->subpass, tph::external_subpass, source_scope(last->access.type), final_scope(texture_data.final_layout));
+            }
+        }
+
+        for(std::uint32_t j{}; j < static_cast<std::uint32_t>(std::size(data.passes)); ++j)
+        {
+            const auto& pass_info{m_passes[data.passes[j]].info};
+            auto& subpass{info.subpasses.emplace_back()};
+
+            for(auto&& attachment : pass_info.color_attachments)
+            {
+                subpass.color_attachments.emplace_back(tph::attachment_reference{attachment_index(attachment.texture), tph::texture_layout::color_attachment_optimal});
+            }
+
+            if(pass_info.depth_attachment)
+            {
+                subpass.depth_attachment.emplace(tph::attachment_reference{attachment_index(pass_info.depth_attachment->texture), tph::texture_layout::depth_stencil_attachment_optimal});
+            }
+
+            for(auto texture : pass_info.input_attachments)
+            {
+                const bool depth{is_depth_format(m_textures[texture].info.format)};
+
+                subpass.input_attachments.emplace_back(tph::attachment_reference{attachment_index(texture), access_layout(graph_access_type::input, depth)});
+            }
+
+            for(auto&& access : pass_accesses(pass_info))
+            {
+                const auto use{find_use(access.texture, j)};
+
+                if(access.type == graph_access_type::sampled)
+                {
+                    //The next use is always in another render pass, reads following reads need nothing,
+                    //but every read must be done before the next write
+                    const auto next{std::find_if(std::next(use), std::end(uses[access.texture]), [](const graph_use& other)
+                    {
+                        return other.access.type != graph_access_type::sampled;
+                    })};
+
+                    if(next != std::end(uses[access.texture]))
+                    {
+                        add_dependency(info.dependencies, j, tph::external_subpass, source_scope(access.type), destination_scope(next->access.type));
+                    }
+                }
+                else if(use != std::begin(uses[access.texture]) && std::prev(use)->render_pass == i)
+                {
+                    const auto& previous{*std::prev(use)};
+
+                    add_dependency(info.dependencies, previous.subpass, j, source_scope(previous.access.type), destination_scope(access.type));
+                }
+            }
+
+            //Attachments used before and after this subpass must keep their content through it
+            for(auto texture : data.attachments)
+            {
+                const auto& texture_uses{uses[texture]};
+
+                const bool used_before{std::any_of(std::begin(texture_uses), std::end(texture_uses), [i, j](const graph_use& use){ return use.render_pass == i && use.subpass < j; })};
+                const bool used_after{std::any_of(std::begin(texture_uses), std::end(texture_uses), [i, j](const graph_use& use){ return use.render_pass == i && use.subpass > j; })};
+                const bool used_here{find_use(texture, j) != std::end(texture_uses)};
+
+                if(used_before && used_after && !used_here)
+                {
+                    subpass.preserve_attachments.emplace_back(attachment_index(texture));
+                }
+            }
+        }
+
+        data.render_pass = tph::render_pass{renderer, info};
+
+        std::vector<std::reference_wrapper<tph::texture_view>> attachments{};
+        attachments.reserve(std::size(data.attachments));
+
+        for(auto texture : data.attachments)
+        {
+            attachments.emplace_back(m_textures[texture].texture->get_texture_view());
+        }
+
+        data.framebuffer = tph::framebuffer{renderer, data.render_pass, attachments, data.width, data.height, 1};
+
+        for(auto index : data.passes)
+        {
+            const auto& pass_info{m_passes[index].info};
+
+            for(auto&& attachment : pass_info.color_attachments)
+            {
+                if(attachment.clear)
+                {
+                    data.framebuffer.set_clear_value(attachment_index(attachment.texture), *attachment.clear);
+                }
+            }
+
+            if(pass_info.depth_attachment && pass_info.depth_attachment->clear)
+            {
+                data.framebuffer.set_clear_value(attachment_index(pass_info.depth_attachment->texture), *pass_info.depth_attachment->clear);
+            }
+        }
+    }
+}
+
+}
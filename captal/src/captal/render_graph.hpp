@@ -0,0 +1,203 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_RENDER_GRAPH_HPP_INCLUDED
+#define CAPTAL_RENDER_GRAPH_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <cassert>
+#include <vector>
+#include <optional>
+#include <string>
+#include <functional>
+#include <memory>
+
+#include <tephra/render_target.hpp>
+
+#include "asynchronous_resource.hpp"
+#include "texture.hpp"
+#include "render_target.hpp"
+
+namespace cpt
+{
+
+using render_graph_texture = std::uint32_t;
+
+//Transient textures live only for the frame, their memory is shared with other transient textures that are never used at the same time
+struct render_graph_texture_info
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    tph::texture_format format{};
+    tph::sample_count sample_count{tph::sample_count::msaa_x1};
+    tph::sampler_info sampling{}; //Only used if the texture is sampled by a pass
+};
+
+struct render_graph_attachment
+{
+    render_graph_texture texture{};
+    std::optional<tph::clear_value_t> clear{}; //If not set, the content written by previous passes is kept
+};
+
+using render_graph_pass_callback = std::function<void(frame_render_info info)>;
+
+struct render_graph_pass_info
+{
+    std::vector<render_graph_attachment> color_attachments{};
+    std::optional<render_graph_attachment> depth_attachment{};
+    std::vector<render_graph_texture> input_attachments{}; //Read at the current fragment only, the pass can be merged with the passes writing them
+    std::vector<render_graph_texture> sampled_textures{}; //Read anywhere, the passes writing them must be in a previous render pass
+    render_graph_pass_callback callback{};
+};
+
+//Passes are declared in the order a naive implementation would execute them, a pass reads what the previously declared passes wrote.
+//On compile, passes that do not contribute to an imported texture are culled, the others are reordered so that compatible passes
+//become subpasses of a single render pass. Barriers are subpass dependencies and layout transitions of the render passes.
+class CAPTAL_API render_graph
+{
+public:
+    render_graph() = default;
+    ~render_graph() = default;
+    render_graph(const render_graph&) = delete;
+    render_graph& operator=(const render_graph&) = delete;
+    render_graph(render_graph&&) noexcept = default;
+    render_graph& operator=(render_graph&&) noexcept = default;
+
+    render_graph_texture add_texture(const render_graph_texture_info& info);
+    //Imported textures keep their content between frames and are left in final_layout at the end of the graph.
+    //current_layout is the layout of the texture before the first record, which transitions it to final_layout.
+    //Textures created from images are in shader_read_only_optimal, use undefined for a new texture whose content does not matter.
+    render_graph_texture import_texture(texture_ptr texture, tph::texture_layout final_layout = tph::texture_layout::shader_read_only_optimal, tph::texture_layout current_layout = tph::texture_layout::shader_read_only_optimal);
+    std::uint32_t add_pass(render_graph_pass_info info);
+
+    //Must be called after the last pass declaration and before any call to the functions below.
+    //Calling it again rebuilds everything, techniques created with the previous render passes stay compatible as long as the attachments did not change.
+    void compile();
+
+    //Records every pass, connect it to render_target::on_compute so the results are ready for the target's render pass
+    void record(frame_render_info info);
+
+    const texture_ptr& texture(render_graph_texture texture) const noexcept
+    {
+        return m_textures[texture].texture;
+    }
+
+    bool is_culled(std::uint32_t pass) const noexcept
+    {
+        return m_passes[pass].culled;
+    }
+
+    //Use these to create render techniques for a pass
+    tph::render_pass& render_pass(std::uint32_t pass) noexcept
+    {
+        assert(!m_passes[pass].culled && "cpt::render_graph::render_pass called on a culled pass.");
+
+        return m_compiled->render_passes[m_passes[pass].render_pass].render_pass;
+    }
+
+    std::uint32_t subpass(std::uint32_t pass) const noexcept
+    {
+        return m_passes[pass].subpass;
+    }
+
+    std::size_t render_pass_count() const noexcept
+    {
+        return m_compiled ? std::size(m_compiled->render_passes) : 0;
+    }
+
+    //Memory allocated for transient textures, after aliasing
+    std::uint64_t transient_memory_size() const noexcept;
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct texture_data
+    {
+        render_graph_texture_info info{};
+        texture_ptr texture{};
+        tph::texture_layout final_layout{};
+        bool imported{};
+        std::optional<tph::texture_layout> pending_layout{}; //Layout of an imported texture that has not been recorded yet
+    };
+
+    struct pass_data
+    {
+        render_graph_pass_info info{};
+        std::uint32_t render_pass{};
+        std::uint32_t subpass{};
+        bool culled{};
+    };
+
+    struct render_pass_data
+    {
+        std::vector<std::uint32_t> passes{};
+        std::vector<render_graph_texture> attachments{};
+        std::uint32_t width{};
+        std::uint32_t height{};
+        tph::render_pass render_pass{};
+        tph::framebuffer framebuffer{};
+    };
+
+    //Replaced on each compile, the previous one lives until the frames that used it are done
+    struct compiled_data : public asynchronous_resource
+    {
+        std::vector<tph::vulkan::memory_heap_chunk> memory{};
+        std::vector<render_pass_data> render_passes{};
+    };
+
+private:
+    void cull_passes(const std::vector<std::vector<std::uint32_t>>& producers, const std::vector<std::optional<std::uint32_t>>& last_writers);
+    void schedule_passes(const std::vector<std::vector<std::uint32_t>>& predecessors);
+    bool can_merge(const render_pass_data& render_pass, const pass_data& pass) const;
+    void make_transient_textures();
+    void make_render_passes();
+
+private:
+    std::vector<texture_data> m_textures{};
+    std::vector<pass_data> m_passes{};
+    std::shared_ptr<compiled_data> m_compiled{};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+using render_graph_ptr = std::shared_ptr<render_graph>;
+using render_graph_weak_ptr = std::weak_ptr<render_graph>;
+
+template<typename... Args>
+render_graph_ptr make_render_graph(Args&&... args)
+{
+    return std::make_shared<render_graph>(std::forward<Args>(args)...);
+}
+
+}
+
+#endif
@@ -37,8 +37,8 @@ namespace cpt
 {
 
 using frame_time_t = std::chrono::duration<std::uint64_t, std::nano>;
-using frame_presented_signal = cpt::signal<>;
-using frame_time_signal = cpt::signal<frame_time_t>;
+using frame_presented_signal = cpt::signal_st<>;
+using frame_time_signal = cpt::signal_st<frame_time_t>;
 
 struct frame_render_info
 {
@@ -48,6 +48,8 @@ struct frame_render_info
     optional_ref<frame_time_signal> time_signal{};
 };
 
+using frame_compute_signal = cpt::signal_st<frame_render_info>;
+
 enum class begin_render_options : std::uint32_t
 {
     none = 0x00,
@@ -77,7 +79,19 @@ public:
         return m_render_pass;
     }
 
+    //Emitted by begin_render when a new frame is recorded, before the render pass begins.
+    //Compute techniques dispatch from here, their results are visible to the draws of the same frame.
+    frame_compute_signal& on_compute() noexcept
+    {
+        return m_compute;
+    }
+
 protected:
+    void dispatch_computes(frame_render_info info)
+    {
+        m_compute(info);
+    }
+
     render_target(const render_target&) = delete;
     render_target& operator=(const render_target&) = delete;
     render_target(render_target&&) noexcept = default;
@@ -85,6 +99,7 @@ protected:
 
 private:
     tph::render_pass m_render_pass{};
+    frame_compute_signal m_compute{};
 };
 
 using render_target_ptr = std::shared_ptr<render_target>;
@@ -22,6 +22,10 @@
 
 #include "render_technique.hpp"
 
+#include <thread>
+#include <algorithm>
+#include <atomic>
+
 #include "engine.hpp"
 #include "vertex.hpp"
 
@@ -36,47 +40,91 @@ descriptor_set::descriptor_set(descriptor_pool& parent, tph::descriptor_set set)
 }
 
 
-descriptor_pool::descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, tph::descriptor_pool pool)
+descriptor_pool::descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, std::span<const tph::descriptor_pool_size> sizes, std::uint32_t capacity)
 :m_parent{&parent}
-,m_pool{std::move(pool)}
+,m_layout{&layout}
+,m_capacity{capacity}
 {
-    for(auto&& set : m_sets)
+    std::vector<tph::descriptor_pool_size> pool_sizes{};
+    pool_sizes.reserve(std::size(sizes));
+
+    for(auto&& size : sizes)
     {
-        set = std::make_shared<descriptor_set>(*this, tph::descriptor_set{engine::instance().renderer(), m_pool, layout});
+        pool_sizes.emplace_back(size.type, size.count * capacity);
     }
+
+    m_pool = tph::descriptor_pool{engine::instance().renderer(), pool_sizes, capacity};
+
+    m_sets.reserve(capacity);
+    m_free.reserve(capacity);
 }
 
-descriptor_set_ptr descriptor_pool::allocate() noexcept
+descriptor_set_ptr descriptor_pool::allocate()
 {
-    for(auto&& set : m_sets)
+    std::lock_guard lock{m_mutex};
+
+    descriptor_set* set{};
+
+    if(!std::empty(m_free))
+    {
+        set = m_free.back();
+        m_free.pop_back();
+    }
+    else if(std::size(m_sets) < m_capacity)
     {
-        if(set.use_count() == 1)
+        set = m_sets.emplace_back(std::make_unique<descriptor_set>(*this, tph::descriptor_set{engine::instance().renderer(), m_pool, *m_layout})).get();
+
+        #ifdef CAPTAL_DEBUG
+        if(!std::empty(m_name))
         {
-            return set;
+            tph::set_object_name(engine::instance().renderer(), set->set(), m_name + " descriptor set #" + std::to_string(std::size(m_sets) - 1));
         }
+        #endif
+    }
+    else
+    {
+        return nullptr;
     }
 
-    return nullptr;
+    set->m_deferred = true;
+
+    //The deleter keeps the pool alive until all of its sets are released, sets go back to the pool once the GPU is done with them
+    return descriptor_set_ptr{set, [pool = shared_from_this()](descriptor_set* set)
+    {
+        impl::retire_resource(*set, [pool, set]()
+        {
+            pool->release(set);
+        });
+    }};
+}
+
+void descriptor_pool::release(descriptor_set* set) noexcept
+{
+    set->m_resources.clear();
+
+    std::lock_guard lock{m_mutex};
+    m_free.emplace_back(set);
 }
 
 bool descriptor_pool::unused() const noexcept
 {
-    return std::all_of(std::begin(m_sets), std::end(m_sets), [](const descriptor_set_ptr& set)
-    {
-        return set.use_count() == 1;
-    });
+    std::lock_guard lock{m_mutex};
+
+    return std::size(m_free) == std::size(m_sets);
 }
 
 #ifdef CAPTAL_DEBUG
 void descriptor_pool::set_name(std::string_view name)
 {
-    const std::string name_str{name};
+    std::lock_guard lock{m_mutex};
+
+    m_name = name;
 
-    tph::set_object_name(engine::instance().renderer(), m_pool, name_str);
+    tph::set_object_name(engine::instance().renderer(), m_pool, m_name);
 
     for(std::size_t i{}; i < std::size(m_sets); ++i)
     {
-        tph::set_object_name(engine::instance().renderer(), m_pool, name_str + " descriptor set #" + std::to_string(i));
+        tph::set_object_name(engine::instance().renderer(), m_sets[i]->set(), m_name + " descriptor set #" + std::to_string(i));
     }
 }
 #endif
@@ -88,7 +136,7 @@ static std::vector<tph::descriptor_pool_size> make_pool_sizes(std::span<const tp
 
     for(auto&& binding : bindings)
     {
-        output.emplace_back(binding.type, binding.count * descriptor_pool::pool_size);
+        output.emplace_back(binding.type, binding.count);
     }
 
     return output;
@@ -96,6 +144,20 @@ static std::vector<tph::descriptor_pool_size> make_pool_sizes(std::span<const tp
 
 render_layout::layout_data render_layout::make_layout_data(const render_layout_info& info)
 {
+    if(info.bindless_textures)
+    {
+        const auto& table{engine::instance().bindless_textures()};
+        assert(table && "cpt::render_layout created with a bindless textures set, but the engine's bindless mode is disabled.");
+
+        //An identically defined layout, so the table's set is compatible with it
+        layout_data output{};
+        output.layout = tph::descriptor_set_layout{engine::instance().renderer(), table->bindings()};
+        output.bindings.assign(std::begin(table->bindings()), std::end(table->bindings()));
+        output.push_constants = info.push_constants;
+
+        return output;
+    }
+
     layout_data output{};
     output.layout = tph::descriptor_set_layout{engine::instance().renderer(), info.bindings};
     output.sizes = make_pool_sizes(info.bindings);
@@ -103,6 +165,19 @@ render_layout::layout_data render_layout::make_layout_data(const render_layout_i
     output.bindings = info.bindings;
     output.push_constants = info.push_constants;
 
+    for(auto&& binding : info.bindings)
+    {
+        if(binding.type == tph::descriptor_type::uniform_buffer_dynamic)
+        {
+            assert(binding.count == 1 && "cpt::render_layout does not support arrays of dynamic uniform buffers.");
+
+            output.dynamic_bindings.emplace_back(binding.binding);
+        }
+    }
+
+    //Dynamic offsets are consumed in binding order
+    std::sort(std::begin(output.dynamic_bindings), std::end(output.dynamic_bindings));
+
     for(auto&& [index, binding] : info.default_bindings)
     {
         output.default_bindings.set(index, binding);
@@ -151,6 +226,13 @@ render_layout::render_layout(const render_layout_info& view_info, const render_l
 
     for(auto&& user : user_info)
     {
+        if(user.bindless_textures)
+        {
+            assert(!m_bindless_textures_index && "cpt::render_layout created with more than one bindless textures set.");
+
+            m_bindless_textures_index = static_cast<std::uint32_t>(std::size(m_layout_data));
+        }
+
         m_layout_data.emplace_back(make_layout_data(user));
     }
 
@@ -164,6 +246,117 @@ descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index)
 {
     std::lock_guard lock{m_mutex};
 
+    return allocate_set(layout_index);
+}
+
+descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index, const binding_buffer& bindings)
+{
+    std::lock_guard lock{m_mutex};
+
+    auto& data{m_layout_data[layout_index]};
+
+    auto resolved{make_frame_vector<std::reference_wrapper<const cpt::binding>>()};
+    resolved.reserve(std::size(data.bindings));
+
+    auto key{make_frame_vector<set_key_element>()};
+    key.reserve(std::size(data.bindings));
+
+    for(auto&& binding : data.bindings)
+    {
+        const auto local{bindings.try_get(binding.binding)};
+        const auto fallback{local ? local : data.default_bindings.try_get(binding.binding)};
+        assert(fallback && "cpt::render_layout::make_set can not find any suitable binding, neither the bindings nor the render layout have a binding for specified index.");
+
+        const cpt::binding& value{*fallback};
+        resolved.emplace_back(value);
+
+        //Dynamic uniform buffers are keyed by heap and range, so renderables allocated in the same heap share the set.
+        //The set keeps the first buffer alive, so the heap can not be released while the set is in use.
+        if(binding.type == tph::descriptor_type::uniform_buffer_dynamic)
+        {
+            const auto buffer{get_dynamic_buffer(value)};
+
+            key.emplace_back(&buffer.buffer.get(), static_cast<std::uint32_t>(binding.type), static_cast<std::uint32_t>(buffer.size));
+        }
+        else
+        {
+            const auto part{get_binding_type(value) == binding_type::uniform_buffer_part ? std::get<uniform_buffer_part>(value).part : 0};
+
+            key.emplace_back(get_binding_resource(value).get(), static_cast<std::uint32_t>(get_binding_type(value)), part);
+        }
+    }
+
+    if(const auto it{data.cache.find(key)}; it != std::end(data.cache))
+    {
+        if(auto set{it->second.lock()}; set)
+        {
+            return set;
+        }
+
+        data.cache.erase(it);
+    }
+
+    auto set{allocate_set(layout_index)};
+
+    auto writes{make_frame_vector<tph::descriptor_write>()};
+    writes.reserve(std::size(data.bindings));
+    set->m_resources.reserve(std::size(data.bindings));
+
+    for(std::size_t i{}; i < std::size(data.bindings); ++i)
+    {
+        if(data.bindings[i].type == tph::descriptor_type::uniform_buffer_dynamic)
+        {
+            writes.emplace_back(make_dynamic_descriptor_write(set->set(), data.bindings[i].binding, resolved[i]));
+        }
+        else
+        {
+            writes.emplace_back(make_descriptor_write(set->set(), data.bindings[i].binding, resolved[i]));
+        }
+
+        set->m_resources.emplace_back(get_binding_resource(resolved[i]));
+    }
+
+    tph::write_descriptors(engine::instance().renderer(), writes);
+
+    //Drop the entries of released sets from time to time, instead of on each release
+    if(std::size(data.cache) >= data.cache_sweep_threshold)
+    {
+        std::erase_if(data.cache, [](const auto& item)
+        {
+            return item.second.expired();
+        });
+
+        data.cache_sweep_threshold = std::max(std::size(data.cache) * 2, std::size_t{64});
+    }
+
+    data.cache.emplace(set_key{std::begin(key), std::end(key)}, set);
+
+    return set;
+}
+
+frame_vector<std::uint32_t> render_layout::dynamic_offsets(std::uint32_t layout_index, const binding_buffer& bindings) const
+{
+    const auto& data{m_layout_data[layout_index]};
+
+    auto output{make_frame_vector<std::uint32_t>()};
+    output.reserve(std::size(data.dynamic_bindings));
+
+    for(const auto binding : data.dynamic_bindings)
+    {
+        const auto local{bindings.try_get(binding)};
+        const auto fallback{local ? local : data.default_bindings.try_get(binding)};
+        assert(fallback && "cpt::render_layout::dynamic_offsets can not find any suitable binding, neither the bindings nor the render layout have a binding for specified index.");
+
+        output.emplace_back(static_cast<std::uint32_t>(get_dynamic_buffer(*fallback).offset));
+    }
+
+    return output;
+}
+
+descriptor_set_ptr render_layout::allocate_set(std::uint32_t layout_index)
+{
+    assert(m_bindless_textures_index != layout_index && "cpt::render_layout::make_set called for the bindless textures set, use the engine's bindless texture table instead.");
+
     auto& data{m_layout_data[layout_index]};
 
     for(auto&& pool : data.pools)
@@ -174,8 +367,9 @@ descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index)
         }
     }
 
-    tph::descriptor_pool pool{engine::instance().renderer(), data.sizes, static_cast<std::uint32_t>(descriptor_pool::pool_size)};
-    data.pools.emplace_back(std::make_unique<descriptor_pool>(*this, data.layout, std::move(pool)));
+    //Pools grow geometrically, so large scenes only create a handful of them
+    const auto capacity{std::min(descriptor_pool::initial_pool_size << std::min(std::size(data.pools), std::size_t{16}), descriptor_pool::max_pool_size)};
+    data.pools.emplace_back(std::make_shared<descriptor_pool>(*this, data.layout, data.sizes, capacity));
 
 #ifdef CAPTAL_DEBUG
     if(!std::empty(m_name))
@@ -258,7 +452,18 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
 
     if(!has_vertex)
     {
-        output.stages.emplace_back(engine::instance().default_vertex_shader());
+        if(info.vertices_layout == vertex_layout::particle)
+        {
+            output.stages.emplace_back(engine::instance().particle_vertex_shader());
+        }
+        else if(info.vertices_layout == vertex_layout::compact)
+        {
+            output.stages.emplace_back(engine::instance().compact_vertex_shader());
+        }
+        else
+        {
+            output.stages.emplace_back(engine::instance().default_vertex_shader());
+        }
     }
 
     if(!has_fragment)
@@ -266,10 +471,29 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
         output.stages.emplace_back(engine::instance().default_fragment_shader());
     }
 
-    output.vertex_input.bindings.emplace_back(0, static_cast<std::uint32_t>(sizeof(vertex)));
-    output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec3f, static_cast<std::uint32_t>(offsetof(vertex, position)));
-    output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4f, static_cast<std::uint32_t>(offsetof(vertex, color)));
-    output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2f, static_cast<std::uint32_t>(offsetof(vertex, texture_coord)));
+    output.vertex_input.bindings.emplace_back(0, static_cast<std::uint32_t>(vertex_size(info.vertices_layout)));
+
+    if(info.vertices_layout == vertex_layout::compact)
+    {
+        output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec2i16, static_cast<std::uint32_t>(offsetof(compact_vertex, position)));
+        output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4u8_norm, static_cast<std::uint32_t>(offsetof(compact_vertex, color)));
+        output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2u16_norm, static_cast<std::uint32_t>(offsetof(compact_vertex, texture_coord)));
+    }
+    else
+    {
+        output.vertex_input.attributes.emplace_back(0, 0, tph::vertex_format::vec3f, static_cast<std::uint32_t>(offsetof(vertex, position)));
+        output.vertex_input.attributes.emplace_back(1, 0, tph::vertex_format::vec4f, static_cast<std::uint32_t>(offsetof(vertex, color)));
+        output.vertex_input.attributes.emplace_back(2, 0, tph::vertex_format::vec2f, static_cast<std::uint32_t>(offsetof(vertex, texture_coord)));
+    }
+
+    if(info.vertices_layout == vertex_layout::particle)
+    {
+        output.vertex_input.bindings.emplace_back(1, static_cast<std::uint32_t>(sizeof(particle_instance)), tph::vertex_input_rate::instance);
+
+        output.vertex_input.attributes.emplace_back(3, 1, tph::vertex_format::vec4f, static_cast<std::uint32_t>(offsetof(particle_instance, position)));
+        output.vertex_input.attributes.emplace_back(4, 1, tph::vertex_format::vec4u8_norm, static_cast<std::uint32_t>(offsetof(particle_instance, color)));
+    }
+
     output.tesselation = info.tesselation;
     output.viewport.viewport_count = 1;
     output.rasterization = info.rasterization;
@@ -282,12 +506,86 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
 }
 
 render_technique::render_technique(const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout, render_technique_options options)
+:render_technique{target->get_render_pass(), 0, info, std::move(layout), options}
+{
+
+}
+
+render_technique::render_technique(tph::render_pass& render_pass, std::uint32_t subpass, const render_technique_info& info, render_layout_ptr layout, render_technique_options options)
 :m_layout{layout ? std::move(layout) : engine::instance().default_render_layout()}
-,m_pipeline{engine::instance().renderer(), target->get_render_pass(), make_info(info, options), m_layout->pipeline_layout()}
+,m_pipeline{engine::instance().renderer(), render_pass, subpass, make_info(info, options), m_layout->pipeline_layout(), engine::instance().pipeline_cache()}
+,m_vertices_layout{info.vertices_layout}
 {
 
 }
 
+std::vector<render_technique_ptr> make_render_techniques(const render_target_ptr& target, std::span<const render_technique_info> infos, render_layout_ptr layout, render_technique_options options, std::uint32_t thread_count)
+{
+    if(!layout)
+    {
+        layout = engine::instance().default_render_layout();
+    }
+
+    if(thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    thread_count = std::min(thread_count, static_cast<std::uint32_t>(std::size(infos)));
+
+    std::vector<render_technique_ptr> output{};
+    output.resize(std::size(infos));
+
+    //Techniques are created on worker threads, they all share the engine's pipeline cache (which is internally synchronized)
+    std::atomic<std::size_t> next{};
+    std::vector<std::exception_ptr> errors{};
+    errors.resize(thread_count);
+
+    const auto worker = [&](std::size_t thread_index)
+    {
+        try
+        {
+            for(auto index{next.fetch_add(1, std::memory_order_relaxed)}; index < std::size(infos); index = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                output[index] = make_render_technique(target, infos[index], layout, options);
+            }
+        }
+        catch(...)
+        {
+            errors[thread_index] = std::current_exception();
+            next.store(std::size(infos), std::memory_order_relaxed);
+        }
+    };
+
+    {
+        std::vector<std::jthread> threads{};
+        threads.reserve(thread_count);
+
+        for(std::uint32_t i{}; i < thread_count; ++i)
+        {
+            threads.emplace_back(worker, i);
+        }
+    }
+
+    for(auto&& error : errors)
+    {
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return output;
+}
+
+std::future<std::vector<render_technique_ptr>> async_make_render_techniques(render_target_ptr target, std::vector<render_technique_info> infos, render_layout_ptr layout, render_technique_options options, std::uint32_t thread_count)
+{
+    return std::async(std::launch::async, [target = std::move(target), infos = std::move(infos), layout = std::move(layout), options, thread_count]() mutable
+    {
+        return make_render_techniques(target, infos, std::move(layout), options, thread_count);
+    });
+}
+
 #ifdef CAPTAL_DEBUG
 void render_technique::set_name(std::string_view name)
 {
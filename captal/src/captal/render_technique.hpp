@@ -27,6 +27,13 @@
 
 #include <memory>
 #include <mutex>
+#include <map>
+#include <compare>
+#include <algorithm>
+#include <optional>
+
+#include <captal_foundation/frame_arena.hpp>
+#include <future>
 
 #include <tephra/shader.hpp>
 #include <tephra/pipeline.hpp>
@@ -36,6 +43,7 @@
 #include "render_target.hpp"
 #include "signal.hpp"
 #include "binding.hpp"
+#include "vertex.hpp"
 
 namespace cpt
 {
@@ -46,6 +54,9 @@ class render_layout;
 
 class CAPTAL_API descriptor_set : public asynchronous_resource
 {
+    friend class descriptor_pool;
+    friend class render_layout;
+
 public:
     descriptor_set() = default;
     explicit descriptor_set(descriptor_pool& parent, tph::descriptor_set set) noexcept;
@@ -74,25 +85,29 @@ public:
 private:
     descriptor_pool* m_parent{};
     tph::descriptor_set m_set{};
+    std::vector<asynchronous_resource_ptr> m_resources{}; //Resources written in the set, released with it
 };
 
 using descriptor_set_ptr = std::shared_ptr<descriptor_set>;
 using descriptor_set_weak_ptr = std::weak_ptr<descriptor_set>;
 
-class CAPTAL_API descriptor_pool
+//Sets are allocated lazily and go back to the pool's free list when their last reference is released.
+//A released set is reused as is, without going through vkFreeDescriptorSets/vkAllocateDescriptorSets.
+class CAPTAL_API descriptor_pool : public std::enable_shared_from_this<descriptor_pool>
 {
 public:
-    static constexpr std::uint32_t pool_size{32};
+    static constexpr std::uint32_t initial_pool_size{32};
+    static constexpr std::uint32_t max_pool_size{4096};
 
 public:
-    explicit descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, tph::descriptor_pool pool);
+    explicit descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, std::span<const tph::descriptor_pool_size> sizes, std::uint32_t capacity);
     ~descriptor_pool() = default;
     descriptor_pool(const descriptor_pool&) = delete;
     descriptor_pool& operator=(const descriptor_pool&) = delete;
     descriptor_pool(descriptor_pool&&) noexcept = delete;
     descriptor_pool& operator=(descriptor_pool&&) noexcept = delete;
 
-    descriptor_set_ptr allocate() noexcept;
+    descriptor_set_ptr allocate();
     bool unused() const noexcept;
 
     render_layout& layout() noexcept
@@ -115,6 +130,11 @@ public:
         return m_pool;
     }
 
+    std::uint32_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -124,10 +144,21 @@ public:
     }
 #endif
 
+private:
+    void release(descriptor_set* set) noexcept;
+
 private:
     render_layout* m_parent{};
+    tph::descriptor_set_layout* m_layout{};
     tph::descriptor_pool m_pool{};
-    std::array<descriptor_set_ptr, pool_size> m_sets{};
+    std::uint32_t m_capacity{};
+    std::vector<std::unique_ptr<descriptor_set>> m_sets{};
+    std::vector<descriptor_set*> m_free{};
+    mutable std::mutex m_mutex{};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
 };
 
 struct render_layout_info
@@ -135,6 +166,7 @@ struct render_layout_info
     std::vector<tph::descriptor_set_layout_binding> bindings{};
     std::vector<tph::push_constant_range> push_constants{};
     std::unordered_map<std::uint32_t, cpt::binding> default_bindings{};
+    bool bindless_textures{}; //The set is the engine's bindless texture table, bindings are ignored and views bind it. Only valid for a user set.
 };
 
 class CAPTAL_API render_layout : public asynchronous_resource
@@ -152,7 +184,18 @@ public:
     render_layout(render_layout&&) noexcept = delete;
     render_layout& operator=(render_layout&&) noexcept = delete;
 
+    //Returns a new set, not written
     descriptor_set_ptr make_set(std::uint32_t layout_index);
+    //Returns a set written with the given bindings, falling back on layout's default bindings.
+    //If a set with the exact same bindings is still alive it is returned instead, so it may be shared.
+    descriptor_set_ptr make_set(std::uint32_t layout_index, const binding_buffer& bindings);
+    //Returns the offsets to bind a set written with the given bindings, one per uniform_buffer_dynamic binding of the layout
+    frame_vector<std::uint32_t> dynamic_offsets(std::uint32_t layout_index, const binding_buffer& bindings) const;
+
+    bool has_dynamic_offsets(std::uint32_t layout_index) const noexcept
+    {
+        return !std::empty(m_layout_data[layout_index].dynamic_bindings);
+    }
 
     tph::descriptor_set_layout& descriptor_set_layout(std::uint32_t layout_index) noexcept
     {
@@ -184,6 +227,11 @@ public:
         return std::size(m_layout_data) - 2;
     }
 
+    std::optional<std::uint32_t> bindless_textures_index() const noexcept
+    {
+        return m_bindless_textures_index;
+    }
+
     tph::pipeline_layout& pipeline_layout() noexcept
     {
         return m_layout;
@@ -206,23 +254,52 @@ public:
 #endif
 
 private:
+    struct set_key_element
+    {
+        const void* resource{};
+        std::uint32_t type{};
+        std::uint32_t part{};
+
+        auto operator<=>(const set_key_element&) const noexcept = default;
+    };
+
+    using set_key = std::vector<set_key_element>;
+
+    //Transparent, so lookups can be done with a frame_vector key without copying it
+    struct set_key_less
+    {
+        using is_transparent = void;
+
+        template<typename Left, typename Right>
+        bool operator()(const Left& left, const Right& right) const noexcept
+        {
+            return std::lexicographical_compare(std::begin(left), std::end(left), std::begin(right), std::end(right));
+        }
+    };
+
     struct layout_data
     {
         tph::descriptor_set_layout layout{};
         std::vector<tph::descriptor_set_layout_binding> bindings{};
+        std::vector<std::uint32_t> dynamic_bindings{};
         binding_buffer default_bindings{};
         std::vector<tph::push_constant_range> push_constants{};
         std::vector<tph::descriptor_pool_size> sizes{};
-        std::vector<std::unique_ptr<descriptor_pool>> pools{};
+        std::vector<std::shared_ptr<descriptor_pool>> pools{};
+        std::map<set_key, descriptor_set_weak_ptr, set_key_less> cache{};
+        std::size_t cache_sweep_threshold{64};
     };
 
     static layout_data make_layout_data(const render_layout_info& info);
     static std::vector<tph::push_constant_range> make_push_constant_ranges(std::span<const layout_data> layouts);
     static std::vector<std::reference_wrapper<tph::descriptor_set_layout>> make_layout_refs(std::span<layout_data> layouts);
 
+    descriptor_set_ptr allocate_set(std::uint32_t layout_index);
+
 private:
     std::vector<layout_data> m_layout_data{};
     tph::pipeline_layout m_layout{};
+    std::optional<std::uint32_t> m_bindless_textures_index{};
     std::mutex m_mutex{};
 
 #ifdef CAPTAL_DEBUG
@@ -236,7 +313,7 @@ using render_layout_weak_ptr = std::weak_ptr<render_layout>;
 template<typename... Args>
 render_layout_ptr make_render_layout(Args&&... args)
 {
-    return std::make_shared<render_layout>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<render_layout>(std::forward<Args>(args)...);
 }
 
 enum class render_technique_options : std::uint32_t
@@ -255,12 +332,15 @@ struct render_technique_info
     tph::pipeline_multisample multisample{};
     tph::pipeline_depth_stencil depth_stencil{};
     tph::pipeline_color_blend color_blend{};
+    vertex_layout vertices_layout{vertex_layout::standard}; //Must match the layout of the renderables drawn with the technique
 };
 
 class CAPTAL_API render_technique : public asynchronous_resource
 {
 public:
     explicit render_technique(const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none);
+    //For render passes that are not owned by a render target, such as the ones built by cpt::render_graph
+    explicit render_technique(tph::render_pass& render_pass, std::uint32_t subpass, const render_technique_info& info, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none);
     ~render_technique() = default;
     render_technique(const render_technique&) = delete;
     render_technique& operator=(const render_technique&) = delete;
@@ -282,6 +362,11 @@ public:
         return m_pipeline;
     }
 
+    vertex_layout vertices_layout() const noexcept
+    {
+        return m_vertices_layout;
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -294,6 +379,7 @@ public:
 private:
     render_layout_ptr m_layout{};
     tph::pipeline m_pipeline{};
+    vertex_layout m_vertices_layout{};
 };
 
 using render_technique_ptr = std::shared_ptr<render_technique>;
@@ -302,9 +388,16 @@ using render_technique_weak_ptr = std::weak_ptr<render_technique>;
 template<typename... Args>
 render_technique_ptr make_render_technique(Args&&... args)
 {
-    return std::make_shared<render_technique>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<render_technique>(std::forward<Args>(args)...);
 }
 
+//Builds one technique per info using up to thread_count worker threads (0 means hardware concurrency).
+//Techniques are returned in the same order as infos. Use it to warm the pipeline cache during loading screens.
+CAPTAL_API std::vector<render_technique_ptr> make_render_techniques(const render_target_ptr& target, std::span<const render_technique_info> infos, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none, std::uint32_t thread_count = 0);
+
+//Same as make_render_techniques, but does not block the calling thread
+CAPTAL_API std::future<std::vector<render_technique_ptr>> async_make_render_techniques(render_target_ptr target, std::vector<render_technique_info> infos, render_layout_ptr layout = nullptr, render_technique_options options = render_technique_options::none, std::uint32_t thread_count = 0);
+
 }
 
 template<> struct cpt::enable_enum_operations<cpt::render_technique_options> {static constexpr bool value{true};};
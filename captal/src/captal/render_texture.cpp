@@ -157,7 +157,7 @@ render_texture::render_texture(std::uint32_t width, std::uint32_t height, const
 ,m_framebuffer{engine::instance().renderer(), get_render_pass(), convert_framebuffer_attachments(m_attachments), width, height, 1}
 ,m_pool{engine::instance().renderer(), tph::command_pool_options::reset}
 {
-    m_frames_data.reserve(4);
+
 }
 
 render_texture::render_texture(texture_ptr texture, tph::sample_count sample_count, tph::texture_format depth_format, tph::texture_layout final_layout)
@@ -171,7 +171,7 @@ render_texture::render_texture(texture_ptr texture, tph::sample_count sample_cou
 ,m_has_depth_stencil{depth_format != tph::texture_format::undefined}
 #endif
 {
-    m_frames_data.reserve(4);
+
 }
 
 render_texture::~render_texture()
@@ -219,12 +219,14 @@ std::optional<frame_render_info> render_texture::begin_render(begin_render_optio
         tph::cmd::reset_query_pool(m_data->buffer, m_data->query_pool, 0, 2);
         tph::cmd::write_timestamp(m_data->buffer, m_data->query_pool, 0, tph::pipeline_stage::top_of_pipe);
 
+        dispatch_computes(frame_render_info{m_data->buffer, m_data->signal, m_data->keeper, m_data->time_signal});
         tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer);
 
         return frame_render_info{m_data->buffer, m_data->signal, m_data->keeper, m_data->time_signal};
     }
     else
     {
+        dispatch_computes(frame_render_info{m_data->buffer, m_data->signal, m_data->keeper});
         tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer);
 
         return frame_render_info{m_data->buffer, m_data->signal, m_data->keeper};
@@ -253,6 +255,12 @@ void render_texture::present()
     tph::submit(engine::instance().renderer(), submit_info, m_data->fence);
     lock.unlock();
 
+    //The frame may never be reused, its resources must not wait for the keeper to be cleared
+    m_data->keeper.submitted([&fence = m_data->fence]()
+    {
+        return fence.try_wait();
+    });
+
     m_data->epoch = m_epoch;
     m_data->submitted = true;
 
@@ -337,6 +345,9 @@ void render_texture::flush_frame_data(frame_data& data)
     }
 
     data.signal();
+
+    //Cached frames are not submitted again, the GPU is done with their resources
+    data.keeper.clear();
 }
 
 void render_texture::reset_frame_data(frame_data& data)
@@ -25,6 +25,8 @@
 
 #include "config.hpp"
 
+#include <deque>
+
 #include <tephra/commands.hpp>
 #include <tephra/synchronization.hpp>
 #include <tephra/query.hpp>
@@ -107,7 +109,7 @@ private:
     std::vector<texture_ptr> m_attachments{};
     tph::framebuffer m_framebuffer{};
     tph::command_pool m_pool{};
-    std::vector<frame_data> m_frames_data{};
+    std::deque<frame_data> m_frames_data{}; //deque: submitted epochs keep references to the fences
     frame_data* m_data{};
 
 #ifdef CAPTAL_DEBUG
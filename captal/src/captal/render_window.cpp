@@ -22,6 +22,8 @@
 
 #include "render_window.hpp"
 
+#include <captal_foundation/frame_arena.hpp>
+
 #include "engine.hpp"
 
 namespace cpt
@@ -309,6 +311,9 @@ std::optional<frame_render_info> render_window::begin_render(begin_render_option
         return std::nullopt;
     }
 
+    //New frame epoch, transient memory of the previous frame can be reclaimed
+    thread_frame_arena().new_frame();
+
     auto& framebuffer{m_framebuffers[m_swapchain->image_index()]};
     update_clear_values(framebuffer);
 
@@ -321,12 +326,14 @@ std::optional<frame_render_info> render_window::begin_render(begin_render_option
         tph::cmd::reset_query_pool(data.buffer, data.query_pool, 0, 2);
         tph::cmd::write_timestamp(data.buffer, data.query_pool, 0, tph::pipeline_stage::top_of_pipe);
 
+        dispatch_computes(frame_render_info{data.buffer, data.signal, data.keeper, data.time_signal});
         tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer);
 
         return frame_render_info{data.buffer, data.signal, data.keeper, data.time_signal};
     }
     else
     {
+        dispatch_computes(frame_render_info{data.buffer, data.signal, data.keeper});
         tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer);
 
         return frame_render_info{data.buffer, data.signal, data.keeper};
@@ -373,6 +380,12 @@ void render_window::present()
     tph::submit(engine::instance().renderer(), submit_info, data.fence);
     lock.unlock();
 
+    //The window may stop presenting, its resources must not wait for the keeper to be cleared
+    data.keeper.submitted([&fence = data.fence]()
+    {
+        return fence.try_wait();
+    });
+
     data.submitted = true;
 
     const auto status{m_swapchain->present(data.image_presentable)};
@@ -542,6 +555,9 @@ void render_window::flush_frame_data(frame_data& data)
     }
 
     data.signal();
+
+    //The same commands are submitted again, their resources move to a new epoch so the previous one can complete
+    data.keeper.renew();
 }
 
 void render_window::reset_frame_data(frame_data& data)
@@ -163,7 +163,7 @@ private:
     bool m_fake_frame{};
 
     tph::command_pool m_pool{};
-    std::vector<frame_data> m_frames_data{};
+    std::vector<frame_data> m_frames_data{}; //Never grows once set up, submitted epochs keep references to the fences
     std::vector<tph::framebuffer> m_framebuffers{};
 
 #ifdef CAPTAL_DEBUG
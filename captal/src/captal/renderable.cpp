@@ -22,7 +22,10 @@
 
 #include "renderable.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <cassert>
+#include <cstring>
 
 #include <tephra/commands.hpp>
 
@@ -31,41 +34,43 @@
 namespace cpt
 {
 
-static std::array<buffer_part, 2> compute_buffer_parts(std::uint32_t vertex_count)
+static std::array<buffer_part, 2> compute_buffer_parts(std::uint32_t vertex_count, vertex_layout layout)
 {
     return std::array<buffer_part, 2>
     {
         buffer_part{buffer_part_type::uniform, sizeof(basic_renderable::uniform_data)},
-        buffer_part{buffer_part_type::vertex, vertex_count * sizeof(vertex)},
+        buffer_part{buffer_part_type::vertex, vertex_count * vertex_size(layout)},
     };
 }
 
-static std::array<buffer_part, 3> compute_buffer_parts(std::uint32_t vertex_count, std::uint32_t index_count)
+static std::array<buffer_part, 3> compute_buffer_parts(std::uint32_t vertex_count, std::uint32_t index_count, vertex_layout layout)
 {
     return std::array<buffer_part, 3>
     {
         buffer_part{buffer_part_type::uniform, sizeof(basic_renderable::uniform_data)},
-        buffer_part{buffer_part_type::vertex, vertex_count * sizeof(vertex)},
+        buffer_part{buffer_part_type::vertex, vertex_count * vertex_size(layout)},
         buffer_part{buffer_part_type::index, index_count * sizeof(std::uint32_t)},
     };
 }
 
-basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t uniform_index)
+basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t uniform_index, vertex_layout layout)
 :m_vertex_count{vertex_count}
 ,m_uniform_index{uniform_index}
+,m_vertices_layout{layout}
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, layout))};
     m_buffer = buffer.get();
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
 }
 
-basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index)
+basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index, vertex_layout layout)
 :m_vertex_count{vertex_count}
 ,m_index_count{index_count}
 ,m_uniform_index{uniform_index}
+,m_vertices_layout{layout}
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count, layout))};
     m_buffer = buffer.get();
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
@@ -73,11 +78,22 @@ basic_renderable::basic_renderable(std::uint32_t vertex_count, std::uint32_t ind
 
 void basic_renderable::set_vertices(std::span<const vertex> vertices) noexcept
 {
+    assert(m_vertices_layout != vertex_layout::compact && "cpt::basic_renderable::set_vertices called with standard vertices on basic_renderable with compact vertices.");
     assert(std::size(vertices) == m_vertex_count && "cpt::basic_renderable::set_vertices called with a wrong number of vertices.");
 
     std::memcpy(&m_buffer->get<vertex>(1), std::data(vertices), std::size(vertices) * sizeof(vertex));
 
-    m_upload_vertices = true;
+    mark_vertices(0, m_vertex_count);
+}
+
+void basic_renderable::set_vertices(std::span<const compact_vertex> vertices) noexcept
+{
+    assert(m_vertices_layout == vertex_layout::compact && "cpt::basic_renderable::set_vertices called with compact vertices on basic_renderable with standard vertices.");
+    assert(std::size(vertices) == m_vertex_count && "cpt::basic_renderable::set_vertices called with a wrong number of vertices.");
+
+    std::memcpy(&m_buffer->get<compact_vertex>(1), std::data(vertices), std::size(vertices) * sizeof(compact_vertex));
+
+    mark_vertices(0, m_vertex_count);
 }
 
 void basic_renderable::set_indices(std::span<const std::uint32_t> indices) noexcept
@@ -87,90 +103,57 @@ void basic_renderable::set_indices(std::span<const std::uint32_t> indices) noexc
 
     std::memcpy(&m_buffer->get<std::uint32_t>(2), std::data(indices), std::size(indices) * sizeof(std::uint32_t));
 
-    m_upload_indices = true;
+    mark_dirty(m_indices_ranges, 0, m_index_count);
 }
 
 void basic_renderable::reset(std::uint32_t vertex_count)
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, m_vertices_layout))};
 
     m_buffer = buffer.get();
     m_vertex_count = vertex_count;
     m_upload_model = true;
+    m_update_bounds = true;
+    m_vertices_ranges.count = 0;
+    m_indices_ranges.count = 0;
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+    ++m_descriptors_epoch;
 }
 
 void basic_renderable::reset(std::uint32_t vertex_count, std::uint32_t index_count)
 {
-    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count))};
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count, m_vertices_layout))};
 
     m_buffer = buffer.get();
     m_vertex_count = vertex_count;
     m_index_count = index_count;
     m_upload_model = true;
+    m_update_bounds = true;
+    m_vertices_ranges.count = 0;
+    m_indices_ranges.count = 0;
 
     m_bindings.set(m_uniform_index, uniform_buffer_part{std::move(buffer), 0});
+    ++m_descriptors_epoch;
 }
 
 void basic_renderable::bind(frame_render_info info, cpt::view& view)
 {
-    const auto& layout{view.render_technique()->layout()};
-
-    const auto write_set = [this, &layout](descriptor_set_data& data)
-    {
-        #ifdef CAPTAL_DEBUG
-        if(!std::empty(m_name))
-        {
-            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
-
-            tph::set_object_name(engine::instance().renderer(), data.set->set(), m_name + " descriptor set for render layout " + layout_name);
-        }
-        #endif
+    assert(view.render_technique()->vertices_layout() == m_vertices_layout && "cpt::basic_renderable::bind called with a view whose render technique does not match the vertex layout of the renderable.");
 
-        const auto to_bind{layout->bindings(render_layout::renderable_index)};
-
-        std::vector<tph::descriptor_write> writes{};
-        writes.reserve(std::size(to_bind));
-
-        for(auto&& binding : to_bind)
-        {
-            const auto local{m_bindings.try_get(binding.binding)};
-
-            if(local)
-            {
-                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *local));
-                data.to_keep.emplace_back(get_binding_resource(*local));
-            }
-            else
-            {
-                const auto fallback{layout->default_binding(render_layout::renderable_index, binding.binding)};
-                assert(fallback && "cpt::basic_renderable::bind can not find any suitable binding, neither the renderable nor the render layout have a binding for specified index.");
-
-                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *fallback));
-                data.to_keep.emplace_back(get_binding_resource(*fallback));
-            }
-        }
-
-        tph::write_descriptors(engine::instance().renderer(), writes);
-    };
+    const auto& layout{view.render_technique()->layout()};
 
     auto it{m_sets.find(layout)};
 
     if(it == std::end(m_sets)) //New layout
     {
-        it = m_sets.emplace(layout, descriptor_set_data{layout->make_set(render_layout::renderable_index), std::vector<asynchronous_resource_ptr>{}, m_descriptors_epoch}).first;
-
-        write_set(it->second);
+        it = m_sets.emplace(layout, descriptor_set_data{layout->make_set(render_layout::renderable_index, m_bindings), m_descriptors_epoch}).first;
     }
     else if(it->second.epoch < m_descriptors_epoch) //Already known layout but not up to date
     {
         it->second.set.reset();
-        it->second.set = layout->make_set(1);
-        it->second.to_keep.clear();
+        it->second.set = layout->make_set(render_layout::renderable_index, m_bindings);
         it->second.epoch = m_descriptors_epoch;
-
-        write_set(it->second);
     }
 
     auto buffer{m_buffer->get_buffer()};
@@ -180,12 +163,22 @@ void basic_renderable::bind(frame_render_info info, cpt::view& view)
         tph::cmd::bind_index_buffer(info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(2), tph::index_type::uint32);
     }
 
-    tph::cmd::bind_vertex_buffer (info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(1));
-    tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set(), layout->pipeline_layout());
+    tph::cmd::bind_vertex_buffer(info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(1));
+
+    //With a dynamic uniform binding the set is shared by the renderables of the same heap, only the offsets differ
+    if(layout->has_dynamic_offsets(render_layout::renderable_index))
+    {
+        const auto offsets{layout->dynamic_offsets(render_layout::renderable_index, m_bindings)};
+
+        tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set(), layout->pipeline_layout(), offsets);
+    }
+    else
+    {
+        tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set(), layout->pipeline_layout());
+    }
 
     m_push_constants.push(info.buffer, layout, render_layout::renderable_index);
 
-    info.keeper.keep(std::begin(it->second.to_keep), std::end(it->second.to_keep));
     info.keeper.keep(it->second.set);
 }
 
@@ -219,16 +212,16 @@ void basic_renderable::upload(memory_transfer_info info)
         keep = true;
     }
 
-    if(std::exchange(m_upload_vertices, false))
+    if(m_vertices_ranges.count > 0)
     {
-        m_buffer->upload(1);
+        upload_dirty(m_vertices_ranges, 1, vertex_size(m_vertices_layout));
 
         keep = true;
     }
 
-    if(std::exchange(m_upload_indices, false))
+    if(m_indices_ranges.count > 0)
     {
-        m_buffer->upload(2);
+        upload_dirty(m_indices_ranges, 2, sizeof(std::uint32_t));
 
         keep = true;
     }
@@ -239,6 +232,140 @@ void basic_renderable::upload(memory_transfer_info info)
     }
 }
 
+void basic_renderable::mark_dirty(dirty_ranges& ranges, std::uint32_t first, std::uint32_t count) noexcept
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    dirty_range range{first, first + count};
+
+    const auto begin{std::begin(ranges.ranges)};
+    const auto end  {begin + ranges.count};
+
+    //First range that ends at or after the new one begins, i.e. the first one that may touch it
+    const auto predicate = [](const dirty_range& range, std::uint32_t value)
+    {
+        return range.end < value;
+    };
+
+    const auto it{std::lower_bound(begin, end, range.begin, predicate)};
+
+    auto last{it};
+    while(last != end && last->begin <= range.end)
+    {
+        range.begin = std::min(range.begin, last->begin);
+        range.end = std::max(range.end, last->end);
+        ++last;
+    }
+
+    if(it != last) //Merged into existing ranges
+    {
+        *it = range;
+        std::move(last, end, it + 1);
+        ranges.count -= static_cast<std::size_t>(last - it - 1);
+
+        return;
+    }
+
+    std::move_backward(it, end, end + 1);
+    *it = range;
+    ++ranges.count;
+
+    if(ranges.count > dirty_ranges::max_ranges)
+    {
+        std::size_t closest{};
+        std::uint32_t closest_gap{std::numeric_limits<std::uint32_t>::max()};
+
+        for(std::size_t i{}; i < ranges.count - 1; ++i)
+        {
+            const std::uint32_t gap{ranges.ranges[i + 1].begin - ranges.ranges[i].end};
+
+            if(gap < closest_gap)
+            {
+                closest = i;
+                closest_gap = gap;
+            }
+        }
+
+        ranges.ranges[closest].end = ranges.ranges[closest + 1].end;
+        std::move(begin + closest + 2, begin + ranges.count, begin + closest + 1);
+        --ranges.count;
+    }
+}
+
+void basic_renderable::upload_dirty(dirty_ranges& ranges, std::size_t part, std::uint64_t element_size)
+{
+    for(std::size_t i{}; i < ranges.count; ++i)
+    {
+        const auto& range{ranges.ranges[i]};
+
+        m_buffer->upload(part, range.begin * element_size, (range.end - range.begin) * element_size);
+    }
+
+    ranges.count = 0;
+}
+
+bounding_box basic_renderable::local_bounds() const noexcept
+{
+    if(std::exchange(m_update_bounds, false))
+    {
+        if(m_vertex_count == 0)
+        {
+            m_local_bounds = bounding_box{};
+        }
+        else if(m_vertices_layout == vertex_layout::compact)
+        {
+            const auto vertices{ccompact_vertices()};
+
+            std::array<std::int16_t, 2> min{vertices[0].position};
+            std::array<std::int16_t, 2> max{vertices[0].position};
+
+            for(auto&& vertex : vertices)
+            {
+                min = std::array<std::int16_t, 2>{std::min(min[0], vertex.position[0]), std::min(min[1], vertex.position[1])};
+                max = std::array<std::int16_t, 2>{std::max(max[0], vertex.position[0]), std::max(max[1], vertex.position[1])};
+            }
+
+            m_local_bounds = bounding_box{vec2f{static_cast<float>(min[0]), static_cast<float>(min[1])}, vec2f{static_cast<float>(max[0]), static_cast<float>(max[1])}};
+        }
+        else
+        {
+            const auto vertices{cvertices()};
+
+            vec2f min{vertices[0].position};
+            vec2f max{vertices[0].position};
+
+            for(auto&& vertex : vertices)
+            {
+                min = vec2f{std::min(min.x(), vertex.position.x()), std::min(min.y(), vertex.position.y())};
+                max = vec2f{std::max(max.x(), vertex.position.x()), std::max(max.y(), vertex.position.y())};
+            }
+
+            m_local_bounds = bounding_box{min, max};
+        }
+    }
+
+    return m_local_bounds;
+}
+
+bounding_box basic_renderable::global_bounds() const noexcept
+{
+    const auto bounds{local_bounds()};
+    const auto model {cpt::model(m_position, m_rotation, vec3f{0.0f, 0.0f, 1.0f}, m_scale, m_origin)};
+
+    const std::array corners
+    {
+        model * vec4f{bounds.top_left.x(),     bounds.top_left.y(),     0.0f, 1.0f},
+        model * vec4f{bounds.bottom_right.x(), bounds.top_left.y(),     0.0f, 1.0f},
+        model * vec4f{bounds.bottom_right.x(), bounds.bottom_right.y(), 0.0f, 1.0f},
+        model * vec4f{bounds.top_left.x(),     bounds.bottom_right.y(), 0.0f, 1.0f},
+    };
+
+    return make_bounding_box(std::begin(corners), std::end(corners));
+}
+
 void basic_renderable::set_binding(std::uint32_t index, cpt::binding binding)
 {
     assert(index != m_uniform_index && "cpt::basic_renderable::set_binding must never be called with index == uniform_index.");
@@ -290,11 +417,26 @@ sprite::sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, c
     set_texture(std::move(texture));
 }
 
+sprite::sprite(const texture_region& region, const color& color)
+:basic_renderable{4, 6, 0}
+,m_width{region.width}
+,m_height{region.height}
+{
+    init(color);
+    set_texture(region);
+}
+
 void sprite::set_texture(texture_ptr texture)
 {
     set_binding(1, std::move(texture));
 }
 
+void sprite::set_texture(const texture_region& region)
+{
+    set_texture(region.texture);
+    set_texture_rect(static_cast<std::int32_t>(region.x), static_cast<std::int32_t>(region.y), region.width, region.height);
+}
+
 void sprite::set_color(const color& color) noexcept
 {
     const auto vertices{basic_renderable::vertices()};
@@ -388,7 +530,7 @@ void polygon::set_outline_color(const color& color) noexcept
 
 void polygon::set_point_color(std::uint32_t point, const color& color) noexcept
 {
-    vertices()[point + 1].color = static_cast<vec4f>(color);
+    vertices(point + 1, 1)[0].color = static_cast<vec4f>(color);
 }
 
 void polygon::init(std::vector<vec2f> points, const color& color)
@@ -421,8 +563,8 @@ void polygon::init(std::vector<vec2f> points, const color& color)
     }
 }
 
-tilemap::tilemap(std::uint32_t width, std::uint32_t height, std::uint32_t tile_width, std::uint32_t tile_height)
-:basic_renderable{width * height * 4, width * height * 6, 0}
+tilemap::tilemap(std::uint32_t width, std::uint32_t height, std::uint32_t tile_width, std::uint32_t tile_height, vertex_layout layout)
+:basic_renderable{width * height * 4, width * height * 6, 0, layout}
 ,m_width{width}
 ,m_height{height}
 ,m_tile_width{tile_width}
@@ -431,8 +573,8 @@ tilemap::tilemap(std::uint32_t width, std::uint32_t height, std::uint32_t tile_w
     init();
 }
 
-tilemap::tilemap(std::uint32_t width, std::uint32_t height, const tileset& tileset)
-:basic_renderable{width * height * 4, width * height * 6, 0}
+tilemap::tilemap(std::uint32_t width, std::uint32_t height, const tileset& tileset, vertex_layout layout)
+:basic_renderable{width * height * 4, width * height * 6, 0, layout}
 ,m_width{width}
 ,m_height{height}
 ,m_tile_width{tileset.tile_width()}
@@ -449,7 +591,20 @@ void tilemap::set_texture(texture_ptr texture)
 
 void tilemap::set_color(std::uint32_t row, std::uint32_t col, const color& color) noexcept
 {
-    const auto vertices{basic_renderable::vertices().subspan((row * m_width + col) * 4)};
+    if(vertices_layout() == vertex_layout::compact)
+    {
+        const auto vertices{basic_renderable::compact_vertices((row * m_width + col) * 4, 4)};
+        const auto packed{pack_color(static_cast<vec4f>(color))};
+
+        vertices[0].color = packed;
+        vertices[1].color = packed;
+        vertices[2].color = packed;
+        vertices[3].color = packed;
+
+        return;
+    }
+
+    const auto vertices{basic_renderable::vertices((row * m_width + col) * 4, 4)};
 
     vertices[0].color = static_cast<vec4f>(color);
     vertices[1].color = static_cast<vec4f>(color);
@@ -473,17 +628,63 @@ void tilemap::set_texture_rect(std::uint32_t row, std::uint32_t col, std::int32_
 
 void tilemap::set_texture_rect(std::uint32_t row, std::uint32_t col, const tileset::texture_rect& rect) noexcept
 {
-    const auto vertices{basic_renderable::vertices().subspan((row * m_width + col) * 4)};
+    set_relative_texture_coords(row, col, rect.top_left.x(), rect.top_left.y(), rect.bottom_right.x(), rect.bottom_right.y());
+}
+
+void tilemap::set_texture_rects(std::uint32_t row, std::uint32_t col, std::span<const tileset::texture_rect> rects) noexcept
+{
+    const std::uint32_t first{row * m_width + col};
+    const auto count{static_cast<std::uint32_t>(std::size(rects))};
 
-    vertices[0].texture_coord = rect.top_left;
-    vertices[1].texture_coord = vec2f{rect.bottom_right.x(), rect.top_left.y()};
-    vertices[2].texture_coord = rect.bottom_right;
-    vertices[3].texture_coord = vec2f{rect.top_left.x(), rect.bottom_right.y()};
+    assert(first + count <= m_width * m_height && "cpt::tilemap::set_texture_rects called with too many rects.");
+
+    if(vertices_layout() == vertex_layout::compact)
+    {
+        const auto vertices{basic_renderable::compact_vertices(first * 4, count * 4)};
+
+        for(std::uint32_t i{}; i < count; ++i)
+        {
+            const auto& rect{rects[i]};
+            const auto current_vertices{vertices.subspan(i * 4)};
+
+            current_vertices[0].texture_coord = pack_texture_coord(rect.top_left);
+            current_vertices[1].texture_coord = pack_texture_coord(vec2f{rect.bottom_right.x(), rect.top_left.y()});
+            current_vertices[2].texture_coord = pack_texture_coord(rect.bottom_right);
+            current_vertices[3].texture_coord = pack_texture_coord(vec2f{rect.top_left.x(), rect.bottom_right.y()});
+        }
+
+        return;
+    }
+
+    const auto vertices{basic_renderable::vertices(first * 4, count * 4)};
+
+    for(std::uint32_t i{}; i < count; ++i)
+    {
+        const auto& rect{rects[i]};
+        const auto current_vertices{vertices.subspan(i * 4)};
+
+        current_vertices[0].texture_coord = rect.top_left;
+        current_vertices[1].texture_coord = vec2f{rect.bottom_right.x(), rect.top_left.y()};
+        current_vertices[2].texture_coord = rect.bottom_right;
+        current_vertices[3].texture_coord = vec2f{rect.top_left.x(), rect.bottom_right.y()};
+    }
 }
 
 void tilemap::set_relative_texture_coords(std::uint32_t row, std::uint32_t col, float x1, float y1, float x2, float y2) noexcept
 {
-    const auto vertices{basic_renderable::vertices().subspan((row * m_width + col) * 4)};
+    if(vertices_layout() == vertex_layout::compact)
+    {
+        const auto vertices{basic_renderable::compact_vertices((row * m_width + col) * 4, 4)};
+
+        vertices[0].texture_coord = pack_texture_coord(vec2f{x1, y1});
+        vertices[1].texture_coord = pack_texture_coord(vec2f{x2, y1});
+        vertices[2].texture_coord = pack_texture_coord(vec2f{x2, y2});
+        vertices[3].texture_coord = pack_texture_coord(vec2f{x1, y2});
+
+        return;
+    }
+
+    const auto vertices{basic_renderable::vertices((row * m_width + col) * 4, 4)};
 
     vertices[0].texture_coord = vec2f{x1, y1};
     vertices[1].texture_coord = vec2f{x2, y1};
@@ -498,8 +699,50 @@ void tilemap::set_relative_texture_rect(std::uint32_t row, std::uint32_t col, fl
 
 void tilemap::init()
 {
+    const auto indices{basic_renderable::indices()};
+
+    for(std::uint32_t j{}; j < m_height; ++j)
+    {
+        for(std::uint32_t i{}; i < m_width; ++i)
+        {
+            const auto shift{(j * m_width + i) * 4};
+            const auto current_indices{indices.subspan((j * m_width + i) * 6)};
+            current_indices[0] = shift + 0;
+            current_indices[1] = shift + 1;
+            current_indices[2] = shift + 2;
+            current_indices[3] = shift + 2;
+            current_indices[4] = shift + 3;
+            current_indices[5] = shift + 0;
+        }
+    }
+
+    if(vertices_layout() == vertex_layout::compact)
+    {
+        assert(m_width * m_tile_width <= 32767 && m_height * m_tile_height <= 32767 && "cpt::tilemap is too large for compact vertices.");
+
+        const auto vertices{basic_renderable::compact_vertices()};
+
+        for(std::uint32_t j{}; j < m_height; ++j)
+        {
+            for(std::uint32_t i{}; i < m_width; ++i)
+            {
+                const auto x1{static_cast<std::int16_t>(i * m_tile_width)};
+                const auto y1{static_cast<std::int16_t>(j * m_tile_height)};
+                const auto x2{static_cast<std::int16_t>((i + 1) * m_tile_width)};
+                const auto y2{static_cast<std::int16_t>((j + 1) * m_tile_height)};
+
+                const auto current_vertices{vertices.subspan((j * m_width + i) * 4)};
+                current_vertices[0] = compact_vertex{{x1, y1}, {255, 255, 255, 255}};
+                current_vertices[1] = compact_vertex{{x2, y1}, {255, 255, 255, 255}};
+                current_vertices[2] = compact_vertex{{x2, y2}, {255, 255, 255, 255}};
+                current_vertices[3] = compact_vertex{{x1, y2}, {255, 255, 255, 255}};
+            }
+        }
+
+        return;
+    }
+
     const auto vertices{basic_renderable::vertices()};
-    const auto indices {basic_renderable::indices()};
 
     for(std::uint32_t j{}; j < m_height; ++j)
     {
@@ -514,17 +757,145 @@ void tilemap::init()
             current_vertices[1].color = vec4f{1.0f, 1.0f, 1.0f, 1.0f};
             current_vertices[2].color = vec4f{1.0f, 1.0f, 1.0f, 1.0f};
             current_vertices[3].color = vec4f{1.0f, 1.0f, 1.0f, 1.0f};
-
-            const auto shift{(j * m_width + i) * 4};
-            const auto current_indices{indices.subspan((j * m_width + i) * 6)};
-            current_indices[0] = shift + 0;
-            current_indices[1] = shift + 1;
-            current_indices[2] = shift + 2;
-            current_indices[3] = shift + 2;
-            current_indices[4] = shift + 3;
-            current_indices[5] = shift + 0;
         }
     }
 }
 
+tile_layer::tile_layer(std::uint32_t width, std::uint32_t height, const tileset& tileset, const color& color)
+:basic_renderable{4, 6, 0}
+,m_width{width}
+,m_height{height}
+,m_tile_width{tileset.tile_width()}
+,m_tile_height{tileset.tile_height()}
+,m_tiles(align_up(width * height, 2u), no_tile)
+,m_dirty_end{static_cast<std::uint32_t>(std::size(m_tiles))}
+{
+    assert(width > 0 && height > 0 && "cpt::tile_layer created with null size.");
+
+    const auto& texture{tileset.texture()};
+
+    m_header.width = width;
+    m_header.height = height;
+    m_header.tile_size[0] = static_cast<float>(m_tile_width) / static_cast<float>(texture->width());
+    m_header.tile_size[1] = static_cast<float>(m_tile_height) / static_cast<float>(texture->height());
+    m_header.columns = tileset.col_count();
+
+    //The shader computes tile coordinates from the texture origin
+    assert(tileset.x() == 0 && tileset.y() == 0 && "cpt::tile_layer does not support tilesets taken from a texture region.");
+
+    //Index 0xFFFF is reserved for no_tile
+    assert(tileset.col_count() * tileset.row_count() <= no_tile && "cpt::tile_layer tileset has too many tiles.");
+
+    m_tiles_buffer = make_storage_buffer(header_size + std::size(m_tiles) * sizeof(std::uint16_t), tph::buffer_usage::transfer_destination);
+
+    set_indices(std::array<std::uint32_t, 6>{0, 1, 2, 2, 3, 0});
+
+    const float map_width {static_cast<float>(width * m_tile_width)};
+    const float map_height{static_cast<float>(height * m_tile_height)};
+    const float cols{static_cast<float>(width)};
+    const float rows{static_cast<float>(height)};
+
+    //Texture coordinates are expressed in cells, the shader splits them into cell index and position within the tile
+    const auto vertices{basic_renderable::vertices()};
+    vertices[0] = vertex{vec3f{0.0f, 0.0f, 0.0f}, vec4f{}, vec2f{0.0f, 0.0f}};
+    vertices[1] = vertex{vec3f{map_width, 0.0f, 0.0f}, vec4f{}, vec2f{cols, 0.0f}};
+    vertices[2] = vertex{vec3f{map_width, map_height, 0.0f}, vec4f{}, vec2f{cols, rows}};
+    vertices[3] = vertex{vec3f{0.0f, map_height, 0.0f}, vec4f{}, vec2f{0.0f, rows}};
+
+    set_color(color);
+    set_binding(1, texture);
+    set_binding(tiles_binding, m_tiles_buffer);
+}
+
+void tile_layer::upload(memory_transfer_info info)
+{
+    basic_renderable::upload(info);
+
+    if(!m_upload_header && m_dirty_begin == m_dirty_end)
+    {
+        return;
+    }
+
+    //Tiles are packed two per 32-bit word on the GPU side, keep copies word aligned
+    const std::uint32_t first{m_upload_header ? 0 : m_dirty_begin & ~1u};
+    const std::uint32_t last {align_up(m_dirty_end, 2u)};
+
+    //The first upload also writes the header, the tile range then starts right after it
+    const std::uint64_t tiles_size        {(last - first) * sizeof(std::uint16_t)};
+    const std::uint64_t total_size        {(m_upload_header ? header_size : 0) + tiles_size};
+    const std::uint64_t destination_offset{m_upload_header ? 0 : header_size + first * sizeof(std::uint16_t)};
+
+    const auto staging{engine::instance().transfer_scheduler().stage(total_size)};
+    auto* const data{reinterpret_cast<std::uint8_t*>(staging.data)};
+
+    if(m_upload_header)
+    {
+        std::memcpy(data, &m_header, header_size);
+        std::memcpy(data + header_size, std::data(m_tiles) + first, tiles_size);
+    }
+    else
+    {
+        std::memcpy(data, std::data(m_tiles) + first, tiles_size);
+    }
+
+    tph::cmd::copy(info.buffer, staging.buffer, m_tiles_buffer->get_buffer(), tph::buffer_copy{staging.offset, destination_offset, total_size});
+
+    tph::buffer_memory_barrier barrier{m_tiles_buffer->get_buffer()};
+    barrier.offset = destination_offset;
+    barrier.size = total_size;
+    barrier.source_access = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+
+    tph::cmd::pipeline_barrier(info.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, std::span{&barrier, 1}, {});
+
+    info.keeper.keep(m_tiles_buffer);
+
+    m_upload_header = false;
+    m_dirty_begin = 0;
+    m_dirty_end = 0;
+}
+
+void tile_layer::set_color(const color& color) noexcept
+{
+    for(auto& vertex : basic_renderable::vertices())
+    {
+        vertex.color = static_cast<vec4f>(color);
+    }
+}
+
+void tile_layer::set_tile(std::uint32_t row, std::uint32_t col, std::uint16_t tile) noexcept
+{
+    assert(row < m_height && col < m_width && "cpt::tile_layer::set_tile called with out of bounds cell.");
+
+    const std::uint32_t index{row * m_width + col};
+
+    if(m_tiles[index] != tile)
+    {
+        m_tiles[index] = tile;
+        mark_dirty(index, index + 1);
+    }
+}
+
+void tile_layer::set_tiles(std::span<const std::uint16_t> tiles) noexcept
+{
+    assert(std::size(tiles) == m_width * m_height && "cpt::tile_layer::set_tiles called with wrong tile count.");
+
+    std::copy(std::begin(tiles), std::end(tiles), std::begin(m_tiles));
+    mark_dirty(0, static_cast<std::uint32_t>(std::size(tiles)));
+}
+
+void tile_layer::mark_dirty(std::uint32_t first, std::uint32_t last) noexcept
+{
+    if(m_dirty_begin == m_dirty_end)
+    {
+        m_dirty_begin = first;
+        m_dirty_end = last;
+    }
+    else
+    {
+        m_dirty_begin = std::min(m_dirty_begin, first);
+        m_dirty_end = std::max(m_dirty_end, last);
+    }
+}
+
 }
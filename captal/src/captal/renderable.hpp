@@ -31,6 +31,7 @@
 #include <concepts>
 #include <numbers>
 
+#include "algorithm.hpp"
 #include "asynchronous_resource.hpp"
 #include "uniform_buffer.hpp"
 #include "binding.hpp"
@@ -38,6 +39,7 @@
 #include "view.hpp"
 #include "vertex.hpp"
 #include "texture.hpp"
+#include "storage_buffer.hpp"
 
 namespace cpt
 {
@@ -82,6 +84,9 @@ concept renderable = requires(T r, const T cr,
     {cr.rotation()} -> std::convertible_to<float>;
     {cr.hidden()}   -> std::convertible_to<bool>;
 
+    {cr.local_bounds()}  -> std::convertible_to<bounding_box>;
+    {cr.global_bounds()} -> std::convertible_to<bounding_box>;
+
     {r.vertices()}   -> std::convertible_to<std::span<vertex>>;
     {cr.vertices()}  -> std::convertible_to<std::span<const vertex>>;
     {cr.cvertices()} -> std::convertible_to<std::span<const vertex>>;
@@ -101,8 +106,8 @@ public:
 
 protected:
     basic_renderable() = default;
-    explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t uniform_index);
-    explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index);
+    explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t uniform_index, vertex_layout layout = vertex_layout::standard);
+    explicit basic_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t uniform_index, vertex_layout layout = vertex_layout::standard);
 
     ~basic_renderable() = default;
     basic_renderable(const basic_renderable&) = delete;
@@ -111,6 +116,7 @@ protected:
     basic_renderable& operator=(basic_renderable&&) noexcept = default;
 
     void set_vertices(std::span<const vertex> vertices) noexcept;
+    void set_vertices(std::span<const compact_vertex> vertices) noexcept;
     void set_indices(std::span<const std::uint32_t> indices) noexcept;
 
     void reset(std::uint32_t vertex_count);
@@ -245,13 +251,36 @@ public:
         return m_hidden;
     }
 
+    //Bounding box of the vertices, in local space (before model transformation)
+    bounding_box local_bounds() const noexcept;
+    //Bounding box of the vertices, in world space (after model transformation)
+    bounding_box global_bounds() const noexcept;
+
+    vertex_layout vertices_layout() const noexcept
+    {
+        return m_vertices_layout;
+    }
+
     std::span<vertex> vertices() noexcept
     {
-        m_upload_vertices = true;
+        assert(m_vertices_layout != vertex_layout::compact && "cpt::basic_renderable::vertices called on basic_renderable with compact vertices");
+
+        mark_vertices(0, m_vertex_count);
 
         return std::span{&m_buffer->get<vertex>(1), static_cast<std::size_t>(m_vertex_count)};
     }
 
+    //Only the returned range is uploaded, prefer this over vertices() when editing a few vertices
+    std::span<vertex> vertices(std::uint32_t first, std::uint32_t count) noexcept
+    {
+        assert(m_vertices_layout != vertex_layout::compact && "cpt::basic_renderable::vertices called on basic_renderable with compact vertices");
+        assert(first + count <= m_vertex_count && "cpt::basic_renderable::vertices called with out of bounds range");
+
+        mark_vertices(first, count);
+
+        return std::span{&m_buffer->get<vertex>(1) + first, static_cast<std::size_t>(count)};
+    }
+
     std::span<const vertex> vertices() const noexcept
     {
         return cvertices();
@@ -259,18 +288,61 @@ public:
 
     std::span<const vertex> cvertices() const noexcept
     {
+        assert(m_vertices_layout != vertex_layout::compact && "cpt::basic_renderable::cvertices called on basic_renderable with compact vertices");
+
         return std::span{&m_buffer->get<const vertex>(1), static_cast<std::size_t>(m_vertex_count)};
     }
 
+    std::span<compact_vertex> compact_vertices() noexcept
+    {
+        assert(m_vertices_layout == vertex_layout::compact && "cpt::basic_renderable::compact_vertices called on basic_renderable with standard vertices");
+
+        mark_vertices(0, m_vertex_count);
+
+        return std::span{&m_buffer->get<compact_vertex>(1), static_cast<std::size_t>(m_vertex_count)};
+    }
+
+    std::span<compact_vertex> compact_vertices(std::uint32_t first, std::uint32_t count) noexcept
+    {
+        assert(m_vertices_layout == vertex_layout::compact && "cpt::basic_renderable::compact_vertices called on basic_renderable with standard vertices");
+        assert(first + count <= m_vertex_count && "cpt::basic_renderable::compact_vertices called with out of bounds range");
+
+        mark_vertices(first, count);
+
+        return std::span{&m_buffer->get<compact_vertex>(1) + first, static_cast<std::size_t>(count)};
+    }
+
+    std::span<const compact_vertex> compact_vertices() const noexcept
+    {
+        return ccompact_vertices();
+    }
+
+    std::span<const compact_vertex> ccompact_vertices() const noexcept
+    {
+        assert(m_vertices_layout == vertex_layout::compact && "cpt::basic_renderable::ccompact_vertices called on basic_renderable with standard vertices");
+
+        return std::span{&m_buffer->get<const compact_vertex>(1), static_cast<std::size_t>(m_vertex_count)};
+    }
+
     std::span<std::uint32_t> indices() noexcept
     {
         assert(m_index_count > 0 && "cpt::basic_renderable::get_indices called on basic_renderable with no index buffer");
 
-        m_upload_indices = true;
+        mark_dirty(m_indices_ranges, 0, m_index_count);
 
         return std::span{&m_buffer->get<std::uint32_t>(2), static_cast<std::size_t>(m_index_count)};
     }
 
+    std::span<std::uint32_t> indices(std::uint32_t first, std::uint32_t count) noexcept
+    {
+        assert(m_index_count > 0 && "cpt::basic_renderable::get_indices called on basic_renderable with no index buffer");
+        assert(first + count <= m_index_count && "cpt::basic_renderable::indices called with out of bounds range");
+
+        mark_dirty(m_indices_ranges, first, count);
+
+        return std::span{&m_buffer->get<std::uint32_t>(2) + first, static_cast<std::size_t>(count)};
+    }
+
     std::span<const std::uint32_t> indices() const noexcept
     {
         return cindices();
@@ -296,13 +368,38 @@ private:
     struct descriptor_set_data
     {
         descriptor_set_ptr set{};
-        std::vector<asynchronous_resource_ptr> to_keep{};
         std::uint32_t epoch{};
     };
 
+    //Range of elements (vertices or indices) modified since last upload
+    struct dirty_range
+    {
+        std::uint32_t begin{};
+        std::uint32_t end{};
+    };
+
+    //Sorted, disjoint ranges. Past max_ranges the closest ranges are merged, trading a few clean bytes for fewer copies
+    struct dirty_ranges
+    {
+        static constexpr std::size_t max_ranges{16};
+
+        std::array<dirty_range, max_ranges + 1> ranges{};
+        std::size_t count{};
+    };
+
 private:
     using descriptor_set_map = std::map<render_layout_weak_ptr, descriptor_set_data, std::owner_less<render_layout_weak_ptr>>;
 
+private:
+    static void mark_dirty(dirty_ranges& ranges, std::uint32_t first, std::uint32_t count) noexcept;
+    void upload_dirty(dirty_ranges& ranges, std::size_t part, std::uint64_t element_size);
+
+    void mark_vertices(std::uint32_t first, std::uint32_t count) noexcept
+    {
+        mark_dirty(m_vertices_ranges, first, count);
+        m_update_bounds = true;
+    }
+
 private:
     binding_buffer m_bindings{};
     push_constants_buffer m_push_constants{};
@@ -313,6 +410,7 @@ private:
     std::uint32_t m_index_count{};
     std::uint32_t m_uniform_index{};
     std::uint32_t m_descriptors_epoch{};
+    vertex_layout m_vertices_layout{};
 
     vec3f m_position{};
     vec3f m_origin{};
@@ -321,8 +419,11 @@ private:
     bool  m_hidden{};
 
     bool m_upload_model{true};
-    bool m_upload_indices{false};
-    bool m_upload_vertices{false};
+    dirty_ranges m_vertices_ranges{};
+    dirty_ranges m_indices_ranges{};
+
+    mutable bounding_box m_local_bounds{};
+    mutable bool m_update_bounds{true};
 
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
@@ -336,6 +437,7 @@ public:
     explicit sprite(std::uint32_t width, std::uint32_t height, const color& color = colors::white);
     explicit sprite(texture_ptr texture, const color& color = colors::white);
     explicit sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, const color& color = colors::white);
+    explicit sprite(const texture_region& region, const color& color = colors::white);
 
     ~sprite() = default;
     sprite(const sprite&) = delete;
@@ -344,6 +446,8 @@ public:
     sprite& operator=(sprite&&) noexcept = default;
 
     void set_texture(texture_ptr texture);
+    //Binds the region's texture and maps the sprite on the region, the sprite keeps its size
+    void set_texture(const texture_region& region);
     void set_color(const color& color) noexcept;
 
     void set_texture_coords(std::int32_t x1, std::int32_t y1, std::int32_t x2, std::int32_t y2) noexcept;
@@ -424,8 +528,9 @@ class CAPTAL_API tilemap final : public basic_renderable
 {
 public:
     tilemap() = default;
-    explicit tilemap(std::uint32_t width, std::uint32_t height, std::uint32_t tile_width, std::uint32_t tile_height);
-    explicit tilemap(std::uint32_t width, std::uint32_t height, const tileset& tileset);
+    //With vertex_layout::compact the whole map must fit in 16-bit coordinates, and the view must use a compact render technique
+    explicit tilemap(std::uint32_t width, std::uint32_t height, std::uint32_t tile_width, std::uint32_t tile_height, vertex_layout layout = vertex_layout::standard);
+    explicit tilemap(std::uint32_t width, std::uint32_t height, const tileset& tileset, vertex_layout layout = vertex_layout::standard);
 
     ~tilemap() = default;
     tilemap(const tilemap&) = delete;
@@ -439,6 +544,8 @@ public:
     void set_texture_coords(std::uint32_t row, std::uint32_t col, std::int32_t x1, std::int32_t y1, std::int32_t x2, std::int32_t y2) noexcept;
     void set_texture_rect(std::uint32_t row, std::uint32_t col, std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height) noexcept;
     void set_texture_rect(std::uint32_t row, std::uint32_t col, const tileset::texture_rect& rect) noexcept;
+    //Bulk edit: rects are written to consecutive cells in row-major order starting at (row, col), and uploaded as one range
+    void set_texture_rects(std::uint32_t row, std::uint32_t col, std::span<const tileset::texture_rect> rects) noexcept;
 
     void set_relative_texture_coords(std::uint32_t row, std::uint32_t col, float x1, float y1, float x2, float y2) noexcept;
     void set_relative_texture_rect(std::uint32_t row, std::uint32_t col, float x, float y, float width, float height) noexcept;
@@ -484,6 +591,99 @@ private:
     std::uint32_t m_tile_height{};
 };
 
+//Draws a whole map as a single quad, the fragment shader looks the tile up in a buffer of 16-bit indices
+//Views drawing it must use engine::tile_layer_render_layout() and engine::tile_layer_fragment_shader()
+class CAPTAL_API tile_layer final : public basic_renderable
+{
+public:
+    static constexpr std::uint16_t no_tile{0xFFFF};
+    static constexpr std::uint32_t tiles_binding{2};
+
+public:
+    tile_layer() = default;
+    explicit tile_layer(std::uint32_t width, std::uint32_t height, const tileset& tileset, const color& color = colors::white);
+
+    ~tile_layer() = default;
+    tile_layer(const tile_layer&) = delete;
+    tile_layer& operator=(const tile_layer&) = delete;
+    tile_layer(tile_layer&&) noexcept = default;
+    tile_layer& operator=(tile_layer&&) noexcept = default;
+
+    void upload(memory_transfer_info info);
+
+    void set_color(const color& color) noexcept;
+    void set_tile(std::uint32_t row, std::uint32_t col, std::uint16_t tile) noexcept;
+    void set_tiles(std::span<const std::uint16_t> tiles) noexcept;
+
+    std::uint16_t tile(std::uint32_t row, std::uint32_t col) const noexcept
+    {
+        assert(row < m_height && col < m_width && "cpt::tile_layer::tile called with out of bounds cell.");
+
+        return m_tiles[row * m_width + col];
+    }
+
+    std::span<const std::uint16_t> tiles() const noexcept
+    {
+        return std::span{m_tiles}.first(m_width * m_height);
+    }
+
+    texture_ptr texture() const
+    {
+        return std::get<texture_ptr>(get_binding(1));
+    }
+
+    const storage_buffer_ptr& tiles_buffer() const noexcept
+    {
+        return m_tiles_buffer;
+    }
+
+    std::uint32_t width() const noexcept
+    {
+        return m_width;
+    }
+
+    std::uint32_t height() const noexcept
+    {
+        return m_height;
+    }
+
+    std::uint32_t tile_width() const noexcept
+    {
+        return m_tile_width;
+    }
+
+    std::uint32_t tile_height() const noexcept
+    {
+        return m_tile_height;
+    }
+
+private:
+    struct header
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        std::array<float, 2> tile_size{};
+        std::uint32_t columns{};
+    };
+
+    static constexpr std::uint64_t header_size{sizeof(header)};
+    static_assert(header_size == 20, "cpt::tile_layer::header must match the std430 layout of data/tile_layer.frag");
+
+    void mark_dirty(std::uint32_t first, std::uint32_t last) noexcept;
+
+private:
+    std::uint32_t m_width{};
+    std::uint32_t m_height{};
+    std::uint32_t m_tile_width{};
+    std::uint32_t m_tile_height{};
+    header m_header{};
+    std::vector<std::uint16_t> m_tiles{};
+    storage_buffer_ptr m_tiles_buffer{};
+    std::uint32_t m_dirty_begin{};
+    std::uint32_t m_dirty_end{};
+    bool m_upload_header{true};
+};
+
 }
 
 #endif
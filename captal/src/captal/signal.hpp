@@ -23,18 +23,522 @@
 #ifndef CAPTAL_SIGNAL_HPP_INCLUDED
 #define CAPTAL_SIGNAL_HPP_INCLUDED
 
-#include <sigslot/signal.hpp>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
 
 namespace cpt
 {
 
-inline namespace sigslot
+namespace impl
 {
 
-using namespace ::sigslot;
+class signal_state_base
+{
+public:
+    signal_state_base() = default;
+    virtual ~signal_state_base() = default;
+    signal_state_base(const signal_state_base&) = delete;
+    signal_state_base& operator=(const signal_state_base&) = delete;
+    signal_state_base(signal_state_base&&) noexcept = delete;
+    signal_state_base& operator=(signal_state_base&&) noexcept = delete;
+
+    virtual void disconnect(std::uint32_t index, std::uint32_t generation) noexcept = 0;
+    virtual bool connected(std::uint32_t index, std::uint32_t generation) const noexcept = 0;
+};
+
+struct null_mutex
+{
+    void lock() noexcept {}
+    bool try_lock() noexcept {return true;}
+    void unlock() noexcept {}
+};
+
+//Type erased callback, small callables are stored inline
+template<typename... Args>
+class signal_callback
+{
+public:
+    static constexpr std::size_t inline_size{48};
+
+    template<typename Callable>
+    static constexpr bool is_inline{sizeof(Callable) <= inline_size && alignof(Callable) <= alignof(std::max_align_t)};
+
+public:
+    signal_callback() = default;
+
+    ~signal_callback()
+    {
+        reset();
+    }
+
+    signal_callback(const signal_callback&) = delete;
+    signal_callback& operator=(const signal_callback&) = delete;
+    signal_callback(signal_callback&&) noexcept = delete;
+    signal_callback& operator=(signal_callback&&) noexcept = delete;
+
+    template<typename Callable>
+    void emplace(Callable&& callable)
+    {
+        using type = std::decay_t<Callable>;
+
+        if constexpr(is_inline<type>)
+        {
+            new(&m_storage) type{std::forward<Callable>(callable)};
+
+            m_invoke = [](void* data, Args&... args)
+            {
+                std::invoke(*std::launder(reinterpret_cast<type*>(data)), args...);
+            };
+
+            m_destroy = [](void* data) noexcept
+            {
+                std::launder(reinterpret_cast<type*>(data))->~type();
+            };
+        }
+        else
+        {
+            new(&m_storage) type*{new type{std::forward<Callable>(callable)}};
+
+            m_invoke = [](void* data, Args&... args)
+            {
+                std::invoke(**std::launder(reinterpret_cast<type**>(data)), args...);
+            };
+
+            m_destroy = [](void* data) noexcept
+            {
+                delete *std::launder(reinterpret_cast<type**>(data));
+            };
+        }
+    }
+
+    void reset() noexcept
+    {
+        if(m_destroy)
+        {
+            std::exchange(m_destroy, nullptr)(&m_storage);
+            m_invoke = nullptr;
+        }
+    }
+
+    void operator()(Args&... args) const
+    {
+        m_invoke(&m_storage, args...);
+    }
+
+private:
+    using invoke_type = void(*)(void*, Args&...);
+    using destroy_type = void(*)(void*) noexcept;
+
+private:
+    alignas(std::max_align_t) mutable std::byte m_storage[inline_size];
+    invoke_type m_invoke{};
+    destroy_type m_destroy{};
+};
+
+template<typename Lockable, typename... Args>
+class signal_state final : public signal_state_base
+{
+    static constexpr std::uint32_t chunk_size{16};
+
+    struct slot
+    {
+        signal_callback<Args...> callback{};
+        std::uint32_t generation{};
+        bool active{};
+        bool pending{}; //disconnected during an emission, released once it ends
+    };
+
+    using chunk_type = std::unique_ptr<slot[]>;
+
+public:
+    signal_state() = default;
+    ~signal_state() = default;
+    signal_state(const signal_state&) = delete;
+    signal_state& operator=(const signal_state&) = delete;
+    signal_state(signal_state&&) noexcept = delete;
+    signal_state& operator=(signal_state&&) noexcept = delete;
+
+    template<typename Callable>
+    std::pair<std::uint32_t, std::uint32_t> connect(Callable&& callable)
+    {
+        std::lock_guard lock{m_mutex};
+
+        std::uint32_t index{};
+
+        //A free slot may be before the end of a running emission, which would call the new slot
+        if(!std::empty(m_free) && m_emitting == 0)
+        {
+            index = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            if(m_used == std::size(m_chunks) * chunk_size)
+            {
+                m_chunks.emplace_back(std::make_unique<slot[]>(chunk_size));
+                m_free.reserve(std::size(m_chunks) * chunk_size);
+            }
+
+            index = m_used++;
+        }
+
+        slot& data{get(index)};
+        data.callback.emplace(std::forward<Callable>(callable));
+        data.active = true;
+
+        ++m_count;
+
+        return std::make_pair(index, data.generation);
+    }
+
+    void disconnect(std::uint32_t index, std::uint32_t generation) noexcept override
+    {
+        std::lock_guard lock{m_mutex};
+
+        if(index < m_used)
+        {
+            slot& data{get(index)};
+
+            if(data.active && data.generation == generation)
+            {
+                deactivate(index);
+            }
+        }
+    }
+
+    bool connected(std::uint32_t index, std::uint32_t generation) const noexcept override
+    {
+        std::lock_guard lock{m_mutex};
+
+        if(index < m_used)
+        {
+            const slot& data{get(index)};
+
+            return data.active && data.generation == generation;
+        }
+
+        return false;
+    }
+
+    void disconnect_all() noexcept
+    {
+        std::lock_guard lock{m_mutex};
+
+        if(m_emitting > 0)
+        {
+            for(std::uint32_t i{}; i < m_used; ++i)
+            {
+                if(get(i).active)
+                {
+                    deactivate(i);
+                }
+            }
+        }
+        else
+        {
+            for(std::uint32_t i{}; i < m_used; ++i)
+            {
+                slot& data{get(i)};
+
+                if(data.active)
+                {
+                    data.active = false;
+                    ++data.generation;
+                    data.callback.reset();
+                }
+            }
+
+            reset_free_list();
+        }
+    }
+
+    void emit(Args&... args)
+    {
+        std::lock_guard lock{m_mutex};
+
+        struct emit_guard
+        {
+            signal_state& state;
+
+            ~emit_guard()
+            {
+                if(--state.m_emitting == 0 && state.m_pending)
+                {
+                    state.release_pending();
+                }
+            }
+        };
+
+        ++m_emitting;
+        const emit_guard guard{*this};
+
+        //Slots connected during the emission are not called
+        const std::uint32_t count{m_used};
+        for(std::uint32_t i{}; i < count; ++i)
+        {
+            const slot& data{get(i)};
+
+            if(data.active)
+            {
+                data.callback(args...);
+            }
+        }
+    }
+
+    std::size_t slot_count() const noexcept
+    {
+        std::lock_guard lock{m_mutex};
+
+        return m_count;
+    }
+
+private:
+    slot& get(std::uint32_t index) noexcept
+    {
+        return m_chunks[index / chunk_size][index % chunk_size];
+    }
+
+    const slot& get(std::uint32_t index) const noexcept
+    {
+        return m_chunks[index / chunk_size][index % chunk_size];
+    }
+
+    void deactivate(std::uint32_t index) noexcept
+    {
+        slot& data{get(index)};
+
+        data.active = false;
+        ++data.generation;
+        --m_count;
+
+        if(m_emitting > 0) //the callback may be running
+        {
+            data.pending = true;
+            m_pending = true;
+        }
+        else
+        {
+            data.callback.reset();
+            m_free.emplace_back(index);
+        }
+    }
+
+    void release_pending() noexcept
+    {
+        for(std::uint32_t i{}; i < m_used; ++i)
+        {
+            slot& data{get(i)};
+
+            if(data.pending)
+            {
+                data.callback.reset();
+                data.pending = false;
+                m_free.emplace_back(i);
+            }
+        }
+
+        m_pending = false;
+
+        if(m_count == 0)
+        {
+            reset_free_list();
+        }
+    }
+
+    //Restart from the first slot, so the next connections are called in order
+    void reset_free_list() noexcept
+    {
+        m_free.clear();
+        m_used = 0;
+        m_count = 0;
+    }
+
+private:
+    mutable Lockable m_mutex{};
+    std::vector<chunk_type> m_chunks{};
+    std::vector<std::uint32_t> m_free{};
+    std::uint32_t m_used{}; //Slots in [0, m_used[ are either connected or in the free list
+    std::uint32_t m_count{};
+    std::uint32_t m_emitting{};
+    bool m_pending{};
+};
 
 }
 
+//Handle to a connected callback, it does not own the connection
+class connection
+{
+    template<typename Lockable, typename... Args>
+    friend class basic_signal;
+
+public:
+    connection() = default;
+    ~connection() = default;
+    connection(const connection&) = default;
+    connection& operator=(const connection&) = default;
+    connection(connection&&) noexcept = default;
+    connection& operator=(connection&&) noexcept = default;
+
+    bool valid() const noexcept
+    {
+        return !m_state.expired();
+    }
+
+    bool connected() const noexcept
+    {
+        if(const auto state{m_state.lock()}; state)
+        {
+            return state->connected(m_index, m_generation);
+        }
+
+        return false;
+    }
+
+    bool disconnect() noexcept
+    {
+        if(const auto state{m_state.lock()}; state)
+        {
+            const bool output{state->connected(m_index, m_generation)};
+            state->disconnect(m_index, m_generation);
+            m_state.reset();
+
+            return output;
+        }
+
+        return false;
+    }
+
+private:
+    explicit connection(std::weak_ptr<impl::signal_state_base> state, std::uint32_t index, std::uint32_t generation) noexcept
+    :m_state{std::move(state)}
+    ,m_index{index}
+    ,m_generation{generation}
+    {
+
+    }
+
+private:
+    std::weak_ptr<impl::signal_state_base> m_state{};
+    std::uint32_t m_index{};
+    std::uint32_t m_generation{};
+};
+
+//Disconnects on destruction
+class scoped_connection : public connection
+{
+public:
+    scoped_connection() = default;
+
+    scoped_connection(connection&& other) noexcept
+    :connection{std::move(other)}
+    {
+
+    }
+
+    ~scoped_connection()
+    {
+        disconnect();
+    }
+
+    scoped_connection(const scoped_connection&) = delete;
+    scoped_connection& operator=(const scoped_connection&) = delete;
+
+    scoped_connection(scoped_connection&& other) noexcept
+    :connection{std::exchange(static_cast<connection&>(other), connection{})}
+    {
+
+    }
+
+    scoped_connection& operator=(scoped_connection&& other) noexcept
+    {
+        disconnect();
+        connection::operator=(std::exchange(static_cast<connection&>(other), connection{}));
+
+        return *this;
+    }
+
+    connection release() noexcept
+    {
+        return std::exchange(static_cast<connection&>(*this), connection{});
+    }
+};
+
+//Callbacks are stored inline when small and their slots are pooled, disconnect_all keeps the storage for the next connections.
+//Callbacks may connect and disconnect slots of the signal they are called from.
+template<typename Lockable, typename... Args>
+class basic_signal
+{
+    using state_type = impl::signal_state<Lockable, Args...>;
+
+public:
+    //The state is created here, a lazy creation in connect would race with concurrent connect, emit and disconnect_all
+    basic_signal()
+    :m_state{std::make_shared<state_type>()}
+    {
+
+    }
+
+    ~basic_signal() = default;
+    basic_signal(const basic_signal&) = delete;
+    basic_signal& operator=(const basic_signal&) = delete;
+    basic_signal(basic_signal&&) noexcept = default;
+    basic_signal& operator=(basic_signal&&) noexcept = default;
+
+    template<typename Callable> requires std::invocable<std::decay_t<Callable>&, Args&...>
+    connection connect(Callable&& callable)
+    {
+        //Moved-from signals can be reused, they are not shared between threads at this point
+        if(!m_state)
+        {
+            m_state = std::make_shared<state_type>();
+        }
+
+        const auto [index, generation] = m_state->connect(std::forward<Callable>(callable));
+
+        return connection{m_state, index, generation};
+    }
+
+    void disconnect_all() noexcept
+    {
+        if(m_state)
+        {
+            m_state->disconnect_all();
+        }
+    }
+
+    void operator()(Args... args)
+    {
+        if(m_state)
+        {
+            m_state->emit(args...);
+        }
+    }
+
+    std::size_t slot_count() const noexcept
+    {
+        return m_state ? m_state->slot_count() : 0;
+    }
+
+private:
+    std::shared_ptr<state_type> m_state{};
+};
+
+//Thread-safe signal, callbacks are called with the signal's lock held
+template<typename... Args>
+using signal = basic_signal<std::recursive_mutex, Args...>;
+
+//Single-threaded signal, no lock is taken
+template<typename... Args>
+using signal_st = basic_signal<impl::null_mutex, Args...>;
+
 }
 
 #endif
@@ -80,7 +80,7 @@ using storage_buffer_weak_ptr = std::weak_ptr<storage_buffer>;
 template<typename... Args>
 storage_buffer_ptr make_storage_buffer(Args&&... args)
 {
-    return std::make_shared<storage_buffer>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<storage_buffer>(std::forward<Args>(args)...);
 }
 
 }
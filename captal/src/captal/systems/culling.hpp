@@ -0,0 +1,85 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_SYSTEMS_CULLING_HPP_INCLUDED
+#define CAPTAL_SYSTEMS_CULLING_HPP_INCLUDED
+
+#include "../config.hpp"
+
+#include <entt/entity/registry.hpp>
+
+#include "../components/node.hpp"
+#include "../components/drawable.hpp"
+
+#include "../culling.hpp"
+
+namespace cpt::systems
+{
+
+namespace impl
+{
+
+inline void remove_from_culling_grid(culling_grid& grid, entt::registry&, entt::entity entity)
+{
+    grid.remove(entity);
+}
+
+}
+
+//Removes entities from the grid when they are destroyed, or when they lose their node or their drawable.
+//Must be called once per grid, before the first call to culling.
+template<components::drawable_specialization Drawable = components::drawable>
+void connect_culling(entt::registry& world, culling_grid& grid)
+{
+    world.on_destroy<Drawable>().template connect<&impl::remove_from_culling_grid>(grid);
+    world.on_destroy<components::node>().template connect<&impl::remove_from_culling_grid>(grid);
+}
+
+template<components::drawable_specialization Drawable = components::drawable>
+void disconnect_culling(entt::registry& world, culling_grid& grid)
+{
+    world.on_destroy<Drawable>().template disconnect<&impl::remove_from_culling_grid>(grid);
+    world.on_destroy<components::node>().template disconnect<&impl::remove_from_culling_grid>(grid);
+}
+
+//Updates the grid with the bounds of drawables whose node has been updated this frame.
+//Drawables without a node are never added to the grid.
+//Must be called after prepare_render, so renderables have the same transformation as their node.
+//Call node::update() after changing the geometry of a renderable without moving it.
+template<components::drawable_specialization Drawable = components::drawable>
+void culling(entt::registry& world, culling_grid& grid)
+{
+    world.view<const components::node, Drawable>().each([&grid](entt::entity entity, const components::node& node, Drawable& drawable)
+    {
+        if(drawable && node.is_updated())
+        {
+            grid.update(entity, drawable.apply([](const auto& renderable)
+            {
+                return renderable.global_bounds();
+            }));
+        }
+    });
+}
+
+}
+
+#endif
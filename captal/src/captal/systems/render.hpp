@@ -25,6 +25,9 @@
 
 #include "../config.hpp"
 
+#include <vector>
+#include <algorithm>
+
 #include <entt/entity/registry.hpp>
 
 #include <tephra/commands.hpp>
@@ -37,6 +40,10 @@
 #include "../view.hpp"
 #include "../render_window.hpp"
 #include "../renderable.hpp"
+#include "../culling.hpp"
+#include "../draw_list.hpp"
+
+#include "culling.hpp"
 
 namespace cpt::systems
 {
@@ -132,6 +139,123 @@ void render(entt::registry& world, cpt::begin_render_options options = cpt::begi
     });
 }
 
+//Same as render, but only the drawables that intersect the camera's visible area are uploaded and drawn.
+//Drawables without a node are not in the grid, they are always drawn.
+//Drawables are drawn in the same order as the non-culled version.
+//Call connect_culling once, so destroyed entities are removed from the grid.
+template<components::drawable_specialization Drawable = components::drawable>
+void render(entt::registry& world, culling_grid& grid, cpt::begin_render_options options = cpt::begin_render_options::none)
+{
+    prepare_render<Drawable>(world);
+    culling<Drawable>(world, grid);
+
+    const auto drawables{world.view<Drawable>()};
+    const auto unculled{world.view<Drawable>(entt::exclude<components::node>)};
+    std::vector<entt::entity> entities{};
+    std::vector<entt::entity> to_remove{};
+
+    world.view<components::camera>().each([&world, &grid, &drawables, &unculled, &entities, &to_remove, options](components::camera& camera)
+    {
+        if(camera)
+        {
+            auto render  {camera->target().begin_render(options)};
+            auto transfer{engine::instance().begin_transfer()};
+
+            camera->upload(transfer);
+
+            if(render)
+            {
+                camera->bind(*render);
+            }
+
+            const auto visible{grid.query(camera->visible_area())};
+
+            entities.assign(std::begin(visible), std::end(visible));
+            entities.insert(std::end(entities), std::begin(unculled), std::end(unculled));
+
+            //Restore drawables' order, as given by the sorting systems
+            std::sort(std::begin(entities), std::end(entities), [&drawables](entt::entity left, entt::entity right)
+            {
+                return drawables.find(left) < drawables.find(right);
+            });
+
+            for(const auto entity : entities)
+            {
+                Drawable* const drawable{world.valid(entity) ? world.template try_get<Drawable>(entity) : nullptr};
+
+                if(!drawable || !*drawable)
+                {
+                    to_remove.emplace_back(entity);
+                    continue;
+                }
+
+                drawable->apply([&camera, &transfer, &render](auto& renderable)
+                {
+                    if(!renderable.hidden())
+                    {
+                        renderable.upload(transfer);
+
+                        if(render)
+                        {
+                            renderable.draw(*render, *camera);
+                        }
+                    }
+                });
+            }
+        }
+    });
+
+    for(const auto entity : to_remove)
+    {
+        grid.remove(entity);
+    }
+}
+
+//Same as render, but drawables are drawn in the order of the draw list, as filled by the draw list sorting systems.
+//Entities that are no longer valid, or that lost their drawable, are skipped.
+template<components::drawable_specialization Drawable = components::drawable>
+void render(entt::registry& world, const draw_list& list, cpt::begin_render_options options = cpt::begin_render_options::none)
+{
+    prepare_render<Drawable>(world);
+
+    world.view<components::camera>().each([&world, &list, options](components::camera& camera)
+    {
+        if(camera)
+        {
+            auto render  {camera->target().begin_render(options)};
+            auto transfer{engine::instance().begin_transfer()};
+
+            camera->upload(transfer);
+
+            if(render)
+            {
+                camera->bind(*render);
+            }
+
+            for(auto&& item : list)
+            {
+                Drawable* const drawable{world.valid(item.entity) ? world.template try_get<Drawable>(item.entity) : nullptr};
+
+                if(drawable && *drawable)
+                {
+                    drawable->apply([&camera, &transfer, &render](auto& renderable)
+                    {
+                        if(!renderable.hidden())
+                        {
+                            renderable.upload(transfer);
+
+                            if(render)
+                            {
+                                renderable.draw(*render, *camera);
+                            }
+                        }
+                    });
+                }
+            }
+        }
+    });
+}
+
 }
 
 #endif
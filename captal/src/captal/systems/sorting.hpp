@@ -31,6 +31,8 @@
 #include "../components/drawable.hpp"
 #include "../components/draw_index.hpp"
 
+#include "../draw_list.hpp"
+
 namespace cpt::systems
 {
 
@@ -79,6 +81,107 @@ void index_z_sorting(entt::registry& world)
     world.sort<Drawable, components::node>();
 }
 
+namespace impl
+{
+
+//Used as a tie breaker in draw keys to group drawables that use the same texture
+template<components::drawable_specialization Drawable>
+std::uint32_t texture_id(const Drawable& drawable) noexcept
+{
+    return drawable.apply([](const auto& renderable) -> std::uint32_t
+    {
+        const auto binding{renderable.try_get_binding(1)};
+
+        if(!binding)
+        {
+            return 0;
+        }
+
+        const auto address{std::visit([](auto&& alternative) -> std::uintptr_t
+        {
+            using type = std::decay_t<decltype(alternative)>;
+
+            if constexpr(std::is_same_v<type, uniform_buffer_part>)
+            {
+                return reinterpret_cast<std::uintptr_t>(alternative.buffer.get());
+            }
+            else
+            {
+                return reinterpret_cast<std::uintptr_t>(alternative.get());
+            }
+        }, *binding)};
+
+        return static_cast<std::uint32_t>(address >> 4);
+    });
+}
+
+template<components::drawable_specialization Drawable>
+std::uint64_t draw_key(const components::node& node, const Drawable& drawable, std::uint32_t draw_index) noexcept
+{
+    const vec3f position{node.position() - node.origin()};
+
+    return make_draw_key(draw_index, position.z(), position.y(), texture_id(drawable));
+}
+
+inline std::uint64_t exact_draw_key(const components::node& node) noexcept
+{
+    const vec3f position{node.position() - node.origin()};
+
+    return make_exact_draw_key(position.z(), position.y());
+}
+
+}
+
+//The following overloads do not touch the registry's pools, they fill the draw list with sort keys and radix sort it.
+//Use them with the render overload that takes a draw list.
+template<components::drawable_specialization Drawable = components::drawable>
+void z_sorting(entt::registry& world, draw_list& list)
+{
+    list.clear();
+
+    world.view<const components::node, const Drawable>().each([&list](entt::entity entity, const components::node& node, const Drawable& drawable)
+    {
+        if(drawable)
+        {
+            list.push(impl::draw_key(node, drawable, 0), entity, impl::exact_draw_key(node));
+        }
+    });
+
+    list.sort();
+}
+
+template<components::drawable_specialization Drawable = components::drawable>
+void index_sorting(entt::registry& world, draw_list& list)
+{
+    list.clear();
+
+    world.view<const components::draw_index, const Drawable>().each([&list](entt::entity entity, components::draw_index index, const Drawable& drawable)
+    {
+        if(drawable)
+        {
+            list.push(make_index_draw_key(index.index, impl::texture_id(drawable)), entity);
+        }
+    });
+
+    list.sort();
+}
+
+//Draw indices must not be greater than draw_key_layout::max_index
+template<components::drawable_specialization Drawable = components::drawable>
+void index_z_sorting(entt::registry& world, draw_list& list)
+{
+    list.clear();
+
+    world.view<const components::node, const components::draw_index, const Drawable>().each([&list](entt::entity entity, const components::node& node, components::draw_index index, const Drawable& drawable)
+    {
+        if(drawable)
+        {
+            list.push(impl::draw_key(node, drawable, index.index), entity, impl::exact_draw_key(node));
+        }
+    });
+
+    list.sort();
+}
 
 }
 
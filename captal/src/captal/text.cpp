@@ -309,6 +309,14 @@ text_bounds text_drawer::bounds(std::string_view string, std::uint32_t line_widt
 }
 
 text text_drawer::draw(std::string_view string, std::uint32_t line_width)
+{
+    const auto geometry{draw_geometry(string, line_width)};
+    const auto indices {generate_indices(std::size(geometry.vertices) / 4u)};
+
+    return text{indices, geometry.vertices, m_atlas, geometry.bounds};
+}
+
+text_geometry text_drawer::draw_geometry(std::string_view string, std::uint32_t line_width)
 {
     const auto outline   {static_cast<std::uint64_t>(m_outline * 64.0f)};
     const auto bold      {static_cast<bool>(m_style & text_style::bold)};
@@ -354,12 +362,32 @@ text text_drawer::draw(std::string_view string, std::uint32_t line_width)
         vertex.position += shift;
     }
 
-    const auto indices{generate_indices(std::size(state.vertices) / 4u)};
-
     const auto text_width {static_cast<std::uint32_t>(state.greatest_x - state.lowest_x)};
     const auto text_height{static_cast<std::uint32_t>(state.greatest_y - state.lowest_y)};
 
-    return text{indices, state.vertices, m_atlas, text_bounds{text_width, text_height}};
+    return text_geometry{std::move(state.vertices), text_bounds{text_width, text_height}};
+}
+
+vec2f text_drawer::solid_texel()
+{
+    if(!m_solid_texel)
+    {
+        //4x4 so that linear sampling at the center never reads the padding
+        std::array<std::uint8_t, 4 * 4 * 4> image;
+        std::fill(std::begin(image), std::end(image), 255);
+
+        const std::size_t size{m_format == glyph_format::color ? std::size(image) : std::size(image) / 4};
+
+        m_solid_texel = m_atlas->add_glyph(std::span{std::data(image), size}, 4, 4);
+        if(!m_solid_texel)
+        {
+            throw full_font_atlas{};
+        }
+    }
+
+    const vec2f texture_size{static_cast<float>(m_atlas->texture()->width()), static_cast<float>(m_atlas->texture()->height())};
+
+    return vec2f{static_cast<float>(m_solid_texel->x) + 2.0f, static_cast<float>(m_solid_texel->y) + 2.0f} / texture_size;
 }
 
 void text_drawer::upload()
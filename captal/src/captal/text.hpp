@@ -127,6 +127,13 @@ enum class text_align : std::uint32_t
     justify = 3
 };
 
+//Vertices of a drawn text, 4 per glyph quad, in the same order as cpt::text's vertices
+struct text_geometry
+{
+    std::vector<vertex> vertices{};
+    text_bounds bounds{};
+};
+
 struct font_set
 {
     std::optional<font> regular{};
@@ -224,6 +231,11 @@ public:
 
     text_bounds bounds(std::string_view string, std::uint32_t line_width = std::numeric_limits<std::uint32_t>::max());
     text draw(std::string_view string, std::uint32_t line_width = std::numeric_limits<std::uint32_t>::max());
+    text_geometry draw_geometry(std::string_view string, std::uint32_t line_width = std::numeric_limits<std::uint32_t>::max());
+
+    //Texture coordinates of an opaque white texel of the atlas, for untextured quads that must share the atlas binding
+    //Like the glyph texture coordinates, they are invalidated when the atlas is resized
+    vec2f solid_texel();
 
     void upload();
 
@@ -232,6 +244,11 @@ public:
         return m_fonts;
     }
 
+    const texture_ptr& texture() const noexcept
+    {
+        return m_atlas->texture();
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -359,6 +376,7 @@ private:
 
     std::shared_ptr<font_atlas> m_atlas{};
     std::unordered_map<std::uint64_t, glyph_info> m_glyphs{};
+    std::optional<bin_packer::rect> m_solid_texel{};
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
 #endif
@@ -22,6 +22,20 @@
 
 #include "texture.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CAPTAL_TEXTURE_SSE2
+    #include <emmintrin.h>
+#endif
+
 #include "engine.hpp"
 
 namespace cpt
@@ -60,33 +74,214 @@ static tph::image make_image(Args&&... args)
     return output;
 }
 
-static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, tph::image image)
+static void begin_texture_upload(tph::command_buffer& buffer, const texture_ptr& texture)
 {
-    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination};
-    texture_ptr texture{make_texture(sampling, static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), info)};
-
-    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
-
     tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.subresource.mip_level_count = texture->mip_levels();
     barrier.source_access      = tph::resource_access::none;
     barrier.destination_access = tph::resource_access::transfer_write;
     barrier.old_layout         = tph::texture_layout::undefined;
     barrier.new_layout         = tph::texture_layout::transfer_destination_optimal;
 
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+}
 
-    tph::image_texture_copy region{};
-    region.texture_size.width  = static_cast<std::uint32_t>(image.width());
-    region.texture_size.height = static_cast<std::uint32_t>(image.height());
+//With mipmap_generation::gpu, level 0 has been written and the other levels are blitted from it
+static void end_texture_upload(tph::command_buffer& buffer, const texture_ptr& texture, mipmap_generation mipmaps = mipmap_generation::none)
+{
+    if(mipmaps == mipmap_generation::gpu && texture->mip_levels() > 1)
+    {
+        tph::mipmap_generation_info info{texture->get_texture()};
+        info.filter             = tph::filter::linear;
+        info.source_access      = tph::resource_access::transfer_write;
+        info.destination_access = tph::resource_access::shader_read;
+        info.old_layout         = tph::texture_layout::transfer_destination_optimal;
+        info.new_layout         = tph::texture_layout::shader_read_only_optimal;
 
-    tph::cmd::copy(buffer, image, texture->get_texture(), region);
+        tph::cmd::generate_mipmaps(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, std::span{&info, 1});
 
+        return;
+    }
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.subresource.mip_level_count = texture->mip_levels();
     barrier.source_access      = tph::resource_access::transfer_write;
     barrier.destination_access = tph::resource_access::shader_read;
     barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
     barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
 
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+}
+
+//The default sampler_info clamps the lod to 0, which would hide every mip level
+static tph::sampler_info mip_sampling(tph::sampler_info sampling, std::uint32_t level_count) noexcept
+{
+    if(level_count > 1 && sampling.max_lod == 0.0f)
+    {
+        sampling.max_lod = static_cast<float>(level_count);
+    }
+
+    return sampling;
+}
+
+static tph::texture_info mip_texture_info(tph::texture_format format, std::uint32_t width, std::uint32_t height, mipmap_generation mipmaps) noexcept
+{
+    if(mipmaps == mipmap_generation::gpu)
+    {
+        return tph::texture_info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination | tph::texture_usage::transfer_source, mip_level_count(width, height)};
+    }
+
+    return tph::texture_info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination};
+}
+
+//2x2 box filter of a RGBA8 level into the next one, a source size of 1 is clamped
+static void downsample(const std::uint8_t* source, std::uint32_t source_width, std::uint32_t source_height, std::uint8_t* destination, std::uint32_t width, std::uint32_t height) noexcept
+{
+    for(std::uint32_t y{}; y < height; ++y)
+    {
+        const std::uint8_t* const top   {source + static_cast<std::size_t>(std::min(y * 2, source_height - 1)) * source_width * 4};
+        const std::uint8_t* const bottom{source + static_cast<std::size_t>(std::min(y * 2 + 1, source_height - 1)) * source_width * 4};
+        std::uint8_t* const output{destination + static_cast<std::size_t>(y) * width * 4};
+
+        std::uint32_t x{};
+
+#if defined(CAPTAL_TEXTURE_SSE2)
+        //Four source pixels of both rows give two output pixels
+        const __m128i zero {_mm_setzero_si128()};
+        const __m128i round{_mm_set1_epi16(2)};
+
+        for(; x + 2 <= width && x * 2 + 4 <= source_width; x += 2)
+        {
+            const __m128i top_pixels   {_mm_loadu_si128(reinterpret_cast<const __m128i*>(top + x * 8))};
+            const __m128i bottom_pixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + x * 8))};
+
+            const __m128i low {_mm_add_epi16(_mm_unpacklo_epi8(top_pixels, zero), _mm_unpacklo_epi8(bottom_pixels, zero))};
+            const __m128i high{_mm_add_epi16(_mm_unpackhi_epi8(top_pixels, zero), _mm_unpackhi_epi8(bottom_pixels, zero))};
+
+            const __m128i sum{_mm_unpacklo_epi64(_mm_add_epi16(low, _mm_srli_si128(low, 8)), _mm_add_epi16(high, _mm_srli_si128(high, 8)))};
+            const __m128i average{_mm_srli_epi16(_mm_add_epi16(sum, round), 2)};
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(average, zero));
+        }
+#endif
+
+        for(; x < width; ++x)
+        {
+            const std::uint32_t left {std::min(x * 2, source_width - 1) * 4};
+            const std::uint32_t right{std::min(x * 2 + 1, source_width - 1) * 4};
+
+            for(std::uint32_t i{}; i < 4; ++i)
+            {
+                const std::uint32_t sum{static_cast<std::uint32_t>(top[left + i] + top[right + i] + bottom[left + i] + bottom[right + i])};
+
+                output[x * 4 + i] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+mip_chain make_mip_chain(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, std::uint32_t level_count)
+{
+    const std::uint32_t full_count{mip_level_count(width, height)};
+    level_count = level_count == 0 ? full_count : std::min(level_count, full_count);
+
+    mip_chain output{};
+    output.levels.reserve(level_count);
+
+    std::uint64_t size{};
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        const std::uint32_t level_width {std::max(width  >> i, 1u)};
+        const std::uint32_t level_height{std::max(height >> i, 1u)};
+
+        output.levels.emplace_back(mip_chain::level{level_width, level_height, size});
+        size += static_cast<std::uint64_t>(level_width) * level_height * 4;
+    }
+
+    output.data.resize(size);
+    std::memcpy(std::data(output.data), rgba, static_cast<std::size_t>(width) * height * 4);
+
+    for(std::uint32_t i{1}; i < level_count; ++i)
+    {
+        const auto& source{output.levels[i - 1]};
+        const auto& level {output.levels[i]};
+
+        downsample(std::data(output.data) + source.offset, source.width, source.height, std::data(output.data) + level.offset, level.width, level.height);
+    }
+
+    return output;
+}
+
+static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, const mip_chain& chain, std::uint32_t first_level)
+{
+    assert(first_level < std::size(chain.levels) && "cpt::make_texture called with out of bounds first level.");
+
+    const auto levels{std::span{chain.levels}.subspan(first_level)};
+    const auto level_count{static_cast<std::uint32_t>(std::size(levels))};
+
+    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    texture_ptr texture{make_texture(mip_sampling(sampling, level_count), levels[0].width, levels[0].height, info)};
+
+    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
+
+    //Levels are contiguous, they are staged with a single copy
+    const std::uint64_t base{levels[0].offset};
+    const std::uint64_t size{std::size(chain.data) - base};
+    const auto staging{cpt::engine::instance().transfer_scheduler().stage(size)};
+    std::memcpy(staging.data, std::data(chain.data) + base, size);
+
+    begin_texture_upload(buffer, texture);
+
+    std::vector<tph::buffer_texture_copy> regions{};
+    regions.reserve(level_count);
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        auto& region{regions.emplace_back()};
+        region.buffer_offset = staging.offset + levels[i].offset - base;
+        region.texture_subresource.mip_level = i;
+        region.texture_size.width  = levels[i].width;
+        region.texture_size.height = levels[i].height;
+        region.texture_size.depth  = 1;
+    }
+
+    tph::cmd::copy(buffer, staging.buffer, texture->get_texture(), regions);
+
+    end_texture_upload(buffer, texture);
+
+    keeper.keep(texture);
+
+    return texture;
+}
+
+static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, tph::image image, mipmap_generation mipmaps)
+{
+    const auto width {static_cast<std::uint32_t>(image.width())};
+    const auto height{static_cast<std::uint32_t>(image.height())};
+
+    if(mipmaps == mipmap_generation::cpu)
+    {
+        image.map();
+        const auto chain{make_mip_chain(width, height, reinterpret_cast<const std::uint8_t*>(image.data()))};
+        image.unmap();
+
+        return make_texture_impl(sampling, format, chain, 0);
+    }
+
+    const tph::texture_info info{mip_texture_info(format, width, height, mipmaps)};
+    texture_ptr texture{make_texture(mip_sampling(sampling, info.mip_levels), width, height, info)};
+
+    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
+
+    begin_texture_upload(buffer, texture);
+
+    tph::image_texture_copy region{};
+    region.texture_size.width  = width;
+    region.texture_size.height = height;
+
+    tph::cmd::copy(buffer, image, texture->get_texture(), region);
+
+    end_texture_upload(buffer, texture, mipmaps);
 
     signal.connect([image = std::move(image)](){});
     keeper.keep(texture);
@@ -94,29 +289,118 @@ static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::tex
     return texture;
 }
 
-texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space)
+//Raw pixels go through the staging ring, decoded images already live in their own host memory
+static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, mipmap_generation mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(file));
+    if(mipmaps == mipmap_generation::cpu)
+    {
+        return make_texture_impl(sampling, format, make_mip_chain(width, height, rgba), 0);
+    }
+
+    const tph::texture_info info{mip_texture_info(format, width, height, mipmaps)};
+    texture_ptr texture{make_texture(mip_sampling(sampling, info.mip_levels), width, height, info)};
+
+    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
+
+    const std::uint64_t size{static_cast<std::uint64_t>(width) * height * 4};
+    const auto staging{cpt::engine::instance().transfer_scheduler().stage(size)};
+    std::memcpy(staging.data, rgba, size);
+
+    begin_texture_upload(buffer, texture);
+
+    tph::buffer_texture_copy region{};
+    region.buffer_offset = staging.offset;
+    region.texture_size.width  = width;
+    region.texture_size.height = height;
+    region.texture_size.depth  = 1;
+
+    tph::cmd::copy(buffer, staging.buffer, texture->get_texture(), region);
+
+    end_texture_upload(buffer, texture, mipmaps);
+
+    keeper.keep(texture);
+
+    return texture;
+}
+
+texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space, mipmap_generation mipmaps)
+{
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(file), mipmaps);
+}
+
+texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space, mipmap_generation mipmaps)
+{
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(data), mipmaps);
 }
 
-texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space, mipmap_generation mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(data));
+    return make_texture_impl(sampling, format_from_color_space(space), make_image(stream), mipmaps);
 }
 
-texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space, mipmap_generation mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(stream));
+    return make_texture_impl(sampling, format_from_color_space(space), width, height, rgba, mipmaps);
 }
 
-texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling, color_space space, mipmap_generation mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(width, height, rgba));
+    return make_texture_impl(sampling, format_from_color_space(space), std::move(image), mipmaps);
 }
 
-texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(const mip_chain& chain, std::uint32_t first_level, const tph::sampler_info& sampling, color_space space)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), std::move(image));
+    return make_texture_impl(sampling, format_from_color_space(space), chain, first_level);
+}
+
+//Uploads the chain on the streaming queue, then hands the texture over to the graphics queue
+static texture_ptr stream_texture(const tph::sampler_info& sampling, tph::texture_format format, const mip_chain& chain, std::shared_ptr<std::atomic<bool>> uploaded)
+{
+    auto& scheduler{cpt::engine::instance().transfer_scheduler()};
+
+    const auto level_count{static_cast<std::uint32_t>(std::size(chain.levels))};
+    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_destination, level_count};
+    texture_ptr texture{make_texture(mip_sampling(sampling, level_count), chain.levels[0].width, chain.levels[0].height, info)};
+
+    auto&& [buffer, signal, keeper] = scheduler.begin_streaming_transfer();
+
+    const auto staging{scheduler.stage_streaming(std::size(chain.data))};
+    std::memcpy(staging.data, std::data(chain.data), std::size(chain.data));
+
+    begin_texture_upload(buffer, texture);
+
+    std::vector<tph::buffer_texture_copy> regions{};
+    regions.reserve(level_count);
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        auto& region{regions.emplace_back()};
+        region.buffer_offset = staging.offset + chain.levels[i].offset;
+        region.texture_subresource.mip_level = i;
+        region.texture_size.width  = chain.levels[i].width;
+        region.texture_size.height = chain.levels[i].height;
+        region.texture_size.depth  = 1;
+    }
+
+    tph::cmd::copy(buffer, staging.buffer, texture->get_texture(), regions);
+
+    tph::texture_memory_barrier barrier{texture->get_texture()};
+    barrier.subresource.mip_level_count = level_count;
+    barrier.source_access      = tph::resource_access::transfer_write;
+    barrier.destination_access = tph::resource_access::shader_read;
+    barrier.old_layout         = tph::texture_layout::transfer_destination_optimal;
+    barrier.new_layout         = tph::texture_layout::shader_read_only_optimal;
+
+    scheduler.transfer_ownership(barrier);
+
+    keeper.keep(texture);
+
+    signal.connect([uploaded = std::move(uploaded)]()
+    {
+        uploaded->store(true, std::memory_order_release);
+    });
+
+    return texture;
 }
 
 tph::renderer& texture::get_renderer() noexcept
@@ -125,6 +409,76 @@ tph::renderer& texture::get_renderer() noexcept
 }
 
 
+namespace impl
+{
+
+//Single thread decoding the streamed files, so streaming many textures at once does not spawn as many threads
+class texture_stream_worker
+{
+public:
+    texture_stream_worker()
+    :m_thread{[this](std::stop_token token)
+    {
+        work(token);
+    }}
+    {
+
+    }
+
+    //The thread is stopped and joined by its destructor, tasks that did not run break their promise
+    ~texture_stream_worker() = default;
+    texture_stream_worker(const texture_stream_worker&) = delete;
+    texture_stream_worker& operator=(const texture_stream_worker&) = delete;
+    texture_stream_worker(texture_stream_worker&&) noexcept = delete;
+    texture_stream_worker& operator=(texture_stream_worker&&) noexcept = delete;
+
+    //The worker only touches host memory, the chain is uploaded through the staging ring once ready
+    std::future<mip_chain> push(std::filesystem::path path)
+    {
+        std::packaged_task<mip_chain()> task{[path = std::move(path)]()
+        {
+            const auto image{tph::decode_image(path)};
+
+            return make_mip_chain(static_cast<std::uint32_t>(image.width), static_cast<std::uint32_t>(image.height), std::data(image.data));
+        }};
+
+        auto output{task.get_future()};
+
+        {
+            std::lock_guard lock{m_mutex};
+            m_tasks.emplace_back(std::move(task));
+        }
+
+        m_condition.notify_one();
+
+        return output;
+    }
+
+private:
+    void work(std::stop_token token)
+    {
+        std::unique_lock lock{m_mutex};
+
+        while(m_condition.wait(lock, token, [this]() { return !std::empty(m_tasks); }))
+        {
+            auto task{std::move(m_tasks.front())};
+            m_tasks.pop_front();
+
+            lock.unlock();
+            task(); //Exceptions are stored in the future
+            lock.lock();
+        }
+    }
+
+private:
+    std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    std::deque<std::packaged_task<mip_chain()>> m_tasks{};
+    std::jthread m_thread{}; //Last, so it starts once the other members exist and is joined before they are destroyed
+};
+
+}
+
 cpt::texture_ptr texture_pool::default_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
 {
     auto output{make_texture(path, sampling, space)};
@@ -148,6 +502,10 @@ texture_pool::texture_pool(load_callback_t load_callback)
 
 }
 
+texture_pool::~texture_pool() = default;
+texture_pool::texture_pool(texture_pool&&) noexcept = default;
+texture_pool& texture_pool::operator=(texture_pool&&) noexcept = default;
+
 cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
 {
     return load(path, m_load_callback, sampling, space);
@@ -155,6 +513,25 @@ cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const tph
 
 cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const load_callback_t& load_callback, const tph::sampler_info& sampling, color_space space)
 {
+    const auto stream{std::find_if(std::begin(m_streams), std::end(m_streams), [&path](const pending_stream& stream)
+    {
+        return stream.path == path;
+    })};
+
+    //Waits for a pending stream rather than decoding the file twice
+    if(stream != std::end(m_streams))
+    {
+        auto pending{std::move(*stream)};
+        m_streams.erase(stream);
+
+        //The streaming upload may not be done, the texture is uploaded again on the graphics queue so it can be used right away
+        const auto chain{pending.texture ? std::move(pending.chain) : pending.future.get()};
+        auto texture{make_texture(chain, 0, pending.sampling, pending.space)};
+        publish(path, texture);
+
+        return texture;
+    }
+
     const auto it{m_pool.find(path)};
     if(it != std::end(m_pool))
     {
@@ -200,6 +577,13 @@ void texture_pool::clear(std::size_t threshold)
 
 void texture_pool::remove(const std::filesystem::path& path)
 {
+    const auto predicate = [&path](const pending_stream& stream)
+    {
+        return stream.path == path;
+    };
+
+    m_streams.erase(std::remove_if(std::begin(m_streams), std::end(m_streams), predicate), std::end(m_streams));
+
     const auto it{m_pool.find(path)};
     if(it != std::end(m_pool))
     {
@@ -221,4 +605,80 @@ void texture_pool::remove(const texture_ptr& texture)
     }
 }
 
+void texture_pool::stream(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
+{
+    const auto predicate = [&path](const pending_stream& stream)
+    {
+        return stream.path == path;
+    };
+
+    if(m_pool.contains(path) || std::any_of(std::begin(m_streams), std::end(m_streams), predicate))
+    {
+        return;
+    }
+
+    if(!m_worker)
+    {
+        m_worker = std::make_unique<impl::texture_stream_worker>();
+    }
+
+    m_streams.emplace_back(pending_stream{path, sampling, space, m_worker->push(path)});
+}
+
+//Indices are used since stream_signal's slots may add or remove streams
+std::size_t texture_pool::poll()
+{
+    std::size_t i{};
+    while(i < std::size(m_streams))
+    {
+        auto& stream{m_streams[i]};
+
+        if(!stream.texture)
+        {
+            if(stream.future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+            {
+                ++i;
+                continue;
+            }
+
+            try
+            {
+                stream.chain = stream.future.get();
+            }
+            catch(...)
+            {
+                m_streams.erase(std::begin(m_streams) + i);
+                throw;
+            }
+
+            stream.uploaded = std::make_shared<std::atomic<bool>>();
+            stream.texture = stream_texture(stream.sampling, format_from_color_space(stream.space), stream.chain, stream.uploaded);
+        }
+
+        if(!stream.uploaded->load(std::memory_order_acquire))
+        {
+            ++i;
+            continue;
+        }
+
+        const auto path{stream.path};
+        auto texture{std::move(stream.texture)};
+        m_streams.erase(std::begin(m_streams) + i);
+
+        publish(path, std::move(texture));
+    }
+
+    return std::size(m_streams);
+}
+
+void texture_pool::publish(const std::filesystem::path& path, texture_ptr texture)
+{
+#ifdef CAPTAL_DEBUG
+    texture->set_name(convert_to<narrow>(path.u8string()));
+#endif
+
+    m_pool.insert_or_assign(path, texture);
+    m_stream_signal(path, texture);
+}
+
 }
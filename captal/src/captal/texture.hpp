@@ -31,6 +31,11 @@
 #include <istream>
 #include <memory>
 #include <functional>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <algorithm>
+#include <bit>
 
 #include <tephra/image.hpp>
 #include <tephra/texture.hpp>
@@ -38,6 +43,7 @@
 #include <captal_foundation/math.hpp>
 
 #include "asynchronous_resource.hpp"
+#include "signal.hpp"
 
 namespace cpt
 {
@@ -48,6 +54,37 @@ enum class color_space : std::uint32_t
     linear = 1
 };
 
+enum class mipmap_generation : std::uint32_t
+{
+    none = 0,
+    gpu = 1, //Blit chain recorded in the transfer command buffer
+    cpu = 2, //Box filter on the CPU, every level goes through the staging ring
+};
+
+//Number of levels of a full mip chain
+constexpr std::uint32_t mip_level_count(std::uint32_t width, std::uint32_t height) noexcept
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+//RGBA8 mip chain, levels are stored one after the other from the largest
+struct mip_chain
+{
+    struct level
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        std::uint64_t offset{};
+    };
+
+    std::vector<level> levels{};
+    std::vector<std::uint8_t> data{};
+};
+
+//Computes a mip chain with a 2x2 box filter, level_count of 0 computes the full chain
+//The filter does not linearize sRGB values, which slightly darkens high contrast areas in small mips
+CAPTAL_API mip_chain make_mip_chain(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, std::uint32_t level_count = 0);
+
 class CAPTAL_API texture : public asynchronous_resource
 {
 public:
@@ -202,14 +239,36 @@ using texture_weak_ptr = std::weak_ptr<texture>;
 template<typename... Args> requires std::constructible_from<texture, Args...>
 texture_ptr make_texture(Args&&... args)
 {
-    return std::make_shared<texture>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<texture>(std::forward<Args>(args)...);
 }
 
-CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+//With mipmaps, a sampling.max_lod of 0 is raised to the level count so the whole chain is used
+CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, mipmap_generation mipmaps = mipmap_generation::none);
+CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, mipmap_generation mipmaps = mipmap_generation::none);
+CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, mipmap_generation mipmaps = mipmap_generation::none);
+CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, mipmap_generation mipmaps = mipmap_generation::none);
+CAPTAL_API texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, mipmap_generation mipmaps = mipmap_generation::none);
+//Uploads the levels of chain starting at first_level, the texture size is the size of that level
+CAPTAL_API texture_ptr make_texture(const mip_chain& chain, std::uint32_t first_level = 0, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+
+using texture_stream_signal = cpt::signal<const std::filesystem::path&, const texture_ptr&>;
+
+namespace impl
+{
+
+class texture_stream_worker;
+
+}
+
+//Part of a texture, such as an image packed in an atlas, in pixels
+struct texture_region
+{
+    texture_ptr texture{};
+    std::uint32_t x{};
+    std::uint32_t y{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+};
 
 class CAPTAL_API texture_pool
 {
@@ -221,6 +280,17 @@ class CAPTAL_API texture_pool
         }
     };
 
+    struct pending_stream
+    {
+        std::filesystem::path path{};
+        tph::sampler_info sampling{};
+        color_space space{};
+        std::future<mip_chain> future{};
+        mip_chain chain{}; //Kept during the upload, load can not wait for the streaming queue
+        texture_ptr texture{}; //Uploaded on the streaming queue, published once the transfer ended
+        std::shared_ptr<std::atomic<bool>> uploaded{};
+    };
+
 public:
     static cpt::texture_ptr default_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space);
 
@@ -231,11 +301,11 @@ public:
     texture_pool();
     explicit texture_pool(load_callback_t load_callback);
 
-    ~texture_pool() = default;
+    ~texture_pool();
     texture_pool(const texture_pool&) = delete;
-    texture_pool& operator=(const texture_pool&) = default;
-    texture_pool(texture_pool&&) noexcept = default;
-    texture_pool& operator=(texture_pool&&) noexcept = default;
+    texture_pool& operator=(const texture_pool&) = delete;
+    texture_pool(texture_pool&&) noexcept;
+    texture_pool& operator=(texture_pool&&) noexcept;
 
     cpt::texture_ptr load(const std::filesystem::path& path, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
     cpt::texture_ptr load(const std::filesystem::path& path, const load_callback_t& load_callback, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
@@ -264,6 +334,18 @@ public:
     void remove(const std::filesystem::path& path);
     void remove(const texture_ptr& texture);
 
+    //Decodes the file and computes its mip chain on the pool's worker thread, streams are processed one at a time in request order.
+    //poll uploads the chain through the engine's streaming transfers once it is ready, then publishes the texture once the upload ended.
+    //The published texture replaces the previous one in the pool and is sent through stream_signal.
+    void stream(const std::filesystem::path& path, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+    //Must be called regularly, from the thread owning the pool, returns the number of streams still pending
+    std::size_t poll();
+
+    texture_stream_signal& stream_signal() noexcept
+    {
+        return m_stream_signal;
+    }
+
     void set_load_callback(load_callback_t new_callback)
     {
         m_load_callback = std::move(new_callback);
@@ -274,9 +356,15 @@ public:
         return m_load_callback;
     }
 
+private:
+    void publish(const std::filesystem::path& path, texture_ptr texture);
+
 private:
     std::unordered_map<std::filesystem::path, texture_ptr, path_hash> m_pool{};
     load_callback_t m_load_callback{};
+    std::vector<pending_stream> m_streams{};
+    texture_stream_signal m_stream_signal{};
+    std::unique_ptr<impl::texture_stream_worker> m_worker{}; //Created on the first stream, then kept alive
 };
 
 class CAPTAL_API tileset
@@ -295,6 +383,21 @@ public:
     :m_texture{std::move(texture)}
     ,m_tile_width{tile_width}
     ,m_tile_height{tile_height}
+    ,m_width{m_texture->width()}
+    ,m_height{m_texture->height()}
+    {
+
+    }
+
+    //Tiles are taken within the region only
+    explicit tileset(const texture_region& region, std::uint32_t tile_width, std::uint32_t tile_height)
+    :m_texture{region.texture}
+    ,m_tile_width{tile_width}
+    ,m_tile_height{tile_height}
+    ,m_x{region.x}
+    ,m_y{region.y}
+    ,m_width{region.width}
+    ,m_height{region.height}
     {
 
     }
@@ -317,8 +420,8 @@ public:
         const float width {static_cast<float>(m_texture->width())};
         const float height{static_cast<float>(m_texture->height())};
 
-        output.top_left     = vec2f{static_cast<float>(( col      * m_tile_width)) / width, static_cast<float>(( row      * m_tile_height)) / height};
-        output.bottom_right = vec2f{static_cast<float>(((col + 1) * m_tile_width)) / width, static_cast<float>(((row + 1) * m_tile_height)) / height};
+        output.top_left     = vec2f{static_cast<float>(m_x + ( col      * m_tile_width)) / width, static_cast<float>(m_y + ( row      * m_tile_height)) / height};
+        output.bottom_right = vec2f{static_cast<float>(m_x + ((col + 1) * m_tile_width)) / width, static_cast<float>(m_y + ((row + 1) * m_tile_height)) / height};
 
         return output;
     }
@@ -333,14 +436,25 @@ public:
         return m_tile_height;
     }
 
+    //Origin of the tiles in the texture
+    std::uint32_t x() const noexcept
+    {
+        return m_x;
+    }
+
+    std::uint32_t y() const noexcept
+    {
+        return m_y;
+    }
+
     std::uint32_t col_count() const noexcept
     {
-        return m_texture->width() / m_tile_width;
+        return m_width / m_tile_width;
     }
 
     std::uint32_t row_count() const noexcept
     {
-        return m_texture->height() / m_tile_height;
+        return m_height / m_tile_height;
     }
 
     const texture_ptr& texture() const noexcept
@@ -352,6 +466,10 @@ private:
     texture_ptr m_texture{};
     std::uint32_t m_tile_width{};
     std::uint32_t m_tile_height{};
+    std::uint32_t m_x{};
+    std::uint32_t m_y{};
+    std::uint32_t m_width{};
+    std::uint32_t m_height{};
 };
 
 }
@@ -1,5 +1,7 @@
 #include "uniform_buffer.hpp"
 
+#include <cassert>
+
 #include <tephra/commands.hpp>
 
 #include "engine.hpp"
@@ -31,6 +33,13 @@ void uniform_buffer::upload(std::size_t index)
     m_buffer.upload(m_parts[index].offset, m_parts[index].size);
 }
 
+void uniform_buffer::upload(std::size_t index, std::uint64_t offset, std::uint64_t size)
+{
+    assert(offset + size <= m_parts[index].size && "cpt::uniform_buffer::upload called with out of bounds range.");
+
+    m_buffer.upload(m_parts[index].offset + offset, size);
+}
+
 std::vector<uniform_buffer::buffer_part_info> uniform_buffer::compute_part_info(std::span<const buffer_part> parts)
 {
     const std::uint64_t uniform_alignment{engine::instance().graphics_device().limits().min_uniform_buffer_alignment};
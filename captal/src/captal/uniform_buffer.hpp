@@ -80,6 +80,8 @@ public:
 
     void upload();
     void upload(std::size_t index);
+    //Uploads size bytes at offset within part index
+    void upload(std::size_t index, std::uint64_t offset, std::uint64_t size);
 
     template<typename T>
     T& get(std::size_t index) noexcept
@@ -127,7 +129,7 @@ using uniform_buffer_weak_ptr = std::weak_ptr<uniform_buffer>;
 template<typename... Args>
 uniform_buffer_ptr make_uniform_buffer(Args&&... args)
 {
-    return std::make_shared<uniform_buffer>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<uniform_buffer>(std::forward<Args>(args)...);
 }
 
 }
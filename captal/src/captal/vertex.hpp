@@ -25,6 +25,12 @@
 
 #include "config.hpp"
 
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
 #include <captal_foundation/math.hpp>
 
 namespace cpt
@@ -37,6 +43,89 @@ struct vertex
     vec2f texture_coord{};
 };
 
+//Positions are integers relative to the renderable origin, colors are RGBA8 unorm and texture coordinates are 16-bit unorm.
+//Positions are read as R16G16_SINT, the only 16-bit integer format that all devices support for vertex buffers,
+//so vertex shaders take them as an ivec2 (see engine::compact_vertex_shader). Other inputs are the same as cpt::vertex.
+struct compact_vertex
+{
+    std::array<std::int16_t, 2> position{};
+    std::array<std::uint8_t, 4> color{};
+    std::array<std::uint16_t, 2> texture_coord{};
+};
+
+static_assert(sizeof(compact_vertex) == 12);
+
+//Per-instance data of cpt::particle_system, the vertices of the instanced quad are regular cpt::vertex
+struct particle_instance
+{
+    vec2f position{};
+    float size{};
+    float rotation{};
+    std::array<std::uint8_t, 4> color{};
+};
+
+static_assert(sizeof(particle_instance) == 20);
+
+enum class vertex_layout : std::uint32_t
+{
+    standard = 0, //cpt::vertex
+    compact = 1, //cpt::compact_vertex
+    particle = 2, //cpt::vertex per vertex, cpt::particle_instance per instance
+};
+
+constexpr std::size_t vertex_size(vertex_layout layout) noexcept
+{
+    return layout == vertex_layout::compact ? sizeof(compact_vertex) : sizeof(vertex);
+}
+
+inline std::int16_t pack_position(float value) noexcept
+{
+    assert(-32768.0f <= value && value <= 32767.0f && "cpt::pack_position called with a value out of the 16-bit range.");
+
+    return static_cast<std::int16_t>(std::lround(value));
+}
+
+inline std::uint8_t pack_unorm8(float value) noexcept
+{
+    return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline std::uint16_t pack_unorm16(float value) noexcept
+{
+    return static_cast<std::uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+inline std::array<std::int16_t, 2> pack_position(const vec2f& position) noexcept
+{
+    return std::array<std::int16_t, 2>{pack_position(position.x()), pack_position(position.y())};
+}
+
+inline std::array<std::uint8_t, 4> pack_color(const vec4f& color) noexcept
+{
+    return std::array<std::uint8_t, 4>{pack_unorm8(color.x()), pack_unorm8(color.y()), pack_unorm8(color.z()), pack_unorm8(color.w())};
+}
+
+inline std::array<std::uint16_t, 2> pack_texture_coord(const vec2f& texture_coord) noexcept
+{
+    return std::array<std::uint16_t, 2>{pack_unorm16(texture_coord.x()), pack_unorm16(texture_coord.y())};
+}
+
+//The z coordinate is dropped, and texture coordinates are clamped to [0, 1]
+inline compact_vertex pack_vertex(const vertex& vertex) noexcept
+{
+    return compact_vertex{pack_position(vec2f{vertex.position}), pack_color(vertex.color), pack_texture_coord(vertex.texture_coord)};
+}
+
+inline vertex unpack_vertex(const compact_vertex& vertex) noexcept
+{
+    return cpt::vertex
+    {
+        vec3f{static_cast<float>(vertex.position[0]), static_cast<float>(vertex.position[1]), 0.0f},
+        vec4f{vertex.color[0] / 255.0f, vertex.color[1] / 255.0f, vertex.color[2] / 255.0f, vertex.color[3] / 255.0f},
+        vec2f{vertex.texture_coord[0] / 65535.0f, vertex.texture_coord[1] / 65535.0f}
+    };
+}
+
 }
 
 #endif
@@ -62,11 +62,7 @@ void view::bind(frame_render_info info)
     if(std::exchange(m_need_descriptor_update, false))
     {
         m_set.reset();
-        m_to_keep.clear();
-
-        const auto to_bind{m_render_technique->layout()->bindings(render_layout::view_index)};
-
-        m_set = m_render_technique->layout()->make_set(render_layout::view_index);
+        m_set = m_render_technique->layout()->make_set(render_layout::view_index, m_bindings);
 
         #ifdef CAPTAL_DEBUG
         if(!std::empty(m_name))
@@ -74,41 +70,33 @@ void view::bind(frame_render_info info)
             tph::set_object_name(engine::instance().renderer(), m_set->set(), m_name + " descriptor set");
         }
         #endif
-
-        std::vector<tph::descriptor_write> writes{};
-        writes.reserve(std::size(to_bind));
-
-        for(auto&& binding : to_bind)
-        {
-            const auto local{m_bindings.try_get(binding.binding)};
-
-            if(local)
-            {
-                writes.emplace_back(make_descriptor_write(m_set->set(), binding.binding, *local));
-                m_to_keep.emplace_back(get_binding_resource(*local));
-            }
-            else
-            {
-                const auto fallback{m_render_technique->layout()->default_binding(render_layout::view_index, binding.binding)};
-                assert(fallback && "cpt::view::bind can not find any suitable binding, neither the view nor the render layout have a binding for specified index.");
-
-                writes.emplace_back(make_descriptor_write(m_set->set(), binding.binding, *fallback));
-                m_to_keep.emplace_back(get_binding_resource(*fallback));
-            }
-        }
-
-        tph::write_descriptors(engine::instance().renderer(), writes);
     }
 
     tph::cmd::set_viewport(info.buffer, m_viewport);
     tph::cmd::set_scissor(info.buffer, m_scissor);
 
     tph::cmd::bind_pipeline(info.buffer, m_render_technique->pipeline());
-    tph::cmd::bind_descriptor_set(info.buffer, 0, m_set->set(), m_render_technique->layout()->pipeline_layout());
+    if(m_render_technique->layout()->has_dynamic_offsets(render_layout::view_index))
+    {
+        const auto offsets{m_render_technique->layout()->dynamic_offsets(render_layout::view_index, m_bindings)};
+
+        tph::cmd::bind_descriptor_set(info.buffer, 0, m_set->set(), m_render_technique->layout()->pipeline_layout(), offsets);
+    }
+    else
+    {
+        tph::cmd::bind_descriptor_set(info.buffer, 0, m_set->set(), m_render_technique->layout()->pipeline_layout());
+    }
 
     m_push_constants.push(info.buffer, m_render_technique->layout(), render_layout::view_index);
 
-    info.keeper.keep(std::begin(m_to_keep), std::end(m_to_keep));
+    if(const auto index{m_render_technique->layout()->bindless_textures_index()}; index)
+    {
+        const auto& table{engine::instance().bindless_textures()};
+
+        tph::cmd::bind_descriptor_set(info.buffer, *index, table->set(), m_render_technique->layout()->pipeline_layout());
+        info.keeper.keep(table);
+    }
+
     info.keeper.keep(m_set);
     info.keeper.keep(m_render_technique);
 }
@@ -155,7 +143,8 @@ void view::set_binding(std::uint32_t index, cpt::binding binding)
     const auto  it      {std::find_if(std::begin(bindings), std::end(bindings), predicate)};
 
     assert(it != std::end(bindings) && "cpt::view::set_binding index must correspond to one of the render layout's bindings.");
-    assert(it->type == convert_binding_type(get_binding_type(binding)) && "cpt::view::set_binding binding's type does not correspond to the layout binding's type at index.");
+    assert((it->type == convert_binding_type(get_binding_type(binding)) || (it->type == tph::descriptor_type::uniform_buffer_dynamic && get_binding_type(binding) == binding_type::uniform_buffer))
+        && "cpt::view::set_binding binding's type does not correspond to the layout binding's type at index.");
 #endif
 
     m_bindings.set(index, std::move(binding));
@@ -30,6 +30,7 @@
 
 #include <captal_foundation/math.hpp>
 
+#include "algorithm.hpp"
 #include "asynchronous_resource.hpp"
 #include "push_constant_buffer.hpp"
 #include "uniform_buffer.hpp"
@@ -259,6 +260,14 @@ public:
         return m_type;
     }
 
+    //World space area covered by the view, matches the projection computed in upload
+    bounding_box visible_area() const noexcept
+    {
+        const vec2f top_left{vec2f{m_position} - (vec2f{m_origin} * vec2f{m_scale})};
+
+        return bounding_box{top_left, top_left + (m_size * vec2f{m_scale})};
+    }
+
 #ifdef CAPTAL_DEBUG
     void set_name(std::string_view name);
 #else
@@ -274,7 +283,6 @@ private:
     binding_buffer m_bindings{};
     push_constants_buffer m_push_constants{};
     descriptor_set_ptr m_set{};
-    std::vector<asynchronous_resource_ptr> m_to_keep{};
 
     tph::viewport m_viewport{};
     tph::scissor m_scissor{};
@@ -20,3 +20,718 @@
 //OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 //SOFTWARE.
 
+#include "widgets.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <bit>
+
+namespace cpt
+{
+
+static constexpr std::uint32_t form_initial_quads{64};
+
+static bool is_horizontal(layout_direction direction) noexcept
+{
+    return direction == layout_direction::left_to_right || direction == layout_direction::right_to_left;
+}
+
+static bool is_reversed(layout_direction direction) noexcept
+{
+    return direction == layout_direction::right_to_left || direction == layout_direction::bottom_to_top;
+}
+
+static std::int32_t horizontal_offset(layout_alignement alignement, std::int32_t free_space) noexcept
+{
+    if(static_cast<bool>(alignement & layout_alignement::right))
+    {
+        return free_space;
+    }
+    else if(static_cast<bool>(alignement & layout_alignement::hcenter))
+    {
+        return free_space / 2;
+    }
+
+    return 0;
+}
+
+static std::int32_t vertical_offset(layout_alignement alignement, std::int32_t free_space) noexcept
+{
+    if(static_cast<bool>(alignement & layout_alignement::bottom))
+    {
+        return free_space;
+    }
+    else if(static_cast<bool>(alignement & layout_alignement::vcenter))
+    {
+        return free_space / 2;
+    }
+
+    return 0;
+}
+
+static widget_rect content_rect(const widget_rect& rect, const widget_layout& layout) noexcept
+{
+    const auto horizontal_margins{std::min(layout.left_margin + layout.right_margin, rect.width)};
+    const auto vertical_margins  {std::min(layout.top_margin + layout.bottom_margin, rect.height)};
+
+    return widget_rect
+    {
+        .x = rect.x + static_cast<std::int32_t>(layout.left_margin),
+        .y = rect.y + static_cast<std::int32_t>(layout.top_margin),
+        .width = rect.width - horizontal_margins,
+        .height = rect.height - vertical_margins
+    };
+}
+
+static bool contains(const widget_rect& rect, std::int32_t x, std::int32_t y) noexcept
+{
+    return x >= rect.x && y >= rect.y && x < rect.x + static_cast<std::int32_t>(rect.width) && y < rect.y + static_cast<std::int32_t>(rect.height);
+}
+
+form::form(text_drawer& drawer, std::uint32_t width, std::uint32_t height, const widget_info& info)
+:basic_renderable{form_initial_quads * 4, form_initial_quads * 6, 0}
+,m_drawer{&drawer}
+,m_width{width}
+,m_height{height}
+,m_quad_capacity{form_initial_quads}
+{
+    const auto indices{basic_renderable::indices()};
+
+    for(std::uint32_t i{}; i < m_quad_capacity; ++i)
+    {
+        const std::uint32_t shift{i * 4};
+
+        indices[i * 6 + 0] = shift + 0;
+        indices[i * 6 + 1] = shift + 1;
+        indices[i * 6 + 2] = shift + 2;
+        indices[i * 6 + 3] = shift + 2;
+        indices[i * 6 + 4] = shift + 3;
+        indices[i * 6 + 5] = shift + 0;
+    }
+
+    m_nodes.emplace_back(node{.info = info});
+
+    check_texture();
+}
+
+widget_id form::add(widget_id parent, widget_info info)
+{
+    assert(parent < std::size(m_nodes) && m_nodes[parent].alive && "cpt::form::add called with an invalid parent.");
+
+    widget_id output{};
+
+    if(!std::empty(m_free_nodes))
+    {
+        output = m_free_nodes.back();
+        m_free_nodes.pop_back();
+
+        m_nodes[output] = node{.info = std::move(info), .parent = parent};
+    }
+    else
+    {
+        output = static_cast<widget_id>(std::size(m_nodes));
+        m_nodes.emplace_back(node{.info = std::move(info), .parent = parent});
+    }
+
+    m_nodes[parent].children.emplace_back(output);
+    invalidate_measure(parent);
+
+    return output;
+}
+
+void form::remove(widget_id widget)
+{
+    assert(widget != root && "cpt::form::remove can not remove the root widget.");
+
+    auto& siblings{m_nodes[m_nodes[widget].parent].children};
+    siblings.erase(std::find(std::begin(siblings), std::end(siblings), widget));
+
+    invalidate_measure(m_nodes[widget].parent);
+
+    //Holes left in the vertex buffer are cleared by the next repack
+    const auto release = [this](auto& self, widget_id current) -> void
+    {
+        for(const auto child : m_nodes[current].children)
+        {
+            self(self, child);
+        }
+
+        //The removed widget can't receive mouse_left, next mouse event won't reference it
+        if(current == m_hovered)
+        {
+            m_hovered = no_widget;
+        }
+
+        m_nodes[current] = node{.alive = false};
+        m_free_nodes.emplace_back(current);
+    };
+
+    release(release, widget);
+
+    m_repack = true;
+}
+
+void form::set_text(widget_id widget, std::string text)
+{
+    auto& node{m_nodes[widget]};
+
+    node.info.text = std::move(text);
+    node.text_dirty = true;
+
+    invalidate_measure(widget);
+    invalidate_geometry(widget);
+}
+
+void form::set_text_color(widget_id widget, const color& color)
+{
+    m_nodes[widget].info.text_color = color;
+
+    invalidate_geometry(widget);
+}
+
+void form::set_background(widget_id widget, const color& color)
+{
+    m_nodes[widget].info.background = color;
+
+    invalidate_geometry(widget);
+}
+
+void form::set_layout(widget_id widget, const widget_layout& layout)
+{
+    m_nodes[widget].info.layout = layout;
+
+    invalidate_measure(widget);
+    invalidate_geometry(widget);
+}
+
+void form::set_size_constraints(widget_id widget, std::uint32_t min_width, std::uint32_t min_height, std::uint32_t max_width, std::uint32_t max_height)
+{
+    auto& info{m_nodes[widget].info};
+
+    info.min_width = min_width;
+    info.min_height = min_height;
+    info.max_width = max_width;
+    info.max_height = max_height;
+
+    invalidate_measure(widget);
+}
+
+void form::show(widget_id widget)
+{
+    if(!m_nodes[widget].info.visible)
+    {
+        m_nodes[widget].info.visible = true;
+
+        invalidate_measure(widget);
+    }
+}
+
+void form::hide(widget_id widget)
+{
+    if(m_nodes[widget].info.visible)
+    {
+        m_nodes[widget].info.visible = false;
+
+        invalidate_measure(widget);
+    }
+}
+
+void form::resize(std::uint32_t width, std::uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+}
+
+void form::update()
+{
+    if(std::empty(m_nodes))
+    {
+        return;
+    }
+
+    measure(root);
+    arrange(root, widget_rect{0, 0, m_width, m_height});
+
+    for(const auto widget : m_dirty_geometry)
+    {
+        if(required_quads(m_nodes[widget]) > m_nodes[widget].quad_capacity)
+        {
+            m_repack = true;
+            break;
+        }
+    }
+
+    if(m_repack)
+    {
+        repack();
+    }
+    else if(!std::empty(m_dirty_geometry))
+    {
+        const auto vertices{basic_renderable::vertices()};
+
+        for(const auto widget : m_dirty_geometry)
+        {
+            write_geometry(widget, vertices);
+        }
+    }
+
+    for(const auto widget : m_dirty_geometry)
+    {
+        m_nodes[widget].geometry_dirty = false;
+    }
+
+    m_dirty_geometry.clear();
+}
+
+void form::upload(memory_transfer_info info)
+{
+    update();
+
+    //Newly shaped glyphs may grow the atlas, which moves every texture coordinate
+    m_drawer->upload();
+
+    if(check_texture())
+    {
+        update();
+    }
+
+    basic_renderable::upload(info);
+}
+
+void form::dispatch_event(const apr::event& event)
+{
+    if(!std::holds_alternative<apr::mouse_event>(event))
+    {
+        return;
+    }
+
+    const auto& mouse_event{std::get<apr::mouse_event>(event)};
+
+    const auto x{mouse_event.x - static_cast<std::int32_t>(position().x())};
+    const auto y{mouse_event.y - static_cast<std::int32_t>(position().y())};
+    const auto target{widget_at(x, y)};
+
+    if(target != m_hovered)
+    {
+        if(m_hovered != no_widget)
+        {
+            m_mouse_left(m_hovered, mouse_event);
+        }
+
+        m_hovered = target;
+
+        if(m_hovered != no_widget)
+        {
+            m_mouse_entered(m_hovered, mouse_event);
+        }
+    }
+
+    if(target == no_widget)
+    {
+        return;
+    }
+
+    if(mouse_event.type == apr::mouse_event::button_pressed)
+    {
+        m_mouse_button_pressed(target, mouse_event);
+    }
+    else if(mouse_event.type == apr::mouse_event::button_released)
+    {
+        m_mouse_button_released(target, mouse_event);
+    }
+    else if(mouse_event.type == apr::mouse_event::moved)
+    {
+        m_mouse_moved(target, mouse_event);
+    }
+    else if(mouse_event.type == apr::mouse_event::wheel_scrolled)
+    {
+        m_mouse_wheel_scrolled(target, mouse_event);
+    }
+}
+
+widget_id form::widget_at(std::int32_t x, std::int32_t y) const noexcept
+{
+    if(std::empty(m_nodes) || !m_nodes[root].shown || !contains(m_nodes[root].rect, x, y))
+    {
+        return no_widget;
+    }
+
+    widget_id output{root};
+
+    bool found{true};
+    while(found)
+    {
+        found = false;
+
+        //Last children are drawn over the first ones
+        const auto& children{m_nodes[output].children};
+        for(auto it{std::rbegin(children)}; it != std::rend(children); ++it)
+        {
+            if(m_nodes[*it].shown && contains(m_nodes[*it].rect, x, y))
+            {
+                output = *it;
+                found = true;
+                break;
+            }
+        }
+    }
+
+    return output;
+}
+
+void form::invalidate_measure(widget_id widget)
+{
+    //A size change may change the size of every ancestor, but never the one of other subtrees
+    while(widget != no_widget && !m_nodes[widget].measure_dirty)
+    {
+        m_nodes[widget].measure_dirty = true;
+        m_nodes[widget].arrange_dirty = true;
+
+        widget = m_nodes[widget].parent;
+    }
+
+    //Ancestors of a dirty widget are always dirty, so the root may be the only one left
+    m_nodes[root].arrange_dirty = true;
+}
+
+void form::invalidate_geometry(widget_id widget)
+{
+    if(!m_nodes[widget].geometry_dirty)
+    {
+        m_nodes[widget].geometry_dirty = true;
+        m_dirty_geometry.emplace_back(widget);
+    }
+}
+
+void form::hide_subtree(widget_id widget)
+{
+    auto& node{m_nodes[widget]};
+
+    if(node.shown)
+    {
+        node.shown = false;
+        node.arrange_dirty = true;
+
+        invalidate_geometry(widget);
+
+        for(const auto child : node.children)
+        {
+            hide_subtree(child);
+        }
+    }
+}
+
+void form::measure(widget_id widget)
+{
+    auto& node{m_nodes[widget]};
+
+    if(!node.measure_dirty)
+    {
+        return;
+    }
+
+    if(node.text_dirty)
+    {
+        if(std::empty(node.info.text))
+        {
+            node.text_vertices.clear();
+            node.text_size = text_bounds{};
+        }
+        else
+        {
+            auto geometry{m_drawer->draw_geometry(node.info.text)};
+
+            node.text_vertices = std::move(geometry.vertices);
+            node.text_size = geometry.bounds;
+        }
+
+        node.text_dirty = false;
+    }
+
+    const auto& layout    {node.info.layout};
+    const bool  horizontal{is_horizontal(layout.direction)};
+
+    std::uint32_t main_size{};
+    std::uint32_t cross_size{};
+    std::uint32_t visible_count{};
+
+    for(const auto child : node.children)
+    {
+        if(m_nodes[child].info.visible)
+        {
+            measure(child);
+
+            const auto& child_node{m_nodes[child]};
+
+            main_size += horizontal ? child_node.preferred_width : child_node.preferred_height;
+            cross_size = std::max(cross_size, horizontal ? child_node.preferred_height : child_node.preferred_width);
+
+            ++visible_count;
+        }
+    }
+
+    if(visible_count > 1)
+    {
+        const auto spacing{static_cast<std::int64_t>(layout.spacing) * (visible_count - 1)};
+        main_size = static_cast<std::uint32_t>(std::max<std::int64_t>(main_size + spacing, 0));
+    }
+
+    const auto content_width {std::max(horizontal ? main_size : cross_size, node.text_size.width)};
+    const auto content_height{std::max(horizontal ? cross_size : main_size, node.text_size.height)};
+
+    node.preferred_width  = std::clamp(content_width + layout.left_margin + layout.right_margin, node.info.min_width, std::max(node.info.min_width, node.info.max_width));
+    node.preferred_height = std::clamp(content_height + layout.top_margin + layout.bottom_margin, node.info.min_height, std::max(node.info.min_height, node.info.max_height));
+    node.measure_dirty = false;
+}
+
+void form::arrange(widget_id widget, const widget_rect& rect)
+{
+    auto& node{m_nodes[widget]};
+
+    //Clean subtree at the same place, nothing to do
+    if(node.shown && !node.arrange_dirty && node.rect == rect)
+    {
+        return;
+    }
+
+    if(!node.shown || node.rect != rect)
+    {
+        invalidate_geometry(widget);
+    }
+
+    node.rect = rect;
+    node.shown = true;
+    node.arrange_dirty = false;
+
+    const auto& layout    {node.info.layout};
+    const bool  horizontal{is_horizontal(layout.direction)};
+    const auto  content   {content_rect(rect, layout)};
+
+    std::int64_t  total{};
+    std::uint32_t visible_count{};
+
+    for(const auto child : node.children)
+    {
+        if(m_nodes[child].info.visible)
+        {
+            total += horizontal ? m_nodes[child].preferred_width : m_nodes[child].preferred_height;
+            ++visible_count;
+        }
+        else
+        {
+            hide_subtree(child);
+        }
+    }
+
+    if(visible_count > 1)
+    {
+        total += static_cast<std::int64_t>(layout.spacing) * (visible_count - 1);
+    }
+
+    const auto main_space{static_cast<std::int64_t>(horizontal ? content.width : content.height)};
+    const auto free_space{static_cast<std::int32_t>(main_space - total)};
+
+    std::int32_t position{horizontal ? content.x + horizontal_offset(layout.alignement, free_space) : content.y + vertical_offset(layout.alignement, free_space)};
+
+    const auto place = [&](widget_id child)
+    {
+        const auto& child_node{m_nodes[child]};
+
+        if(!child_node.info.visible)
+        {
+            return;
+        }
+
+        widget_rect child_rect{};
+
+        if(horizontal)
+        {
+            child_rect.width  = child_node.preferred_width;
+            child_rect.height = std::min(child_node.preferred_height, content.height);
+            child_rect.x = position;
+            child_rect.y = content.y + vertical_offset(layout.alignement, static_cast<std::int32_t>(content.height - child_rect.height));
+
+            position += static_cast<std::int32_t>(child_rect.width) + layout.spacing;
+        }
+        else
+        {
+            child_rect.width  = std::min(child_node.preferred_width, content.width);
+            child_rect.height = child_node.preferred_height;
+            child_rect.x = content.x + horizontal_offset(layout.alignement, static_cast<std::int32_t>(content.width - child_rect.width));
+            child_rect.y = position;
+
+            position += static_cast<std::int32_t>(child_rect.height) + layout.spacing;
+        }
+
+        arrange(child, child_rect);
+    };
+
+    if(is_reversed(layout.direction))
+    {
+        for(auto it{std::rbegin(node.children)}; it != std::rend(node.children); ++it)
+        {
+            place(*it);
+        }
+    }
+    else
+    {
+        for(const auto child : node.children)
+        {
+            place(child);
+        }
+    }
+}
+
+std::uint32_t form::required_quads(const node& data) const noexcept
+{
+    if(!data.alive || !data.shown)
+    {
+        return 0;
+    }
+
+    const std::uint32_t background{data.info.background.alpha > 0.0f ? 1u : 0u};
+
+    return background + static_cast<std::uint32_t>(std::size(data.text_vertices) / 4);
+}
+
+void form::repack()
+{
+    std::uint32_t total{};
+
+    for(auto& node : m_nodes)
+    {
+        const auto required{required_quads(node)};
+
+        //Some room to grow, so editing a text rarely moves every widget
+        node.first_quad = total;
+        node.quad_capacity = required > 0 ? std::bit_ceil(required) : 0;
+
+        total += node.quad_capacity;
+    }
+
+    if(total > m_quad_capacity)
+    {
+        m_quad_capacity = std::max(total, m_quad_capacity * 2);
+
+        reset(m_quad_capacity * 4, m_quad_capacity * 6);
+
+        const auto indices{basic_renderable::indices()};
+
+        for(std::uint32_t i{}; i < m_quad_capacity; ++i)
+        {
+            const std::uint32_t shift{i * 4};
+
+            indices[i * 6 + 0] = shift + 0;
+            indices[i * 6 + 1] = shift + 1;
+            indices[i * 6 + 2] = shift + 2;
+            indices[i * 6 + 3] = shift + 2;
+            indices[i * 6 + 4] = shift + 3;
+            indices[i * 6 + 5] = shift + 0;
+        }
+    }
+
+    const auto vertices{basic_renderable::vertices()};
+    std::fill(std::begin(vertices), std::end(vertices), vertex{});
+
+    for(widget_id i{}; i < std::size(m_nodes); ++i)
+    {
+        if(m_nodes[i].alive)
+        {
+            write_geometry(i, vertices);
+        }
+    }
+
+    m_repack = false;
+}
+
+void form::write_geometry(widget_id widget, std::span<vertex> vertices) noexcept
+{
+    auto& node{m_nodes[widget]};
+
+    //Unused quads are left degenerated, they are culled for free by the rasterizer
+    const auto quads{vertices.subspan(node.first_quad * 4, node.quad_capacity * 4)};
+    std::fill(std::begin(quads), std::end(quads), vertex{});
+
+    node.quad_count = required_quads(node);
+
+    if(node.quad_count == 0)
+    {
+        return;
+    }
+
+    auto it{std::begin(quads)};
+
+    if(node.info.background.alpha > 0.0f)
+    {
+        const auto x1{static_cast<float>(node.rect.x)};
+        const auto y1{static_cast<float>(node.rect.y)};
+        const auto x2{x1 + static_cast<float>(node.rect.width)};
+        const auto y2{y1 + static_cast<float>(node.rect.height)};
+        const auto color{static_cast<vec4f>(node.info.background)};
+
+        *it++ = vertex{vec3f{x1, y1, 0.0f}, color, m_solid_texel};
+        *it++ = vertex{vec3f{x2, y1, 0.0f}, color, m_solid_texel};
+        *it++ = vertex{vec3f{x2, y2, 0.0f}, color, m_solid_texel};
+        *it++ = vertex{vec3f{x1, y2, 0.0f}, color, m_solid_texel};
+    }
+
+    if(!std::empty(node.text_vertices))
+    {
+        const auto content{content_rect(node.rect, node.info.layout)};
+        const auto free_x {static_cast<std::int32_t>(content.width) - static_cast<std::int32_t>(node.text_size.width)};
+        const auto free_y {static_cast<std::int32_t>(content.height) - static_cast<std::int32_t>(node.text_size.height)};
+
+        const vec3f shift
+        {
+            static_cast<float>(content.x + horizontal_offset(node.info.layout.alignement, free_x)),
+            static_cast<float>(content.y + vertical_offset(node.info.layout.alignement, free_y)),
+            0.0f
+        };
+
+        //Text drawer colors are modulated, so outlines and underlines keep their own color
+        const auto color{static_cast<vec4f>(node.info.text_color)};
+
+        for(const auto& vertex : node.text_vertices)
+        {
+            *it++ = cpt::vertex{vertex.position + shift, vertex.color * color, vertex.texture_coord};
+        }
+    }
+}
+
+bool form::check_texture()
+{
+    const auto& texture{m_drawer->texture()};
+
+    if(texture == m_texture)
+    {
+        return false;
+    }
+
+    //The atlas has been resized, texture coordinates are relative to its size
+    if(m_texture)
+    {
+        const vec2f factor
+        {
+            static_cast<float>(m_texture->width()) / static_cast<float>(texture->width()),
+            static_cast<float>(m_texture->height()) / static_cast<float>(texture->height())
+        };
+
+        for(auto& node : m_nodes)
+        {
+            for(auto& vertex : node.text_vertices)
+            {
+                vertex.texture_coord *= factor;
+            }
+        }
+    }
+
+    m_texture = texture;
+    m_solid_texel = m_drawer->solid_texel();
+    m_repack = true;
+
+    set_binding(1, m_texture);
+
+    return true;
+}
+
+}
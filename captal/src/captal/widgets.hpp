@@ -29,6 +29,8 @@
 #include <tuple>
 #include <concepts>
 #include <string>
+#include <vector>
+#include <span>
 
 #include "render_window.hpp"
 #include "text.hpp"
@@ -109,12 +111,11 @@ concept parent_widget = requires(T w)
     requires widget<T>;
     requires widget_tuple<std::decay_t<decltype(w.children)>> || widget<std::decay_t<decltype(w.children)>>;
 };
-/*
 enum class layout_alignement : std::uint32_t
 {
     left    = 0x01,
     right   = 0x02,
-    hcenter = 0x40,
+    hcenter = 0x04,
     top     = 0x10,
     bottom  = 0x20,
     vcenter = 0x40,
@@ -128,7 +129,7 @@ enum class layout_alignement : std::uint32_t
     center_right  = vcenter | right,
     center_left   = vcenter | left,
     center        = vcenter | hcenter,
-};*/
+};
 
 enum class layout_direction : std::uint32_t
 {
@@ -257,59 +258,60 @@ struct box_layout
     }
 };
 
-class form final : public basic_renderable
-{
-    class widget_container_base
-    {
-    public:
-        widget_container_base() = default;
-        virtual ~widget_container_base() = default;
-        widget_container_base(const widget_container_base&) = delete;
-        widget_container_base& operator=(const widget_container_base&) = delete;
-        widget_container_base(widget_container_base&&) noexcept = delete;
-        widget_container_base& operator=(widget_container_base&&) noexcept = delete;
-
-        virtual void resize(std::uint32_t width, std::uint32_t height) = 0;
-    };
+using widget_id = std::uint32_t;
 
-    template<widget Widget>
-    class widget_container final : public widget_container_base
-    {
-    public:
-        using widget_type = Widget;
+inline constexpr widget_id no_widget{std::numeric_limits<widget_id>::max()};
 
-    public:
-        widget_container() = default;
+struct widget_rect
+{
+    std::int32_t  x{};
+    std::int32_t  y{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+
+    friend bool operator==(const widget_rect&, const widget_rect&) noexcept = default;
+};
 
-        template<typename T>
-        widget_container(T&& widget)
-        :m_widget{std::forward<T>(widget)}
-        {
+//How a widget places its content: its children and its text
+struct widget_layout
+{
+    std::uint32_t     top_margin{};
+    std::uint32_t     right_margin{};
+    std::uint32_t     bottom_margin{};
+    std::uint32_t     left_margin{};
+    std::int32_t      spacing{};
+    layout_direction  direction{layout_direction::top_to_bottom};
+    layout_alignement alignement{layout_alignement::top_left};
+};
 
-        }
+struct widget_info
+{
+    std::uint32_t min_width{};
+    std::uint32_t min_height{};
+    std::uint32_t max_width{std::numeric_limits<std::uint32_t>::max()};
+    std::uint32_t max_height{std::numeric_limits<std::uint32_t>::max()};
 
-        ~widget_container() = default;
-        widget_container(const widget_container&) = delete;
-        widget_container& operator=(const widget_container&) = delete;
-        widget_container(widget_container_base&&) noexcept = delete;
-        widget_container& operator=(widget_container&&) noexcept = delete;
+    cpt::color background{colors::transparent};
+    cpt::color text_color{colors::black};
+    std::string text{};
 
-        void resize(std::uint32_t width, std::uint32_t height) override
-        {
-            m_widget.resize(width, height);
-        }
+    widget_layout layout{};
+    bool visible{true};
+};
 
-    private:
-        widget_type m_widget{};
-    };
+using form_mouse_event_signal = cpt::signal<widget_id, const apr::mouse_event&>;
 
+//Retained widget tree, rendered as a single renderable.
+//Layout results are cached per widget, and an update only measures, arranges and rewrites the widgets that changed.
+//Backgrounds and texts of every widget share one vertex buffer, textured with the atlas of the text drawer, so the whole form is one draw.
+class CAPTAL_API form final : public basic_renderable
+{
 public:
-    template<widget Widget>
-    form(Widget&& top_widget)
-    :m_widget{std::make_unique<widget_container<Widget>>(std::forward<Widget>(top_widget))}
-    {
+    static constexpr widget_id root{0};
 
-    }
+public:
+    form() = default;
+    explicit form(text_drawer& drawer, std::uint32_t width, std::uint32_t height, const widget_info& info = widget_info{});
 
     ~form() = default;
     form(const form&) = delete;
@@ -317,20 +319,135 @@ public:
     form(form&&) noexcept = default;
     form& operator=(form&&) noexcept = default;
 
-    void dispatch_event(const apr::event& event)
+    widget_id add(widget_id parent, widget_info info);
+    void remove(widget_id widget);
+
+    void set_text(widget_id widget, std::string text);
+    void set_text_color(widget_id widget, const color& color);
+    void set_background(widget_id widget, const color& color);
+    void set_layout(widget_id widget, const widget_layout& layout);
+    void set_size_constraints(widget_id widget, std::uint32_t min_width, std::uint32_t min_height, std::uint32_t max_width, std::uint32_t max_height);
+    void show(widget_id widget);
+    void hide(widget_id widget);
+
+    void resize(std::uint32_t width, std::uint32_t height);
+
+    //Brings the layout and the vertices up to date, this is done by upload() if needed
+    void update();
+    void upload(memory_transfer_info info);
+
+    void dispatch_event(const apr::event& event);
+
+    //The deepest visible widget under the given point, in the form's local space
+    widget_id widget_at(std::int32_t x, std::int32_t y) const noexcept;
+
+    const widget_info& info(widget_id widget) const noexcept
+    {
+        return m_nodes[widget].info;
+    }
+
+    widget_id parent(widget_id widget) const noexcept
+    {
+        return m_nodes[widget].parent;
+    }
+
+    std::span<const widget_id> children(widget_id widget) const noexcept
+    {
+        return m_nodes[widget].children;
+    }
+
+    //Only meaningful once the form is up to date
+    const widget_rect& rect(widget_id widget) const noexcept
+    {
+        return m_nodes[widget].rect;
+    }
+
+    widget_id hovered() const noexcept
     {
+        return m_hovered;
+    }
 
+    std::uint32_t width() const noexcept
+    {
+        return m_width;
     }
 
-    void resize(std::uint32_t width, std::uint32_t height)
+    std::uint32_t height() const noexcept
     {
-        m_widget->resize(width, height);
+        return m_height;
     }
 
+    form_mouse_event_signal& on_mouse_button_pressed() noexcept {return m_mouse_button_pressed;}
+    form_mouse_event_signal& on_mouse_button_released() noexcept {return m_mouse_button_released;}
+    form_mouse_event_signal& on_mouse_moved() noexcept {return m_mouse_moved;}
+    form_mouse_event_signal& on_mouse_wheel_scrolled() noexcept {return m_mouse_wheel_scrolled;}
+    form_mouse_event_signal& on_mouse_entered() noexcept {return m_mouse_entered;}
+    form_mouse_event_signal& on_mouse_left() noexcept {return m_mouse_left;}
+
 private:
-    std::unique_ptr<widget_container_base> m_widget{};
+    struct node
+    {
+        widget_info info{};
+        widget_id parent{no_widget};
+        std::vector<widget_id> children{};
+
+        std::uint32_t preferred_width{};
+        std::uint32_t preferred_height{};
+        widget_rect rect{};
+
+        std::vector<vertex> text_vertices{};
+        text_bounds text_size{};
+
+        std::uint32_t first_quad{};
+        std::uint32_t quad_count{};
+        std::uint32_t quad_capacity{};
+
+        bool alive{true};
+        bool shown{};
+        bool measure_dirty{true};
+        bool arrange_dirty{true};
+        bool text_dirty{true};
+        bool geometry_dirty{};
+    };
+
+private:
+    void invalidate_measure(widget_id widget);
+    void invalidate_geometry(widget_id widget);
+    void hide_subtree(widget_id widget);
+
+    void measure(widget_id widget);
+    void arrange(widget_id widget, const widget_rect& rect);
+
+    std::uint32_t required_quads(const node& data) const noexcept;
+    void repack();
+    void write_geometry(widget_id widget, std::span<vertex> vertices) noexcept;
+    bool check_texture();
+
+private:
+    text_drawer* m_drawer{};
+    std::uint32_t m_width{};
+    std::uint32_t m_height{};
+
+    std::vector<node> m_nodes{};
+    std::vector<widget_id> m_free_nodes{};
+    std::vector<widget_id> m_dirty_geometry{};
+    std::uint32_t m_quad_capacity{};
+    bool m_repack{true};
+
+    texture_ptr m_texture{};
+    vec2f m_solid_texel{};
+
+    widget_id m_hovered{no_widget};
+    form_mouse_event_signal m_mouse_button_pressed{};
+    form_mouse_event_signal m_mouse_button_released{};
+    form_mouse_event_signal m_mouse_moved{};
+    form_mouse_event_signal m_mouse_wheel_scrolled{};
+    form_mouse_event_signal m_mouse_entered{};
+    form_mouse_event_signal m_mouse_left{};
 };
 
 }
 
+template<> struct cpt::enable_enum_operations<cpt::layout_alignement> {static constexpr bool value{true};};
+
 #endif
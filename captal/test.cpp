@@ -0,0 +1,724 @@
+#include <captal/engine.hpp>
+#include <captal/culling.hpp>
+#include <captal/draw_list.hpp>
+#include <captal/particle.hpp>
+#include <captal/render_graph.hpp>
+#include <captal/compute_technique.hpp>
+#include <captal/signal.hpp>
+#include <captal/systems/culling.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <tephra/commands.hpp>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+//Records its destruction
+struct tracked_resource final : public cpt::asynchronous_resource
+{
+    explicit tracked_resource(bool& destroyed) noexcept
+    :destroyed{&destroyed}
+    {
+
+    }
+
+    ~tracked_resource()
+    {
+        *destroyed = true;
+    }
+
+    bool* destroyed{};
+};
+
+TEST_CASE("Resource retirement test", "[asynchronous_resource]")
+{
+    cpt::engine engine{"captal_test", cpt::version{0, 1, 0}};
+    auto& retirement{engine.retirement()};
+
+    //Completes the epochs of the transfers recorded by the engine itself
+    engine.submit_transfers();
+    engine.renderer().wait();
+    engine.submit_transfers();
+
+    bool destroyed{};
+    bool stale_done{};
+    bool frame_done{};
+
+    auto resource{cpt::make_asynchronous_resource<tracked_resource>(destroyed)};
+
+    //A keeper that is never cleared, like the last frame of a render texture that is not used anymore
+    bool other_destroyed{};
+    auto other{cpt::make_asynchronous_resource<tracked_resource>(other_destroyed)};
+
+    cpt::asynchronous_resource_keeper stale{};
+    stale.keep(other);
+    stale.submitted([&stale_done]()
+    {
+        return stale_done;
+    });
+
+    SECTION("cpt::resource_retirement completes submitted epochs without clearing their keeper")
+    {
+        cpt::asynchronous_resource_keeper frame{};
+        frame.keep(resource);
+        frame.submitted([&frame_done]()
+        {
+            return frame_done;
+        });
+
+        resource.reset();
+        retirement.collect();
+        REQUIRE(!destroyed);
+
+        frame_done = true;
+        retirement.collect();
+        REQUIRE(!destroyed); //The stale epoch is older and still running
+
+        stale_done = true;
+        retirement.collect();
+        REQUIRE(destroyed);
+        REQUIRE(retirement.pending_count() == 0);
+    }
+
+    SECTION("cpt::resource_retirement keeps resources of epochs that are not submitted")
+    {
+        cpt::asynchronous_resource_keeper frame{};
+        frame.keep(resource);
+
+        stale_done = true;
+        resource.reset();
+        retirement.collect();
+        REQUIRE(!destroyed);
+
+        frame.clear();
+        REQUIRE(destroyed);
+    }
+
+    stale.clear();
+}
+
+TEST_CASE("Signal test", "[signal]")
+{
+    cpt::signal<int> signal{};
+    std::vector<int> calls{};
+
+    SECTION("cpt::signal does not call slots connected during an emission, even in a reused slot")
+    {
+        bool connect{true};
+        signal.connect([&](int)
+        {
+            if(std::exchange(connect, false))
+            {
+                signal.connect([&calls](int value){ calls.emplace_back(value * 100); });
+            }
+        });
+
+        auto second{signal.connect([&calls](int value){ calls.emplace_back(value * 10); })};
+        signal.connect([&calls](int value){ calls.emplace_back(value); });
+        second.disconnect(); //Its slot is free, and after the first one
+
+        signal(1);
+        REQUIRE(calls == std::vector<int>{1});
+
+        calls.clear();
+        signal(2);
+        REQUIRE(std::size(calls) == 2);
+        REQUIRE(std::count(std::begin(calls), std::end(calls), 200) == 1);
+        REQUIRE(std::count(std::begin(calls), std::end(calls), 2) == 1);
+        REQUIRE(signal.slot_count() == 3);
+    }
+
+    SECTION("cpt::signal does not call slots disconnected during an emission")
+    {
+        cpt::connection second{};
+
+        signal.connect([&](int value)
+        {
+            calls.emplace_back(value);
+            second.disconnect();
+        });
+
+        second = signal.connect([&calls](int value){ calls.emplace_back(value * 10); });
+
+        signal(1);
+        REQUIRE(calls == std::vector<int>{1});
+        REQUIRE(!second.connected());
+        REQUIRE(signal.slot_count() == 1);
+    }
+
+    SECTION("cpt::signal lets a slot disconnect itself")
+    {
+        cpt::connection self{};
+        self = signal.connect([&](int value)
+        {
+            calls.emplace_back(value);
+            self.disconnect();
+        });
+
+        signal(1);
+        signal(2);
+        REQUIRE(calls == std::vector<int>{1});
+        REQUIRE(signal.slot_count() == 0);
+    }
+
+    SECTION("cpt::scoped_connection disconnects on destruction")
+    {
+        {
+            cpt::scoped_connection scoped{signal.connect([&calls](int value){ calls.emplace_back(value); })};
+
+            signal(1);
+            REQUIRE(scoped.connected());
+        }
+
+        signal(2);
+        REQUIRE(calls == std::vector<int>{1});
+        REQUIRE(signal.slot_count() == 0);
+
+        cpt::scoped_connection moved{};
+
+        {
+            cpt::scoped_connection scoped{signal.connect([&calls](int value){ calls.emplace_back(value); })};
+            moved = std::move(scoped);
+        }
+
+        signal(3);
+        REQUIRE(calls == std::vector<int>{1, 3});
+        REQUIRE(moved.connected());
+    }
+
+    SECTION("cpt::signal supports recursive emissions")
+    {
+        cpt::connection second{};
+
+        signal.connect([&](int value)
+        {
+            calls.emplace_back(value);
+
+            if(value > 0)
+            {
+                signal(value - 1);
+            }
+            else
+            {
+                second.disconnect(); //Disconnected while the outer emissions are still running
+            }
+        });
+
+        second = signal.connect([&calls](int value){ calls.emplace_back(value * 10); });
+
+        signal(2);
+        REQUIRE(calls == std::vector<int>{2, 1, 0});
+        REQUIRE(signal.slot_count() == 1);
+
+        //The released slot is reused once every emission ended
+        calls.clear();
+        signal.connect([&calls](int value){ calls.emplace_back(value * 100); });
+        signal(0);
+        REQUIRE(calls == std::vector<int>{0, 0});
+    }
+}
+
+static std::vector<entt::entity> sorted_query(cpt::culling_grid& grid, const cpt::bounding_box& area)
+{
+    const auto result{grid.query(area)};
+
+    std::vector<entt::entity> output{std::begin(result), std::end(result)};
+    std::sort(std::begin(output), std::end(output));
+
+    return output;
+}
+
+TEST_CASE("Culling grid test", "[culling]")
+{
+    cpt::culling_grid grid{100.0f};
+
+    const auto first {entt::entity{1}};
+    const auto second{entt::entity{2}};
+    const auto large {entt::entity{3}};
+
+    grid.update(first, cpt::bounding_box{cpt::vec2f{10.0f, 10.0f}, cpt::vec2f{20.0f, 20.0f}});
+    grid.update(second, cpt::bounding_box{cpt::vec2f{90.0f, 90.0f}, cpt::vec2f{210.0f, 110.0f}});
+    grid.update(large, cpt::bounding_box{cpt::vec2f{-5000.0f, -5000.0f}, cpt::vec2f{5000.0f, 5000.0f}});
+
+    REQUIRE(grid.size() == 3);
+
+    SECTION("cpt::culling_grid returns each intersecting item once")
+    {
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{0.0f, 0.0f}, cpt::vec2f{300.0f, 300.0f}}) == std::vector{first, second, large});
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{150.0f, 95.0f}, cpt::vec2f{160.0f, 105.0f}}) == std::vector{second, large});
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{6000.0f, 6000.0f}, cpt::vec2f{7000.0f, 7000.0f}}).empty());
+    }
+
+    SECTION("cpt::culling_grid moves updated items")
+    {
+        grid.update(first, cpt::bounding_box{cpt::vec2f{510.0f, 510.0f}, cpt::vec2f{520.0f, 520.0f}});
+
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{0.0f, 0.0f}, cpt::vec2f{50.0f, 50.0f}}) == std::vector{large});
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{500.0f, 500.0f}, cpt::vec2f{550.0f, 550.0f}}) == std::vector{first, large});
+    }
+
+    SECTION("cpt::culling_grid removes items")
+    {
+        grid.remove(second);
+        grid.remove(large);
+
+        REQUIRE(grid.size() == 1);
+        REQUIRE(!grid.contains(second));
+        REQUIRE(sorted_query(grid, cpt::bounding_box{cpt::vec2f{0.0f, 0.0f}, cpt::vec2f{300.0f, 300.0f}}) == std::vector{first});
+    }
+}
+
+TEST_CASE("Culling system test", "[culling]")
+{
+    entt::registry world{};
+    cpt::culling_grid grid{};
+
+    cpt::systems::connect_culling(world, grid);
+
+    const auto destroyed{world.create()};
+    const auto moved    {world.create()};
+
+    world.emplace<cpt::components::node>(destroyed);
+    world.emplace<cpt::components::node>(moved);
+
+    grid.update(destroyed, cpt::bounding_box{cpt::vec2f{0.0f, 0.0f}, cpt::vec2f{10.0f, 10.0f}});
+    grid.update(moved, cpt::bounding_box{cpt::vec2f{0.0f, 0.0f}, cpt::vec2f{10.0f, 10.0f}});
+
+    SECTION("cpt::systems::connect_culling removes destroyed entities from the grid")
+    {
+        world.destroy(destroyed);
+
+        REQUIRE(!grid.contains(destroyed));
+        REQUIRE(grid.contains(moved));
+    }
+
+    SECTION("cpt::systems::connect_culling removes entities that lose their node from the grid")
+    {
+        world.remove<cpt::components::node>(moved);
+
+        REQUIRE(!grid.contains(moved));
+        REQUIRE(grid.contains(destroyed));
+    }
+
+    SECTION("cpt::systems::disconnect_culling stops the removal")
+    {
+        cpt::systems::disconnect_culling(world, grid);
+        world.destroy(destroyed);
+
+        REQUIRE(grid.contains(destroyed));
+    }
+}
+
+static std::vector<entt::entity> sorted_entities(cpt::draw_list& list)
+{
+    list.sort();
+
+    std::vector<entt::entity> output{};
+    for(auto&& item : list)
+    {
+        output.emplace_back(item.entity);
+    }
+
+    return output;
+}
+
+TEST_CASE("Draw list test", "[draw_list]")
+{
+    cpt::draw_list list{};
+
+    SECTION("cpt::make_draw_key orders by draw index, then z, then y, then texture")
+    {
+        list.push(cpt::make_draw_key(1, 0.0f, 0.0f, 0), entt::entity{0});
+        list.push(cpt::make_draw_key(0, 10.0f, 0.0f, 0), entt::entity{1});
+        list.push(cpt::make_draw_key(0, -10.0f, 100.0f, 0), entt::entity{2});
+        list.push(cpt::make_draw_key(0, -10.0f, -100.0f, 7), entt::entity{3});
+        list.push(cpt::make_draw_key(0, -10.0f, -100.0f, 3), entt::entity{4});
+        list.push(cpt::make_draw_key(cpt::draw_key_layout::max_index, -1000.0f, -1000.0f, 0), entt::entity{5});
+
+        REQUIRE(sorted_entities(list) == std::vector{entt::entity{4}, entt::entity{3}, entt::entity{2}, entt::entity{1}, entt::entity{0}, entt::entity{5}});
+    }
+
+    SECTION("cpt::draw_list keeps the insertion order of equal keys")
+    {
+        for(std::uint32_t i{}; i < 1000; ++i)
+        {
+            list.push(cpt::make_draw_key(i % 2, 1.0f, 2.0f, 3), entt::entity{i});
+        }
+
+        const auto entities{sorted_entities(list)};
+
+        for(std::uint32_t i{}; i < 500; ++i)
+        {
+            REQUIRE(entities[i] == entt::entity{i * 2});
+            REQUIRE(entities[i + 500] == entt::entity{i * 2 + 1});
+        }
+    }
+
+    SECTION("cpt::make_draw_key truncates z and y, the texture then breaks the ties")
+    {
+        list.push(cpt::make_draw_key(0, 1.0f, 1000.0001f, 2), entt::entity{0});
+        list.push(cpt::make_draw_key(0, 1.0f, 1000.0f, 1), entt::entity{1});
+
+        REQUIRE(sorted_entities(list) == std::vector{entt::entity{1}, entt::entity{0}});
+    }
+
+    SECTION("cpt::draw_list orders close z and y exactly when an exact key is given")
+    {
+        //Same truncated y, the texture alone would put the second item first
+        list.push(cpt::make_draw_key(0, 1.0f, 1000.0f, 2), entt::entity{0}, cpt::make_exact_draw_key(1.0f, 1000.0f));
+        list.push(cpt::make_draw_key(0, 1.0f, 1000.0001f, 1), entt::entity{1}, cpt::make_exact_draw_key(1.0f, 1000.0001f));
+        list.push(cpt::make_draw_key(0, 1.0f, 999.9999f, 3), entt::entity{2}, cpt::make_exact_draw_key(1.0f, 999.9999f));
+        list.push(cpt::make_draw_key(0, 1.0f, 1000.0f, 1), entt::entity{3}, cpt::make_exact_draw_key(1.0f, 1000.0f));
+        list.push(cpt::make_draw_key(0, 1.0001f, 0.0f, 0), entt::entity{4}, cpt::make_exact_draw_key(1.0001f, 0.0f));
+        list.push(cpt::make_draw_key(0, 1.0f, 0.0f, 0), entt::entity{5}, cpt::make_exact_draw_key(1.0f, 0.0f));
+
+        REQUIRE(sorted_entities(list) == std::vector{entt::entity{5}, entt::entity{2}, entt::entity{3}, entt::entity{0}, entt::entity{1}, entt::entity{4}});
+    }
+
+    SECTION("cpt::make_index_draw_key keeps the whole draw index")
+    {
+        list.push(cpt::make_index_draw_key(100000, 0), entt::entity{0});
+        list.push(cpt::make_index_draw_key(4096, 0), entt::entity{1});
+        list.push(cpt::make_index_draw_key(4095, 1), entt::entity{2});
+        list.push(cpt::make_index_draw_key(4095, 0), entt::entity{3});
+
+        REQUIRE(sorted_entities(list) == std::vector{entt::entity{3}, entt::entity{2}, entt::entity{1}, entt::entity{0}});
+    }
+}
+
+static std::vector<cpt::particle_instance> packed_particles(const cpt::particle_system& system)
+{
+    std::vector<cpt::particle_instance> output{};
+    output.resize(system.size());
+
+    system.pack(output);
+
+    return output;
+}
+
+TEST_CASE("Particle system test", "[particle]")
+{
+    //Particle systems own an instance buffer, they need an engine
+    cpt::engine engine{"captal_test", cpt::version{0, 1, 0}};
+
+    cpt::particle_emitter emitter{};
+    emitter.max_angle = 0.0f;
+    emitter.min_speed = 10.0f;
+    emitter.max_speed = 10.0f;
+    emitter.min_lifetime = 2.0f;
+    emitter.max_lifetime = 2.0f;
+    emitter.start_size = 1.0f;
+    emitter.end_size = 3.0f;
+    emitter.start_color = cpt::colors::white;
+    emitter.end_color = cpt::colors::black;
+
+    SECTION("cpt::particle_system integrates and packs the particles")
+    {
+        cpt::particle_system system{64};
+        system.set_gravity(cpt::vec2f{0.0f, 10.0f});
+        system.emit(emitter, 37); //Not a multiple of 4, so both the SIMD and the scalar paths are used
+        system.update(0.5f);
+
+        REQUIRE(system.size() == 37);
+
+        for(auto&& instance : packed_particles(system))
+        {
+            REQUIRE(instance.position.x() == Approx{5.0f});
+            REQUIRE(instance.position.y() == Approx{2.5f});
+            REQUIRE(instance.size == Approx{1.5f});
+            REQUIRE(instance.color == std::array<std::uint8_t, 4>{191, 191, 191, 255});
+        }
+
+        const auto bounds{system.local_bounds()};
+        REQUIRE(bounds.top_left.x() == Approx{5.0f - 1.5f * 0.70710678f});
+        REQUIRE(bounds.bottom_right.y() == Approx{2.5f + 1.5f * 0.70710678f});
+    }
+
+    SECTION("cpt::particle_system removes dead particles")
+    {
+        cpt::particle_system system{64};
+        system.emit(emitter, 16);
+        system.update(1.0f);
+
+        emitter.min_lifetime = 4.0f;
+        emitter.max_lifetime = 4.0f;
+        system.emit(emitter, 8);
+        system.update(1.5f);
+
+        REQUIRE(system.size() == 8);
+    }
+
+    SECTION("cpt::particle_system gives the same result on several threads")
+    {
+        constexpr std::uint32_t count{cpt::particle_system::min_range_size * 3 + 5};
+
+        cpt::particle_system single{count, 1};
+        cpt::particle_system multi{count, 4};
+
+        //Emitters are deterministic, each batch starts at a different position
+        for(std::uint32_t i{}; i < 8; ++i)
+        {
+            emitter.position = cpt::vec2f{static_cast<float>(i) * 10.0f, static_cast<float>(i) * -10.0f};
+
+            single.emit(emitter, count / 8 + 1);
+            multi.emit(emitter, count / 8 + 1);
+        }
+
+        single.update(0.25f);
+        multi.update(0.25f);
+
+        const auto single_particles{packed_particles(single)};
+        const auto multi_particles {packed_particles(multi)};
+
+        REQUIRE(std::size(single_particles) == std::size(multi_particles));
+
+        for(std::size_t i{}; i < std::size(single_particles); ++i)
+        {
+            REQUIRE(single_particles[i].position == multi_particles[i].position);
+            REQUIRE(single_particles[i].color == multi_particles[i].color);
+        }
+
+        REQUIRE(single.local_bounds().top_left == multi.local_bounds().top_left);
+        REQUIRE(single.local_bounds().bottom_right == multi.local_bounds().bottom_right);
+    }
+}
+
+static cpt::render_graph_attachment cleared(cpt::render_graph_texture texture)
+{
+    return cpt::render_graph_attachment{texture, tph::clear_value_t{tph::clear_color_value{tph::clear_color_float_value{}}}};
+}
+
+static cpt::render_graph_attachment loaded(cpt::render_graph_texture texture)
+{
+    return cpt::render_graph_attachment{texture};
+}
+
+TEST_CASE("Render graph test", "[render_graph]")
+{
+    //Render graphs create render passes and transient textures, they need an engine
+    cpt::engine engine{"captal_test", cpt::version{0, 1, 0}};
+
+    const tph::texture_info output_info{tph::texture_format::r8g8b8a8_unorm, tph::texture_usage::color_attachment | tph::texture_usage::sampled};
+
+    cpt::render_graph graph{};
+    const auto output{graph.import_texture(cpt::make_texture(64u, 64u, output_info), tph::texture_layout::shader_read_only_optimal, tph::texture_layout::undefined)};
+    const auto color {graph.add_texture(cpt::render_graph_texture_info{64, 64, tph::texture_format::r8g8b8a8_unorm})};
+    const auto small {graph.add_texture(cpt::render_graph_texture_info{32, 32, tph::texture_format::r8g8b8a8_unorm})};
+
+    SECTION("cpt::render_graph culls the passes that do not contribute to an imported texture")
+    {
+        const auto unused     {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(small)}})};
+        const auto overwritten{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(output)}})};
+        const auto producer   {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto consumer   {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(output)}, .sampled_textures = {color}})};
+
+        graph.compile();
+
+        REQUIRE(graph.is_culled(unused));
+        REQUIRE(graph.is_culled(overwritten));
+        REQUIRE(!graph.is_culled(producer));
+        REQUIRE(!graph.is_culled(consumer));
+        REQUIRE(graph.render_pass_count() == 2);
+    }
+
+    SECTION("cpt::render_graph merges passes linked by input attachments")
+    {
+        const auto first {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto second{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {loaded(output)}, .input_attachments = {color}})};
+
+        graph.compile();
+
+        REQUIRE(graph.render_pass_count() == 1);
+        REQUIRE(graph.subpass(first) == 0);
+        REQUIRE(graph.subpass(second) == 1);
+        REQUIRE(&graph.render_pass(first) == &graph.render_pass(second));
+    }
+
+    SECTION("cpt::render_graph does not merge passes that sample a texture of the render pass")
+    {
+        const auto first {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto second{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(output)}, .sampled_textures = {color}})};
+
+        graph.compile();
+
+        REQUIRE(graph.render_pass_count() == 2);
+        REQUIRE(graph.subpass(second) == 0);
+        REQUIRE(&graph.render_pass(first) != &graph.render_pass(second));
+    }
+
+    SECTION("cpt::render_graph does not merge passes that clear an attachment of the render pass")
+    {
+        const auto first {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto second{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {loaded(output)}, .input_attachments = {color}})};
+        const auto third {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto fourth{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {loaded(output)}, .input_attachments = {color}})};
+
+        graph.compile();
+
+        REQUIRE(graph.render_pass_count() == 2);
+        REQUIRE(&graph.render_pass(first) == &graph.render_pass(second));
+        REQUIRE(&graph.render_pass(third) == &graph.render_pass(fourth));
+        REQUIRE(&graph.render_pass(second) != &graph.render_pass(third));
+    }
+
+    SECTION("cpt::render_graph reorders passes to merge them")
+    {
+        //Executed in declaration order, every pass would need its own render pass
+        const auto first {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(color)}})};
+        const auto second{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(small)}})};
+        const auto third {graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {cleared(output)}, .input_attachments = {color}})};
+        const auto fourth{graph.add_pass(cpt::render_graph_pass_info{.color_attachments = {loaded(output)}, .sampled_textures = {small}})};
+
+        graph.compile();
+
+        REQUIRE(graph.render_pass_count() == 3);
+        REQUIRE(&graph.render_pass(first) == &graph.render_pass(third));
+        REQUIRE(graph.subpass(third) == 1);
+        REQUIRE(&graph.render_pass(second) != &graph.render_pass(first));
+        REQUIRE(&graph.render_pass(fourth) != &graph.render_pass(second));
+        REQUIRE(graph.subpass(fourth) == 0);
+    }
+}
+
+//Runs a reference kernel on binding 0 = input and reads binding 1 back, output starts zeroed.
+//Inputs are uploaded with cmd::update_buffer, they must be smaller than 64 KiB.
+static std::vector<std::uint8_t> run_kernel(cpt::compute_technique& technique, std::span<const std::byte> input, std::uint64_t output_size, std::uint32_t count)
+{
+    auto& engine{cpt::engine::instance()};
+
+    const auto input_buffer {cpt::make_storage_buffer(std::size(input), tph::buffer_usage::transfer_destination)};
+    const auto output_buffer{cpt::make_storage_buffer(output_size, tph::buffer_usage::transfer_destination | tph::buffer_usage::transfer_source)};
+    tph::buffer readback{engine.renderer(), output_size, tph::buffer_usage::transfer_destination};
+
+    technique.set_binding(0, 0, input_buffer);
+    technique.set_binding(0, 1, output_buffer);
+
+    auto transfer{engine.begin_transfer()};
+
+    tph::cmd::update_buffer(transfer.buffer, input_buffer->get_buffer(), 0, std::size(input), std::data(input));
+    tph::cmd::fill_buffer(transfer.buffer, output_buffer->get_buffer(), 0, output_size, 0);
+
+    const tph::memory_barrier upload_barrier{tph::resource_access::transfer_write, tph::resource_access::shader_read | tph::resource_access::shader_write};
+    tph::cmd::pipeline_barrier(transfer.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::compute_shader, tph::dependency_flags::none, std::span{&upload_barrier, 1}, {}, {});
+
+    cpt::frame_presented_signal signal{};
+    technique.dispatch(cpt::frame_render_info{transfer.buffer, signal, transfer.keeper}, (count + cpt::reference_group_size - 1) / cpt::reference_group_size);
+
+    const tph::memory_barrier readback_barrier{tph::resource_access::shader_write, tph::resource_access::transfer_read};
+    tph::cmd::pipeline_barrier(transfer.buffer, tph::pipeline_stage::compute_shader, tph::pipeline_stage::transfer, tph::dependency_flags::none, std::span{&readback_barrier, 1}, {}, {});
+
+    tph::cmd::copy(transfer.buffer, output_buffer->get_buffer(), readback, tph::buffer_copy{0, 0, output_size});
+
+    engine.submit_transfers();
+    engine.renderer().wait();
+
+    std::vector<std::uint8_t> output(output_size);
+    std::memcpy(std::data(output), readback.map(), output_size);
+    readback.unmap();
+
+    return output;
+}
+
+//Run it with a software implementation (e.g. lavapipe) where no GPU is available
+TEST_CASE("Reference compute kernels test", "[compute]")
+{
+    cpt::engine engine{"captal_test", cpt::version{0, 1, 0}};
+
+    SECTION("engine::sprite_cull_compute_shader finds the same boxes as cpt::culling_grid")
+    {
+        constexpr std::uint32_t count{500};
+
+        cpt::culling_grid grid{100.0f};
+        std::vector<std::array<float, 4>> boxes{};
+
+        for(std::uint32_t i{}; i < count; ++i)
+        {
+            const float x{static_cast<float>(i % 25) * 40.0f};
+            const float y{static_cast<float>(i / 25) * 40.0f};
+
+            boxes.emplace_back(std::array{x, y, x + 30.0f, y + 30.0f});
+            grid.update(entt::entity{i}, cpt::bounding_box{cpt::vec2f{x, y}, cpt::vec2f{x + 30.0f, y + 30.0f}});
+        }
+
+        //Edges of the area do not touch any box, so inclusive and exclusive tests agree
+        const cpt::bounding_box area{cpt::vec2f{105.0f, 105.0f}, cpt::vec2f{505.0f, 305.0f}};
+
+        auto technique{cpt::make_compute_technique(cpt::compute_technique_info{tph::pipeline_shader_stage{engine.sprite_cull_compute_shader()}}, engine.sprite_cull_compute_layout())};
+        technique->set_push_constant(0, cpt::sprite_cull_parameters{std::array{105.0f, 105.0f, 505.0f, 305.0f}, count});
+
+        const auto output{run_kernel(*technique, std::as_bytes(std::span{boxes}), (count + 1) * sizeof(std::uint32_t), count)};
+
+        std::vector<std::uint32_t> words(count + 1);
+        std::memcpy(std::data(words), std::data(output), std::size(output));
+
+        std::vector<entt::entity> visible{};
+        for(std::uint32_t i{}; i < words[0]; ++i)
+        {
+            visible.emplace_back(entt::entity{words[i + 1]});
+        }
+
+        std::sort(std::begin(visible), std::end(visible));
+
+        const auto expected{sorted_query(grid, area)};
+
+        REQUIRE(!std::empty(expected));
+        REQUIRE(visible == expected);
+    }
+
+    SECTION("engine::particle_compute_shader integrates like cpt::particle_system")
+    {
+        constexpr std::uint32_t capacity{200};
+        constexpr std::uint32_t count{150};
+        constexpr float time{0.25f};
+
+        cpt::particle_emitter emitter{};
+        emitter.position = cpt::vec2f{10.0f, -20.0f};
+        emitter.min_speed = 5.0f;
+        emitter.max_speed = 50.0f;
+        emitter.min_lifetime = 2.0f;
+        emitter.max_lifetime = 4.0f;
+        emitter.start_size = 1.0f;
+        emitter.end_size = 8.0f;
+        emitter.start_color = cpt::colors::white;
+        emitter.end_color = cpt::colors::black;
+
+        cpt::particle_system system{capacity};
+        system.set_gravity(cpt::vec2f{0.0f, 9.81f});
+        system.set_drag(0.5f);
+        system.emit(emitter, count);
+
+        std::vector<float> attributes(cpt::particle_system::attribute_count * capacity);
+        system.copy_attributes(attributes);
+
+        system.update(time);
+        const auto expected{packed_particles(system)};
+
+        auto technique{cpt::make_compute_technique(cpt::compute_technique_info{tph::pipeline_shader_stage{engine.particle_compute_shader()}}, engine.particle_compute_layout())};
+        technique->set_push_constant(0, cpt::particle_simulation_parameters{time, count, capacity, system.drag(), system.gravity()});
+
+        const auto output{run_kernel(*technique, std::as_bytes(std::span{attributes}), count * sizeof(cpt::particle_instance), count)};
+
+        std::vector<cpt::particle_instance> instances(count);
+        std::memcpy(std::data(instances), std::data(output), std::size(output));
+
+        REQUIRE(std::size(expected) == count);
+
+        for(std::size_t i{}; i < count; ++i)
+        {
+            REQUIRE(instances[i].position.x() == Approx{expected[i].position.x()}.margin(1e-4));
+            REQUIRE(instances[i].position.y() == Approx{expected[i].position.y()}.margin(1e-4));
+            REQUIRE(instances[i].size == Approx{expected[i].size}.margin(1e-4));
+            REQUIRE(instances[i].rotation == Approx{expected[i].rotation}.margin(1e-4));
+
+            //Rounding of the color conversion may differ by one
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                REQUIRE(std::abs(static_cast<int>(instances[i].color[j]) - static_cast<int>(expected[i].color[j])) <= 1);
+            }
+        }
+    }
+}
@@ -6,6 +6,8 @@
 #include <captal/external/pugixml.hpp>
 
 #include <captal_foundation/stack_allocator.hpp>
+
+#include "sansation.hpp"
 /*
 static_assert(cpt::tuple_like<std::tuple<int, float, double>>);
 static_assert(cpt::tuple_like<std::array<int, 42>>);
@@ -54,13 +56,65 @@ static void run()
     cpt::view view{target, cpt::render_technique_info{.multisample{tph::sample_count::msaa_x4}}};
     view.fit(window);
 
-    cpt::sprite sprite{40, 40, cpt::colors::dodgerblue};
-    sprite.move_to(cpt::vec3f{0.0f, 0.0f, 0.0f});
+    cpt::text_drawer drawer{cpt::font_set{cpt::font{sansation_regular_font_data, 12}}};
+
+    //A settings screen of 500 widgets, rendered in a single draw
+    const cpt::widget_info root_info
+    {
+        .background = cpt::colors::white,
+        .layout = cpt::widget_layout{.top_margin = 24, .left_margin = 8, .spacing = 2}
+    };
+
+    cpt::form form{drawer, 640, 480, root_info};
+
+    for(std::uint32_t i{}; i < 100; ++i)
+    {
+        const auto row{form.add(cpt::form::root, cpt::widget_info{.layout = cpt::widget_layout{.spacing = 4, .direction = cpt::layout_direction::left_to_right}})};
+
+        for(std::uint32_t j{}; j < 5; ++j)
+        {
+            form.add(row, cpt::widget_info
+            {
+                .min_width = 100,
+                .background = cpt::colors::lightgray,
+                .text = "Option " + std::to_string(i * 5 + j),
+                .layout = cpt::widget_layout{.left_margin = 4, .right_margin = 4, .alignement = cpt::layout_alignement::center_left}
+            });
+        }
+    }
+
+    //Only the hovered widgets are rewritten, the rest of the form stays untouched
+    form.on_mouse_entered().connect([&form](cpt::widget_id widget, const apr::mouse_event&)
+    {
+        if(form.children(widget).empty())
+        {
+            form.set_background(widget, cpt::colors::dodgerblue);
+        }
+    });
+
+    form.on_mouse_left().connect([&form](cpt::widget_id widget, const apr::mouse_event&)
+    {
+        if(form.children(widget).empty())
+        {
+            form.set_background(widget, cpt::colors::lightgray);
+        }
+    });
+
+    window->on_event().connect([&form](cpt::window&, const apr::event& event)
+    {
+        form.dispatch_event(event);
+    });
+
+    window->on_resized().connect([&form, &view](cpt::window& window, const apr::window_event&)
+    {
+        form.resize(window.width(), window.height());
+        view.fit(window);
+    });
 
     auto transfer_info{cpt::engine::instance().begin_transfer()};
 
     view.upload(transfer_info);
-    sprite.upload(transfer_info);
+    form.upload(transfer_info);
 
     cpt::engine::instance().submit_transfers();
 
@@ -111,8 +165,13 @@ static void run()
 
         if(render_info)
         {
+            auto transfer_info{cpt::engine::instance().begin_transfer()};
+            view.upload(transfer_info);
+            form.upload(transfer_info);
+            cpt::engine::instance().submit_transfers();
+
             view.bind(*render_info);
-            sprite.draw(*render_info, view);
+            form.draw(*render_info, view);
         }
 
         target->present();
@@ -28,6 +28,29 @@
 #include <iterator>
 #include <concepts>
 #include <ranges>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CAPTAL_FOUNDATION_ENCODING_SSE2
+    #include <emmintrin.h>
+
+    #if defined(__SSSE3__) || defined(__AVX__)
+        #define CAPTAL_FOUNDATION_ENCODING_SSSE3
+        #include <tmmintrin.h>
+    #endif
+
+    #if defined(__AVX2__)
+        #define CAPTAL_FOUNDATION_ENCODING_AVX2
+        #include <immintrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64) //table lookups and horizontal reductions are AArch64 only
+    #define CAPTAL_FOUNDATION_ENCODING_NEON
+    #include <arm_neon.h>
+#endif
 
 namespace cpt
 {
@@ -646,6 +669,711 @@ template<> struct char_encoding<char32_t> {using type = utf32;};
 template<typename CharT>
 using char_encoding_t = typename char_encoding<CharT>::type;
 
+}
+
+namespace impl
+{
+
+template<typename Input, typename Output>
+inline constexpr bool has_fast_conversion =
+    (std::derived_from<Input, utf8> && std::derived_from<Output, utf32> && sizeof(typename Output::char_type) == 4) ||
+    (std::derived_from<Input, utf8> && std::derived_from<Output, utf16> && sizeof(typename Output::char_type) == 2) ||
+    (std::derived_from<Input, utf32> && std::derived_from<Output, utf8> && sizeof(typename Input::char_type) == 4) ||
+    (std::derived_from<Input, utf16> && std::derived_from<Output, utf8> && sizeof(typename Input::char_type) == 2);
+
+template<typename It, typename CharT>
+concept contiguous_code_units = std::contiguous_iterator<It> && sizeof(std::iter_value_t<It>) == sizeof(CharT);
+
+//Highest count of output values a single input value can produce
+template<typename Input, typename Output>
+constexpr std::size_t max_conversion_ratio() noexcept
+{
+    if constexpr(std::derived_from<Input, utf8>)
+    {
+        return 1;
+    }
+    else if constexpr(std::derived_from<Input, utf16>)
+    {
+        return 3;
+    }
+    else
+    {
+        return 4;
+    }
+}
+
+template<encoding Input, encoding Output, std::input_iterator InputIt, std::output_iterator<typename Output::char_type> OutputIt>
+constexpr OutputIt convert_codepoints(InputIt begin, InputIt end, OutputIt output)
+{
+    while(begin < end)
+    {
+        codepoint_t code{};
+        begin  = Input::decode(begin, end, code);
+        output = Output::encode(code, output);
+    }
+
+    return output;
+}
+
+template<std::input_iterator InputIt>
+constexpr bool validate_utf8_scalar(InputIt begin, InputIt end) noexcept
+{
+    while(begin != end)
+    {
+        const auto lead{static_cast<std::uint8_t>(*begin)};
+
+        if(lead < 0x80)
+        {
+            ++begin;
+            continue;
+        }
+
+        std::ptrdiff_t length{};
+        std::uint8_t low{0x80};
+        std::uint8_t high{0xBF};
+
+        if(lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 2;
+        }
+        else if(lead == 0xE0)
+        {
+            length = 3;
+            low = 0xA0; //overlong
+        }
+        else if(lead == 0xED)
+        {
+            length = 3;
+            high = 0x9F; //surrogates
+        }
+        else if(lead >= 0xE1 && lead <= 0xEF)
+        {
+            length = 3;
+        }
+        else if(lead == 0xF0)
+        {
+            length = 4;
+            low = 0x90; //overlong
+        }
+        else if(lead == 0xF4)
+        {
+            length = 4;
+            high = 0x8F; //above U+10FFFF
+        }
+        else if(lead >= 0xF1 && lead <= 0xF3)
+        {
+            length = 4;
+        }
+        else
+        {
+            return false;
+        }
+
+        if(std::distance(begin, end) < length)
+        {
+            return false;
+        }
+
+        ++begin;
+
+        const auto second{static_cast<std::uint8_t>(*begin++)};
+        if(second < low || second > high)
+        {
+            return false;
+        }
+
+        for(std::ptrdiff_t i{2}; i < length; ++i)
+        {
+            if((static_cast<std::uint8_t>(*begin++) & 0xC0) != 0x80)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//Decodes one codepoint of a sequence known to be valid
+constexpr const std::uint8_t* decode_valid_utf8(const std::uint8_t* begin, codepoint_t& output) noexcept
+{
+    const codepoint_t lead{begin[0]};
+
+    if(lead < 0x80)
+    {
+        output = lead;
+        return begin + 1;
+    }
+    else if(lead < 0xE0)
+    {
+        output = ((lead & 0x1F) << 6) | (begin[1] & 0x3Fu);
+        return begin + 2;
+    }
+    else if(lead < 0xF0)
+    {
+        output = ((lead & 0x0F) << 12) | ((begin[1] & 0x3Fu) << 6) | (begin[2] & 0x3Fu);
+        return begin + 3;
+    }
+    else
+    {
+        output = ((lead & 0x07) << 18) | ((begin[1] & 0x3Fu) << 12) | ((begin[2] & 0x3Fu) << 6) | (begin[3] & 0x3Fu);
+        return begin + 4;
+    }
+}
+
+#if defined(CAPTAL_FOUNDATION_ENCODING_SSSE3) || defined(CAPTAL_FOUNDATION_ENCODING_NEON)
+
+//Keiser & Lemire lookup algorithm: each error class is a bit, a pair of bytes is invalid if the 3 lookups share a bit
+//See "Validating UTF-8 In Less Than One Instruction Per Byte", 2021
+namespace utf8_errors
+{
+
+inline constexpr std::uint8_t too_short     {1 << 0}; // 11______ 0_______ or 11______ 11______
+inline constexpr std::uint8_t too_long      {1 << 1}; // 0_______ 10______
+inline constexpr std::uint8_t overlong_3    {1 << 2}; // 11100000 100_____
+inline constexpr std::uint8_t too_large     {1 << 3}; // 11110100 1001____ and above
+inline constexpr std::uint8_t surrogate     {1 << 4}; // 11101101 101_____
+inline constexpr std::uint8_t overlong_2    {1 << 5}; // 1100000_ 10______
+inline constexpr std::uint8_t too_large_1000{1 << 6}; // 11110101 1000____ and above
+inline constexpr std::uint8_t overlong_4    {1 << 6}; // 11110000 1000____
+inline constexpr std::uint8_t two_conts     {1 << 7}; // 10______ 10______
+inline constexpr std::uint8_t carry         {too_short | too_long | two_conts};
+
+inline constexpr std::array<std::uint8_t, 16> byte_1_high
+{
+    too_long, too_long, too_long, too_long,
+    too_long, too_long, too_long, too_long,
+    two_conts, two_conts, two_conts, two_conts,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4
+};
+
+inline constexpr std::array<std::uint8_t, 16> byte_1_low
+{
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000
+};
+
+inline constexpr std::array<std::uint8_t, 16> byte_2_high
+{
+    too_short, too_short, too_short, too_short,
+    too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate  | too_large,
+    too_long | overlong_2 | two_conts | surrogate  | too_large,
+    too_short, too_short, too_short, too_short
+};
+
+//A lead byte in the last 3 bytes of a block may need bytes of the next block
+inline constexpr std::array<std::uint8_t, 32> incomplete_max
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+}
+
+#endif
+
+#if defined(CAPTAL_FOUNDATION_ENCODING_AVX2)
+
+class utf8_checker
+{
+public:
+    static constexpr std::size_t block_size{32};
+
+public:
+    void check(const std::uint8_t* data) noexcept
+    {
+        const __m256i input{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))};
+
+        if(_mm256_movemask_epi8(input) == 0)
+        {
+            m_error = _mm256_or_si256(m_error, m_prev_incomplete);
+            m_prev_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            const __m256i shifted{_mm256_permute2x128_si256(m_prev_input, input, 0x21)};
+            const __m256i prev1{_mm256_alignr_epi8(input, shifted, 16 - 1)};
+            const __m256i prev2{_mm256_alignr_epi8(input, shifted, 16 - 2)};
+            const __m256i prev3{_mm256_alignr_epi8(input, shifted, 16 - 3)};
+
+            const __m256i nibble{_mm256_set1_epi8(0x0F)};
+            const __m256i byte_1_high{_mm256_shuffle_epi8(load_table(utf8_errors::byte_1_high), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble))};
+            const __m256i byte_1_low {_mm256_shuffle_epi8(load_table(utf8_errors::byte_1_low),  _mm256_and_si256(prev1, nibble))};
+            const __m256i byte_2_high{_mm256_shuffle_epi8(load_table(utf8_errors::byte_2_high), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble))};
+            const __m256i special    {_mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high)};
+
+            const __m256i third {_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)))};
+            const __m256i fourth{_mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)))};
+            const __m256i must23{_mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)))};
+
+            m_error = _mm256_or_si256(m_error, _mm256_xor_si256(must23, special));
+            m_prev_incomplete = _mm256_subs_epu8(input, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(std::data(utf8_errors::incomplete_max))));
+        }
+
+        m_prev_input = input;
+    }
+
+    bool valid() const noexcept
+    {
+        return _mm256_testz_si256(m_error, m_error) != 0;
+    }
+
+private:
+    static __m256i load_table(const std::array<std::uint8_t, 16>& table) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(std::data(table))));
+    }
+
+private:
+    __m256i m_error{_mm256_setzero_si256()};
+    __m256i m_prev_input{_mm256_setzero_si256()};
+    __m256i m_prev_incomplete{_mm256_setzero_si256()};
+};
+
+#elif defined(CAPTAL_FOUNDATION_ENCODING_SSSE3)
+
+class utf8_checker
+{
+public:
+    static constexpr std::size_t block_size{16};
+
+public:
+    void check(const std::uint8_t* data) noexcept
+    {
+        const __m128i input{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))};
+
+        if(_mm_movemask_epi8(input) == 0)
+        {
+            m_error = _mm_or_si128(m_error, m_prev_incomplete);
+            m_prev_incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            const __m128i prev1{_mm_alignr_epi8(input, m_prev_input, 16 - 1)};
+            const __m128i prev2{_mm_alignr_epi8(input, m_prev_input, 16 - 2)};
+            const __m128i prev3{_mm_alignr_epi8(input, m_prev_input, 16 - 3)};
+
+            const __m128i nibble{_mm_set1_epi8(0x0F)};
+            const __m128i byte_1_high{_mm_shuffle_epi8(load_table(utf8_errors::byte_1_high), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble))};
+            const __m128i byte_1_low {_mm_shuffle_epi8(load_table(utf8_errors::byte_1_low),  _mm_and_si128(prev1, nibble))};
+            const __m128i byte_2_high{_mm_shuffle_epi8(load_table(utf8_errors::byte_2_high), _mm_and_si128(_mm_srli_epi16(input, 4), nibble))};
+            const __m128i special    {_mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high)};
+
+            const __m128i third {_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)))};
+            const __m128i fourth{_mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)))};
+            const __m128i must23{_mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)))};
+
+            m_error = _mm_or_si128(m_error, _mm_xor_si128(must23, special));
+            m_prev_incomplete = _mm_subs_epu8(input, _mm_loadu_si128(reinterpret_cast<const __m128i*>(std::data(utf8_errors::incomplete_max) + 16)));
+        }
+
+        m_prev_input = input;
+    }
+
+    bool valid() const noexcept
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(m_error, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+private:
+    static __m128i load_table(const std::array<std::uint8_t, 16>& table) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(std::data(table)));
+    }
+
+private:
+    __m128i m_error{_mm_setzero_si128()};
+    __m128i m_prev_input{_mm_setzero_si128()};
+    __m128i m_prev_incomplete{_mm_setzero_si128()};
+};
+
+#elif defined(CAPTAL_FOUNDATION_ENCODING_NEON)
+
+class utf8_checker
+{
+public:
+    static constexpr std::size_t block_size{16};
+
+public:
+    void check(const std::uint8_t* data) noexcept
+    {
+        const uint8x16_t input{vld1q_u8(data)};
+
+        if(vmaxvq_u8(input) < 0x80)
+        {
+            m_error = vorrq_u8(m_error, m_prev_incomplete);
+            m_prev_incomplete = vdupq_n_u8(0);
+        }
+        else
+        {
+            const uint8x16_t prev1{vextq_u8(m_prev_input, input, 16 - 1)};
+            const uint8x16_t prev2{vextq_u8(m_prev_input, input, 16 - 2)};
+            const uint8x16_t prev3{vextq_u8(m_prev_input, input, 16 - 3)};
+
+            const uint8x16_t byte_1_high{vqtbl1q_u8(vld1q_u8(std::data(utf8_errors::byte_1_high)), vshrq_n_u8(prev1, 4))};
+            const uint8x16_t byte_1_low {vqtbl1q_u8(vld1q_u8(std::data(utf8_errors::byte_1_low)),  vandq_u8(prev1, vdupq_n_u8(0x0F)))};
+            const uint8x16_t byte_2_high{vqtbl1q_u8(vld1q_u8(std::data(utf8_errors::byte_2_high)), vshrq_n_u8(input, 4))};
+            const uint8x16_t special    {vandq_u8(vandq_u8(byte_1_high, byte_1_low), byte_2_high)};
+
+            const uint8x16_t third {vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80))};
+            const uint8x16_t fourth{vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80))};
+            const uint8x16_t must23{vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80))};
+
+            m_error = vorrq_u8(m_error, veorq_u8(must23, special));
+            m_prev_incomplete = vqsubq_u8(input, vld1q_u8(std::data(utf8_errors::incomplete_max) + 16));
+        }
+
+        m_prev_input = input;
+    }
+
+    bool valid() const noexcept
+    {
+        return vmaxvq_u8(m_error) == 0;
+    }
+
+private:
+    uint8x16_t m_error{vdupq_n_u8(0)};
+    uint8x16_t m_prev_input{vdupq_n_u8(0)};
+    uint8x16_t m_prev_incomplete{vdupq_n_u8(0)};
+};
+
+#endif
+
+inline bool validate_utf8(const std::uint8_t* data, std::size_t size) noexcept
+{
+#if defined(CAPTAL_FOUNDATION_ENCODING_SSSE3) || defined(CAPTAL_FOUNDATION_ENCODING_NEON)
+    utf8_checker checker{};
+
+    std::size_t i{};
+    for(; i + utf8_checker::block_size <= size; i += utf8_checker::block_size)
+    {
+        checker.check(data + i);
+    }
+
+    //The zero padding catches sequences truncated by the end of the input
+    std::array<std::uint8_t, utf8_checker::block_size> tail{};
+    if(i < size)
+    {
+        std::memcpy(std::data(tail), data + i, size - i);
+    }
+
+    checker.check(std::data(tail));
+
+    return checker.valid();
+#elif defined(CAPTAL_FOUNDATION_ENCODING_SSE2)
+    //No byte shuffle without SSSE3, only skip ASCII blocks
+    const std::uint8_t* const end{data + size};
+
+    while(end - data >= 16)
+    {
+        if(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))) != 0)
+        {
+            break;
+        }
+
+        data += 16;
+    }
+
+    return validate_utf8_scalar(data, end);
+#else
+    return validate_utf8_scalar(data, data + size);
+#endif
+}
+
+//Widens a block of 16 ASCII bytes, returns false if the block contains any other byte
+template<typename OutChar>
+inline bool widen_ascii_block(const std::uint8_t* input, OutChar* output) noexcept
+{
+#if defined(CAPTAL_FOUNDATION_ENCODING_SSE2)
+    const __m128i block{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input))};
+
+    if(_mm_movemask_epi8(block) != 0)
+    {
+        return false;
+    }
+
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i low {_mm_unpacklo_epi8(block, zero)};
+    const __m128i high{_mm_unpackhi_epi8(block, zero)};
+
+    if constexpr(sizeof(OutChar) == 2)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 0, low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 1, high);
+    }
+    else
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 0, _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 1, _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 2, _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output) + 3, _mm_unpackhi_epi16(high, zero));
+    }
+
+    return true;
+#elif defined(CAPTAL_FOUNDATION_ENCODING_NEON)
+    const uint8x16_t block{vld1q_u8(input)};
+
+    if(vmaxvq_u8(block) >= 0x80)
+    {
+        return false;
+    }
+
+    const uint16x8_t low {vmovl_u8(vget_low_u8(block))};
+    const uint16x8_t high{vmovl_u8(vget_high_u8(block))};
+
+    if constexpr(sizeof(OutChar) == 2)
+    {
+        vst1q_u16(reinterpret_cast<std::uint16_t*>(output) + 0, low);
+        vst1q_u16(reinterpret_cast<std::uint16_t*>(output) + 8, high);
+    }
+    else
+    {
+        vst1q_u32(reinterpret_cast<std::uint32_t*>(output) + 0,  vmovl_u16(vget_low_u16(low)));
+        vst1q_u32(reinterpret_cast<std::uint32_t*>(output) + 4,  vmovl_u16(vget_high_u16(low)));
+        vst1q_u32(reinterpret_cast<std::uint32_t*>(output) + 8,  vmovl_u16(vget_low_u16(high)));
+        vst1q_u32(reinterpret_cast<std::uint32_t*>(output) + 12, vmovl_u16(vget_high_u16(high)));
+    }
+
+    return true;
+#else
+    std::uint64_t first{};
+    std::uint64_t second{};
+    std::memcpy(&first, input, 8);
+    std::memcpy(&second, input + 8, 8);
+
+    if(((first | second) & 0x8080808080808080ull) != 0)
+    {
+        return false;
+    }
+
+    for(std::size_t i{}; i < 16; ++i)
+    {
+        output[i] = static_cast<OutChar>(input[i]);
+    }
+
+    return true;
+#endif
+}
+
+//Narrows a block of 8 ASCII values, returns false if the block contains any other value
+template<typename InChar>
+inline bool narrow_ascii_block(const InChar* input, std::uint8_t* output) noexcept
+{
+#if defined(CAPTAL_FOUNDATION_ENCODING_SSE2)
+    __m128i block{};
+
+    if constexpr(sizeof(InChar) == 2)
+    {
+        block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) != 0xFFFF)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        const __m128i low {_mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + 0)};
+        const __m128i high{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + 1)};
+        const __m128i mask{_mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi32(static_cast<int>(0xFFFFFF80)))};
+
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(mask, _mm_setzero_si128())) != 0xFFFF)
+        {
+            return false;
+        }
+
+        block = _mm_packs_epi32(low, high);
+    }
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(block, block));
+
+    return true;
+#elif defined(CAPTAL_FOUNDATION_ENCODING_NEON)
+    uint16x8_t block{};
+
+    if constexpr(sizeof(InChar) == 2)
+    {
+        block = vld1q_u16(reinterpret_cast<const std::uint16_t*>(input));
+
+        if(vmaxvq_u16(block) >= 0x80)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        const uint32x4_t low {vld1q_u32(reinterpret_cast<const std::uint32_t*>(input) + 0)};
+        const uint32x4_t high{vld1q_u32(reinterpret_cast<const std::uint32_t*>(input) + 4)};
+
+        if(vmaxvq_u32(vorrq_u32(low, high)) >= 0x80)
+        {
+            return false;
+        }
+
+        block = vcombine_u16(vmovn_u32(low), vmovn_u32(high));
+    }
+
+    vst1_u8(output, vmovn_u16(block));
+
+    return true;
+#else
+    for(std::size_t i{}; i < 8; ++i)
+    {
+        if(static_cast<std::uint32_t>(input[i]) >= 0x80)
+        {
+            return false;
+        }
+    }
+
+    for(std::size_t i{}; i < 8; ++i)
+    {
+        output[i] = static_cast<std::uint8_t>(input[i]);
+    }
+
+    return true;
+#endif
+}
+
+//Input must be valid UTF-8
+template<typename OutChar>
+inline OutChar* transcode_valid_utf8(const std::uint8_t* begin, const std::uint8_t* end, OutChar* output) noexcept
+{
+    while(begin != end)
+    {
+        if(end - begin >= 16)
+        {
+            if(widen_ascii_block(begin, output))
+            {
+                begin  += 16;
+                output += 16;
+
+                continue;
+            }
+        }
+
+        //Decode at least the rest of the block, then retry the fast path
+        const std::uint8_t* const stop{end - begin > 16 ? begin + 16 : end};
+
+        while(begin < stop)
+        {
+            codepoint_t code{};
+            begin = decode_valid_utf8(begin, code);
+
+            if constexpr(sizeof(OutChar) == 2)
+            {
+                if(code >= 0x10000)
+                {
+                    code -= 0x10000;
+
+                    *output++ = static_cast<OutChar>((code >> 10)   + 0xD800);
+                    *output++ = static_cast<OutChar>((code & 0x3FF) + 0xDC00);
+                }
+                else
+                {
+                    *output++ = static_cast<OutChar>(code);
+                }
+            }
+            else
+            {
+                *output++ = static_cast<OutChar>(code);
+            }
+        }
+    }
+
+    return output;
+}
+
+template<encoding Input, encoding Output, typename InChar, typename OutChar>
+inline OutChar* convert_contiguous(const InChar* begin, const InChar* end, OutChar* output)
+{
+    if constexpr(std::derived_from<Input, utf8>)
+    {
+        const auto data{reinterpret_cast<const std::uint8_t*>(begin)};
+        const auto size{static_cast<std::size_t>(end - begin)};
+
+        if(validate_utf8(data, size))
+        {
+            return transcode_valid_utf8(data, data + size, output);
+        }
+
+        //Invalid sequences keep the historical behaviour
+        return convert_codepoints<Input, Output>(begin, end, output);
+    }
+    else
+    {
+        const auto bytes{reinterpret_cast<std::uint8_t*>(output)};
+        std::size_t written{};
+
+        while(begin != end)
+        {
+            if(end - begin >= 8)
+            {
+                if(narrow_ascii_block(begin, bytes + written))
+                {
+                    begin   += 8;
+                    written += 8;
+
+                    continue;
+                }
+            }
+
+            const auto stop{end - begin > 8 ? begin + 8 : end};
+
+            while(begin < stop)
+            {
+                codepoint_t code{};
+                begin = Input::decode(begin, end, code);
+                written = static_cast<std::size_t>(utf8::encode(code, bytes + written) - bytes);
+            }
+        }
+
+        return output + written;
+    }
+}
+
+}
+
+inline namespace foundation
+{
+
+//True if [begin, end[ is well-formed UTF-8: no truncated or overlong sequences, no surrogates and nothing above U+10FFFF
+template<std::contiguous_iterator InputIt>
+constexpr bool is_valid_utf8(InputIt begin, InputIt end) noexcept requires(sizeof(std::iter_value_t<InputIt>) == 1)
+{
+    if(std::is_constant_evaluated())
+    {
+        return impl::validate_utf8_scalar(begin, end);
+    }
+
+    return impl::validate_utf8(reinterpret_cast<const std::uint8_t*>(std::to_address(begin)), static_cast<std::size_t>(end - begin));
+}
+
+template<std::ranges::contiguous_range Range>
+constexpr bool is_valid_utf8(const Range& range) noexcept requires(sizeof(std::ranges::range_value_t<Range>) == 1)
+{
+    return is_valid_utf8(std::ranges::begin(range), std::ranges::end(range));
+}
+
 template<encoding Input, encoding Output, std::input_iterator InputIt, std::output_iterator<typename Output::char_type> OutputIt>
 constexpr OutputIt convert(InputIt begin, InputIt end, OutputIt output)
 {
@@ -656,16 +1384,22 @@ constexpr OutputIt convert(InputIt begin, InputIt end, OutputIt output)
     {
         return std::copy(begin, end, output);
     }
-    else
+    else if constexpr(impl::has_fast_conversion<Input, Output> && impl::contiguous_code_units<InputIt, typename Input::char_type> && impl::contiguous_code_units<OutputIt, typename Output::char_type>)
     {
-        while(begin < end)
+        //Contiguous UTF-8 <-> UTF-16/UTF-32 goes through the vectorised kernels
+        if(!std::is_constant_evaluated())
         {
-            codepoint_t code{};
-            begin  = Input::decode(begin, end, code);
-            output = Output::encode(code, output);
+            const auto first{std::to_address(output)};
+            const auto last{impl::convert_contiguous<Input, Output>(std::to_address(begin), std::to_address(end), first)};
+
+            return output + (last - first);
         }
 
-        return output;
+        return impl::convert_codepoints<Input, Output>(begin, end, output);
+    }
+    else
+    {
+        return impl::convert_codepoints<Input, Output>(begin, end, output);
     }
 }
 
@@ -675,11 +1409,34 @@ concept reservable = requires(T str, std::size_t count)
     str.reserve(count);
 };
 
+template<typename T>
+concept resizable = requires(T str, std::size_t count)
+{
+    str.resize(count);
+    {std::data(str)} -> std::same_as<typename T::value_type*>;
+};
+
 template<encoding Input, encoding Output, typename StringIn, typename StringOut = std::basic_string<typename Output::char_type>>
 constexpr StringOut convert(const StringIn& str)
 {
     StringOut output{};
 
+    if constexpr(impl::has_fast_conversion<Input, Output> && resizable<StringOut> && std::ranges::contiguous_range<const StringIn>)
+    {
+        //Convert straight into the storage sized for the worst case, then shrink it
+        if(!std::is_constant_evaluated())
+        {
+            const auto size{static_cast<std::size_t>(std::ranges::size(str))};
+            output.resize(size * impl::max_conversion_ratio<Input, Output>());
+
+            const auto first{std::ranges::data(str)};
+            const auto last{convert<Input, Output>(first, first + size, std::data(output))};
+            output.resize(static_cast<std::size_t>(last - std::data(output)));
+
+            return output;
+        }
+    }
+
     if constexpr(reservable<StringOut>)
     {
         output.reserve(Input::count(std::begin(str), std::end(str)) * Output::max_char_length());
@@ -0,0 +1,248 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_FOUNDATION_FRAME_ARENA_HPP_INCLUDED
+#define CAPTAL_FOUNDATION_FRAME_ARENA_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cassert>
+
+namespace cpt
+{
+
+inline namespace foundation
+{
+
+struct frame_arena_statistics
+{
+    std::size_t capacity{};             //Total size of the blocks owned by the arena
+    std::size_t used{};                 //Bytes currently allocated
+    std::size_t frame_peak{};           //Peak usage since last call to new_frame
+    std::size_t high_water_mark{};      //Peak usage since arena creation
+    std::size_t upstream_allocations{}; //Number of blocks requested to the upstream resource
+};
+
+//Bump allocator that never frees individual allocations.
+//new_frame must be called once per frame, it rewinds the arena and merges the blocks so the next frame fits in a single block.
+//Allocations should be released before new_frame. If some are still alive the arena does not rewind, the blocks are kept
+//and new allocations go after the live ones until every allocation has been released.
+//The arena also rewinds as soon as every allocation has been deallocated, so scoped containers reuse the same memory.
+//The arena is not synchronized, it must only be used (allocation and deallocation) by a single thread.
+class frame_arena final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_block_size{64 * 1024};
+
+private:
+    struct block
+    {
+        std::byte* data{};
+        std::size_t size{};
+    };
+
+public:
+    explicit frame_arena(std::size_t block_size = default_block_size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+    :m_upstream{upstream}
+    ,m_block_size{block_size}
+    {
+        assert(m_upstream && "cpt::frame_arena must have a valid upstream memory resource.");
+    }
+
+    ~frame_arena()
+    {
+        release();
+    }
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+    frame_arena(frame_arena&&) noexcept = delete;
+    frame_arena& operator=(frame_arena&&) noexcept = delete;
+
+    void new_frame()
+    {
+        //Live memory must never be handed out again, the arena will rewind once it is deallocated
+        if(m_live_allocations == 0)
+        {
+            rewind();
+        }
+
+        m_statistics.frame_peak = m_statistics.used;
+    }
+
+    void release() noexcept
+    {
+        assert(m_live_allocations == 0 && "cpt::frame_arena::release called while some memory is still in use.");
+
+        for(auto&& current : m_blocks)
+        {
+            m_upstream->deallocate(current.data, current.size, alignof(std::max_align_t));
+        }
+
+        m_blocks.clear();
+        m_block_index = 0;
+        m_offset = 0;
+        m_statistics.capacity = 0;
+        m_statistics.used = 0;
+    }
+
+    const frame_arena_statistics& statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
+    std::size_t live_allocations() const noexcept
+    {
+        return m_live_allocations;
+    }
+
+    std::pmr::memory_resource* upstream() const noexcept
+    {
+        return m_upstream;
+    }
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override
+    {
+        while(m_block_index < std::size(m_blocks))
+        {
+            auto& current{m_blocks[m_block_index]};
+
+            const auto address{reinterpret_cast<std::uintptr_t>(current.data) + m_offset};
+            const auto padding{(alignment - (address % alignment)) % alignment};
+
+            if(m_offset + padding + size <= current.size)
+            {
+                m_offset += padding + size;
+
+                return register_allocation(current.data + m_offset - size, padding + size);
+            }
+
+            //Skip the end of the current block, it will be reclaimed on rewind
+            ++m_block_index;
+            m_offset = 0;
+        }
+
+        const auto block_size{std::max(m_block_size, size + alignment)};
+        auto* const data{static_cast<std::byte*>(m_upstream->allocate(block_size, alignof(std::max_align_t)))};
+
+        m_blocks.emplace_back(block{data, block_size});
+        m_block_index = std::size(m_blocks) - 1;
+        m_statistics.capacity += block_size;
+        ++m_statistics.upstream_allocations;
+
+        const auto padding{(alignment - (reinterpret_cast<std::uintptr_t>(data) % alignment)) % alignment};
+        m_offset = padding + size;
+
+        return register_allocation(data + padding, padding + size);
+    }
+
+    void do_deallocate(void* pointer [[maybe_unused]], std::size_t size [[maybe_unused]], std::size_t alignment [[maybe_unused]]) override
+    {
+        assert(m_live_allocations > 0 && "cpt::frame_arena::deallocate called more times than allocate.");
+
+        if(m_live_allocations > 0 && --m_live_allocations == 0)
+        {
+            rewind();
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    void* register_allocation(void* pointer, std::size_t consumed) noexcept
+    {
+        ++m_live_allocations;
+
+        m_statistics.used += consumed;
+        m_statistics.frame_peak = std::max(m_statistics.frame_peak, m_statistics.used);
+        m_statistics.high_water_mark = std::max(m_statistics.high_water_mark, m_statistics.used);
+
+        return pointer;
+    }
+
+    void rewind()
+    {
+        //If the usage did not fit in the first block, replace all blocks with a single one big enough for everything
+        if(std::size(m_blocks) > 1)
+        {
+            const auto capacity{m_statistics.capacity};
+
+            release();
+
+            auto* const data{static_cast<std::byte*>(m_upstream->allocate(capacity, alignof(std::max_align_t)))};
+
+            m_blocks.emplace_back(block{data, capacity});
+            m_statistics.capacity = capacity;
+            ++m_statistics.upstream_allocations;
+        }
+
+        m_block_index = 0;
+        m_offset = 0;
+        m_statistics.used = 0;
+    }
+
+private:
+    std::pmr::memory_resource* m_upstream{};
+    std::size_t m_block_size{};
+    std::vector<block> m_blocks{};
+    std::size_t m_block_index{};
+    std::size_t m_offset{};
+    std::size_t m_live_allocations{};
+    frame_arena_statistics m_statistics{};
+};
+
+//Each thread owns its own arena, so no synchronization is needed.
+inline frame_arena& thread_frame_arena() noexcept
+{
+    thread_local frame_arena arena{};
+
+    return arena;
+}
+
+template<typename T>
+using frame_vector = std::pmr::vector<T>;
+
+using frame_string = std::pmr::string;
+
+template<typename T>
+frame_vector<T> make_frame_vector(frame_arena& arena = thread_frame_arena())
+{
+    return frame_vector<T>{&arena};
+}
+
+inline frame_string make_frame_string(frame_arena& arena = thread_frame_arena())
+{
+    return frame_string{&arena};
+}
+
+}
+
+}
+
+#endif
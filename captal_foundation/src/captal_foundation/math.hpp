@@ -28,13 +28,350 @@
 #include <concepts>
 #include <ranges>
 #include <type_traits>
+#include <algorithm>
+#include <span>
 #include <cmath>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CAPTAL_FOUNDATION_MATH_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64) //vdivq_f32 and vaddvq_f32 are AArch64 only
+    #define CAPTAL_FOUNDATION_MATH_NEON
+    #include <arm_neon.h>
+#endif
 
 namespace cpt
 {
 
 //abs, pow, sqrt, sin, cos, tan
 
+namespace impl
+{
+
+//Kernels behind the vec4f and mat4f operators, matrices are 16 contiguous floats, row major
+//All pointers may alias, every input is loaded before the output is stored
+
+#if defined(CAPTAL_FOUNDATION_MATH_SSE2)
+
+using float4 = __m128;
+
+struct float4x4
+{
+    float4 x;
+    float4 y;
+    float4 z;
+    float4 w;
+};
+
+inline float4 load4(const float* data) noexcept {return _mm_loadu_ps(data);}
+inline void store4(float* data, float4 value) noexcept {_mm_storeu_ps(data, value);}
+inline float4 splat4(float value) noexcept {return _mm_set1_ps(value);}
+inline float4 add4(float4 left, float4 right) noexcept {return _mm_add_ps(left, right);}
+inline float4 sub4(float4 left, float4 right) noexcept {return _mm_sub_ps(left, right);}
+inline float4 mul4(float4 left, float4 right) noexcept {return _mm_mul_ps(left, right);}
+inline float4 div4(float4 left, float4 right) noexcept {return _mm_div_ps(left, right);}
+inline float4 neg4(float4 value) noexcept {return _mm_xor_ps(value, _mm_set1_ps(-0.0f));}
+inline float4 madd4(float4 left, float4 right, float4 add) noexcept {return _mm_add_ps(_mm_mul_ps(left, right), add);}
+
+inline float sum4(float4 value) noexcept
+{
+    const float4 pairs{_mm_add_ps(value, _mm_movehl_ps(value, value))};
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+}
+
+inline void store3(float* data, float4 value) noexcept
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(data), value);
+    _mm_store_ss(data + 2, _mm_movehl_ps(value, value));
+}
+
+inline float4x4 load_rows(const float* matrix) noexcept
+{
+    return float4x4{load4(matrix), load4(matrix + 4), load4(matrix + 8), load4(matrix + 12)};
+}
+
+inline float4x4 load_columns(const float* matrix) noexcept
+{
+    float4x4 output{load_rows(matrix)};
+    _MM_TRANSPOSE4_PS(output.x, output.y, output.z, output.w);
+
+    return output;
+}
+
+#elif defined(CAPTAL_FOUNDATION_MATH_NEON)
+
+using float4 = float32x4_t;
+
+struct float4x4
+{
+    float4 x;
+    float4 y;
+    float4 z;
+    float4 w;
+};
+
+inline float4 load4(const float* data) noexcept {return vld1q_f32(data);}
+inline void store4(float* data, float4 value) noexcept {vst1q_f32(data, value);}
+inline float4 splat4(float value) noexcept {return vdupq_n_f32(value);}
+inline float4 add4(float4 left, float4 right) noexcept {return vaddq_f32(left, right);}
+inline float4 sub4(float4 left, float4 right) noexcept {return vsubq_f32(left, right);}
+inline float4 mul4(float4 left, float4 right) noexcept {return vmulq_f32(left, right);}
+inline float4 div4(float4 left, float4 right) noexcept {return vdivq_f32(left, right);}
+inline float4 neg4(float4 value) noexcept {return vnegq_f32(value);}
+inline float4 madd4(float4 left, float4 right, float4 add) noexcept {return vmlaq_f32(add, left, right);}
+inline float sum4(float4 value) noexcept {return vaddvq_f32(value);}
+
+inline void store3(float* data, float4 value) noexcept
+{
+    vst1_f32(data, vget_low_f32(value));
+    vst1q_lane_f32(data + 2, value, 2);
+}
+
+inline float4x4 load_rows(const float* matrix) noexcept
+{
+    return float4x4{load4(matrix), load4(matrix + 4), load4(matrix + 8), load4(matrix + 12)};
+}
+
+inline float4x4 load_columns(const float* matrix) noexcept
+{
+    const float32x4x4_t columns{vld4q_f32(matrix)};
+
+    return float4x4{columns.val[0], columns.val[1], columns.val[2], columns.val[3]};
+}
+
+#endif
+
+#if defined(CAPTAL_FOUNDATION_MATH_SSE2) || defined(CAPTAL_FOUNDATION_MATH_NEON)
+
+inline void add4f(const float* left, const float* right, float* output) noexcept
+{
+    store4(output, add4(load4(left), load4(right)));
+}
+
+inline void sub4f(const float* left, const float* right, float* output) noexcept
+{
+    store4(output, sub4(load4(left), load4(right)));
+}
+
+inline void mul4f(const float* left, const float* right, float* output) noexcept
+{
+    store4(output, mul4(load4(left), load4(right)));
+}
+
+inline void div4f(const float* left, const float* right, float* output) noexcept
+{
+    store4(output, div4(load4(left), load4(right)));
+}
+
+inline void neg4f(const float* vector, float* output) noexcept
+{
+    store4(output, neg4(load4(vector)));
+}
+
+inline float dot4f(const float* left, const float* right) noexcept
+{
+    return sum4(mul4(load4(left), load4(right)));
+}
+
+inline float4 combine_rows(const float4x4& rows, const float* factors) noexcept
+{
+    float4 output{mul4(splat4(factors[0]), rows.x)};
+    output = madd4(splat4(factors[1]), rows.y, output);
+    output = madd4(splat4(factors[2]), rows.z, output);
+    output = madd4(splat4(factors[3]), rows.w, output);
+
+    return output;
+}
+
+inline void mat4f_mul(const float* left, const float* right, float* output) noexcept
+{
+    const float4x4 rows{load_rows(right)};
+    const float4x4 result{combine_rows(rows, left), combine_rows(rows, left + 4), combine_rows(rows, left + 8), combine_rows(rows, left + 12)};
+
+    store4(output, result.x);
+    store4(output + 4, result.y);
+    store4(output + 8, result.z);
+    store4(output + 12, result.w);
+}
+
+inline float4 transform_columns(const float4x4& columns, float x, float y, float z, float4 w) noexcept
+{
+    return madd4(columns.z, splat4(z), madd4(columns.y, splat4(y), madd4(columns.x, splat4(x), w)));
+}
+
+inline void mat4f_mul_vec(const float* matrix, const float* vector, float* output) noexcept
+{
+    const float4x4 columns{load_columns(matrix)};
+    store4(output, transform_columns(columns, vector[0], vector[1], vector[2], mul4(columns.w, splat4(vector[3]))));
+}
+
+inline void vec_mul_mat4f(const float* vector, const float* matrix, float* output) noexcept
+{
+    store4(output, combine_rows(load_rows(matrix), vector));
+}
+
+inline void mat4f_transpose(const float* matrix, float* output) noexcept
+{
+    const float4x4 columns{load_columns(matrix)};
+
+    store4(output, columns.x);
+    store4(output + 4, columns.y);
+    store4(output + 8, columns.z);
+    store4(output + 12, columns.w);
+}
+
+inline void mat4f_transform(const float* matrix, const float* input, float* output, std::size_t count) noexcept
+{
+    const float4x4 columns{load_columns(matrix)};
+
+    for(std::size_t i{}; i < count; ++i, input += 4, output += 4)
+    {
+        store4(output, transform_columns(columns, input[0], input[1], input[2], mul4(columns.w, splat4(input[3]))));
+    }
+}
+
+inline void mat4f_transform_points(const float* matrix, const float* input, float* output, std::size_t count) noexcept
+{
+    const float4x4 columns{load_columns(matrix)};
+
+    for(std::size_t i{}; i < count; ++i, input += 3, output += 3)
+    {
+        store3(output, transform_columns(columns, input[0], input[1], input[2], columns.w));
+    }
+}
+
+#else
+
+inline void add4f(const float* left, const float* right, float* output) noexcept
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = left[i] + right[i];
+    }
+}
+
+inline void sub4f(const float* left, const float* right, float* output) noexcept
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = left[i] - right[i];
+    }
+}
+
+inline void mul4f(const float* left, const float* right, float* output) noexcept
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = left[i] * right[i];
+    }
+}
+
+inline void div4f(const float* left, const float* right, float* output) noexcept
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = left[i] / right[i];
+    }
+}
+
+inline void neg4f(const float* vector, float* output) noexcept
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        output[i] = -vector[i];
+    }
+}
+
+inline float dot4f(const float* left, const float* right) noexcept
+{
+    return left[0] * right[0] + left[1] * right[1] + left[2] * right[2] + left[3] * right[3];
+}
+
+inline void mat4f_mul(const float* left, const float* right, float* output) noexcept
+{
+    std::array<float, 16> result{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        for(std::size_t k{}; k < 4; ++k)
+        {
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                result[i * 4 + j] += left[i * 4 + k] * right[k * 4 + j];
+            }
+        }
+    }
+
+    std::copy(std::begin(result), std::end(result), output);
+}
+
+inline void mat4f_mul_vec(const float* matrix, const float* vector, float* output) noexcept
+{
+    std::array<float, 4> result{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        result[i] = dot4f(matrix + i * 4, vector);
+    }
+
+    std::copy(std::begin(result), std::end(result), output);
+}
+
+inline void vec_mul_mat4f(const float* vector, const float* matrix, float* output) noexcept
+{
+    std::array<float, 4> result{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            result[j] += vector[i] * matrix[i * 4 + j];
+        }
+    }
+
+    std::copy(std::begin(result), std::end(result), output);
+}
+
+inline void mat4f_transpose(const float* matrix, float* output) noexcept
+{
+    std::array<float, 16> result{};
+
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            result[j * 4 + i] = matrix[i * 4 + j];
+        }
+    }
+
+    std::copy(std::begin(result), std::end(result), output);
+}
+
+inline void mat4f_transform(const float* matrix, const float* input, float* output, std::size_t count) noexcept
+{
+    for(std::size_t i{}; i < count; ++i, input += 4, output += 4)
+    {
+        mat4f_mul_vec(matrix, input, output);
+    }
+}
+
+inline void mat4f_transform_points(const float* matrix, const float* input, float* output, std::size_t count) noexcept
+{
+    for(std::size_t i{}; i < count; ++i, input += 3, output += 3)
+    {
+        const std::array<float, 4> point{input[0], input[1], input[2], 1.0f};
+        std::array<float, 4> result{};
+
+        mat4f_mul_vec(matrix, std::data(point), std::data(result));
+        std::copy(std::begin(result), std::begin(result) + 3, output);
+    }
+}
+
+#endif
+
+}
+
 inline namespace foundation
 {
 
@@ -350,6 +687,15 @@ constexpr vec<T, Size> operator+(const vec<T, Size>& left, const vec<T, Size>& r
 {
     vec<T, Size> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::add4f(std::data(left), std::data(right), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size; ++i)
     {
         output[i] = left[i] + right[i];
@@ -371,6 +717,15 @@ constexpr vec<T, Size> operator-(const vec<T, Size>& vector) noexcept
 {
     vec<T, Size> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::neg4f(std::data(vector), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size; ++i)
     {
         output[i] = -vector[i];
@@ -384,6 +739,15 @@ constexpr vec<T, Size> operator-(const vec<T, Size>& left, const vec<T, Size>& r
 {
     vec<T, Size> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::sub4f(std::data(left), std::data(right), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size; ++i)
     {
         output[i] = left[i] - right[i];
@@ -405,6 +769,15 @@ constexpr vec<T, Size> operator*(const vec<T, Size>& left, const vec<T, Size>& r
 {
     vec<T, Size> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::mul4f(std::data(left), std::data(right), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size; ++i)
     {
         output[i] = left[i] * right[i];
@@ -426,6 +799,15 @@ constexpr vec<T, Size> operator/(const vec<T, Size>& left, const vec<T, Size>& r
 {
     vec<T, Size> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::div4f(std::data(left), std::data(right), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size; ++i)
     {
         output[i] = left[i] / right[i];
@@ -445,6 +827,14 @@ constexpr vec<T, Size>& operator/=(vec<T, Size>& left, const vec<T, Size>& right
 template<arithmetic T, std::size_t Size>
 constexpr T dot(const vec<T, Size>& left, const vec<T, Size>& right) noexcept
 {
+    if constexpr(std::is_same_v<T, float> && Size == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            return impl::dot4f(std::data(left), std::data(right));
+        }
+    }
+
     T output{};
 
     for(std::size_t i{}; i < Size; ++i)
@@ -874,6 +1264,15 @@ constexpr mat<T, Size1, Size3> operator*(const mat<T, Size1, Size2>& left, const
 {
     mat<T, Size1, Size3> output{};
 
+    if constexpr(std::is_same_v<T, float> && Size1 == 4 && Size2 == 4 && Size3 == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::mat4f_mul(std::data(left[0]), std::data(right[0]), std::data(output[0]));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Size1; ++i)
     {
         for(std::size_t j{}; j < Size3; ++j)
@@ -893,6 +1292,15 @@ constexpr vec<T, Rows> operator*(const mat<T, Rows, Cols>& left, const vec<T, Co
 {
     vec<T, Rows> output{};
 
+    if constexpr(std::is_same_v<T, float> && Rows == 4 && Cols == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::mat4f_mul_vec(std::data(left[0]), std::data(right), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t i{}; i < Rows; ++i)
     {
         for(std::size_t j{}; j < Cols; ++j)
@@ -909,6 +1317,15 @@ constexpr vec<T, Cols> operator*(const vec<T, Rows>& left, const mat<T, Rows, Co
 {
     vec<T, Cols> output{};
 
+    if constexpr(std::is_same_v<T, float> && Rows == 4 && Cols == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::vec_mul_mat4f(std::data(left), std::data(right[0]), std::data(output));
+            return output;
+        }
+    }
+
     for(std::size_t j{}; j < Cols; ++j)
     {
         for(std::size_t i{}; i < Rows; ++i)
@@ -954,6 +1371,15 @@ constexpr mat<T, Cols, Rows> transpose(const mat<T, Rows, Cols>& matrix) noexcep
 {
     mat<T, Cols, Rows> output{};
 
+    if constexpr(std::is_same_v<T, float> && Rows == 4 && Cols == 4)
+    {
+        if(!std::is_constant_evaluated())
+        {
+            impl::mat4f_transpose(std::data(matrix[0]), std::data(output[0]));
+            return output;
+        }
+    }
+
     for(std::size_t x{}; x < Rows; ++x)
     {
         for(std::size_t y{}; y < Cols; ++y)
@@ -1079,16 +1505,42 @@ constexpr mat<T, 4, 4> scale(const vec<T, 3>& scale) noexcept
     return output;
 }
 
+//Same as scale(factor) * rotate(angle, axis) * translate(translation), without the matrix products
 template<arithmetic T>
 mat<T, 4, 4> model(const vec<T, 3>& translation, T angle, const vec<T, 3>& axis, const vec<T, 3>& factor)
 {
-    return scale(factor) * rotate(angle, axis) * translate(translation);
+    mat<T, 4, 4> output{rotate(angle, axis)};
+
+    for(std::size_t i{}; i < 3; ++i)
+    {
+        const vec<T, 3> row{output[i][0], output[i][1], output[i][2]};
+
+        output[i][0] *= factor[i];
+        output[i][1] *= factor[i];
+        output[i][2] *= factor[i];
+        output[i][3] = factor[i] * dot(row, translation);
+    }
+
+    return output;
 }
 
+//Same as scale(factor) * translate(translation) * rotate(angle, axis) * translate(-origin), without the matrix products
 template<arithmetic T>
 mat<T, 4, 4> model(const vec<T, 3>& translation, T angle, const vec<T, 3>& axis, const vec<T, 3>& factor, const vec<T, 3>& origin)
 {
-    return scale(factor) * translate(translation) * rotate(angle, axis) * translate(-origin);
+    mat<T, 4, 4> output{rotate(angle, axis)};
+
+    for(std::size_t i{}; i < 3; ++i)
+    {
+        const vec<T, 3> row{output[i][0], output[i][1], output[i][2]};
+
+        output[i][0] *= factor[i];
+        output[i][1] *= factor[i];
+        output[i][2] *= factor[i];
+        output[i][3] = factor[i] * (translation[i] - dot(row, origin));
+    }
+
+    return output;
 }
 
 /* this is a cool effect :)
@@ -1168,6 +1620,42 @@ using mat4d = mat4<double>;
 using mat4i = mat4<std::int32_t>;
 using mat4u = mat4<std::uint32_t>;
 
+static_assert(sizeof(mat4f) == sizeof(float) * 16, "cpt::mat4f must be 16 contiguous floats.");
+
+//Batch kernels: output[i] = matrix * input[i], input and output may be the same span
+inline void transform(const mat4f& matrix, std::span<const vec4f> input, std::span<vec4f> output) noexcept
+{
+    assert(std::size(output) >= std::size(input) && "cpt::transform output is too small.");
+
+    if(!std::empty(input))
+    {
+        impl::mat4f_transform(std::data(matrix[0]), std::data(input[0]), std::data(output[0]), std::size(input));
+    }
+}
+
+//Same as transform, with w = 1 and without perspective divide
+inline void transform_points(const mat4f& matrix, std::span<const vec3f> input, std::span<vec3f> output) noexcept
+{
+    assert(std::size(output) >= std::size(input) && "cpt::transform_points output is too small.");
+
+    if(!std::empty(input))
+    {
+        impl::mat4f_transform_points(std::data(matrix[0]), std::data(input[0]), std::data(output[0]), std::size(input));
+    }
+}
+
+//Batch version of model with an origin, from structure of arrays inputs
+inline void models(std::span<const vec3f> translations, std::span<const float> angles, const vec3f& axis, std::span<const vec3f> factors, std::span<const vec3f> origins, std::span<mat4f> output) noexcept
+{
+    assert(std::size(angles) == std::size(translations) && std::size(factors) == std::size(translations) && std::size(origins) == std::size(translations) && "cpt::models inputs must have the same size.");
+    assert(std::size(output) >= std::size(translations) && "cpt::models output is too small.");
+
+    for(std::size_t i{}; i < std::size(translations); ++i)
+    {
+        output[i] = model(translations[i], angles[i], axis, factors[i], origins[i]);
+    }
+}
+
 namespace indices
 {
 
@@ -3,10 +3,12 @@
 #include <captal_foundation/optional_ref.hpp>
 #include <captal_foundation/enum_operations.hpp>
 #include <captal_foundation/stack_allocator.hpp>
+#include <captal_foundation/frame_arena.hpp>
 #include <captal_foundation/math.hpp>
 
 #include <vector>
 #include <numbers>
+#include <thread>
 
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 #define CATCH_CONFIG_MAIN
@@ -145,6 +147,128 @@ TEST_CASE("Stack allocator test", "[stack_alloc]")
     }
 }
 
+TEST_CASE("Frame arena test", "[frame_arena]")
+{
+    SECTION("cpt::frame_arena allocates aligned memory within a single block")
+    {
+        cpt::frame_arena arena{1024};
+
+        void* memory1{arena.allocate(3, 1)};
+        void* memory2{arena.allocate(16, 16)};
+        REQUIRE(memory1);
+        REQUIRE(memory2);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(memory2) % 16 == 0);
+        REQUIRE(arena.statistics().upstream_allocations == 1);
+
+        arena.deallocate(memory2, 16, 16);
+        arena.deallocate(memory1, 3, 1);
+    }
+
+    SECTION("cpt::frame_arena rewinds once all allocations are released")
+    {
+        cpt::frame_arena arena{1024};
+
+        void* memory1{arena.allocate(64)};
+        arena.deallocate(memory1, 64);
+        REQUIRE(arena.statistics().used == 0);
+
+        void* memory2{arena.allocate(64)};
+        REQUIRE(memory1 == memory2);
+        arena.deallocate(memory2, 64);
+    }
+
+    SECTION("cpt::frame_arena merges its blocks so the next frame does not allocate")
+    {
+        cpt::frame_arena arena{256};
+
+        {
+            auto vector{cpt::make_frame_vector<std::uint32_t>(arena)};
+            vector.resize(1000);
+        }
+
+        arena.new_frame();
+
+        const auto allocations{arena.statistics().upstream_allocations};
+        REQUIRE(arena.statistics().capacity >= 1000 * sizeof(std::uint32_t));
+        REQUIRE(arena.statistics().high_water_mark >= 1000 * sizeof(std::uint32_t));
+
+        {
+            auto vector{cpt::make_frame_vector<std::uint32_t>(arena)};
+            vector.reserve(1000);
+            vector.resize(1000);
+        }
+
+        arena.new_frame();
+        REQUIRE(arena.statistics().upstream_allocations == allocations);
+    }
+
+    SECTION("cpt::frame_arena rewinds at every new_frame")
+    {
+        cpt::frame_arena arena{1024};
+
+        for(std::size_t i{}; i < 16; ++i)
+        {
+            {
+                auto vector{cpt::make_frame_vector<std::uint8_t>(arena)};
+                vector.resize(512);
+
+                auto string{cpt::make_frame_string(arena)};
+                string.assign(256, 'a');
+
+                REQUIRE(arena.statistics().frame_peak >= 768);
+            }
+
+            arena.new_frame();
+
+            REQUIRE(arena.statistics().used == 0);
+            REQUIRE(arena.statistics().frame_peak == 0);
+            REQUIRE(arena.live_allocations() == 0);
+        }
+
+        REQUIRE(arena.statistics().upstream_allocations == 1);
+    }
+
+    SECTION("cpt::frame_arena does not reuse memory still in use at new_frame")
+    {
+        cpt::frame_arena arena{256};
+
+        auto* const kept{static_cast<std::uint8_t*>(arena.allocate(128, 1))};
+        std::fill_n(kept, 128, std::uint8_t{42});
+
+        arena.new_frame();
+
+        REQUIRE(arena.live_allocations() == 1);
+        REQUIRE(arena.statistics().used >= 128);
+
+        auto* const other{static_cast<std::uint8_t*>(arena.allocate(128, 1))};
+        std::fill_n(other, 128, std::uint8_t{0});
+
+        REQUIRE(std::all_of(kept, kept + 128, [](std::uint8_t value){ return value == 42; }));
+
+        arena.deallocate(other, 128, 1);
+        arena.deallocate(kept, 128, 1);
+
+        REQUIRE(arena.statistics().used == 0);
+
+        arena.new_frame();
+        REQUIRE(arena.statistics().capacity >= 256);
+    }
+
+    SECTION("cpt::thread_frame_arena returns a different arena per thread")
+    {
+        cpt::frame_arena* other{};
+
+        std::thread thread{[&other]()
+        {
+            other = &cpt::thread_frame_arena();
+        }};
+
+        thread.join();
+
+        REQUIRE(other != &cpt::thread_frame_arena());
+    }
+}
+
 TEST_CASE("Encoding test", "[encoding]")
 {
     const std::u8string_view string{u8"abcÀçè中国日本国кир👦"}; //A string with a lot of special chars with different sizes (in UTF-8)
@@ -169,6 +293,141 @@ TEST_CASE("Encoding test", "[encoding]")
     REQUIRE(count.operator()<cpt::wide>() == codepoint_count);
 }
 
+TEST_CASE("Encoding fast paths", "[encoding]")
+{
+    //Long enough to cross several vector blocks, with multibyte sequences straddling block boundaries
+    std::u8string text{};
+    for(std::size_t i{}; i < 24; ++i)
+    {
+        text += u8"The quick brown fox ";
+        text += u8"àéîõü中国日本кир👦";
+        text.append(i, u8'x');
+    }
+
+    const auto scalar = [] <cpt::encoding Input, cpt::encoding Output, typename String> (const String& string)
+    {
+        std::basic_string<typename Output::char_type> output{};
+        cpt::convert<Input, Output>(std::begin(string), std::end(string), std::back_inserter(output));
+
+        return output;
+    };
+
+    for(std::size_t offset{}; offset < 40; ++offset)
+    {
+        const std::u8string_view view{std::data(text) + offset, std::size(text) - offset};
+        const std::u32string utf32{scalar.operator()<cpt::utf8, cpt::utf32>(view)};
+        const std::u16string utf16{scalar.operator()<cpt::utf8, cpt::utf16>(view)};
+
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf32>(view) == utf32);
+        REQUIRE(cpt::convert<cpt::utf8, cpt::utf16>(view) == utf16);
+        REQUIRE(cpt::convert<cpt::utf32, cpt::utf8>(utf32) == scalar.operator()<cpt::utf32, cpt::utf8>(utf32));
+        REQUIRE(cpt::convert<cpt::utf16, cpt::utf8>(utf16) == scalar.operator()<cpt::utf16, cpt::utf8>(utf16));
+
+        if(cpt::is_valid_utf8(view))
+        {
+            REQUIRE(cpt::convert<cpt::utf32, cpt::utf8>(utf32) == view);
+        }
+    }
+
+    REQUIRE(cpt::is_valid_utf8(text));
+    REQUIRE(cpt::is_valid_utf8(std::u8string_view{}));
+
+    const std::array<std::u8string_view, 10> invalids
+    {
+        u8"\xC0\xAF",             //overlong 2 bytes
+        u8"\xE0\x80\xAF",         //overlong 3 bytes
+        u8"\xF0\x80\x80\xAF",     //overlong 4 bytes
+        u8"\xED\xA0\x80",         //surrogate
+        u8"\xF4\x90\x80\x80",     //above U+10FFFF
+        u8"\xF8\x88\x80\x80\x80", //5 bytes
+        u8"\x80",                 //stray continuation
+        u8"\xE4\xB8",             //truncated
+        u8"\xC3\xA9\xA9",         //too long
+        u8"\xE4\x41\xAD",         //too short
+    };
+
+    for(const auto invalid : invalids)
+    {
+        for(std::size_t position : {0, 13, 14, 15, 16, 30, 31, 32, 63, 100})
+        {
+            std::u8string copy{std::u8string_view{text}.substr(0, position)};
+            copy.erase(std::find_if(std::rbegin(copy), std::rend(copy), [](char8_t c){ return c < 0x80; }).base(), std::end(copy));
+            copy += invalid;
+
+            REQUIRE(!cpt::is_valid_utf8(copy));
+            REQUIRE(!cpt::is_valid_utf8(copy + u8"0123456789abcdefghijklmnopqrstuvwxyz"));
+
+            const std::u8string suffixed{copy + u8"0123456789abcdef"};
+            REQUIRE(cpt::convert<cpt::utf8, cpt::utf32>(suffixed) == scalar.operator()<cpt::utf8, cpt::utf32>(suffixed));
+        }
+    }
+}
+
+TEST_CASE("Encoding benchmark", "[.][encoding_bench]")
+{
+    //Each corpus is 1 MiB of UTF-8, divide 1 by the mean time to get MiB/s
+    const auto make_corpus = [](std::u8string_view pattern)
+    {
+        std::u8string output{};
+        while(std::size(output) + std::size(pattern) <= 1024 * 1024)
+        {
+            output += pattern;
+        }
+
+        return output;
+    };
+
+    const std::array corpora
+    {
+        std::pair{std::string_view{"ASCII"}, make_corpus(u8"Lorem ipsum dolor sit amet, consectetur adipiscing elit. ")},
+        std::pair{std::string_view{"Latin"}, make_corpus(u8"Ça fera un été très chaud à Noël, déjà vu. Größe, mañana. ")},
+        std::pair{std::string_view{"CJK"},   make_corpus(u8"日本語の文章と中文句子，以及한국어 문장입니다。")},
+    };
+
+    for(const auto& [name, corpus] : corpora)
+    {
+        const auto utf32{cpt::convert<cpt::utf8, cpt::utf32>(corpus)};
+
+        BENCHMARK("1 MiB " + std::string{name} + " validation")
+        {
+            return cpt::is_valid_utf8(corpus);
+        };
+
+        BENCHMARK("1 MiB " + std::string{name} + " utf8 -> utf32 scalar")
+        {
+            std::u32string output{};
+            output.reserve(std::size(corpus));
+            cpt::convert<cpt::utf8, cpt::utf32>(std::begin(corpus), std::end(corpus), std::back_inserter(output));
+
+            return output;
+        };
+
+        BENCHMARK("1 MiB " + std::string{name} + " utf8 -> utf32")
+        {
+            return cpt::convert<cpt::utf8, cpt::utf32>(corpus);
+        };
+
+        BENCHMARK("1 MiB " + std::string{name} + " utf8 -> utf16")
+        {
+            return cpt::convert<cpt::utf8, cpt::utf16>(corpus);
+        };
+
+        BENCHMARK("1 MiB " + std::string{name} + " utf32 -> utf8 scalar")
+        {
+            std::u8string output{};
+            output.reserve(std::size(utf32) * 4);
+            cpt::convert<cpt::utf32, cpt::utf8>(std::begin(utf32), std::end(utf32), std::back_inserter(output));
+
+            return output;
+        };
+
+        BENCHMARK("1 MiB " + std::string{name} + " utf32 -> utf8")
+        {
+            return cpt::convert<cpt::utf32, cpt::utf8>(utf32);
+        };
+    }
+}
+
 /*
 static constexpr std::size_t pool_size{1024};
 
@@ -274,4 +533,157 @@ TEST_CASE("maths test", "[math_test]")
         REQUIRE(transformed[z] == Approx(8.0).margin(0.01));
         REQUIRE(transformed[w] == Approx(1.0).margin(0.01));
     }
+
+    SECTION("vec4f and mat4f kernels match the constant evaluated code")
+    {
+        static constexpr cpt::vec4f left{1.0f, -2.0f, 3.0f, 0.5f};
+        static constexpr cpt::vec4f right{4.0f, 5.0f, -6.0f, 2.0f};
+        static constexpr cpt::mat4f matrix{left, right, left * right, left - right};
+        static constexpr cpt::mat4f other{right, left, left + right, right / left};
+
+        static constexpr auto sum{left + right};
+        static constexpr auto difference{left - right};
+        static constexpr auto product{left * right};
+        static constexpr auto quotient{left / right};
+        static constexpr auto negated{-left};
+        static constexpr auto dot{cpt::dot(left, right)};
+        static constexpr auto matrix_product{matrix * other};
+        static constexpr auto transformed{matrix * left};
+        static constexpr auto left_transformed{left * matrix};
+        static constexpr auto transposed{cpt::transpose(matrix)};
+
+        //Copies force the runtime path
+        auto runtime_left{left};
+        auto runtime_right{right};
+        auto runtime_matrix{matrix};
+        auto runtime_other{other};
+
+        REQUIRE(runtime_left + runtime_right == sum);
+        REQUIRE(runtime_left - runtime_right == difference);
+        REQUIRE(runtime_left * runtime_right == product);
+        REQUIRE(runtime_left / runtime_right == quotient);
+        REQUIRE(-runtime_left == negated);
+        REQUIRE(cpt::dot(runtime_left, runtime_right) == Approx(dot));
+        REQUIRE(cpt::transpose(runtime_matrix) == transposed);
+
+        const auto runtime_product{runtime_matrix * runtime_other};
+        const auto runtime_transformed{runtime_matrix * runtime_left};
+        const auto runtime_left_transformed{runtime_left * runtime_matrix};
+
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            REQUIRE(runtime_transformed[i] == Approx(transformed[i]));
+            REQUIRE(runtime_left_transformed[i] == Approx(left_transformed[i]));
+
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                REQUIRE(runtime_product[i][j] == Approx(matrix_product[i][j]));
+            }
+        }
+    }
+
+    SECTION("Batch transforms")
+    {
+        const cpt::vec3f axis{0.0f, 0.0f, 1.0f};
+
+        std::vector<cpt::vec3f> translations{};
+        std::vector<float> angles{};
+        std::vector<cpt::vec3f> factors{};
+        std::vector<cpt::vec3f> origins{};
+
+        for(std::size_t i{}; i < 37; ++i)
+        {
+            const auto value{static_cast<float>(i)};
+
+            translations.emplace_back(value, value * 2.0f, -value);
+            angles.emplace_back(value * 0.1f);
+            factors.emplace_back(1.0f + value * 0.01f, 2.0f, 0.5f);
+            origins.emplace_back(value * 0.5f, 1.0f, 0.0f);
+        }
+
+        std::vector<cpt::mat4f> models(std::size(translations));
+        cpt::models(translations, angles, axis, factors, origins, models);
+
+        for(std::size_t i{}; i < std::size(models); ++i)
+        {
+            const auto expected{cpt::scale(factors[i]) * cpt::translate(translations[i]) * cpt::rotate(angles[i], axis) * cpt::translate(-origins[i])};
+            const auto simple{cpt::scale(factors[i]) * cpt::rotate(angles[i], axis) * cpt::translate(translations[i])};
+            const auto simple_model{cpt::model(translations[i], angles[i], axis, factors[i])};
+
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                for(std::size_t k{}; k < 4; ++k)
+                {
+                    REQUIRE(models[i][j][k] == Approx(expected[j][k]).margin(0.0001));
+                    REQUIRE(simple_model[j][k] == Approx(simple[j][k]).margin(0.0001));
+                }
+            }
+        }
+
+        const auto& matrix{models[5]};
+
+        std::vector<cpt::vec4f> vectors{};
+        for(const auto& translation : translations)
+        {
+            vectors.emplace_back(translation, 1.0f);
+        }
+
+        std::vector<cpt::vec4f> transformed(std::size(vectors));
+        cpt::transform(matrix, vectors, transformed);
+
+        std::vector<cpt::vec3f> points{translations};
+        cpt::transform_points(matrix, points, points);
+
+        for(std::size_t i{}; i < std::size(vectors); ++i)
+        {
+            const auto expected{matrix * vectors[i]};
+
+            for(std::size_t j{}; j < 4; ++j)
+            {
+                REQUIRE(transformed[i][j] == Approx(expected[j]).margin(0.0001));
+            }
+
+            for(std::size_t j{}; j < 3; ++j)
+            {
+                REQUIRE(points[i][j] == Approx(expected[j]).margin(0.0001));
+            }
+        }
+    }
+}
+
+TEST_CASE("maths benchmark", "[.][math_bench]")
+{
+    static constexpr std::size_t node_count{50000};
+    const cpt::vec3f axis{0.0f, 0.0f, 1.0f};
+
+    std::vector<cpt::vec3f> translations(node_count, cpt::vec3f{10.0f, 20.0f, 0.0f});
+    std::vector<float> angles(node_count, 0.5f);
+    std::vector<cpt::vec3f> factors(node_count, cpt::vec3f{2.0f, 2.0f, 1.0f});
+    std::vector<cpt::vec3f> origins(node_count, cpt::vec3f{8.0f, 8.0f, 0.0f});
+    std::vector<cpt::mat4f> models(node_count);
+    std::vector<cpt::vec3f> points(node_count * 4, cpt::vec3f{1.0f, 2.0f, 0.0f});
+
+    BENCHMARK("50k model matrices, matrix products")
+    {
+        for(std::size_t i{}; i < node_count; ++i)
+        {
+            models[i] = cpt::scale(factors[i]) * cpt::translate(translations[i]) * cpt::rotate(angles[i], axis) * cpt::translate(-origins[i]);
+        }
+
+        return models[node_count / 2][0][0];
+    };
+
+    BENCHMARK("50k model matrices, cpt::models")
+    {
+        cpt::models(translations, angles, axis, factors, origins, models);
+
+        return models[node_count / 2][0][0];
+    };
+
+    BENCHMARK("200k points, cpt::transform_points")
+    {
+        cpt::transform_points(models[0], points, points);
+
+        return points[0][0];
+    };
 }
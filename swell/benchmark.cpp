@@ -0,0 +1,128 @@
+#include <swell/audio_world.hpp>
+#include <swell/offline.hpp>
+#include <swell/wave.hpp>
+#include <swell/effect.hpp>
+
+#include <cmath>
+#include <numbers>
+#include <sstream>
+#include <iostream>
+#include <string>
+
+//Renders a scripted scene without any audio device and reports the throughput.
+//Usage: swell_offline_benchmark [voice count] [duration in seconds] [output.wav]
+
+static std::vector<std::uint8_t> make_tone(float frequency, std::uint32_t sample_rate, std::uint32_t frame_count)
+{
+    std::vector<float> samples{};
+    samples.resize(frame_count);
+
+    for(std::uint32_t i{}; i < frame_count; ++i)
+    {
+        samples[i] = 0.5f * std::sin(2.0f * std::numbers::pi_v<float> * frequency * static_cast<float>(i) / static_cast<float>(sample_rate));
+    }
+
+    std::ostringstream oss{};
+    swl::write_wave(oss, samples, 1, sample_rate);
+
+    const std::string data{oss.str()};
+
+    return std::vector<std::uint8_t>{std::begin(data), std::end(data)};
+}
+
+int main(int argc, char** argv)
+{
+    constexpr std::uint32_t sample_rate{44100};
+
+    const std::size_t voice_count{argc > 1 ? std::stoul(argv[1]) : 32};
+    const double duration{argc > 2 ? std::stod(argv[2]) : 60.0};
+
+    swl::audio_world world{sample_rate};
+    swl::listener listener{2};
+    listener.set_direction(swl::vec3f{0.0f, 0.0f, 1.0f});
+
+    //Every non-spatialized voice shares a single reverb
+    const swl::bus_id environment{world.make_bus("environment")};
+    world.emplace_effect<swl::lowpass_filter>(environment, 4000.0f);
+    world.emplace_effect<swl::reverb>(environment, sample_rate);
+
+    std::vector<std::vector<std::uint8_t>> tones{};
+    std::vector<swl::sound> sounds{};
+    tones.reserve(voice_count);
+    sounds.reserve(voice_count);
+
+    for(std::size_t i{}; i < voice_count; ++i)
+    {
+        //One second of a tone whose period fits exactly, so it loops seamlessly
+        tones.emplace_back(make_tone(110.0f + 55.0f * static_cast<float>(i % 16), sample_rate, sample_rate));
+
+        auto& sound{sounds.emplace_back(world, std::make_unique<swl::wave_reader>(tones.back(), swl::sound_reader_options::none))};
+        sound.set_loop_points(0, sample_rate);
+        sound.set_volume(1.0f / static_cast<float>(voice_count));
+
+        if(i % 2 == 0)
+        {
+            sound.enable_spatialization();
+        }
+        else
+        {
+            sound.set_bus(environment);
+        }
+    }
+
+    swl::offline_renderer renderer{world, listener};
+
+    //Voices start staggered, move around the listener every 10ms and fade out at the end
+    for(std::size_t i{}; i < voice_count; ++i)
+    {
+        renderer.schedule(static_cast<std::uint64_t>(i) * 441, [&sounds, i]
+        {
+            sounds[i].start();
+        });
+    }
+
+    const auto frame_count{static_cast<std::uint64_t>(duration * sample_rate)};
+
+    for(std::uint64_t frame{}; frame < frame_count; frame += 441)
+    {
+        renderer.schedule(frame, [&sounds, frame, voice_count]
+        {
+            const float time{static_cast<float>(frame) / static_cast<float>(sample_rate)};
+
+            for(std::size_t i{}; i < voice_count; i += 2)
+            {
+                const float angle{time + static_cast<float>(i)};
+                sounds[i].move_to(swl::vec3f{std::cos(angle) * 4.0f, 0.0f, std::sin(angle) * 4.0f});
+            }
+        });
+    }
+
+    renderer.schedule(frame_count - std::min<std::uint64_t>(frame_count, sample_rate), [&sounds]
+    {
+        for(auto& sound : sounds)
+        {
+            sound.fade_out(std::chrono::seconds{1});
+        }
+    });
+
+    const auto statistics{argc > 3 ? renderer.render(std::filesystem::path{argv[3]}, frame_count) : [&]
+    {
+        std::vector<float> output{};
+        return renderer.render(output, frame_count);
+    }()};
+
+    const auto milliseconds = [](swl::seconds time)
+    {
+        return time.count() * 1000.0;
+    };
+
+    std::cout << "voices:            " << voice_count << "\n";
+    std::cout << "frames:            " << statistics.frame_count << " in " << statistics.world.block_count << " blocks\n";
+    std::cout << "elapsed:           " << milliseconds(statistics.elapsed) << " ms\n";
+    std::cout << "frames per second: " << statistics.frames_per_second << "\n";
+    std::cout << "realtime factor:   " << statistics.realtime_factor << "x\n";
+    std::cout << "read:              " << milliseconds(statistics.world.read) << " ms\n";
+    std::cout << "fading:            " << milliseconds(statistics.world.fading) << " ms\n";
+    std::cout << "mixing:            " << milliseconds(statistics.world.mixing) << " ms\n";
+    std::cout << "effects:           " << milliseconds(statistics.world.effects) << " ms\n";
+}
@@ -24,6 +24,7 @@
 
 #include <cassert>
 #include <numbers>
+#include <utility>
 
 namespace swl
 {
@@ -315,6 +316,15 @@ void sound::seek(std::uint64_t frame)
     m_data->reader->seek(frame);
 }
 
+void sound::set_bus(bus_id bus)
+{
+    assert(bus < m_data->world->bus_count() && "swl::sound::set_bus bus does not exist.");
+
+    std::lock_guard lock{m_data->mutex};
+
+    m_data->state.bus = bus;
+}
+
 std::unique_ptr<sound_reader> sound::change_reader(std::unique_ptr<sound_reader> new_reader)
 {
     std::lock_guard lock{m_data->mutex};
@@ -390,6 +400,13 @@ std::uint64_t sound::tell() const
     return m_data->reader->tell();
 }
 
+bus_id sound::bus() const
+{
+    std::lock_guard lock{m_data->mutex};
+
+    return m_data->state.bus;
+}
+
 static constexpr float fast_pow(float value, std::size_t count) noexcept
 {
     if(value == 0.0f)
@@ -437,10 +454,16 @@ inline float mix_amplitude(float value, std::size_t count) noexcept
     return sign(value) * (1.0f - fast_pow(1.0f - std::abs(value), count));
 }
 
+audio_world::audio_world()
+:audio_world{0}
+{
+
+}
+
 audio_world::audio_world(std::uint32_t sample_rate)
 :m_sample_rate{sample_rate}
 {
-
+    m_buses.emplace_back(bus_data{.name = "master"});
 }
 
 void audio_world::set_up(const vec3f& direction)
@@ -467,51 +490,152 @@ void audio_world::generate(std::size_t frame_count)
         return;
     }
 
+    const auto begin{clock::now()};
+
     m_sample_buffer.clear();
     store_sounds_data(frame_count);
 
     lock.unlock();
 
+    const auto read{clock::now()};
+
     for(auto& sound : m_sounds_data)
     {
         apply_fading(sound, frame_count);
     }
 
+    const auto faded{clock::now()};
+
+    std::lock_guard bus_lock{m_bus_mutex};
+
+    std::uint32_t max_channel_count{};
+    for(const auto& listener : m_listeners_data)
+    {
+        max_channel_count = std::max(max_channel_count, listener.state.channel_count);
+    }
+
+    //Only grows when a block is bigger than all the previous ones, like the sample buffer
+    if(frame_count * max_channel_count > m_bus_size)
+    {
+        m_bus_size = frame_count * max_channel_count;
+        m_bus_samples.resize(std::size(m_buses) * m_bus_size);
+    }
+
+    //Every listener hears the sounds from its own position, in its own layout, so each one needs its own mix.
+    //With a single listener, which is the common case, the buses and their effects are processed once per block.
+    clock::duration effects{};
+
     for(auto& listener : m_listeners_data)
     {
-        std::lock_guard lock{*listener.queue};
+        const auto master{mix_buses(listener, frame_count, effects)};
 
-        m_listener_samples = listener.queue->begin(frame_count * listener.state.channel_count);
+        std::lock_guard queue_lock{*listener.queue};
 
-        for(auto& sound : m_sounds_data)
+        copy_to_listener(listener, master, listener.queue->begin(frame_count * listener.state.channel_count));
+
+        listener.queue->end();
+    }
+
+    const auto mixed{clock::now()};
+
+    lock.lock();
+
+    m_statistics.generated_frames += frame_count;
+    m_statistics.block_count += 1;
+    m_statistics.read    += read - begin;
+    m_statistics.fading  += faded - read;
+    m_statistics.mixing  += mixed - faded - effects;
+    m_statistics.effects += effects;
+
+    free_resources();
+}
+
+std::span<float> audio_world::mix_buses(const listener_data_buffer& listener, std::size_t frame_count, clock::duration& effects)
+{
+    //Listener volume is applied when the master bus is copied to the listener
+    listener_data_buffer mix_listener{nullptr, listener.state};
+    mix_listener.state.volume = 1.0f;
+
+    const auto channel_count{mix_listener.state.channel_count};
+    const auto bus_size{frame_count * channel_count};
+
+    const auto bus_samples = [this, bus_size](bus_id bus)
+    {
+        return std::span<float>{std::data(m_bus_samples) + bus * m_bus_size, bus_size};
+    };
+
+    for(bus_id i{}; i < std::size(m_buses); ++i)
+    {
+        const auto samples{bus_samples(i)};
+        std::fill(std::begin(samples), std::end(samples), 0.0f);
+    }
+
+    for(auto& sound : m_sounds_data)
+    {
+        //Buses can not be removed and sound::set_bus checks the bus, this should never happen
+        assert(sound.state.bus < std::size(m_buses) && "swl::audio_world::generate sound is routed to a bus that does not exist.");
+
+        if(sound.state.bus >= std::size(m_buses))
+        {
+            continue;
+        }
+
+        const auto samples{bus_samples(sound.state.bus)};
+
+        if(sound.state.channel_count == 1 && mix_listener.state.spatialization.enable && sound.state.spatialization.enable)
         {
-            if(sound.state.channel_count == 1 && listener.state.spatialization.enable && sound.state.spatialization.enable)
+            spatialize(mix_listener, sound, samples, frame_count);
+        }
+        else if(sound.state.channel_count != channel_count)
+        {
+            adjust_channels(mix_listener, sound, samples, frame_count);
+        }
+        else //no spacialization and sound.state.channel_count == channel_count
+        {
+            for(std::size_t i{}; i < std::size(sound.samples); ++i)
             {
-                spatialize(listener, sound, frame_count);
+                samples[i] += sound.samples[i] * sound.state.volume;
             }
-            else if(sound.state.channel_count != listener.state.channel_count)
+        }
+    }
+
+    const auto effects_begin{clock::now()};
+
+    //A bus always outputs to a bus created before it, so walking backward processes a bus once all its inputs are summed
+    for(auto i{static_cast<bus_id>(std::size(m_buses))}; i-- > 0;)
+    {
+        const auto& bus{m_buses[i]};
+        const auto samples{bus_samples(i)};
+
+        for(auto& effect : bus.effects)
+        {
+            effect->process(samples, channel_count, m_sample_rate);
+        }
+
+        if(i != master_bus)
+        {
+            const auto destination{bus_samples(bus.output)};
+
+            for(std::size_t j{}; j < bus_size; ++j)
             {
-                adjust_channels(listener, sound, frame_count);
+                destination[j] += samples[j] * bus.volume;
             }
-            else //no spacialization and sound.state.channel_count == listener.state.channel_count
+        }
+        else if(bus.volume != 1.0f)
+        {
+            for(auto& sample : samples)
             {
-                const float volume{sound.state.volume * listener.state.volume};
-
-                for(std::size_t i{}; i < std::size(sound.samples); ++i)
-                {
-                    m_listener_samples[i] += sound.samples[i] * volume;
-                }
+                sample *= bus.volume;
             }
         }
-
-        mix_sounds();
-
-        listener.queue->end();
     }
 
-    lock.lock();
+    effects += clock::now() - effects_begin;
 
-    free_resources();
+    const auto master{bus_samples(master_bus)};
+    mix_sounds(master);
+
+    return master;
 }
 
 vec3f audio_world::up() const
@@ -521,11 +645,101 @@ vec3f audio_world::up() const
     return m_up;
 }
 
+bus_id audio_world::make_bus(std::string name, bus_id output)
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    assert(output < std::size(m_buses) && "swl::audio_world::make_bus output bus does not exist.");
+
+    m_buses.emplace_back(bus_data{.name = std::move(name), .output = output});
+    m_bus_samples.resize(std::size(m_buses) * m_bus_size); //So the audio thread does not allocate for the new bus
+
+    return static_cast<bus_id>(std::size(m_buses) - 1);
+}
+
+std::optional<bus_id> audio_world::find_bus(std::string_view name) const
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    for(std::size_t i{}; i < std::size(m_buses); ++i)
+    {
+        if(m_buses[i].name == name)
+        {
+            return static_cast<bus_id>(i);
+        }
+    }
+
+    return std::nullopt;
+}
+
+audio_effect& audio_world::add_effect(bus_id bus, std::unique_ptr<audio_effect> effect)
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    assert(bus < std::size(m_buses) && "swl::audio_world::add_effect bus does not exist.");
+
+    return *m_buses[bus].effects.emplace_back(std::move(effect));
+}
+
+void audio_world::clear_effects(bus_id bus)
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    assert(bus < std::size(m_buses) && "swl::audio_world::clear_effects bus does not exist.");
+
+    m_buses[bus].effects.clear();
+}
+
+void audio_world::set_bus_volume(bus_id bus, float volume)
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    assert(bus < std::size(m_buses) && "swl::audio_world::set_bus_volume bus does not exist.");
+
+    m_buses[bus].volume = get_volume_multiplier(volume);
+}
+
+float audio_world::bus_volume(bus_id bus) const
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    return m_buses[bus].volume;
+}
+
+bus_id audio_world::bus_output(bus_id bus) const
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    return m_buses[bus].output;
+}
+
+std::size_t audio_world::bus_count() const
+{
+    std::lock_guard lock{m_bus_mutex};
+
+    return std::size(m_buses);
+}
+
+audio_world_statistics audio_world::statistics() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_statistics;
+}
+
+void audio_world::reset_statistics()
+{
+    std::lock_guard lock{m_mutex};
+
+    m_statistics = audio_world_statistics{};
+}
+
 impl::sound_data* audio_world::make_sound()
 {
     std::lock_guard lock{m_mutex};
 
     m_sounds.push_back(std::make_unique<impl::sound_data>());
+    m_sounds.back()->world = this;
 
     return m_sounds.back().get();
 }
@@ -629,6 +843,14 @@ void audio_world::store_sounds_data(std::size_t frame_count)
             sound->state.status = sound_status::aborted;
         }
     }
+
+    //The sample buffer may have been reallocated while growing, rebind the spans to its final storage
+    std::size_t offset{};
+    for(auto& sound : m_sounds_data)
+    {
+        sound.samples = std::span<float>{std::data(m_sample_buffer) + offset, std::size(sound.samples)};
+        offset += std::size(sound.samples);
+    }
 }
 
 std::span<float> audio_world::get_sound_data(impl::sound_data& sound, std::size_t frame_count)
@@ -710,7 +932,7 @@ void audio_world::apply_fading(sound_data_buffer& sound, std::size_t frame_count
     }
 }
 
-void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept
 {
     const vec3f listener_position  {listener.state.spatialization.position};
     const vec3f sound_base_position{sound.state.spatialization.position};
@@ -726,7 +948,7 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     {
         for(std::size_t i{}; i < frame_count; ++i)
         {
-            m_listener_samples[i] += sound.samples[i] * factor;
+            output[i] += sound.samples[i] * factor;
         }
 
         return;
@@ -746,8 +968,8 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     {
         for(std::size_t i{}; i < frame_count; ++i)
         {
-            m_listener_samples[i * 2]     += sound.samples[i] * factor * ((-sine) + 2.0f) / 4.0f; //right
-            m_listener_samples[i * 2 + 1] += sound.samples[i] * factor * (sine + 2.0f) / 4.0f; //left
+            output[i * 2]     += sound.samples[i] * factor * ((-sine) + 2.0f) / 4.0f; //right
+            output[i * 2 + 1] += sound.samples[i] * factor * (sine + 2.0f) / 4.0f; //left
         }
     }
     else
@@ -756,7 +978,7 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     }
 }
 
-void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept
 {
     const float volume{sound.state.volume * listener.state.volume};
 
@@ -766,8 +988,8 @@ void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buf
         {
             const float sample{sound.samples[i] * volume};
 
-            m_listener_samples[i * 2]     += sample; //right
-            m_listener_samples[i * 2 + 1] += sample; //left
+            output[i * 2]     += sample; //right
+            output[i * 2 + 1] += sample; //left
         }
     }
     else if(listener.state.channel_count == 1 && sound.state.channel_count == 2)
@@ -776,14 +998,24 @@ void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buf
         {
             const float sample{(sound.samples[i * 2] + sound.samples[i * 2 + 1]) * volume};
 
-            m_listener_samples[i] += mix_amplitude(sample, 2);
+            output[i] += mix_amplitude(sample, 2);
         }
     }
 }
 
-void audio_world::mix_sounds()
+void audio_world::copy_to_listener(listener_data_buffer& listener, std::span<const float> input, std::span<float> output) noexcept
+{
+    const float volume{listener.state.volume};
+
+    for(std::size_t i{}; i < std::size(output); ++i)
+    {
+        output[i] = input[i] * volume;
+    }
+}
+
+void audio_world::mix_sounds(std::span<float> samples)
 {
-    for(auto& sample : m_listener_samples)
+    for(auto& sample : samples)
     {
         sample = mix_amplitude(sample, std::size(m_sounds_data));
     }
@@ -32,9 +32,13 @@
 #include <mutex>
 #include <condition_variable>
 #include <span>
+#include <string>
+#include <string_view>
+#include <optional>
 
 #include "sound_reader.hpp"
 #include "stream.hpp"
+#include "effect.hpp"
 
 namespace swl
 {
@@ -43,6 +47,10 @@ class listener;
 class sound;
 class audio_world;
 
+using bus_id = std::uint32_t;
+
+inline constexpr bus_id master_bus{0};
+
 class audio_queue
 {
     friend class audio_world;
@@ -263,11 +271,13 @@ struct sound_state
     std::uint64_t loop_end{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t fading{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t current_fading{};
+    bus_id bus{master_bus};
     sound_spatialization spatialization{};
 };
 
 struct sound_data
 {
+    audio_world* world{};
     std::unique_ptr<sound_reader> reader{};
     sound_state state{};
     std::mutex mutex{};
@@ -317,6 +327,7 @@ public:
     void move(const vec3f& relative);
     void move_to(const vec3f& position);
     void seek(std::uint64_t frame);
+    void set_bus(bus_id bus);
 
     template<typename Rep1, typename Period1, typename Rep2, typename Period2>
     void set_loop_points(std::chrono::duration<Rep1, Period1> begin, std::chrono::duration<Rep2, Period2> end)
@@ -341,6 +352,7 @@ public:
     float attenuation() const;
     vec3f position() const;
     std::uint64_t tell() const;
+    bus_id bus() const;
 
     template<typename DurationT>
     DurationT frames_to_time(std::uint64_t frames) const
@@ -358,6 +370,16 @@ private:
     impl::sound_data* m_data{};
 };
 
+struct audio_world_statistics
+{
+    std::uint64_t generated_frames{};
+    std::uint64_t block_count{};
+    seconds read{};
+    seconds fading{};
+    seconds mixing{};
+    seconds effects{};
+};
+
 class SWELL_API audio_world
 {
     template<typename T>
@@ -377,7 +399,7 @@ class SWELL_API audio_world
     };
 
 public:
-    audio_world() = default;
+    audio_world();
     explicit audio_world(std::uint32_t sample_rate);
 
     ~audio_world() = default;
@@ -400,7 +422,26 @@ public:
     void discard(std::size_t frame_count);
     void generate(std::size_t frame_count);
 
+    //Buses can only output to an already existing bus, the graph is therefore always acyclic
+    bus_id make_bus(std::string name, bus_id output = master_bus);
+    std::optional<bus_id> find_bus(std::string_view name) const;
+    audio_effect& add_effect(bus_id bus, std::unique_ptr<audio_effect> effect);
+    void clear_effects(bus_id bus);
+    void set_bus_volume(bus_id bus, float volume);
+
+    template<typename T, typename... Args>
+    T& emplace_effect(bus_id bus, Args&&... args)
+    {
+        return static_cast<T&>(add_effect(bus, std::make_unique<T>(std::forward<Args>(args)...)));
+    }
+
+    float bus_volume(bus_id bus) const;
+    bus_id bus_output(bus_id bus) const;
+    std::size_t bus_count() const;
+
     vec3f up() const;
+    audio_world_statistics statistics() const;
+    void reset_statistics();
 
     std::uint32_t sample_rate() const noexcept
     {
@@ -422,6 +463,14 @@ private:
         impl::listener_state state{};
     };
 
+    struct bus_data
+    {
+        std::string name{};
+        bus_id output{};
+        float volume{1.0f};
+        std::vector<std::unique_ptr<audio_effect>> effects{};
+    };
+
 private:
     void discard_impl(std::size_t frame_count);
     void discard_sound_data(impl::sound_data& sound, std::size_t frame_count);
@@ -430,9 +479,12 @@ private:
     std::span<float> get_sound_data(impl::sound_data& sound, std::size_t frame_count);
 
     void apply_fading(sound_data_buffer& sound, std::size_t frame_count);
-    void spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void mix_sounds();
+    void spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept;
+    void adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) noexcept;
+    //Mixes the sounds through the buses for a listener, returns the master bus
+    std::span<float> mix_buses(const listener_data_buffer& listener, std::size_t frame_count, clock::duration& effects);
+    void copy_to_listener(listener_data_buffer& listener, std::span<const float> input, std::span<float> output) noexcept;
+    void mix_sounds(std::span<float> samples);
 
     void free_resources();
 
@@ -446,9 +498,14 @@ private:
     std::vector<sound_data_buffer> m_sounds_data{};
     std::vector<listener_data_buffer> m_listeners_data{};
 
-    std::span<float> m_listener_samples{};
+    std::vector<bus_data> m_buses{};
+    std::vector<float> m_bus_samples{}; //m_bus_size samples per bus, master included
+    std::size_t m_bus_size{};
+
+    audio_world_statistics m_statistics{};
 
     mutable std::mutex m_mutex{};
+    mutable std::mutex m_bus_mutex{};
 };
 
 }
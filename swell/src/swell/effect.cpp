@@ -0,0 +1,152 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "effect.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace swl
+{
+
+lowpass_filter::lowpass_filter(float cutoff) noexcept
+:m_cutoff{cutoff}
+{
+
+}
+
+void lowpass_filter::process(std::span<float> samples, std::uint32_t channel_count, std::uint32_t sample_rate) noexcept
+{
+    assert(channel_count <= max_channels && "swl::lowpass_filter supports up to 8 channels.");
+
+    if(m_sample_rate != sample_rate)
+    {
+        m_factor = 1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * m_cutoff / static_cast<float>(sample_rate));
+        m_sample_rate = sample_rate;
+    }
+
+    const std::size_t frame_count{std::size(samples) / channel_count};
+
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        for(std::size_t j{}; j < channel_count; ++j)
+        {
+            auto& state{m_state[j]};
+            auto& sample{samples[i * channel_count + j]};
+
+            state += m_factor * (sample - state);
+            sample = state;
+        }
+    }
+}
+
+//Tunings of the original Freeverb, expressed in frames at 44100Hz
+static constexpr std::array<std::size_t, 4> comb_lengths{1116, 1188, 1277, 1356};
+static constexpr std::array<std::size_t, 2> allpass_lengths{556, 441};
+static constexpr std::size_t stereo_spread{23};
+static constexpr float fixed_gain{0.015f};
+static constexpr float allpass_feedback{0.5f};
+
+reverb::reverb(std::uint32_t sample_rate, const reverb_parameters& parameters)
+:m_parameters{parameters}
+{
+    const double scale{static_cast<double>(sample_rate) / 44100.0};
+
+    const auto scaled = [scale](std::size_t length)
+    {
+        return std::max<std::size_t>(static_cast<std::size_t>(static_cast<double>(length) * scale), 1);
+    };
+
+    for(std::size_t i{}; i < std::size(m_channels); ++i)
+    {
+        const std::size_t spread{i * stereo_spread};
+
+        for(std::size_t j{}; j < std::size(comb_lengths); ++j)
+        {
+            m_channels[i].combs[j].buffer.resize(scaled(comb_lengths[j] + spread));
+        }
+
+        for(std::size_t j{}; j < std::size(allpass_lengths); ++j)
+        {
+            m_channels[i].allpasses[j].buffer.resize(scaled(allpass_lengths[j] + spread));
+        }
+    }
+}
+
+void reverb::process(std::span<float> samples, std::uint32_t channel_count, [[maybe_unused]] std::uint32_t sample_rate) noexcept
+{
+    const std::size_t frame_count{std::size(samples) / channel_count};
+    const std::size_t wet_channels{std::min<std::size_t>(channel_count, std::size(m_channels))};
+
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        const auto frame{std::data(samples) + i * channel_count};
+
+        float input{};
+        for(std::size_t j{}; j < wet_channels; ++j)
+        {
+            input += frame[j];
+        }
+
+        input *= fixed_gain;
+
+        for(std::size_t j{}; j < wet_channels; ++j)
+        {
+            frame[j] = frame[j] * m_parameters.dry + process_channel(m_channels[j], input) * m_parameters.wet;
+        }
+    }
+}
+
+float reverb::process_channel(channel_state& channel, float input) noexcept
+{
+    const float feedback{0.7f + m_parameters.room_size * 0.28f};
+    const float damping {m_parameters.damping * 0.4f};
+
+    float output{};
+
+    for(auto& comb : channel.combs)
+    {
+        const float delayed{comb.buffer[comb.index]};
+
+        comb.store = delayed * (1.0f - damping) + comb.store * damping;
+        comb.buffer[comb.index] = input + comb.store * feedback;
+        comb.index = (comb.index + 1) % std::size(comb.buffer);
+
+        output += delayed;
+    }
+
+    for(auto& allpass : channel.allpasses)
+    {
+        const float delayed{allpass.buffer[allpass.index]};
+
+        allpass.buffer[allpass.index] = output + delayed * allpass_feedback;
+        allpass.index = (allpass.index + 1) % std::size(allpass.buffer);
+
+        output = delayed - output;
+    }
+
+    return output;
+}
+
+}
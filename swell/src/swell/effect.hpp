@@ -0,0 +1,140 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_EFFECT_HPP_INCLUDED
+#define SWELL_EFFECT_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <array>
+#include <vector>
+#include <span>
+
+namespace swl
+{
+
+//Effects run on the audio thread, on the summed signal of a bus, with interleaved samples.
+//process() must not allocate nor block.
+//Buses are processed once per block and per bound listener, in the channel layout of that listener.
+//Each listener hears the sounds from its own position, so its signal can not be shared with the others:
+//with several listeners, stateful effects see the listeners' blocks one after the other and should be used with a single listener.
+class SWELL_API audio_effect
+{
+public:
+    audio_effect() = default;
+    virtual ~audio_effect() = default;
+    audio_effect(const audio_effect&) = delete;
+    audio_effect& operator=(const audio_effect&) = delete;
+    audio_effect(audio_effect&&) noexcept = delete;
+    audio_effect& operator=(audio_effect&&) noexcept = delete;
+
+    virtual void process(std::span<float> samples, std::uint32_t channel_count, std::uint32_t sample_rate) noexcept = 0;
+};
+
+class SWELL_API lowpass_filter final : public audio_effect
+{
+public:
+    static constexpr std::size_t max_channels{8};
+
+public:
+    explicit lowpass_filter(float cutoff) noexcept;
+    ~lowpass_filter() = default;
+
+    void process(std::span<float> samples, std::uint32_t channel_count, std::uint32_t sample_rate) noexcept override;
+
+    void set_cutoff(float cutoff) noexcept
+    {
+        m_cutoff = cutoff;
+        m_sample_rate = 0;
+    }
+
+    float cutoff() const noexcept
+    {
+        return m_cutoff;
+    }
+
+private:
+    float m_cutoff{};
+    float m_factor{};
+    std::uint32_t m_sample_rate{};
+    std::array<float, max_channels> m_state{};
+};
+
+struct reverb_parameters
+{
+    float room_size{0.5f};
+    float damping{0.5f};
+    float wet{0.3f};
+    float dry{1.0f};
+};
+
+//Schroeder reverberator, parallel comb filters followed by serial all-pass filters.
+//Mono and stereo signals are supported, other channels are left dry.
+class SWELL_API reverb final : public audio_effect
+{
+public:
+    explicit reverb(std::uint32_t sample_rate, const reverb_parameters& parameters = reverb_parameters{});
+    ~reverb() = default;
+
+    void process(std::span<float> samples, std::uint32_t channel_count, std::uint32_t sample_rate) noexcept override;
+
+    void set_parameters(const reverb_parameters& parameters) noexcept
+    {
+        m_parameters = parameters;
+    }
+
+    const reverb_parameters& parameters() const noexcept
+    {
+        return m_parameters;
+    }
+
+private:
+    struct comb_filter
+    {
+        std::vector<float> buffer{};
+        std::size_t index{};
+        float store{};
+    };
+
+    struct allpass_filter
+    {
+        std::vector<float> buffer{};
+        std::size_t index{};
+    };
+
+    struct channel_state
+    {
+        std::array<comb_filter, 4> combs{};
+        std::array<allpass_filter, 2> allpasses{};
+    };
+
+private:
+    float process_channel(channel_state& channel, float input) noexcept;
+
+private:
+    reverb_parameters m_parameters{};
+    std::array<channel_state, 2> m_channels{};
+};
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <tuple>
+
+#if defined(_WIN32)
+    #include <windows.h>
+
+    namespace swl
+    {
+
+    static std::pair<const std::uint8_t*, std::size_t> map_file(const std::filesystem::path& path)
+    {
+        const HANDLE file{CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+        if(file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error{"Can not open file \"" + path.string() + "\"."};
+
+        LARGE_INTEGER size{};
+        if(!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error{"Can not get size of file \"" + path.string() + "\"."};
+        }
+
+        if(size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return std::make_pair(nullptr, std::size_t{});
+        }
+
+        const HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+        CloseHandle(file);
+
+        if(!mapping)
+            throw std::runtime_error{"Can not map file \"" + path.string() + "\"."};
+
+        const void* const data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+        CloseHandle(mapping); //The view keeps the mapping alive
+
+        if(!data)
+            throw std::runtime_error{"Can not map file \"" + path.string() + "\"."};
+
+        return std::make_pair(static_cast<const std::uint8_t*>(data), static_cast<std::size_t>(size.QuadPart));
+    }
+
+    static void unmap_file(const std::uint8_t* data, std::size_t size [[maybe_unused]]) noexcept
+    {
+        UnmapViewOfFile(data);
+    }
+
+    }
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+
+    namespace swl
+    {
+
+    static std::pair<const std::uint8_t*, std::size_t> map_file(const std::filesystem::path& path)
+    {
+        const int file{open(path.c_str(), O_RDONLY)};
+        if(file == -1)
+            throw std::runtime_error{"Can not open file \"" + path.string() + "\"."};
+
+        struct stat status{};
+        if(fstat(file, &status) == -1)
+        {
+            close(file);
+            throw std::runtime_error{"Can not get size of file \"" + path.string() + "\"."};
+        }
+
+        const auto size{static_cast<std::size_t>(status.st_size)};
+        if(size == 0)
+        {
+            close(file);
+            return std::make_pair(nullptr, std::size_t{});
+        }
+
+        void* const data{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)};
+        close(file); //The mapping keeps a reference on the file
+
+        if(data == MAP_FAILED)
+            throw std::runtime_error{"Can not map file \"" + path.string() + "\"."};
+
+        madvise(data, size, MADV_SEQUENTIAL);
+
+        return std::make_pair(static_cast<const std::uint8_t*>(data), size);
+    }
+
+    static void unmap_file(const std::uint8_t* data, std::size_t size) noexcept
+    {
+        munmap(const_cast<std::uint8_t*>(data), size);
+    }
+
+    }
+#endif
+
+namespace swl
+{
+
+mapped_file::mapped_file(const std::filesystem::path& file)
+{
+    std::tie(m_data, m_size) = map_file(file);
+}
+
+mapped_file::~mapped_file()
+{
+    if(m_data)
+    {
+        unmap_file(m_data, m_size);
+    }
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+:m_data{std::exchange(other.m_data, nullptr)}
+,m_size{std::exchange(other.m_size, 0)}
+{
+
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    m_data = std::exchange(other.m_data, m_data);
+    m_size = std::exchange(other.m_size, m_size);
+
+    return *this;
+}
+
+}
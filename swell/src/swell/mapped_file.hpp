@@ -0,0 +1,74 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_MAPPED_FILE_HPP_INCLUDED
+#define SWELL_MAPPED_FILE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <span>
+
+namespace swl
+{
+
+//Read-only view of a whole file, pages are loaded by the OS on first access.
+class SWELL_API mapped_file
+{
+public:
+    constexpr mapped_file() = default;
+    explicit mapped_file(const std::filesystem::path& file);
+
+    ~mapped_file();
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+
+    const std::uint8_t* data() const noexcept
+    {
+        return m_data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    std::span<const std::uint8_t> span() const noexcept
+    {
+        return std::span<const std::uint8_t>{m_data, m_size};
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+private:
+    const std::uint8_t* m_data{};
+    std::size_t m_size{};
+};
+
+}
+
+#endif
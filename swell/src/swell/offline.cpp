@@ -0,0 +1,129 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "offline.hpp"
+
+#include <cassert>
+
+#include "wave.hpp"
+
+namespace swl
+{
+
+static audio_world_statistics operator-(const audio_world_statistics& left, const audio_world_statistics& right) noexcept
+{
+    return audio_world_statistics
+    {
+        .generated_frames = left.generated_frames - right.generated_frames,
+        .block_count      = left.block_count - right.block_count,
+        .read             = left.read - right.read,
+        .fading           = left.fading - right.fading,
+        .mixing           = left.mixing - right.mixing,
+        .effects          = left.effects - right.effects,
+    };
+}
+
+offline_renderer::offline_renderer(audio_world& world, listener& listener, std::size_t block_size)
+:m_world{&world}
+,m_listener{&listener}
+,m_block_size{block_size}
+{
+    assert(block_size > 0 && "swl::offline_renderer block size must not be 0.");
+}
+
+void offline_renderer::schedule(std::uint64_t frame, event_type event)
+{
+    m_events.emplace(frame, std::move(event));
+}
+
+offline_statistics offline_renderer::render(std::span<float> output)
+{
+    const std::uint32_t channel_count{m_listener->channel_count()};
+
+    assert(std::size(output) % channel_count == 0 && "swl::offline_renderer::render output must contain complete frames.");
+
+    const std::uint64_t frame_count{std::size(output) / channel_count};
+    const audio_world_statistics initial{m_world->statistics()};
+    const auto begin{clock::now()};
+
+    std::uint64_t rendered{};
+    while(rendered < frame_count)
+    {
+        run_events();
+
+        std::uint64_t count{std::min<std::uint64_t>(m_block_size, frame_count - rendered)};
+        if(!std::empty(m_events))
+        {
+            count = std::min(count, std::begin(m_events)->first - m_position);
+        }
+
+        //The world forgets its listeners after each generation
+        m_world->bind_listener(*m_listener);
+        m_world->generate(count);
+        m_listener->drain(std::data(output) + rendered * channel_count, count);
+
+        rendered   += count;
+        m_position += count;
+    }
+
+    const seconds elapsed{clock::now() - begin};
+    const double  audio_time{static_cast<double>(frame_count) / m_world->sample_rate()};
+
+    return offline_statistics
+    {
+        .frame_count       = frame_count,
+        .elapsed           = elapsed,
+        .frames_per_second = static_cast<double>(frame_count) / elapsed.count(),
+        .realtime_factor   = audio_time / elapsed.count(),
+        .world             = m_world->statistics() - initial,
+    };
+}
+
+offline_statistics offline_renderer::render(std::vector<float>& output, std::uint64_t frame_count)
+{
+    const auto begin{std::size(output)};
+    output.resize(begin + frame_count * m_listener->channel_count());
+
+    return render(std::span{std::data(output) + begin, std::size(output) - begin});
+}
+
+offline_statistics offline_renderer::render(const std::filesystem::path& file, std::uint64_t frame_count)
+{
+    std::vector<float> samples{};
+    const auto output{render(samples, frame_count)};
+
+    write_wave(file, samples, m_listener->channel_count(), m_world->sample_rate());
+
+    return output;
+}
+
+void offline_renderer::run_events()
+{
+    //Events may schedule other events, multimap iterators stay valid on insertion
+    while(!std::empty(m_events) && std::begin(m_events)->first <= m_position)
+    {
+        auto node{m_events.extract(std::begin(m_events))};
+        node.mapped()();
+    }
+}
+
+}
@@ -0,0 +1,101 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_OFFLINE_HPP_INCLUDED
+#define SWELL_OFFLINE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <span>
+#include <vector>
+
+#include "audio_world.hpp"
+
+namespace swl
+{
+
+struct offline_statistics
+{
+    std::uint64_t frame_count{};
+    seconds elapsed{};
+    double frames_per_second{};
+    double realtime_factor{};
+    audio_world_statistics world{};
+};
+
+//Drives an audio world without any audio device, as fast as the CPU allows.
+//Scheduled events run exactly at their frame, blocks are split around them so the output is deterministic.
+class SWELL_API offline_renderer
+{
+public:
+    using event_type = std::function<void()>;
+
+public:
+    offline_renderer() = default;
+    explicit offline_renderer(audio_world& world, listener& listener, std::size_t block_size = 512);
+
+    ~offline_renderer() = default;
+    offline_renderer(const offline_renderer&) = delete;
+    offline_renderer& operator=(const offline_renderer&) = delete;
+    offline_renderer(offline_renderer&& other) noexcept = default;
+    offline_renderer& operator=(offline_renderer&& other) noexcept = default;
+
+    void schedule(std::uint64_t frame, event_type event);
+
+    template<typename Rep, typename Period>
+    void schedule(std::chrono::duration<Rep, Period> time, event_type event)
+    {
+        schedule(time_to_frame(time), std::move(event));
+    }
+
+    offline_statistics render(std::span<float> output);
+    offline_statistics render(std::vector<float>& output, std::uint64_t frame_count);
+    offline_statistics render(const std::filesystem::path& file, std::uint64_t frame_count);
+
+    std::uint64_t tell() const noexcept
+    {
+        return m_position;
+    }
+
+    template<typename Rep, typename Period>
+    std::uint64_t time_to_frame(std::chrono::duration<Rep, Period> time) const
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<seconds>(time).count() * m_world->sample_rate());
+    }
+
+private:
+    void run_events();
+
+private:
+    audio_world* m_world{};
+    listener* m_listener{};
+    std::size_t m_block_size{};
+    std::uint64_t m_position{};
+    std::multimap<std::uint64_t, event_type> m_events{};
+};
+
+}
+
+#endif
@@ -0,0 +1,257 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "pcm.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SWELL_PCM_SSE2
+    #include <emmintrin.h>
+
+    #if defined(__SSSE3__) || defined(__AVX__)
+        #define SWELL_PCM_SSSE3
+        #include <tmmintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define SWELL_PCM_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace swl
+{
+
+static constexpr float uint8_scale{1.0f / static_cast<float>(0x80)};
+static constexpr float int16_scale{1.0f / static_cast<float>(0x8000)};
+static constexpr float int24_scale{1.0f / static_cast<float>(0x800000)};
+static constexpr float int32_scale{1.0f / static_cast<float>(0x80000000u)};
+
+static std::int32_t load_int24(const std::uint8_t* data) noexcept
+{
+    const auto value{static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16))};
+
+    return static_cast<std::int32_t>(value << 8) >> 8;
+}
+
+static void convert_uint8(const std::uint8_t* data, float* output, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+
+#if defined(SWELL_PCM_SSE2)
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i bias{_mm_set1_epi16(128)};
+    const __m128 scale{_mm_set1_ps(uint8_scale)};
+
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))};
+        const __m128i low  {_mm_sub_epi16(_mm_unpacklo_epi8(bytes, zero), bias)};
+        const __m128i high {_mm_sub_epi16(_mm_unpackhi_epi8(bytes, zero), bias)};
+
+        //unpack a word with itself then shift right: sign extension to 32 bits
+        _mm_storeu_ps(output + i + 0,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(low, low), 16)), scale));
+        _mm_storeu_ps(output + i + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(low, low), 16)), scale));
+        _mm_storeu_ps(output + i + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(high, high), 16)), scale));
+        _mm_storeu_ps(output + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(high, high), 16)), scale));
+    }
+#elif defined(SWELL_PCM_NEON)
+    const float32x4_t scale{vdupq_n_f32(uint8_scale)};
+
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const uint8x16_t bytes{vld1q_u8(data + i)};
+        const int16x8_t low {vreinterpretq_s16_u16(vsubq_u16(vmovl_u8(vget_low_u8(bytes)), vdupq_n_u16(128)))};
+        const int16x8_t high{vreinterpretq_s16_u16(vsubq_u16(vmovl_u8(vget_high_u8(bytes)), vdupq_n_u16(128)))};
+
+        vst1q_f32(output + i + 0,  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(low))), scale));
+        vst1q_f32(output + i + 4,  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(low))), scale));
+        vst1q_f32(output + i + 8,  vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(high))), scale));
+        vst1q_f32(output + i + 12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(high))), scale));
+    }
+#endif
+
+    for(; i < sample_count; ++i)
+    {
+        output[i] = static_cast<float>(static_cast<std::int32_t>(data[i]) - 128) * uint8_scale;
+    }
+}
+
+static void convert_int16(const std::uint8_t* data, float* output, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+
+#if defined(SWELL_PCM_SSE2)
+    const __m128 scale{_mm_set1_ps(int16_scale)};
+
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const __m128i words{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2))};
+
+        _mm_storeu_ps(output + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16)), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16)), scale));
+    }
+#elif defined(SWELL_PCM_NEON)
+    const float32x4_t scale{vdupq_n_f32(int16_scale)};
+
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const int16x8_t words{vreinterpretq_s16_u8(vld1q_u8(data + i * 2))};
+
+        vst1q_f32(output + i + 0, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(words))), scale));
+        vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(words))), scale));
+    }
+#endif
+
+    for(; i < sample_count; ++i)
+    {
+        const auto value{static_cast<std::int16_t>(data[i * 2] | (data[i * 2 + 1] << 8))};
+
+        output[i] = static_cast<float>(value) * int16_scale;
+    }
+}
+
+static void convert_int24(const std::uint8_t* data, float* output, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+
+#if defined(SWELL_PCM_SSSE3)
+    //Each sample is moved to the 3 upper bytes of a 32-bit lane, the arithmetic shift then extends its sign
+    const __m128i shuffle{_mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)};
+    const __m128 scale{_mm_set1_ps(int24_scale)};
+
+    //4 samples are 12 bytes but the load reads 16, keep the last 2 samples for the scalar loop
+    for(; i + 6 <= sample_count; i += 4)
+    {
+        const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 3))};
+        const __m128i values{_mm_srai_epi32(_mm_shuffle_epi8(bytes, shuffle), 8)};
+
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+    }
+#elif defined(SWELL_PCM_NEON)
+    const float32x4_t scale{vdupq_n_f32(int24_scale)};
+
+    //vld3 deinterleaves the low, middle and high bytes of 8 samples
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const uint8x8x3_t bytes{vld3_u8(data + i * 3)};
+
+        const uint16x8_t low {vmovl_u8(bytes.val[0])};
+        const uint16x8_t mid {vmovl_u8(bytes.val[1])};
+        const uint16x8_t high{vmovl_u8(bytes.val[2])};
+
+        const uint32x4_t first {vorrq_u32(vorrq_u32(vshll_n_u16(vget_low_u16(low), 8), vshll_n_u16(vget_low_u16(mid), 16)), vshlq_n_u32(vmovl_u16(vget_low_u16(high)), 24))};
+        const uint32x4_t second{vorrq_u32(vorrq_u32(vshll_n_u16(vget_high_u16(low), 8), vshll_n_u16(vget_high_u16(mid), 16)), vshlq_n_u32(vmovl_u16(vget_high_u16(high)), 24))};
+
+        vst1q_f32(output + i + 0, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(first), 8)), scale));
+        vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(second), 8)), scale));
+    }
+#else
+    if constexpr(std::endian::native == std::endian::little)
+    {
+        //Unaligned 32-bit loads read one byte past the sample, so the last sample is done byte per byte
+        for(; i + 1 < sample_count; ++i)
+        {
+            std::uint32_t value;
+            std::memcpy(&value, data + i * 3, sizeof(value));
+
+            output[i] = static_cast<float>(static_cast<std::int32_t>(value << 8) >> 8) * int24_scale;
+        }
+    }
+#endif
+
+    for(; i < sample_count; ++i)
+    {
+        output[i] = static_cast<float>(load_int24(data + i * 3)) * int24_scale;
+    }
+}
+
+static void convert_int32(const std::uint8_t* data, float* output, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+
+#if defined(SWELL_PCM_SSE2)
+    const __m128 scale{_mm_set1_ps(int32_scale)};
+
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        const __m128i values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4))};
+
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+    }
+#elif defined(SWELL_PCM_NEON)
+    const float32x4_t scale{vdupq_n_f32(int32_scale)};
+
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vreinterpretq_s32_u8(vld1q_u8(data + i * 4))), scale));
+    }
+#endif
+
+    for(; i < sample_count; ++i)
+    {
+        const auto value{static_cast<std::int32_t>(static_cast<std::uint32_t>(data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16)) | (static_cast<std::uint32_t>(data[i * 4 + 3]) << 24))};
+
+        output[i] = static_cast<float>(value) * int32_scale;
+    }
+}
+
+static void convert_float32(const std::uint8_t* data, float* output, std::size_t sample_count) noexcept
+{
+    if constexpr(std::endian::native == std::endian::little)
+    {
+        std::memcpy(output, data, sample_count * sizeof(float));
+    }
+    else
+    {
+        for(std::size_t i{}; i < sample_count; ++i)
+        {
+            const auto value{static_cast<std::uint32_t>(data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16)) | (static_cast<std::uint32_t>(data[i * 4 + 3]) << 24)};
+
+            output[i] = std::bit_cast<float>(value);
+        }
+    }
+}
+
+void convert_samples(const std::uint8_t* data, sample_format format, float* output, std::size_t sample_count) noexcept
+{
+    switch(format)
+    {
+        case sample_format::float32: convert_float32(data, output, sample_count); break;
+        case sample_format::int32:   convert_int32(data, output, sample_count);   break;
+        case sample_format::int24:   convert_int24(data, output, sample_count);   break;
+        case sample_format::int16:   convert_int16(data, output, sample_count);   break;
+        case sample_format::uint8:   convert_uint8(data, output, sample_count);   break;
+        case sample_format::int8:
+        {
+            for(std::size_t i{}; i < sample_count; ++i)
+            {
+                output[i] = static_cast<float>(static_cast<std::int8_t>(data[i])) * uint8_scale;
+            }
+
+            break;
+        }
+        default: break;
+    }
+}
+
+}
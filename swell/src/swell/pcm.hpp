@@ -0,0 +1,52 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_PCM_HPP_INCLUDED
+#define SWELL_PCM_HPP_INCLUDED
+
+#include "config.hpp"
+
+namespace swl
+{
+
+//Size in bytes of one sample of the given format in a little-endian PCM stream.
+constexpr std::size_t sample_format_size(sample_format format) noexcept
+{
+    switch(format)
+    {
+        case sample_format::float32: return 4;
+        case sample_format::int32:   return 4;
+        case sample_format::int24:   return 3;
+        case sample_format::int16:   return 2;
+        case sample_format::int8:    return 1;
+        case sample_format::uint8:   return 1;
+        default: return 0;
+    }
+}
+
+//Converts little-endian interleaved samples to normalised floats, there is no alignment requirement on data.
+//Integer formats map their full range to [-1; 1[, float32 samples are copied as is.
+SWELL_API void convert_samples(const std::uint8_t* data, sample_format format, float* output, std::size_t sample_count) noexcept;
+
+}
+
+#endif
@@ -23,54 +23,38 @@
 #include "wave.hpp"
 
 #include <cassert>
+#include <algorithm>
+#include <bit>
 
 #include <captal_foundation/stack_allocator.hpp>
 
-namespace swl
-{
+#include "pcm.hpp"
 
-template<std::uint32_t Bits>
-static std::int32_t extend_sign(std::uint32_t value) noexcept
-{
-    if(value > (1u << (Bits - 1u)))
-    {
-        return static_cast<std::int32_t>((0xFFFFFFFFu << Bits) | value);
-    }
-    else
-    {
-        return static_cast<std::int32_t>(value);
-    }
-}
-
-
-static std::uint8_t read_uint8(const std::uint8_t* data) noexcept
-{
-    return data[0];
-}
-
-static std::int16_t read_int16(const std::uint8_t* data) noexcept
+namespace swl
 {
-    return static_cast<std::int16_t>(data[0] | (data[1] << 8));
-}
 
 static std::uint16_t read_uint16(const std::uint8_t* data) noexcept
 {
     return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
 }
 
-static std::int32_t read_int24(const std::uint8_t* data) noexcept
+static std::uint32_t read_uint32(const std::uint8_t* data) noexcept
 {
-    return extend_sign<24>(static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16)));
+    return static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
 }
 
-static std::int32_t read_int32(const std::uint8_t* data) noexcept
+static void write_uint16(std::uint8_t* data, std::uint16_t value) noexcept
 {
-    return static_cast<std::int32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    data[0] = static_cast<std::uint8_t>(value);
+    data[1] = static_cast<std::uint8_t>(value >> 8);
 }
 
-static std::uint32_t read_uint32(const std::uint8_t* data) noexcept
+static void write_uint32(std::uint8_t* data, std::uint32_t value) noexcept
 {
-    return static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    data[0] = static_cast<std::uint8_t>(value);
+    data[1] = static_cast<std::uint8_t>(value >> 8);
+    data[2] = static_cast<std::uint8_t>(value >> 16);
+    data[3] = static_cast<std::uint8_t>(value >> 24);
 }
 
 static std::array<std::uint8_t, 4> read_bits32(const std::uint8_t* data) noexcept
@@ -78,39 +62,9 @@ static std::array<std::uint8_t, 4> read_bits32(const std::uint8_t* data) noexcep
     return {data[0], data[1], data[2], data[3]};
 }
 
-static void read_samples(const std::uint8_t* data, std::size_t bits_per_sample, float* output, std::size_t sample_count) noexcept
-{
-    const std::size_t byte_per_sample{bits_per_sample / 8u};
-
-    if(bits_per_sample == 8)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(static_cast<std::int32_t>(read_uint8(data + (i * byte_per_sample))) - 128) / static_cast<float>(0x80);
-        }
-    }
-    else if(bits_per_sample == 16)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int16(data + (i * byte_per_sample))) / static_cast<float>(0x8000);
-        }
-    }
-    else if(bits_per_sample == 24)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int24(data + (i * byte_per_sample))) / static_cast<float>(0x800000);
-        }
-    }
-    else if(bits_per_sample == 32)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int32(data + (i * byte_per_sample))) / static_cast<float>(0x80000000);
-        }
-    }
-}
+static constexpr std::uint16_t format_pcm{0x0001};
+static constexpr std::uint16_t format_ieee_float{0x0003};
+static constexpr std::uint16_t format_extensible{0xFFFE};
 
 static constexpr std::array<std::uint8_t, 4> riff_block_id  {0x52, 0x49, 0x46, 0x46};
 static constexpr std::array<std::uint8_t, 4> riff_type_wave {0x57, 0x41, 0x56, 0x45};
@@ -153,6 +107,11 @@ public:
         return m_bits_per_sample;
     }
 
+    sample_format format() const noexcept
+    {
+        return m_format;
+    }
+
 private:
     void init()
     {
@@ -195,38 +154,67 @@ private:
 
         if(id == format_block_id)
         {
-            std::array<std::uint8_t, 16> format_data;
-            read_source(std::data(format_data), std::size(format_data));
-            read_format_block(std::data(format_data));
+            //16 bytes for the common part, 40 for WAVE_FORMAT_EXTENSIBLE
+            std::array<std::uint8_t, 40> format_data{};
+            const auto format_size{std::min(static_cast<std::size_t>(size), std::size(format_data))};
 
-            if(size > 16)
+            if(format_size < 16 || !read_source(std::data(format_data), format_size))
             {
-                skip_source(align_up(size - 16u, 2u));
+                throw std::runtime_error{"swl::wave_reader invalid format block."};
             }
+
+            read_format_block(std::data(format_data), format_size);
+            skip_source(align_up(static_cast<std::size_t>(size), std::size_t{2}) - format_size);
         }
         else if(id == data_block_id)
         {
             m_data_offset = tell_source();
             m_data_size   = static_cast<std::size_t>(size);
 
-            skip_source(size);
+            skip_source(align_up(static_cast<std::size_t>(size), std::size_t{2})); //RIFF chunks are word aligned
         }
         else
         {
-            skip_source(size);
+            skip_source(align_up(static_cast<std::size_t>(size), std::size_t{2}));
         }
     }
 
-    void read_format_block(const std::uint8_t* block)
+    void read_format_block(const std::uint8_t* block, std::size_t size)
     {
-        if(read_uint16(block) != 1)
+        auto tag{read_uint16(block)};
+        if(tag == format_extensible && size >= 40)
         {
-            throw std::runtime_error{"swl::wave_reader invalid format. Only uncompressed (PCM) data are supported."};
+            tag = read_uint16(block + 24); //The sub-format GUID starts with the format tag
         }
 
         m_info.channel_count = static_cast<std::uint32_t>(read_uint16(block + 2));
         m_info.frequency     = read_uint32(block + 4);
         m_bits_per_sample    = static_cast<std::size_t>(read_uint16(block + 14));
+
+        if(tag == format_pcm)
+        {
+            switch(m_bits_per_sample)
+            {
+                case 8:  m_format = sample_format::uint8; break;
+                case 16: m_format = sample_format::int16; break;
+                case 24: m_format = sample_format::int24; break;
+                case 32: m_format = sample_format::int32; break;
+                default: throw std::runtime_error{"swl::wave_reader invalid format. Only 8, 16, 24 and 32 bits PCM data are supported."};
+            }
+        }
+        else if(tag == format_ieee_float)
+        {
+            if(m_bits_per_sample != 32)
+            {
+                throw std::runtime_error{"swl::wave_reader invalid format. Only 32 bits floating point data are supported."};
+            }
+
+            m_format = sample_format::float32;
+        }
+        else
+        {
+            throw std::runtime_error{"swl::wave_reader invalid format. Only uncompressed (PCM or IEEE float) data are supported."};
+        }
     }
 
     bool read_source(std::uint8_t* output, std::size_t size)
@@ -306,52 +294,40 @@ private:
 
     sound_info m_info{};
     std::size_t m_bits_per_sample{};
+    sample_format m_format{};
     std::size_t m_data_offset{};
     std::size_t m_data_size{};
 };
 
 wave_reader::wave_reader(const std::filesystem::path& file, sound_reader_options options)
 :m_options{options}
+,m_mapping{file}
 {
-    std::ifstream ifs{file, std::ios_base::binary};
-    if(!ifs)
+    if(m_mapping.empty())
         throw std::runtime_error{"Can not read file \"" + file.string() + "\"."};
 
-    wave_decoder decoder{ifs};
+    wave_decoder decoder{m_mapping.span()};
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
-    if(static_cast<bool>(m_options & sound_reader_options::decoded))
-    {
-        std::vector<std::uint8_t> data{};
-        data.resize(byte_size(info().frame_count));
+    if(m_data_offset + byte_size(info().frame_count) > m_mapping.size())
+        throw std::runtime_error{"Too short wave data."};
 
-        ifs.clear();
-        ifs.seekg(m_data_offset, std::ios_base::beg);
-        if(!ifs.read(reinterpret_cast<char*>(std::data(data)), static_cast<std::streamsize>(std::size(data))))
-            throw std::runtime_error{"Too short wave data."};
-
-        const auto sample_count{sample_size(info().frame_count)};
+    const auto data{m_mapping.span().subspan(m_data_offset, byte_size(info().frame_count))};
 
-        m_decoded_buffer.resize(sample_count);
-        read_samples(std::data(data), m_bits_per_sample, std::data(m_decoded_buffer), sample_count);
-    }
-    else if(static_cast<bool>(m_options & sound_reader_options::buffered))
+    if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
-        m_source_buffer.resize(byte_size(info().frame_count));
-
-        ifs.clear();
-        ifs.seekg(m_data_offset, std::ios_base::beg);
-        if(!ifs.read(reinterpret_cast<char*>(std::data(m_source_buffer)), static_cast<std::streamsize>(std::size(m_source_buffer))))
-            throw std::runtime_error{"Too short wave data."};
+        m_decoded_buffer.resize(sample_size(info().frame_count));
+        convert_samples(std::data(data), m_format, std::data(m_decoded_buffer), std::size(m_decoded_buffer));
 
-        m_source = m_source_buffer;
+        m_mapping = mapped_file{};
     }
     else
     {
-        m_file   = std::move(ifs);
-        m_stream = &m_file;
+        //The mapping already is an in-memory source, buffered readers do not need their own copy
+        m_source = data;
     }
 
     seek(0);
@@ -364,12 +340,13 @@ wave_reader::wave_reader(std::span<const std::uint8_t> data, sound_reader_option
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
     if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
         m_decoded_buffer.resize(sample_size(info().frame_count));
 
-        read_samples(std::data(data) + m_data_offset, m_bits_per_sample, std::data(m_decoded_buffer), std::size(m_decoded_buffer));
+        convert_samples(std::data(data) + m_data_offset, m_format, std::data(m_decoded_buffer), std::size(m_decoded_buffer));
     }
     else if(static_cast<bool>(m_options & sound_reader_options::buffered))
     {
@@ -397,6 +374,7 @@ wave_reader::wave_reader(std::istream& stream, sound_reader_options options)
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
     if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
@@ -410,7 +388,7 @@ wave_reader::wave_reader(std::istream& stream, sound_reader_options options)
         if(!stream.read(reinterpret_cast<char*>(std::data(data)), static_cast<std::streamsize>(std::size(data))))
             throw std::runtime_error{"Too short wave data."};
 
-        read_samples(std::data(data), m_bits_per_sample, std::data(m_decoded_buffer), sample_size(info().frame_count));
+        convert_samples(std::data(data), m_format, std::data(m_decoded_buffer), sample_size(info().frame_count));
     }
     else if(static_cast<bool>(m_options & sound_reader_options::buffered))
     {
@@ -506,7 +484,7 @@ bool wave_reader::read_samples_from_memory(float* output, std::size_t frame_coun
         const auto size{byte_size(m_current_frame)};
         const auto max {(std::size(m_source) - size) / (m_bits_per_sample / 8)};
 
-        read_samples(std::data(m_source) + size, m_bits_per_sample, output, max);
+        convert_samples(std::data(m_source) + size, m_format, output, max);
         std::fill(output + max, output + sample_size(frame_count), 0.0f);
 
         m_current_frame += frame_count;
@@ -515,7 +493,7 @@ bool wave_reader::read_samples_from_memory(float* output, std::size_t frame_coun
     }
     else
     {
-        read_samples(std::data(m_source) + byte_size(m_current_frame), m_bits_per_sample, output, sample_size(frame_count));
+        convert_samples(std::data(m_source) + byte_size(m_current_frame), m_format, output, sample_size(frame_count));
 
         m_current_frame += frame_count;
 
@@ -529,12 +507,75 @@ bool wave_reader::read_samples_from_stream(float* output, std::size_t frame_coun
     m_source_buffer.resize(byte_size(frame_count));
 
     m_stream->read(reinterpret_cast<char*>(std::data(m_source_buffer)), std::size(m_source_buffer));
-    read_samples(std::data(m_source_buffer), m_bits_per_sample, output, sample_size(frame_count));
+    convert_samples(std::data(m_source_buffer), m_format, output, sample_size(frame_count));
 
     m_current_frame += frame_count;
 
     return static_cast<std::size_t>(m_stream->gcount()) == std::size(m_source_buffer);
 }
 
+void write_wave(std::ostream& stream, std::span<const float> samples, std::uint32_t channel_count, std::uint32_t sample_rate)
+{
+    assert(channel_count > 0 && "swl::write_wave channel count must not be 0.");
+    assert(std::size(samples) % channel_count == 0 && "swl::write_wave samples must contain complete frames.");
+
+    const auto data_size{static_cast<std::uint32_t>(std::size(samples) * sizeof(float))};
+
+    std::array<std::uint8_t, 44> header{};
+    std::copy(std::begin(riff_block_id), std::end(riff_block_id), std::begin(header));
+    write_uint32(std::data(header) + 4, data_size + 36);
+    std::copy(std::begin(riff_type_wave), std::end(riff_type_wave), std::begin(header) + 8);
+
+    std::copy(std::begin(format_block_id), std::end(format_block_id), std::begin(header) + 12);
+    write_uint32(std::data(header) + 16, 16);
+    write_uint16(std::data(header) + 20, format_ieee_float);
+    write_uint16(std::data(header) + 22, static_cast<std::uint16_t>(channel_count));
+    write_uint32(std::data(header) + 24, sample_rate);
+    write_uint32(std::data(header) + 28, sample_rate * channel_count * sizeof(float));
+    write_uint16(std::data(header) + 32, static_cast<std::uint16_t>(channel_count * sizeof(float)));
+    write_uint16(std::data(header) + 34, 32);
+
+    std::copy(std::begin(data_block_id), std::end(data_block_id), std::begin(header) + 36);
+    write_uint32(std::data(header) + 40, data_size);
+
+    stream.write(reinterpret_cast<const char*>(std::data(header)), std::size(header));
+
+    if constexpr(std::endian::native == std::endian::little)
+    {
+        stream.write(reinterpret_cast<const char*>(std::data(samples)), data_size);
+    }
+    else
+    {
+        std::array<std::uint8_t, 4096> buffer;
+
+        for(std::size_t i{}; i < std::size(samples); i += std::size(buffer) / 4)
+        {
+            const auto count{std::min(std::size(buffer) / 4, std::size(samples) - i)};
+
+            for(std::size_t j{}; j < count; ++j)
+            {
+                write_uint32(std::data(buffer) + j * 4, std::bit_cast<std::uint32_t>(samples[i + j]));
+            }
+
+            stream.write(reinterpret_cast<const char*>(std::data(buffer)), count * 4);
+        }
+    }
+
+    if(!stream)
+    {
+        throw std::runtime_error{"swl::write_wave can not write samples."};
+    }
+}
+
+void write_wave(const std::filesystem::path& file, std::span<const float> samples, std::uint32_t channel_count, std::uint32_t sample_rate)
+{
+    std::ofstream ofs{file, std::ios_base::binary};
+    if(!ofs)
+    {
+        throw std::runtime_error{"Can not write file \"" + file.string() + "\"."};
+    }
+
+    write_wave(ofs, samples, channel_count, sample_rate);
+}
 
 }
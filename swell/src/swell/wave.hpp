@@ -29,8 +29,10 @@
 #include <filesystem>
 #include <span>
 #include <variant>
+#include <vector>
 
 #include "sound_reader.hpp"
+#include "mapped_file.hpp"
 
 namespace swl
 {
@@ -69,15 +71,20 @@ private:
     std::uint64_t m_current_frame{};
     std::size_t m_data_offset{};
     std::size_t m_bits_per_sample{};
+    sample_format m_format{};
 
     std::vector<std::uint8_t> m_source_buffer{};
-    std::ifstream m_file{};
+    mapped_file m_mapping{};
 
     std::vector<float> m_decoded_buffer{};
     std::span<const std::uint8_t> m_source{};
     std::istream* m_stream{};
 };
 
+//Writes interleaved samples as a 32-bit IEEE float wave file.
+SWELL_API void write_wave(std::ostream& stream, std::span<const float> samples, std::uint32_t channel_count, std::uint32_t sample_rate);
+SWELL_API void write_wave(const std::filesystem::path& file, std::span<const float> samples, std::uint32_t channel_count, std::uint32_t sample_rate);
+
 }
 
 #endif
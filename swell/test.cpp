@@ -0,0 +1,355 @@
+#include <swell/audio_world.hpp>
+#include <swell/offline.hpp>
+#include <swell/effect.hpp>
+#include <swell/wave.hpp>
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+static constexpr std::uint32_t sample_rate{48000};
+
+static std::vector<std::uint8_t> make_wave(std::span<const float> samples, std::uint32_t channel_count = 1)
+{
+    std::ostringstream oss{};
+    swl::write_wave(oss, samples, channel_count, sample_rate);
+
+    const std::string data{oss.str()};
+
+    return std::vector<std::uint8_t>{std::begin(data), std::end(data)};
+}
+
+static std::vector<std::uint8_t> make_constant_wave(float value, std::size_t frame_count)
+{
+    return make_wave(std::vector<float>(frame_count, value));
+}
+
+//Ramp from -1 to 1, every sample is different
+static std::vector<float> make_ramp(std::size_t sample_count)
+{
+    std::vector<float> output{};
+    output.reserve(sample_count);
+
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        output.emplace_back(static_cast<float>(i) / static_cast<float>(sample_count) * 2.0f - 1.0f);
+    }
+
+    return output;
+}
+
+//Multiplies the signal by a constant and counts its calls
+class gain_effect final : public swl::audio_effect
+{
+public:
+    explicit gain_effect(float gain) noexcept
+    :m_gain{gain}
+    {
+
+    }
+
+    void process(std::span<float> samples, std::uint32_t, std::uint32_t) noexcept override
+    {
+        for(auto& sample : samples)
+        {
+            sample *= m_gain;
+        }
+
+        ++m_calls;
+    }
+
+    std::size_t calls() const noexcept
+    {
+        return m_calls;
+    }
+
+private:
+    float m_gain{};
+    std::size_t m_calls{};
+};
+
+TEST_CASE("Audio bus test", "[bus]")
+{
+    swl::audio_world world{sample_rate};
+
+    swl::listener listener{1};
+    listener.disable_spatialization();
+
+    const auto data{make_constant_wave(0.5f, 4096)};
+    swl::sound sound{world, std::make_unique<swl::wave_reader>(data)};
+
+    SECTION("swl::audio_world routes sounds through their bus and its effects")
+    {
+        const auto bus{world.make_bus("bus")};
+        world.emplace_effect<gain_effect>(bus, 0.5f);
+        sound.set_bus(bus);
+        sound.start();
+
+        swl::offline_renderer renderer{world, listener, 256};
+
+        std::vector<float> output{};
+        renderer.render(output, 1024);
+
+        for(const auto sample : output)
+        {
+            REQUIRE(sample == Approx{0.25f});
+        }
+    }
+
+    SECTION("swl::audio_world sums a bus into its output bus")
+    {
+        const auto parent{world.make_bus("parent")};
+        const auto child {world.make_bus("child", parent)};
+        world.emplace_effect<gain_effect>(parent, 0.5f);
+        world.emplace_effect<gain_effect>(child, 0.5f);
+
+        REQUIRE(world.bus_output(child) == parent);
+
+        sound.set_bus(child);
+        sound.start();
+
+        swl::offline_renderer renderer{world, listener, 256};
+
+        std::vector<float> output{};
+        renderer.render(output, 1024);
+
+        for(const auto sample : output)
+        {
+            REQUIRE(sample == Approx{0.125f});
+        }
+    }
+
+    SECTION("swl::audio_world processes buses once per block with a single listener")
+    {
+        const auto bus{world.make_bus("bus")};
+        auto& effect{world.emplace_effect<gain_effect>(bus, 1.0f)};
+        sound.set_bus(bus);
+        sound.start();
+
+        std::vector<float> output(256);
+
+        for(std::size_t i{}; i < 4; ++i)
+        {
+            world.bind_listener(listener);
+            world.generate(256);
+
+            listener.drain(std::data(output), 256);
+        }
+
+        REQUIRE(effect.calls() == 4);
+    }
+
+    SECTION("swl::audio_world mixes the buses for each listener, in its own state")
+    {
+        const auto bus{world.make_bus("bus")};
+        auto& effect{world.emplace_effect<gain_effect>(bus, 1.0f)};
+        sound.set_bus(bus);
+        sound.enable_spatialization();
+        sound.start();
+
+        //The first listener does not spatialize, the second one is far from the sound
+        swl::listener other{2};
+        other.move_to(swl::vec3f{3.0f, 0.0f, 0.0f});
+
+        std::vector<float> first_output(256);
+        std::vector<float> other_output(512);
+
+        world.bind_listener(listener, other);
+        world.generate(256);
+
+        listener.drain(std::data(first_output), 256);
+        other.drain(std::data(other_output), 256);
+
+        REQUIRE(effect.calls() == 2);
+
+        for(std::size_t i{}; i < 256; ++i)
+        {
+            REQUIRE(first_output[i] == Approx{0.5f});
+            REQUIRE(other_output[i * 2] < 0.5f);
+            REQUIRE(other_output[i * 2 + 1] < 0.5f);
+        }
+    }
+}
+
+TEST_CASE("Audio effects test", "[effect]")
+{
+    SECTION("swl::lowpass_filter converges to a constant signal and smooths steps")
+    {
+        swl::lowpass_filter filter{1000.0f};
+
+        std::vector<float> samples(4800, 1.0f);
+        filter.process(samples, 1, sample_rate);
+
+        REQUIRE(samples.front() > 0.0f);
+        REQUIRE(samples.front() < 1.0f);
+        REQUIRE(samples.back() == Approx{1.0f});
+
+        for(std::size_t i{1}; i < std::size(samples); ++i)
+        {
+            REQUIRE(samples[i] >= samples[i - 1]);
+        }
+    }
+
+    SECTION("swl::lowpass_filter keeps a separate state per channel")
+    {
+        swl::lowpass_filter filter{1000.0f};
+
+        std::vector<float> samples(4800 * 2);
+        for(std::size_t i{}; i < std::size(samples); i += 2)
+        {
+            samples[i] = 1.0f;
+        }
+
+        filter.process(samples, 2, sample_rate);
+
+        REQUIRE(samples[std::size(samples) - 2] == Approx{1.0f});
+        REQUIRE(samples[std::size(samples) - 1] == Approx{0.0f});
+    }
+
+    SECTION("swl::reverb adds a decaying tail after an impulse")
+    {
+        swl::reverb reverb{sample_rate};
+
+        std::vector<float> samples(sample_rate);
+        samples[0] = 1.0f;
+
+        reverb.process(samples, 1, sample_rate);
+
+        float tail{};
+        for(std::size_t i{1}; i < std::size(samples); ++i)
+        {
+            tail = std::max(tail, std::abs(samples[i]));
+        }
+
+        REQUIRE(tail > 0.0f);
+        REQUIRE(tail < 1.0f);
+    }
+
+    SECTION("swl::reverb without wet signal leaves the input untouched")
+    {
+        swl::reverb reverb{sample_rate, swl::reverb_parameters{.wet = 0.0f, .dry = 1.0f}};
+
+        std::vector<float> samples(1024);
+        for(std::size_t i{}; i < std::size(samples); ++i)
+        {
+            samples[i] = static_cast<float>(i % 7) / 7.0f;
+        }
+
+        const auto input{samples};
+        reverb.process(samples, 1, sample_rate);
+
+        REQUIRE(samples == input);
+    }
+}
+
+TEST_CASE("Offline renderer test", "[offline]")
+{
+    swl::audio_world world{sample_rate};
+
+    swl::listener listener{1};
+    listener.disable_spatialization();
+
+    const auto source{make_ramp(1000)};
+    const auto data{make_wave(source)};
+    swl::sound sound{world, std::make_unique<swl::wave_reader>(data)};
+
+    SECTION("swl::offline_renderer renders the source, then silence")
+    {
+        sound.start();
+
+        swl::offline_renderer renderer{world, listener, 64}; //Not a divisor of the source size
+
+        std::vector<float> output{};
+        const auto statistics{renderer.render(output, 1200)};
+
+        REQUIRE(std::size(output) == 1200);
+        REQUIRE(statistics.frame_count == 1200);
+        REQUIRE(statistics.world.generated_frames == 1200);
+        REQUIRE(renderer.tell() == 1200);
+
+        for(std::size_t i{}; i < std::size(source); ++i)
+        {
+            REQUIRE(output[i] == Approx{source[i]}.margin(1e-6));
+        }
+
+        for(std::size_t i{std::size(source)}; i < std::size(output); ++i)
+        {
+            REQUIRE(output[i] == 0.0f);
+        }
+    }
+
+    SECTION("swl::offline_renderer runs scheduled events at their exact frame")
+    {
+        swl::offline_renderer renderer{world, listener, 256};
+        renderer.schedule(100, [&sound]()
+        {
+            sound.start();
+        });
+
+        std::vector<float> output{};
+        renderer.render(output, 1200);
+
+        for(std::size_t i{}; i < 100; ++i)
+        {
+            REQUIRE(output[i] == 0.0f);
+        }
+
+        for(std::size_t i{}; i < std::size(source); ++i)
+        {
+            REQUIRE(output[i + 100] == Approx{source[i]}.margin(1e-6));
+        }
+    }
+
+    SECTION("swl::offline_renderer output does not depend on the block size")
+    {
+        std::vector<float> reference{};
+
+        {
+            sound.start();
+
+            swl::offline_renderer renderer{world, listener, 1024};
+            renderer.render(reference, 1200);
+        }
+
+        swl::sound other{world, std::make_unique<swl::wave_reader>(data)};
+        other.start();
+
+        swl::offline_renderer renderer{world, listener, 7};
+
+        std::vector<float> output{};
+        renderer.render(output, 1200);
+
+        REQUIRE(output == reference);
+    }
+
+    SECTION("swl::offline_renderer writes a readable wave file")
+    {
+        const auto path{std::filesystem::temp_directory_path() / "swell_offline_test.wav"};
+
+        sound.start();
+
+        swl::offline_renderer renderer{world, listener};
+        renderer.render(path, 1000);
+
+        swl::wave_reader reader{path};
+        REQUIRE(reader.info().frame_count == 1000);
+        REQUIRE(reader.info().frequency == sample_rate);
+        REQUIRE(reader.info().channel_count == 1);
+
+        std::vector<float> output(1000);
+        reader.read(std::data(output), 1000);
+
+        for(std::size_t i{}; i < std::size(source); ++i)
+        {
+            REQUIRE(output[i] == Approx{source[i]}.margin(1e-6));
+        }
+
+        reader = swl::wave_reader{};
+        std::filesystem::remove(path);
+    }
+}
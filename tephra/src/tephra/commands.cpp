@@ -897,6 +897,12 @@ void bind_vertex_buffer(command_buffer& command_buffer, buffer& buffer, std::uin
     vkCmdBindVertexBuffers(underlying_cast<VkCommandBuffer>(command_buffer), 0, 1, &native_buffer, &offset);
 }
 
+void bind_vertex_buffer(command_buffer& command_buffer, std::uint32_t binding, buffer& buffer, std::uint64_t offset) noexcept
+{
+    VkBuffer native_buffer{underlying_cast<VkBuffer>(buffer)};
+    vkCmdBindVertexBuffers(underlying_cast<VkCommandBuffer>(command_buffer), binding, 1, &native_buffer, &offset);
+}
+
 void bind_index_buffer(command_buffer& command_buffer, buffer& buffer, std::uint64_t offset, index_type type) noexcept
 {
     vkCmdBindIndexBuffer(underlying_cast<VkCommandBuffer>(command_buffer), underlying_cast<VkBuffer>(buffer), offset, static_cast<VkIndexType>(type));
@@ -924,6 +930,13 @@ void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, st
                             index, static_cast<std::uint32_t>(std::size(native_sets)), std::data(native_sets), 0, nullptr);
 }
 
+void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, std::span<const std::uint32_t> dynamic_offsets, pipeline_type bind_point) noexcept
+{
+    VkDescriptorSet native_set{underlying_cast<VkDescriptorSet>(set)};
+    vkCmdBindDescriptorSets(underlying_cast<VkCommandBuffer>(command_buffer), static_cast<VkPipelineBindPoint>(bind_point), underlying_cast<VkPipelineLayout>(layout),
+                            index, 1, &native_set, static_cast<std::uint32_t>(std::size(dynamic_offsets)), std::data(dynamic_offsets));
+}
+
 void reset_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept
 {
     vkCmdResetEvent(underlying_cast<VkCommandBuffer>(command_buffer), underlying_cast<VkEvent>(event), static_cast<VkPipelineStageFlags>(stage));
@@ -1426,6 +1439,8 @@ void submit(renderer& renderer, std::span<const submit_info> submits, optional_r
 void submit(renderer& renderer, queue queue, const submit_info& info, optional_ref<fence> fence)
 {
     assert(std::size(info.wait_semaphores) == std::size(info.wait_stages) && "tph::submit_info::wait_semaphores and tph::submit_info::wait_stages must have the same size.");
+    assert((std::empty(info.wait_values) || std::size(info.wait_values) == std::size(info.wait_semaphores)) && "tph::submit_info::wait_values must be empty or have the same size as tph::submit_info::wait_semaphores.");
+    assert((std::empty(info.signal_values) || std::size(info.signal_values) == std::size(info.signal_semaphores)) && "tph::submit_info::signal_values must be empty or have the same size as tph::submit_info::signal_semaphores.");
 
     stack_memory_pool<1024 * 2> pool{};
 
@@ -1467,6 +1482,18 @@ void submit(renderer& renderer, queue queue, const submit_info& info, optional_r
     native_submit.signalSemaphoreCount = static_cast<std::uint32_t>(std::size(signal_semaphores));
     native_submit.pSignalSemaphores = std::data(signal_semaphores);
 
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    if(!std::empty(info.wait_values) || !std::empty(info.signal_values))
+    {
+        timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_info.waitSemaphoreValueCount = static_cast<std::uint32_t>(std::size(info.wait_values));
+        timeline_info.pWaitSemaphoreValues = std::data(info.wait_values);
+        timeline_info.signalSemaphoreValueCount = static_cast<std::uint32_t>(std::size(info.signal_values));
+        timeline_info.pSignalSemaphoreValues = std::data(info.signal_values);
+
+        native_submit.pNext = &timeline_info;
+    }
+
     VkFence native_fence{fence.has_value() ? underlying_cast<VkFence>(*fence) : VkFence{}};
 
     if(auto result{vkQueueSubmit(underlying_cast<VkQueue>(renderer, queue), 1, &native_submit, native_fence)}; result != VK_SUCCESS)
@@ -1493,6 +1520,8 @@ void submit(renderer& renderer, queue queue, std::span<const submit_info> submit
     for(const auto& submit : submits)
     {
         assert(std::size(submit.wait_semaphores) == std::size(submit.wait_stages) && "tph::submit_info::wait_semaphores and tph::submit_info::wait_stages must have the same size.");
+        assert((std::empty(submit.wait_values) || std::size(submit.wait_values) == std::size(submit.wait_semaphores)) && "tph::submit_info::wait_values must be empty or have the same size as tph::submit_info::wait_semaphores.");
+        assert((std::empty(submit.signal_values) || std::size(submit.signal_values) == std::size(submit.signal_semaphores)) && "tph::submit_info::signal_values must be empty or have the same size as tph::submit_info::signal_semaphores.");
 
         auto wait_semaphores{make_stack_vector<VkSemaphore>(pool)};
         wait_semaphores.reserve(std::size(submit.wait_semaphores));
@@ -1525,11 +1554,17 @@ void submit(renderer& renderer, queue queue, std::span<const submit_info> submit
         temp_submits.emplace_back(temp_submit_info{std::move(wait_semaphores), std::move(wait_stages), std::move(command_buffers), std::move(signal_semaphores)});
     }
 
+    auto timeline_infos{make_stack_vector<VkTimelineSemaphoreSubmitInfo>(pool)};
+    timeline_infos.reserve(std::size(submits)); //never reallocates, native submits keep pointers to its elements
+
     auto native_submits{make_stack_vector<VkSubmitInfo>(pool)};
     native_submits.reserve(std::size(temp_submits));
 
-    for(const auto& temp_submit : temp_submits)
+    for(std::size_t i{}; i < std::size(temp_submits); ++i)
     {
+        const auto& temp_submit{temp_submits[i]};
+        const auto& submit{submits[i]};
+
         VkSubmitInfo& native_submit{native_submits.emplace_back()};
         native_submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         native_submit.waitSemaphoreCount = static_cast<std::uint32_t>(std::size(temp_submit.wait_semaphores));
@@ -1539,6 +1574,18 @@ void submit(renderer& renderer, queue queue, std::span<const submit_info> submit
         native_submit.pCommandBuffers = std::data(temp_submit.command_buffers);
         native_submit.signalSemaphoreCount = static_cast<std::uint32_t>(std::size(temp_submit.signal_semaphores));
         native_submit.pSignalSemaphores = std::data(temp_submit.signal_semaphores);
+
+        if(!std::empty(submit.wait_values) || !std::empty(submit.signal_values))
+        {
+            VkTimelineSemaphoreSubmitInfo& timeline_info{timeline_infos.emplace_back()};
+            timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timeline_info.waitSemaphoreValueCount = static_cast<std::uint32_t>(std::size(submit.wait_values));
+            timeline_info.pWaitSemaphoreValues = std::data(submit.wait_values);
+            timeline_info.signalSemaphoreValueCount = static_cast<std::uint32_t>(std::size(submit.signal_values));
+            timeline_info.pSignalSemaphoreValues = std::data(submit.signal_values);
+
+            native_submit.pNext = &timeline_info;
+        }
     }
 
     VkFence native_fence{fence.has_value() ? underlying_cast<VkFence>(*fence) : VkFence{}};
@@ -331,6 +331,8 @@ struct submit_info
     std::vector<pipeline_stage> wait_stages{};
     std::vector<std::reference_wrapper<command_buffer>> command_buffers{};
     std::vector<std::reference_wrapper<semaphore>> signal_semaphores{};
+    std::vector<std::uint64_t> wait_values{}; //Either empty or one value per wait semaphore, ignored for binary semaphores
+    std::vector<std::uint64_t> signal_values{}; //Either empty or one value per signal semaphore, ignored for binary semaphores
 };
 
 namespace cmd
@@ -376,9 +378,12 @@ TEPHRA_API void end_render_pass(command_buffer& command_buffer) noexcept;
 
 TEPHRA_API void bind_pipeline(command_buffer& command_buffer, pipeline& pipeline) noexcept;
 TEPHRA_API void bind_vertex_buffer(command_buffer& command_buffer, buffer& buffer, std::uint64_t offset) noexcept;
+TEPHRA_API void bind_vertex_buffer(command_buffer& command_buffer, std::uint32_t binding, buffer& buffer, std::uint64_t offset) noexcept;
 TEPHRA_API void bind_index_buffer(command_buffer& command_buffer, buffer& buffer, std::uint64_t offset, index_type type) noexcept;
 TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, pipeline_type bind_point = pipeline_type::graphics) noexcept;
 TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, std::span<descriptor_set> sets, pipeline_layout& layout, pipeline_type bind_point = pipeline_type::graphics) noexcept;
+//Dynamic offsets are given in binding order, one per dynamic uniform or storage buffer descriptor of the set
+TEPHRA_API void bind_descriptor_set(command_buffer& command_buffer, std::uint32_t index, descriptor_set& set, pipeline_layout& layout, std::span<const std::uint32_t> dynamic_offsets, pipeline_type bind_point = pipeline_type::graphics) noexcept;
 
 TEPHRA_API void reset_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept;
 TEPHRA_API void set_event(command_buffer& command_buffer, event& event, pipeline_stage stage) noexcept;
@@ -43,6 +43,10 @@ descriptor_set_layout::descriptor_set_layout(renderer& renderer, std::span<const
 
     auto native_bindings{make_stack_vector<VkDescriptorSetLayoutBinding>(pool)};
     native_bindings.reserve(std::size(bindings));
+    auto native_flags{make_stack_vector<VkDescriptorBindingFlags>(pool)};
+    native_flags.reserve(std::size(bindings));
+
+    descriptor_binding_flags all_flags{};
 
     for(auto&& binding : bindings)
     {
@@ -53,9 +57,28 @@ descriptor_set_layout::descriptor_set_layout(renderer& renderer, std::span<const
         native_binding.descriptorCount = binding.count;
 
         native_bindings.emplace_back(native_binding);
+        native_flags.emplace_back(static_cast<VkDescriptorBindingFlags>(binding.flags));
+
+        all_flags |= binding.flags;
     }
 
-    m_layout = vulkan::descriptor_set_layout{underlying_cast<VkDevice>(renderer), native_bindings};
+    //Binding flags are only chained when used, so layouts without them do not need the descriptor indexing feature
+    if(all_flags != descriptor_binding_flags::none)
+    {
+        VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{};
+        flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        flags_info.bindingCount = static_cast<std::uint32_t>(std::size(native_flags));
+        flags_info.pBindingFlags = std::data(native_flags);
+
+        const bool update_after_bind{static_cast<bool>(all_flags & descriptor_binding_flags::update_after_bind)};
+        const VkDescriptorSetLayoutCreateFlags flags{update_after_bind ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0u};
+
+        m_layout = vulkan::descriptor_set_layout{underlying_cast<VkDevice>(renderer), native_bindings, flags, &flags_info};
+    }
+    else
+    {
+        m_layout = vulkan::descriptor_set_layout{underlying_cast<VkDevice>(renderer), native_bindings};
+    }
 }
 
 void set_object_name(renderer& renderer, const descriptor_set_layout& object, const std::string& name)
@@ -70,7 +93,7 @@ void set_object_name(renderer& renderer, const descriptor_set_layout& object, co
         throw vulkan::error{result};
 }
 
-descriptor_pool::descriptor_pool(renderer& renderer, std::span<const descriptor_pool_size> sizes, std::optional<std::uint32_t> max_sets)
+descriptor_pool::descriptor_pool(renderer& renderer, std::span<const descriptor_pool_size> sizes, std::optional<std::uint32_t> max_sets, descriptor_pool_options options)
 {
     stack_memory_pool<1024> pool{};
 
@@ -95,7 +118,7 @@ descriptor_pool::descriptor_pool(renderer& renderer, std::span<const descriptor_
         max_sets = total_size;
     }
 
-    m_descriptor_pool = vulkan::descriptor_pool{underlying_cast<VkDevice>(renderer), native_sizes, *max_sets};
+    m_descriptor_pool = vulkan::descriptor_pool{underlying_cast<VkDevice>(renderer), native_sizes, *max_sets, static_cast<VkDescriptorPoolCreateFlags>(options)};
 }
 
 void set_object_name(renderer& renderer, const descriptor_pool& object, const std::string& name)
@@ -47,6 +47,7 @@ struct descriptor_set_layout_binding
     std::uint32_t binding{};
     descriptor_type type{};
     std::uint32_t count{1};
+    descriptor_binding_flags flags{}; //Requires the descriptor_indexing feature if not none
 };
 
 class TEPHRA_API descriptor_set_layout
@@ -101,7 +102,8 @@ class TEPHRA_API descriptor_pool
 
 public:
     constexpr descriptor_pool() = default;
-    explicit descriptor_pool(renderer& renderer, std::span<const descriptor_pool_size> sizes, std::optional<std::uint32_t> max_sets = std::nullopt);
+    //Sets of layouts with update_after_bind bindings must be allocated from a pool created with descriptor_pool_options::update_after_bind
+    explicit descriptor_pool(renderer& renderer, std::span<const descriptor_pool_size> sizes, std::optional<std::uint32_t> max_sets = std::nullopt, descriptor_pool_options options = descriptor_pool_options::none);
 
     explicit descriptor_pool(vulkan::descriptor_pool descriptor_pool) noexcept
     :m_descriptor_pool{std::move(descriptor_pool)}
@@ -311,6 +311,20 @@ enum class descriptor_type : std::uint32_t
     input_attachment = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
 };
 
+enum class descriptor_binding_flags : std::uint32_t
+{
+    none = 0,
+    update_after_bind = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+    update_unused_while_pending = VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+    partially_bound = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+};
+
+enum class descriptor_pool_options : std::uint32_t
+{
+    none = 0,
+    update_after_bind = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+};
+
 enum class vertex_input_rate : std::uint32_t
 {
     vertex = VK_VERTEX_INPUT_RATE_VERTEX,
@@ -335,6 +349,11 @@ enum class vertex_format : std::uint32_t
     vec4i = VK_FORMAT_R32G32B32A32_SINT,
     vec4f = VK_FORMAT_R32G32B32A32_SFLOAT,
     vec4d = VK_FORMAT_R64G64B64A64_SFLOAT,
+    vec2i16 = VK_FORMAT_R16G16_SINT,
+    vec2i16_scaled = VK_FORMAT_R16G16_SSCALED, //Not mandatory for vertex buffers
+    vec4i16_scaled = VK_FORMAT_R16G16B16A16_SSCALED,
+    vec2u16_norm = VK_FORMAT_R16G16_UNORM,
+    vec4u8_norm = VK_FORMAT_R8G8B8A8_UNORM,
 };
 
 enum class texture_format : std::uint32_t
@@ -663,6 +682,8 @@ template<> struct tph::enable_enum_operations<tph::resource_access> {static cons
 template<> struct tph::enable_enum_operations<tph::texture_aspect> {static constexpr bool value{true};};
 template<> struct tph::enable_enum_operations<tph::format_feature> {static constexpr bool value{true};};
 template<> struct tph::enable_enum_operations<tph::dependency_flags> {static constexpr bool value{true};};
+template<> struct tph::enable_enum_operations<tph::descriptor_binding_flags> {static constexpr bool value{true};};
+template<> struct tph::enable_enum_operations<tph::descriptor_pool_options> {static constexpr bool value{true};};
 template<> struct tph::enable_enum_operations<tph::query_pipeline_statistic> {static constexpr bool value{true};};
 template<> struct tph::enable_enum_operations<tph::query_control> {static constexpr bool value{true};};
 template<> struct tph::enable_enum_operations<tph::query_results> {static constexpr bool value{true};};
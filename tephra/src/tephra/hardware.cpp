@@ -48,6 +48,9 @@ static physical_device_properties make_properties(const VkPhysicalDeviceProperti
     output.api_version.patch = VK_VERSION_PATCH(properties.apiVersion);
     output.type = static_cast<physical_device_type>(properties.deviceType);
     std::copy(std::cbegin(properties.pipelineCacheUUID), std::cend(properties.pipelineCacheUUID), std::begin(output.uuid));
+    output.vendor_id = properties.vendorID;
+    output.device_id = properties.deviceID;
+    output.driver_version = properties.driverVersion;
 
     return output;
 }
@@ -263,14 +266,29 @@ physical_device make_physical_device(VkPhysicalDevice device, tph::version insta
 
         vkGetPhysicalDeviceProperties2(device, &properties);
 
-        VkPhysicalDeviceFeatures features{};
-        vkGetPhysicalDeviceFeatures(device, &features);
+        VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing{};
+        descriptor_indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore{};
+        timeline_semaphore.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        timeline_semaphore.pNext = &descriptor_indexing;
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &timeline_semaphore;
+
+        vkGetPhysicalDeviceFeatures2(device, &features);
 
         physical_device output{};
 
         output.m_physical_device = device;
         output.m_properties = make_properties(properties.properties);
-        output.m_features = make_features(features);
+        output.m_features = make_features(features.features);
+        output.m_features.timeline_semaphore = static_cast<bool>(timeline_semaphore.timelineSemaphore);
+        output.m_features.descriptor_indexing = descriptor_indexing.runtimeDescriptorArray
+                                             && descriptor_indexing.descriptorBindingPartiallyBound
+                                             && descriptor_indexing.descriptorBindingSampledImageUpdateAfterBind
+                                             && descriptor_indexing.descriptorBindingUpdateUnusedWhilePending;
         output.m_limits = make_limits(properties.properties.limits);
         output.m_memory_properties = make_memory_properties(device);
         output.m_driver = make_driver(driver);
@@ -54,6 +54,9 @@ struct physical_device_properties
     tph::version api_version{};
     std::string name{};
     std::array<std::uint8_t, 16> uuid{};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
 };
 
 struct physical_device_features
@@ -101,6 +104,8 @@ struct physical_device_features
     bool shader_resource_min_lod{};
     bool variable_multisample_rate{};
     bool inherited_queries{};
+    bool timeline_semaphore{}; //Vulkan 1.2 core feature, always false on older instances
+    bool descriptor_indexing{}; //Vulkan 1.2 core feature: runtime arrays, partially bound and update after bind sampled images. Always false on older instances
 };
 
 struct physical_device_limits
@@ -66,6 +66,29 @@ static VkMemoryPropertyFlags optimal_memory_types(image_usage usage)
     return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
 }
 
+decoded_image decode_image(const std::filesystem::path& file)
+{
+    return decode_image(read_file<std::vector<std::uint8_t>>(file));
+}
+
+decoded_image decode_image(std::span<const std::uint8_t> data)
+{
+    int width{};
+    int height{};
+    int channels{};
+
+    stbi_ptr pixels{stbi_load_from_memory(std::data(data), static_cast<int>(std::size(data)), &width, &height, &channels, STBI_rgb_alpha)};
+    if(!pixels)
+        throw std::runtime_error{"Can not load image. " + std::string{stbi_failure_reason()}};
+
+    const auto size{static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4};
+
+    decoded_image output{static_cast<std::size_t>(width), static_cast<std::size_t>(height)};
+    output.data.assign(pixels.get(), pixels.get() + size);
+
+    return output;
+}
+
 image::image(renderer& renderer, const std::filesystem::path& file, image_usage usage)
 :image{renderer, read_file<std::vector<std::uint8_t>>(file), usage}
 {
@@ -26,6 +26,8 @@
 #include "config.hpp"
 
 #include <filesystem>
+#include <vector>
+#include <span>
 
 #include "vulkan/vulkan.hpp"
 #include "vulkan/memory.hpp"
@@ -71,6 +73,17 @@ enum class image_format
     jpg = 3,
 };
 
+//RGBA8 pixels decoded in host memory, unlike tph::image it does not allocate any device memory
+struct decoded_image
+{
+    std::size_t width{};
+    std::size_t height{};
+    std::vector<std::uint8_t> data{};
+};
+
+TEPHRA_API decoded_image decode_image(const std::filesystem::path& file);
+TEPHRA_API decoded_image decode_image(std::span<const std::uint8_t> data);
+
 class TEPHRA_API image
 {
     template<typename VulkanObject, typename... Args>
@@ -506,9 +506,35 @@ renderer::renderer(const physical_device& physical_device, renderer_layer layers
         queue.pQueuePriorities = &priority;
     }
 
-    m_device = vulkan::device{m_physical_device, layer_names, extension_names, queues, features};
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing{};
+    descriptor_indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    descriptor_indexing.runtimeDescriptorArray = VK_TRUE;
+    descriptor_indexing.descriptorBindingPartiallyBound = VK_TRUE;
+    descriptor_indexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    descriptor_indexing.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore{};
+    timeline_semaphore.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timeline_semaphore.timelineSemaphore = static_cast<VkBool32>(enabled_features.timeline_semaphore);
+
+    //Feature structures are only chained when enabled, so older drivers never see them
+    const void* next{};
+
+    if(enabled_features.descriptor_indexing)
+    {
+        next = &descriptor_indexing;
+    }
+
+    if(enabled_features.timeline_semaphore)
+    {
+        timeline_semaphore.pNext = const_cast<void*>(next);
+        next = &timeline_semaphore;
+    }
+
+    m_device = vulkan::device{m_physical_device, layer_names, extension_names, queues, features, next};
     m_layers = layers;
     m_extensions = extensions;
+    m_features = enabled_features;
 
     tph::vulkan::functions::load_device_level_functions(m_device);
 
@@ -103,6 +103,11 @@ public:
         return m_extensions;
     }
 
+    const physical_device_features& enabled_features() const noexcept
+    {
+        return m_features;
+    }
+
     std::uint32_t queue_family(queue queue) const noexcept
     {
         return m_queue_families[static_cast<std::size_t>(queue)];
@@ -138,6 +143,7 @@ private:
     vulkan::device m_device{};
     renderer_layer m_layers{};
     renderer_extension m_extensions{};
+    physical_device_features m_features{};
     queue_families_t m_queue_families{};
     queues_t m_queues{};
     transfer_granularity m_transfer_queue_granularity{};
@@ -37,6 +37,55 @@ semaphore::semaphore(renderer& renderer)
 
 }
 
+semaphore::semaphore(renderer& renderer, std::uint64_t initial_value)
+:m_semaphore{underlying_cast<VkDevice>(renderer), initial_value}
+{
+
+}
+
+std::uint64_t semaphore::value() const
+{
+    std::uint64_t output{};
+    if(auto result{vkGetSemaphoreCounterValue(m_semaphore.device(), m_semaphore, &output)}; result != VK_SUCCESS)
+        throw vulkan::error{result};
+
+    return output;
+}
+
+void semaphore::signal(std::uint64_t value)
+{
+    VkSemaphoreSignalInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    info.semaphore = m_semaphore;
+    info.value = value;
+
+    if(auto result{vkSignalSemaphore(m_semaphore.device(), &info)}; result != VK_SUCCESS)
+        throw vulkan::error{result};
+}
+
+bool semaphore::wait_impl(std::uint64_t value, std::uint64_t nanoseconds) const
+{
+    if(nanoseconds == 0)
+    {
+        return this->value() >= value;
+    }
+
+    VkSemaphore native_semaphore{m_semaphore};
+
+    VkSemaphoreWaitInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    info.semaphoreCount = 1;
+    info.pSemaphores = &native_semaphore;
+    info.pValues = &value;
+
+    const auto result{vkWaitSemaphores(m_semaphore.device(), &info, nanoseconds)};
+
+    if(result < 0)
+        throw vulkan::error{result};
+
+    return result != VK_TIMEOUT;
+}
+
 void set_object_name(renderer& renderer, const semaphore& object, const std::string& name)
 {
     VkDebugUtilsObjectNameInfoEXT info{};
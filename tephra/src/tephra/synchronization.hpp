@@ -42,6 +42,7 @@ class TEPHRA_API semaphore
 public:
     constexpr semaphore() = default;
     explicit semaphore(renderer& renderer);
+    explicit semaphore(renderer& renderer, std::uint64_t initial_value); //Requires the timeline_semaphore feature
 
     explicit semaphore(vulkan::semaphore semaphore) noexcept
     :m_semaphore{std::move(semaphore)}
@@ -55,6 +56,41 @@ public:
     semaphore(semaphore&& other) noexcept = default;
     semaphore& operator=(semaphore&& other) noexcept = default;
 
+    //Timeline semaphore functions, only valid on semaphores created with an initial value
+    std::uint64_t value() const;
+    void signal(std::uint64_t value);
+
+    void wait(std::uint64_t value) const
+    {
+        wait_impl(value, std::numeric_limits<std::uint64_t>::max());
+    }
+
+    bool try_wait(std::uint64_t value) const
+    {
+        return wait_impl(value, 0);
+    }
+
+    template<typename Rep, typename Period>
+    bool wait_for(std::uint64_t value, const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return wait_impl(value, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+    }
+
+    template<typename Clock, typename Duration>
+    bool wait_until(std::uint64_t value, const std::chrono::time_point<Clock, Duration>& time) const
+    {
+        const auto current_time{Clock::now()};
+        if(time < current_time)
+        {
+            return try_wait(value);
+        }
+
+        return wait_impl(value, std::chrono::duration_cast<std::chrono::nanoseconds>(time - current_time).count());
+    }
+
+private:
+    bool wait_impl(std::uint64_t value, std::uint64_t nanoseconds) const;
+
 private:
     vulkan::semaphore m_semaphore{};
 };
@@ -23,6 +23,8 @@
 #include "texture.hpp"
 
 #include <cassert>
+#include <algorithm>
+#include <stdexcept>
 
 #include "vulkan/vulkan_functions.hpp"
 #include "vulkan/helper.hpp"
@@ -149,6 +151,63 @@ texture::texture(renderer& renderer, cubemap_t, std::uint32_t size, const textur
     m_memory = renderer.allocator().allocate_bound(m_image, vulkan::memory_resource_type::non_linear, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
 
+texture::texture(renderer& renderer, aliased_memory_t, std::uint32_t width, std::uint32_t height, const texture_info& info)
+:m_dimensions{2}
+,m_width{width}
+,m_height{height}
+,m_depth{1}
+,m_format{info.format}
+,m_aspect{aspect_from_format(m_format)}
+,m_mip_levels{info.mip_levels}
+,m_array_layers{info.array_layers}
+,m_sample_count{info.sample_count}
+{
+    VkImageCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.extent = VkExtent3D{width, height, 1};
+    create_info.format = static_cast<VkFormat>(m_format);
+    create_info.mipLevels = info.mip_levels;
+    create_info.arrayLayers = info.array_layers;
+    create_info.samples = static_cast<VkSampleCountFlagBits>(info.sample_count);
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = static_cast<VkImageUsageFlags>(info.usage);
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    m_image = vulkan::image{underlying_cast<VkDevice>(renderer), create_info};
+}
+
+vulkan::memory_heap_chunk alias_memory(renderer& renderer, std::span<const std::reference_wrapper<texture>> textures)
+{
+    assert(!std::empty(textures) && "tph::alias_memory called with no texture.");
+
+    VkMemoryRequirements requirements{};
+    requirements.memoryTypeBits = ~std::uint32_t{};
+
+    for(const texture& aliased : textures)
+    {
+        VkMemoryRequirements texture_requirements{};
+        vkGetImageMemoryRequirements(underlying_cast<VkDevice>(renderer), underlying_cast<VkImage>(aliased), &texture_requirements);
+
+        requirements.size = std::max(requirements.size, texture_requirements.size);
+        requirements.alignment = std::max(requirements.alignment, texture_requirements.alignment);
+        requirements.memoryTypeBits &= texture_requirements.memoryTypeBits;
+    }
+
+    if(requirements.memoryTypeBits == 0)
+        throw std::runtime_error{"Can not alias textures memory, they do not have any memory type in common."};
+
+    auto output{renderer.allocator().allocate(requirements, vulkan::memory_resource_type::non_linear, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
+
+    for(const texture& aliased : textures)
+    {
+        output.bind(underlying_cast<VkImage>(aliased));
+    }
+
+    return output;
+}
+
 void set_object_name(renderer& renderer, const texture& object, const std::string& name)
 {
     VkDebugUtilsObjectNameInfoEXT info{};
@@ -26,6 +26,8 @@
 #include "config.hpp"
 
 #include <optional>
+#include <span>
+#include <functional>
 
 #include "vulkan/vulkan.hpp"
 #include "vulkan/memory.hpp"
@@ -79,6 +81,10 @@ inline texture_aspect aspect_from_format(texture_format format) noexcept
 struct cubemap_t{};
 inline constexpr cubemap_t cubemap{};
 
+//Textures created with this tag have no memory, it must be bound with alias_memory before any other use
+struct aliased_memory_t{};
+inline constexpr aliased_memory_t aliased_memory{};
+
 class TEPHRA_API texture
 {
     template<typename VulkanObject, typename... Args>
@@ -92,6 +98,7 @@ public:
     explicit texture(renderer& renderer, std::uint32_t width, std::uint32_t height, const texture_info& info);
     explicit texture(renderer& renderer, std::uint32_t width, std::uint32_t height, std::uint32_t depth, const texture_info& info);
     explicit texture(renderer& renderer, cubemap_t, std::uint32_t size, const texture_info& info);
+    explicit texture(renderer& renderer, aliased_memory_t, std::uint32_t width, std::uint32_t height, const texture_info& info);
 
     explicit texture(vulkan::image image, vulkan::memory_heap_chunk memory,
                      std::uint32_t dimensions, std::uint32_t width, std::uint32_t height, std::uint32_t depth, bool is_cubemap,
@@ -185,6 +192,11 @@ private:
 
 TEPHRA_API void set_object_name(renderer& renderer, const texture& object, const std::string& name);
 
+//Allocates a single chunk large enough for every texture and binds them all to it.
+//Textures must have been created with aliased_memory, only one of them holds meaningful content at a time.
+//The returned chunk must outlive the textures.
+TEPHRA_API vulkan::memory_heap_chunk alias_memory(renderer& renderer, std::span<const std::reference_wrapper<texture>> textures);
+
 template<>
 inline VkDevice underlying_cast(const texture& texture) noexcept
 {
@@ -161,10 +161,11 @@ instance::~instance()
 
 /////////////////////////////////////////////////////////////////////
 
-device::device(VkPhysicalDevice physical_device, std::span<const char* const> layers, std::span<const char* const> extensions, std::span<const VkDeviceQueueCreateInfo> queues, const VkPhysicalDeviceFeatures& features)
+device::device(VkPhysicalDevice physical_device, std::span<const char* const> layers, std::span<const char* const> extensions, std::span<const VkDeviceQueueCreateInfo> queues, const VkPhysicalDeviceFeatures& features, const void* next)
 {
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.pNext = next;
     create_info.enabledLayerCount = static_cast<std::uint32_t>(std::size(layers));
     create_info.ppEnabledLayerNames = std::data(layers);
     create_info.enabledExtensionCount = static_cast<std::uint32_t>(std::size(extensions));
@@ -347,6 +348,22 @@ semaphore::semaphore(VkDevice device)
         throw error{result};
 }
 
+semaphore::semaphore(VkDevice device, std::uint64_t initial_value)
+:m_device{device}
+{
+    VkSemaphoreTypeCreateInfo type_info{};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    create_info.pNext = &type_info;
+
+    if(auto result{vkCreateSemaphore(m_device, &create_info, nullptr, &m_semaphore)}; result != VK_SUCCESS)
+        throw error{result};
+}
+
 semaphore::~semaphore()
 {
     if(m_semaphore)
@@ -434,11 +451,13 @@ command_buffer::~command_buffer()
 
 /////////////////////////////////////////////////////////////////////
 
-descriptor_set_layout::descriptor_set_layout(VkDevice device, std::span<const VkDescriptorSetLayoutBinding> bindings)
+descriptor_set_layout::descriptor_set_layout(VkDevice device, std::span<const VkDescriptorSetLayoutBinding> bindings, VkDescriptorSetLayoutCreateFlags flags, const void* next)
 :m_device{device}
 {
     VkDescriptorSetLayoutCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    create_info.pNext = next;
+    create_info.flags = flags;
     create_info.bindingCount = static_cast<std::uint32_t>(std::size(bindings));
     create_info.pBindings = std::data(bindings);
 
@@ -454,11 +473,12 @@ descriptor_set_layout::~descriptor_set_layout()
 
 /////////////////////////////////////////////////////////////////////
 
-descriptor_pool::descriptor_pool(VkDevice device, std::span<const VkDescriptorPoolSize> sizes, std::uint32_t max_sets)
+descriptor_pool::descriptor_pool(VkDevice device, std::span<const VkDescriptorPoolSize> sizes, std::uint32_t max_sets, VkDescriptorPoolCreateFlags flags)
 :m_device{device}
 {
     VkDescriptorPoolCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    create_info.flags = flags;
     create_info.poolSizeCount = static_cast<std::uint32_t>(std::size(sizes));
     create_info.pPoolSizes = std::data(sizes);
     create_info.maxSets = max_sets;
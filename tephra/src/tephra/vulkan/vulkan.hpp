@@ -190,7 +190,7 @@ class TEPHRA_API device
 {
 public:
     constexpr device() = default;
-    explicit device(VkPhysicalDevice physical_device, std::span<const char* const> layers, std::span<const char* const> extensions, std::span<const VkDeviceQueueCreateInfo> queues, const VkPhysicalDeviceFeatures& features);
+    explicit device(VkPhysicalDevice physical_device, std::span<const char* const> layers, std::span<const char* const> extensions, std::span<const VkDeviceQueueCreateInfo> queues, const VkPhysicalDeviceFeatures& features, const void* next = nullptr);
 
     explicit device(VkDevice device) noexcept
     :m_device{device}
@@ -611,6 +611,7 @@ class TEPHRA_API semaphore
 public:
     constexpr semaphore() = default;
     explicit semaphore(VkDevice device);
+    explicit semaphore(VkDevice device, std::uint64_t initial_value); //timeline semaphore
 
     explicit semaphore(VkDevice device, VkSemaphore semaphore) noexcept
     :m_device{device}
@@ -854,7 +855,7 @@ class TEPHRA_API descriptor_set_layout
 {
 public:
     constexpr descriptor_set_layout() = default;
-    explicit descriptor_set_layout(VkDevice device, std::span<const VkDescriptorSetLayoutBinding> bindings);
+    explicit descriptor_set_layout(VkDevice device, std::span<const VkDescriptorSetLayoutBinding> bindings, VkDescriptorSetLayoutCreateFlags flags = 0, const void* next = nullptr);
 
     explicit descriptor_set_layout(VkDevice device, VkDescriptorSetLayout descriptor_set_layout) noexcept
     :m_device{device}
@@ -901,7 +902,7 @@ class TEPHRA_API descriptor_pool
 {
 public:
     constexpr descriptor_pool() = default;
-    explicit descriptor_pool(VkDevice device, std::span<const VkDescriptorPoolSize> sizes, std::uint32_t max_sets);
+    explicit descriptor_pool(VkDevice device, std::span<const VkDescriptorPoolSize> sizes, std::uint32_t max_sets, VkDescriptorPoolCreateFlags flags = 0);
 
     explicit descriptor_pool(VkDevice device, VkDescriptorPool descriptor_pool) noexcept
     :m_device{device}